@@ -39,6 +39,7 @@ struct _GebrDaemonServerPriv {
 	gchar *clock;
 	gchar *model;
 	gchar *memory;
+	gdouble time_to_ready;
 
 	/* To represent connection */
 	guint timeout;
@@ -191,6 +192,7 @@ gebr_daemon_server_init(GebrDaemonServer *daemon)
 	daemon->priv->maestro_addr = NULL;
 	daemon->priv->ac = TRUE;
 	daemon->priv->mpi_flavors = NULL;
+	daemon->priv->time_to_ready = -1;
 
 	daemon->priv->timeout = -1;
 }
@@ -461,6 +463,23 @@ gebr_daemon_server_get_memory(GebrDaemonServer *daemon)
 	return daemon->priv->memory;
 }
 
+void
+gebr_daemon_server_set_time_to_ready(GebrDaemonServer *daemon,
+                                     gdouble seconds)
+{
+	g_return_if_fail(GEBR_IS_DAEMON_SERVER(daemon));
+
+	daemon->priv->time_to_ready = seconds;
+}
+
+gdouble
+gebr_daemon_server_get_time_to_ready(GebrDaemonServer *daemon)
+{
+	g_return_val_if_fail(GEBR_IS_DAEMON_SERVER(daemon), -1);
+
+	return daemon->priv->time_to_ready;
+}
+
 gboolean
 gebr_daemon_server_accepts_mpi(GebrDaemonServer *daemon,
 			       const gchar *mpi_flavor)
@@ -128,6 +128,16 @@ void gebr_daemon_server_set_memory(GebrDaemonServer *daemon, const gchar *memory
 
 const gchar *gebr_daemon_server_get_memory(GebrDaemonServer *daemon);
 
+void gebr_daemon_server_set_time_to_ready(GebrDaemonServer *daemon, gdouble seconds);
+
+/**
+ * gebr_daemon_server_get_time_to_ready:
+ *
+ * Returns: the time, in seconds, the maestro took to connect to @daemon the
+ * last time, or -1 if unknown.
+ */
+gdouble gebr_daemon_server_get_time_to_ready(GebrDaemonServer *daemon);
+
 gboolean gebr_daemon_server_accepts_mpi(GebrDaemonServer *daemon,
 					const gchar *mpi_flavor);
 
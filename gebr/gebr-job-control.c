@@ -39,6 +39,8 @@ typedef struct {
 	guint sig_status;
 	guint sig_issued;
 	guint sig_cmd_line;
+	guint sig_output_loaded;
+	guint sig_hold;
 	guint sig_button;
 } LastSelection;
 
@@ -166,6 +168,8 @@ static void job_control_fill_servers_info(GebrJobControl *jc);
 
 static void job_control_disconnect_signals(GebrJobControl *jc);
 
+static void job_control_unsubscribe_output(GebrJob *job);
+
 static void gebr_job_control_info_set_visible(GebrJobControl *jc,
 					      gboolean visible,
 					      const gchar *txt);
@@ -238,6 +242,8 @@ on_select_non_single_job(GebrJobControl *jc,
 
 	job_control_disconnect_signals(jc);
 	update_control_buttons(jc, can_close, can_kill, can_save);
+	if (jc->priv->last_selection.job)
+		job_control_unsubscribe_output(jc->priv->last_selection.job);
 	jc->priv->last_selection.job = NULL;
 
 	GtkTreeModel *model = GTK_TREE_MODEL(jc->priv->store);
@@ -869,6 +875,13 @@ on_job_output(GebrJob *job,
 		gtk_text_view_scroll_to_mark(GTK_TEXT_VIEW(jc->priv->text_view), jc->priv->text_mark, 0, FALSE, 0, 0);
 }
 
+static void
+on_job_output_loaded(GebrJob *job,
+		     GebrJobControl *jc)
+{
+	gebr_job_control_load_details(jc, job);
+}
+
 static void
 on_job_status(GebrJob *job,
 	      GebrCommJobStatus old_status,
@@ -894,6 +907,13 @@ on_job_status(GebrJob *job,
 	gtk_tree_model_row_changed(GTK_TREE_MODEL(jc->priv->store), path, iter);
 }
 
+static void
+on_job_hold_changed(GebrJob *job,
+		    GebrJobControl *jc)
+{
+	gebr_jc_update_status_and_time(jc, job, gebr_job_get_status(job));
+}
+
 static void
 on_job_issued(GebrJob *job,
 	      const gchar *issues,
@@ -1038,6 +1058,21 @@ job_control_fill_servers_info(GebrJobControl *jc)
 						  g_strcmp0(niceness, "0")? _(", using only free resources of processing nodes.") : _(", disputing for resources of the processing nodes."));
 		g_string_append(resources, markup);
 
+		gboolean fitted;
+		gdouble sigma, kappa;
+		if (gebr_job_get_scaling(job, &fitted, &sigma, &kappa)) {
+			gchar *scaling_message;
+			if (fitted)
+				scaling_message = g_markup_printf_escaped(_("The number of processes was chosen from previous executions "
+									    "of this flow (contention %.3f, coherence %.4f).\n"),
+									  sigma, kappa);
+			else
+				scaling_message = g_markup_printf_escaped(_("The number of processes was chosen automatically, "
+									    "using all cores since this flow has not run enough times.\n"));
+			g_string_append(resources, scaling_message);
+			g_free(scaling_message);
+		}
+
 		const gchar *mpi_owner_tst = gebr_job_get_mpi_owner(job);
 		const gchar *mpi_flavor = gebr_job_get_mpi_flavor(job);
 		if (mpi_owner_tst && *mpi_owner_tst) {
@@ -1119,6 +1154,15 @@ job_control_fill_servers_info(GebrJobControl *jc)
 	}
 }
 
+static void
+job_control_unsubscribe_output(GebrJob *job)
+{
+	const gchar *maddr = gebr_job_get_maestro_address(job);
+	GebrMaestroServer *maestro = gebr_maestro_controller_get_maestro_for_address(gebr.maestro_controller, maddr);
+	if (maestro)
+		gebr_maestro_server_unsubscribe_output(maestro, job);
+}
+
 static void
 job_control_disconnect_signals(GebrJobControl *jc)
 {
@@ -1131,6 +1175,10 @@ job_control_disconnect_signals(GebrJobControl *jc)
 		                            jc->priv->last_selection.sig_issued);
 		g_signal_handler_disconnect(jc->priv->last_selection.job,
 		                            jc->priv->last_selection.sig_cmd_line);
+		g_signal_handler_disconnect(jc->priv->last_selection.job,
+		                            jc->priv->last_selection.sig_output_loaded);
+		g_signal_handler_disconnect(jc->priv->last_selection.job,
+		                            jc->priv->last_selection.sig_hold);
 	}
 }
 
@@ -1173,6 +1221,10 @@ job_control_on_cursor_changed(GtkTreeSelection *selection,
 	if (has_job) {
 		job_control_disconnect_signals(jc);
 
+		/* Only the output of the job shown is streamed */
+		if (old_job && old_job != job)
+			job_control_unsubscribe_output(old_job);
+
 		jc->priv->last_selection.job = job;
 		jc->priv->last_selection.sig_output =
 				g_signal_connect(job, "output", G_CALLBACK(on_job_output), jc);
@@ -1182,6 +1234,15 @@ job_control_on_cursor_changed(GtkTreeSelection *selection,
 				g_signal_connect(job, "issued", G_CALLBACK(on_job_issued), jc);
 		jc->priv->last_selection.sig_cmd_line =
 				g_signal_connect(job, "cmd-line-received", G_CALLBACK(on_job_cmd_line), jc);
+		jc->priv->last_selection.sig_output_loaded =
+				g_signal_connect(job, "output-loaded", G_CALLBACK(on_job_output_loaded), jc);
+		jc->priv->last_selection.sig_hold =
+				g_signal_connect(job, "hold-changed", G_CALLBACK(on_job_hold_changed), jc);
+
+		const gchar *maddr = gebr_job_get_maestro_address(job);
+		GebrMaestroServer *maestro = gebr_maestro_controller_get_maestro_for_address(gebr.maestro_controller, maddr);
+		if (maestro)
+			gebr_maestro_server_subscribe_output(maestro, job);
 
 		gebr_job_control_load_details(jc, job);
 	}
@@ -1407,6 +1468,12 @@ compute_subheader_label(GebrJob *job,
 		g_string_append_c(start, '\n');
 		g_string_append_printf(start, _("Elapsed time: %s"),
 				       gebr_job_get_running_time(job, start_date));
+		gchar *remaining = gebr_job_get_remaining_time(job, start_date);
+		if (remaining) {
+			g_string_append_c(start, '\n');
+			g_string_append_printf(start, _("Estimated time left: %s"), remaining);
+			g_free(remaining);
+		}
 		*subheader = g_string_free(start, FALSE);
 		*start_detail = NULL;
 		g_string_free(finish, TRUE);
@@ -1440,7 +1507,13 @@ compute_subheader_label(GebrJob *job,
 	}
 
 	if (status == JOB_STATUS_INITIAL) {
-		*subheader = _("Waiting for nodes");
+		const gchar *reason;
+		gint position = gebr_job_get_hold(job, &reason);
+		if (position > 0)
+			*subheader = g_markup_printf_escaped(_("Waiting in position %d of the queue\n%s"),
+							     position, reason);
+		else
+			*subheader = _("Waiting for nodes");
 		*start_detail = NULL;
 		g_string_free(start, TRUE);
 		g_string_free(finish, TRUE);
@@ -1689,6 +1762,9 @@ gebr_job_control_load_details(GebrJobControl *jc,
 		g_string_append(info, _("\n --- The execution started. --- \n\n"));
 	}
 
+	if (!gebr_job_get_output_complete(job))
+		g_string_append(info, _("[Earlier output is not shown, choose \"Show earlier output\" in the context menu]\n"));
+
 	g_string_append(info, gebr_job_get_output(job));
 
 	if (status == JOB_STATUS_FINISHED) {
@@ -1863,6 +1939,18 @@ autoscroll_toggled(GtkCheckMenuItem * check_menu_item)
 	gebr.config.job_log_auto_scroll = gtk_check_menu_item_get_active(check_menu_item);
 }
 
+static void
+on_show_earlier_output(GtkMenuItem *item,
+		       GebrJobControl *jc)
+{
+	GebrJob *job = jc->priv->last_selection.job;
+	const gchar *maddr = gebr_job_get_maestro_address(job);
+	GebrMaestroServer *maestro = gebr_maestro_controller_get_maestro_for_address(gebr.maestro_controller, maddr);
+
+	if (maestro)
+		gebr_maestro_server_request_earlier_output(maestro, job);
+}
+
 static void
 on_text_view_populate_popup(GtkTextView * text_view, GtkMenu * menu, GebrJobControl *jc)
 {
@@ -1883,6 +1971,14 @@ on_text_view_populate_popup(GtkTextView * text_view, GtkMenu * menu, GebrJobCont
 	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menu_item);
 	g_signal_connect(menu_item, "toggled", G_CALLBACK(autoscroll_toggled), NULL);
 	gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(menu_item), gebr.config.job_log_auto_scroll);
+
+	GebrJob *job = jc->priv->last_selection.job;
+	if (text_view == GTK_TEXT_VIEW(jc->priv->text_view) && job && !gebr_job_get_output_complete(job)) {
+		menu_item = gtk_menu_item_new_with_label(_("Show earlier output"));
+		gtk_widget_show(menu_item);
+		gtk_menu_shell_append(GTK_MENU_SHELL(menu), menu_item);
+		g_signal_connect(menu_item, "activate", G_CALLBACK(on_show_earlier_output), jc);
+	}
 }
 
 static GtkMenu *
@@ -2585,6 +2681,11 @@ gebr_job_control_add(GebrJobControl *jc, GebrJob *job)
 	                   JC_IS_CONTROL, FALSE,
 	                   JC_CONTROL_TYPE, TIME_NONE,
 	                   -1);
+
+	/* Jobs are added again when their maestro reconnects */
+	g_signal_handlers_disconnect_by_func(job, on_job_disconnected, jc);
+	g_signal_handlers_disconnect_by_func(job, on_job_remove, jc);
+	g_signal_handlers_disconnect_by_func(job, on_status_update_toolbar_buttons, jc);
 	g_signal_connect(job, "disconnect", G_CALLBACK(on_job_disconnected), jc);
 	g_signal_connect(job, "job-remove", G_CALLBACK(on_job_remove), jc);
 	g_signal_connect(job, "status-change", G_CALLBACK(on_status_update_toolbar_buttons), jc);
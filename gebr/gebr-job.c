@@ -19,6 +19,7 @@
 
 #include <glib/gi18n.h>
 #include <stdlib.h>
+#include <string.h>
 #include <libgebr/utils.h>
 
 #include "gebr.h"
@@ -61,8 +62,20 @@ struct _GebrJobPriv {
 	gchar *snapshot_id;
 	gchar *gebrjob_id;
 	const gchar *server_list;
+	gint eta;
+
+	/* Automatic speed, see gebr_job_set_scaling() */
+	gboolean auto_speed;
+	gboolean has_scaling;
+	gdouble sigma;
+	gdouble kappa;
 
 	gboolean is_fake;
+	gboolean output_loaded;
+
+	/* Place in the run queue of the maestro, see gebr_job_set_hold() */
+	gint hold_position;
+	gchar *hold_reason;
 
 	/* Interface properties */
 	GtkTreeIter iter;
@@ -80,6 +93,8 @@ enum {
 	OUTPUT,
 	DISCONNECT,
 	JOB_REMOVE,
+	OUTPUT_LOADED,
+	HOLD_CHANGED,
 	N_SIGNALS
 };
 
@@ -109,6 +124,7 @@ gebr_job_finalize(GObject *object)
 	g_free(job->priv->snapshot_title);
 	g_free(job->priv->snapshot_id);
 	g_free(job->priv->gebrjob_id);
+	g_free(job->priv->hold_reason);
 
 	G_OBJECT_CLASS(gebr_job_parent_class)->finalize(object);
 }
@@ -135,8 +151,10 @@ gebr_job_init(GebrJob *job)
 						GebrJobPriv);
 	job->priv->status = JOB_STATUS_INITIAL;
 	job->priv->is_fake = TRUE;
+	job->priv->output_loaded = TRUE;
 	job->priv->description = NULL;
 	job->priv->snapshot_title = NULL;
+	job->priv->eta = -1;
 }
 
 static void
@@ -201,6 +219,24 @@ gebr_job_class_init(GebrJobClass *klass)
 			             g_cclosure_marshal_VOID__VOID,
 			             G_TYPE_NONE, 0);
 
+	signals[OUTPUT_LOADED] =
+			g_signal_new("output-loaded",
+			             G_OBJECT_CLASS_TYPE(gobject_class),
+			             G_SIGNAL_RUN_FIRST,
+			             G_STRUCT_OFFSET(GebrJobClass, output_loaded),
+			             NULL, NULL,
+			             g_cclosure_marshal_VOID__VOID,
+			             G_TYPE_NONE, 0);
+
+	signals[HOLD_CHANGED] =
+			g_signal_new("hold-changed",
+			             G_OBJECT_CLASS_TYPE(gobject_class),
+			             G_SIGNAL_RUN_FIRST,
+			             G_STRUCT_OFFSET(GebrJobClass, hold_changed),
+			             NULL, NULL,
+			             g_cclosure_marshal_VOID__VOID,
+			             G_TYPE_NONE, 0);
+
 	g_type_class_add_private(klass, sizeof(GebrJobPriv));
 }
 
@@ -627,6 +663,53 @@ gebr_job_get_running_time(GebrJob *job, const gchar *start_date)
 
 	return gebr_calculate_detailed_relative_time(&start_time, &current_time);
 }
+
+gchar *
+gebr_job_get_remaining_time(GebrJob *job, const gchar *start_date)
+{
+	GTimeVal finish_time, current_time;
+
+	if (job->priv->eta < 0 || !start_date
+	    || !g_time_val_from_iso8601(start_date, &finish_time))
+		return NULL;
+
+	finish_time.tv_sec += job->priv->eta;
+	g_get_current_time(&current_time);
+
+	if (finish_time.tv_sec <= current_time.tv_sec)
+		return NULL;
+
+	return gebr_calculate_detailed_relative_time(&current_time, &finish_time);
+}
+
+void
+gebr_job_set_eta(GebrJob *job, gint eta)
+{
+	job->priv->eta = eta;
+}
+
+void
+gebr_job_set_scaling(GebrJob *job, gboolean fitted, gdouble sigma, gdouble kappa)
+{
+	job->priv->auto_speed = TRUE;
+	job->priv->has_scaling = fitted;
+	job->priv->sigma = sigma;
+	job->priv->kappa = kappa;
+}
+
+gboolean
+gebr_job_get_scaling(GebrJob *job, gboolean *fitted, gdouble *sigma, gdouble *kappa)
+{
+	if (fitted)
+		*fitted = job->priv->has_scaling;
+	if (sigma)
+		*sigma = job->priv->sigma;
+	if (kappa)
+		*kappa = job->priv->kappa;
+
+	return job->priv->auto_speed;
+}
+
 gchar *
 gebr_job_get_elapsed_time(GebrJob *job)
 {
@@ -824,10 +907,79 @@ void
 gebr_job_append_output(GebrJob *job, gint frac,
 		       const gchar *output)
 {
+	/* Missing the output before, this would be out of place */
+	if (!job->priv->output_loaded)
+		return;
+
 	g_string_append(job->priv->tasks[frac].output, output);
 	g_signal_emit(job, signals[OUTPUT], 0, frac, output);
 }
 
+void
+gebr_job_set_output(GebrJob *job, gint frac,
+		    gsize offset,
+		    gsize total,
+		    const gchar *output)
+{
+	if (frac >= 0 && frac < job->priv->n_servers) {
+		GebrJobTask *task = &job->priv->tasks[frac];
+		gsize len = strlen(output);
+
+		if (offset + len == total) {
+			g_string_assign(task->output, output);
+			task->output_offset = offset;
+		} else if (offset + len == task->output_offset) {
+			g_string_prepend(task->output, output);
+			task->output_offset = offset;
+		}
+	}
+
+	gebr_job_set_output_loaded(job, TRUE);
+}
+
+gboolean
+gebr_job_get_output_complete(GebrJob *job)
+{
+	for (gint i = 0; i < job->priv->n_servers; i++)
+		if (job->priv->tasks[i].output_offset > 0)
+			return FALSE;
+	return TRUE;
+}
+
+gboolean
+gebr_job_get_output_loaded(GebrJob *job)
+{
+	return job->priv->output_loaded;
+}
+
+void
+gebr_job_set_output_loaded(GebrJob *job, gboolean loaded)
+{
+	job->priv->output_loaded = loaded;
+
+	if (loaded)
+		g_signal_emit(job, signals[OUTPUT_LOADED], 0);
+}
+
+void
+gebr_job_set_hold(GebrJob *job, gint position, const gchar *reason)
+{
+	job->priv->hold_position = position;
+	g_free(job->priv->hold_reason);
+	job->priv->hold_reason = position > 0 ? g_strdup(reason) : NULL;
+
+	g_signal_emit(job, signals[HOLD_CHANGED], 0);
+}
+
+gint
+gebr_job_get_hold(GebrJob *job, const gchar **reason)
+{
+	if (reason)
+		*reason = job->priv->hold_reason;
+
+	return job->priv->hold_position;
+}
+
 void
 gebr_job_set_maestro_address(GebrJob *job, const gchar *address)
 {
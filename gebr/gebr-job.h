@@ -65,6 +65,10 @@ struct _GebrJobClass {
 	void (*disconnect) (GebrJob *job);
 
 	void (*job_remove) (GebrJob *job);
+
+	void (*output_loaded) (GebrJob *job);
+
+	void (*hold_changed) (GebrJob *job);
 };
 
 typedef struct {
@@ -73,6 +77,7 @@ typedef struct {
 	gchar *cmd_line;
 	gdouble percentage;
 	GString *output;
+	gsize output_offset; /* Bytes before @output not fetched */
 } GebrJobTask;
 
 GType gebr_job_get_type() G_GNUC_CONST;
@@ -174,6 +179,38 @@ gint gebr_job_get_total_procs (GebrJob *job);
 
 gchar *gebr_job_get_running_time(GebrJob *job, const gchar *start_date);
 
+/**
+ * gebr_job_get_remaining_time:
+ *
+ * Returns: the time left for @job to finish, predicted by the maestro from
+ * previous executions of its flow, or %NULL if unknown.
+ */
+gchar *gebr_job_get_remaining_time(GebrJob *job, const gchar *start_date);
+
+/**
+ * gebr_job_set_eta:
+ *
+ * Sets the predicted duration of @job, in seconds.
+ */
+void gebr_job_set_eta(GebrJob *job, gint eta);
+
+/**
+ * gebr_job_set_scaling:
+ *
+ * Tells that the number of processes of @job was chosen by the maestro. If
+ * @fitted is %TRUE, it comes from the contention @sigma and coherence
+ * @kappa measured in previous executions of the flow.
+ */
+void gebr_job_set_scaling(GebrJob *job, gboolean fitted, gdouble sigma, gdouble kappa);
+
+/**
+ * gebr_job_get_scaling:
+ *
+ * Returns: %TRUE if the number of processes of @job was chosen by the
+ * maestro, see gebr_job_set_scaling().
+ */
+gboolean gebr_job_get_scaling(GebrJob *job, gboolean *fitted, gdouble *sigma, gdouble *kappa);
+
 gchar *gebr_job_get_elapsed_time(GebrJob *job);
 
 gdouble gebr_job_get_exec_speed(GebrJob *job);
@@ -216,6 +253,58 @@ void gebr_job_set_issues(GebrJob *job, const gchar *issues);
 
 void gebr_job_append_output(GebrJob *job, gint frac, const gchar *output);
 
+/**
+ * gebr_job_set_output:
+ *
+ * Sets the bytes of the output of the task @frac of @job from @offset,
+ * which has @total bytes in the maestro, and tells the output of @job is
+ * loaded. The last page replaces the output we have, the one just
+ * before it is prepended.
+ */
+void gebr_job_set_output(GebrJob *job, gint frac, gsize offset, gsize total, const gchar *output);
+
+/**
+ * gebr_job_get_output_complete:
+ *
+ * Returns: %FALSE if the beginning of the output of some task of @job
+ * was not fetched, see gebr_maestro_server_request_earlier_output().
+ */
+gboolean gebr_job_get_output_complete(GebrJob *job);
+
+/**
+ * gebr_job_get_output_loaded:
+ *
+ * Returns: %TRUE if @job has all of its output. Output of jobs that are
+ * not shown is fetched only when needed, see
+ * gebr_maestro_server_subscribe_output(), and is ignored until then.
+ */
+gboolean gebr_job_get_output_loaded(GebrJob *job);
+
+/**
+ * gebr_job_set_output_loaded:
+ *
+ * Emits "output-loaded" when @loaded is %TRUE.
+ */
+void gebr_job_set_output_loaded(GebrJob *job, gboolean loaded);
+
+/**
+ * gebr_job_set_hold:
+ *
+ * Tells that @job waits at @position in the run queue of the maestro,
+ * because of @reason, or that it left the queue if @position is 0. Emits
+ * "hold-changed".
+ */
+void gebr_job_set_hold(GebrJob *job, gint position, const gchar *reason);
+
+/**
+ * gebr_job_get_hold:
+ * @reason: Return location for the reason @job is held, owned by @job
+ *
+ * Returns: the position of @job in the run queue of the maestro, or 0 if
+ * it is not waiting there.
+ */
+gint gebr_job_get_hold(GebrJob *job, const gchar **reason);
+
 void gebr_job_set_maestro_address(GebrJob *job, const gchar *address);
 
 const gchar *gebr_job_get_maestro_address(GebrJob *job);
@@ -1461,10 +1461,19 @@ server_tooltip_callback(GtkTreeView * tree_view, GtkTooltip * tooltip,
 
 		const gchar *error = gebr_daemon_server_get_error_msg(daemon);
 
-		if (!error || !*error)
+		if (error && *error) {
+			gtk_tooltip_set_text(tooltip, error);
+			return TRUE;
+		}
+
+		gdouble seconds = gebr_daemon_server_get_time_to_ready(daemon);
+
+		if (gebr_daemon_server_get_state(daemon) != SERVER_STATE_LOGGED || seconds < 0)
 			return FALSE;
 
-		gtk_tooltip_set_text(tooltip, error);
+		gchar *text = g_strdup_printf(_("Connected in %.1lf seconds"), seconds);
+		gtk_tooltip_set_text(tooltip, text);
+		g_free(text);
 		return TRUE;
 	}
 	return FALSE;
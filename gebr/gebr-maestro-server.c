@@ -33,6 +33,10 @@
 
 #include "gebr.h" // for gebr_get_session_id()
 
+/* Bytes of output asked for at once, see
+ * gebr_maestro_server_request_earlier_output() */
+#define OUTPUT_PAGE_SIZE (256 * 1024)
+
 struct MaestroInfoIface {
 	GebrMaestroInfo iface;
 	GebrMaestroServer *maestro;
@@ -54,6 +58,12 @@ struct _GebrMaestroServerPriv {
 	gint clocks_diff;
 	gboolean wizard_setup;
 
+	/* Last change of the jobs received, see send_sync_request() */
+	gchar *cursor;
+
+	/* Ids of the jobs whose output maestro sends us */
+	GHashTable *subscriptions;
+
 	/* GVFS */
 	gboolean has_connected_daemon;
 	GFile *mount_location;
@@ -408,6 +418,95 @@ gebr_maestro_server_get_error(GebrMaestroServer *maestro,
 	*error_msg = maestro->priv->error_msg;
 }
 
+/*
+ * Asks maestro for the changes of the jobs after the last one received,
+ * or for all jobs on the first connection.
+ */
+static void
+send_sync_request(GebrMaestroServer *maestro)
+{
+	GebrCommUri *uri = gebr_comm_uri_new();
+	gebr_comm_uri_set_prefix(uri, "/sync");
+	gebr_comm_uri_add_param(uri, "cursor", maestro->priv->cursor ? maestro->priv->cursor : "");
+	gchar *url = gebr_comm_uri_to_string(uri);
+	gebr_comm_uri_free(uri);
+
+	gebr_comm_protocol_socket_send_request(maestro->priv->server->socket,
+					       GEBR_COMM_HTTP_METHOD_PUT, url, NULL);
+	g_free(url);
+}
+
+static void
+send_subscribe_request(GebrMaestroServer *maestro,
+		       const gchar *prefix,
+		       const gchar *id)
+{
+	GebrCommUri *uri = gebr_comm_uri_new();
+	gebr_comm_uri_set_prefix(uri, prefix);
+	gebr_comm_uri_add_param(uri, "id", id);
+	gchar *url = gebr_comm_uri_to_string(uri);
+	gebr_comm_uri_free(uri);
+
+	gebr_comm_protocol_socket_send_request(maestro->priv->server->socket,
+					       GEBR_COMM_HTTP_METHOD_PUT, url, NULL);
+	g_free(url);
+}
+
+static void
+resubscribe_output(const gchar *id,
+		   gpointer value,
+		   GebrMaestroServer *maestro)
+{
+	send_subscribe_request(maestro, "/subscribe", id);
+}
+
+/*
+ * Drops the jobs of @maestro, which does not know what changed since the
+ * cursor we have and sends all of them again.
+ */
+static void
+remove_all_jobs(GebrMaestroServer *maestro)
+{
+	GHashTableIter iter;
+	gpointer id, job;
+
+	g_hash_table_iter_init(&iter, maestro->priv->jobs);
+	while (g_hash_table_iter_next(&iter, &id, &job)) {
+		gebr_job_remove(job);
+		g_hash_table_iter_remove(&iter);
+		g_free(id);
+	}
+
+	GtkTreeIter it;
+	GtkTreeModel *model = GTK_TREE_MODEL(maestro->priv->queues_model);
+	gboolean valid = gtk_tree_model_get_iter_first(model, &it);
+	while (valid) {
+		GebrJob *j;
+		gtk_tree_model_get(model, &it, 0, &j, -1);
+		if (j) {
+			g_object_unref(j);
+			valid = gtk_list_store_remove(maestro->priv->queues_model, &it);
+		} else
+			valid = gtk_tree_model_iter_next(model, &it);
+	}
+}
+
+static void
+redefine_job(const gchar *id,
+	     GebrJob *job,
+	     GebrMaestroServer *maestro)
+{
+	g_signal_emit(maestro, signals[JOB_DEFINE], 0, job);
+}
+
+static void
+unload_output(const gchar *id,
+	      GebrJob *job,
+	      gpointer data)
+{
+	gebr_job_set_output_loaded(job, FALSE);
+}
+
 void
 state_changed(GebrCommServer *comm_server,
 	      gpointer user_data)
@@ -418,6 +517,10 @@ state_changed(GebrCommServer *comm_server,
 	if (state == SERVER_STATE_DISCONNECTED) {
 		gtk_list_store_clear(maestro->priv->groups_store);
 
+		/* Output sent while disconnected is lost, it is fetched
+		 * again for the jobs that need it */
+		g_hash_table_foreach(maestro->priv->jobs, (GHFunc)unload_output, NULL);
+
 		const gchar *err = gebr_comm_server_get_last_error(maestro->priv->server);
                 if (err && *err) {
                 	if (comm_server->error == SERVER_ERROR_CONNECT)
@@ -643,6 +746,16 @@ parse_messages(GebrCommServer *comm_server,
 
 				gebr_comm_server_set_logged(comm_server);
 
+				/* Jobs kept from the last connection are shown
+				 * again, maestro sends what changed since then */
+				if (maestro->priv->cursor)
+					g_hash_table_foreach(maestro->priv->jobs, (GHFunc)redefine_job, maestro);
+				send_sync_request(maestro);
+
+				/* A new connection streams no output until asked */
+				g_hash_table_foreach(maestro->priv->subscriptions,
+						     (GHFunc)resubscribe_output, maestro);
+
 				gboolean use_key = gebr_comm_server_get_use_public_key(comm_server);
 				if (use_key)
 					gebr_comm_server_append_key(comm_server, G_CALLBACK(gebr_maestro_server_append_key_finished), maestro);
@@ -713,11 +826,11 @@ parse_messages(GebrCommServer *comm_server,
 		}
 		else if (message->hash == gebr_comm_protocol_defs.ssta_def.code_hash) {
 			GList *arguments;
-			GString *addr, *ssta, *ac, *hostname, *ncores, *cpu_clock, *cpu_model, *memory;
+			GString *addr, *ssta, *ac, *hostname, *ncores, *cpu_clock, *cpu_model, *memory, *ready;
 			const gchar *maestro_addr = gebr_maestro_server_get_address(maestro);
 
 			/* organize message data */
-			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 8)) == NULL)
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 9)) == NULL)
 				goto err;
 
 			hostname =  g_list_nth_data(arguments, 0);
@@ -728,6 +841,7 @@ parse_messages(GebrCommServer *comm_server,
 			cpu_clock = g_list_nth_data(arguments, 5);
 			cpu_model = g_list_nth_data(arguments, 6);
 			memory =    g_list_nth_data(arguments, 7);
+			ready =     g_list_nth_data(arguments, 8);
 
 			g_debug("Daemon state change (%s) %s", addr->str, ssta->str);
 
@@ -753,6 +867,7 @@ parse_messages(GebrCommServer *comm_server,
 			gebr_daemon_server_set_cpu_clock(daemon, cpu_clock->str);
 			gebr_daemon_server_set_cpu_model(daemon, cpu_model->str);
 			gebr_daemon_server_set_memory(daemon, memory->str);
+			gebr_daemon_server_set_time_to_ready(daemon, ready->len ? g_strtod(ready->str, NULL) : -1);
 
 			if (maestro->priv->has_connected_daemon && !have_logged_daemon(maestro))
 				unmount_gvfs(maestro, FALSE);
@@ -799,6 +914,7 @@ parse_messages(GebrCommServer *comm_server,
 
 			GebrJob *job = g_hash_table_lookup(maestro->priv->jobs, id->str);
 			gboolean prev_exist = FALSE;
+			gboolean submitted = FALSE;
 
 			if (!job) {
 				job = g_hash_table_lookup(maestro->priv->temp_jobs, temp_id->str);
@@ -807,6 +923,12 @@ parse_messages(GebrCommServer *comm_server,
 					gebr_job_set_runid(job, id->str);
 					g_hash_table_insert(maestro->priv->jobs, g_strdup(id->str), job);
 					prev_exist = TRUE;
+					submitted = TRUE;
+
+					/* Maestro streams the output of a job
+					 * to the client that submitted it */
+					g_hash_table_insert(maestro->priv->subscriptions,
+							    g_strdup(id->str), GINT_TO_POINTER(TRUE));
 				}
 			}
 
@@ -852,12 +974,19 @@ parse_messages(GebrCommServer *comm_server,
 				gebr_job_set_exec_speed(job, atof(speed->str));
 				gebr_job_set_static_status(job, gebr_comm_job_get_status_from_string(status->str));
 
+				/* Its output is fetched when needed */
+				gebr_job_set_output_loaded(job, FALSE);
+
+				g_hash_table_insert(maestro->priv->jobs, g_strdup(id->str), job);
+			}
+
+			/* Jobs sent again on reconnection may have started
+			 * or finished meanwhile */
+			if (!submitted) {
 				if (start_date->len > 0)
 					gebr_job_set_start_date(job, start_date->str);
 				if (finish_date->len > 0)
 					gebr_job_set_finish_date(job, finish_date->str);
-
-				g_hash_table_insert(maestro->priv->jobs, g_strdup(id->str), job);
 			}
 			
 			if (init || prev_exist)
@@ -881,6 +1010,55 @@ parse_messages(GebrCommServer *comm_server,
 
 			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
 		}
+		else if (message->hash == gebr_comm_protocol_defs.eta_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 2)) == NULL)
+				goto err;
+
+			GString *id = g_list_nth_data(arguments, 0);
+			GString *eta = g_list_nth_data(arguments, 1);
+
+			GebrJob *job = g_hash_table_lookup(maestro->priv->jobs, id->str);
+			if (job)
+				gebr_job_set_eta(job, atoi(eta->str));
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		}
+		else if (message->hash == gebr_comm_protocol_defs.hld_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 3)) == NULL)
+				goto err;
+
+			GString *id = g_list_nth_data(arguments, 0);
+			GString *position = g_list_nth_data(arguments, 1);
+			GString *reason = g_list_nth_data(arguments, 2);
+
+			GebrJob *job = g_hash_table_lookup(maestro->priv->jobs, id->str);
+			if (job)
+				gebr_job_set_hold(job, atoi(position->str), reason->str);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		}
+		else if (message->hash == gebr_comm_protocol_defs.scl_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 3)) == NULL)
+				goto err;
+
+			GString *id = g_list_nth_data(arguments, 0);
+			GString *sigma = g_list_nth_data(arguments, 1);
+			GString *kappa = g_list_nth_data(arguments, 2);
+
+			GebrJob *job = g_hash_table_lookup(maestro->priv->jobs, id->str);
+			if (job)
+				gebr_job_set_scaling(job, sigma->len > 0,
+						     g_ascii_strtod(sigma->str, NULL),
+						     g_ascii_strtod(kappa->str, NULL));
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		}
 		else if (message->hash == gebr_comm_protocol_defs.cmd_def.code_hash) {
 			GList *arguments;
 
@@ -911,6 +1089,44 @@ parse_messages(GebrCommServer *comm_server,
 
 			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
 		}
+		else if (message->hash == gebr_comm_protocol_defs.otr_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 5)) == NULL)
+				goto err;
+
+			GString *id = g_list_nth_data(arguments, 0);
+			GString *frac = g_list_nth_data(arguments, 1);
+			GString *offset = g_list_nth_data(arguments, 2);
+			GString *total = g_list_nth_data(arguments, 3);
+			GString *output = g_list_nth_data(arguments, 4);
+
+			GebrJob *job = g_hash_table_lookup(maestro->priv->jobs, id->str);
+			if (job)
+				gebr_job_set_output(job, atoi(frac->str) - 1,
+						    g_ascii_strtoull(offset->str, NULL, 10),
+						    g_ascii_strtoull(total->str, NULL, 10),
+						    output->str);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		}
+		else if (message->hash == gebr_comm_protocol_defs.cur_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 2)) == NULL)
+				goto err;
+
+			GString *cursor = g_list_nth_data(arguments, 0);
+			GString *reset = g_list_nth_data(arguments, 1);
+
+			if (g_strcmp0(reset->str, "1") == 0)
+				remove_all_jobs(maestro);
+
+			g_free(maestro->priv->cursor);
+			maestro->priv->cursor = g_strdup(cursor->str);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		}
 		else if (message->hash == gebr_comm_protocol_defs.sta_def.code_hash) {
 			GList *arguments;
 
@@ -938,9 +1154,15 @@ parse_messages(GebrCommServer *comm_server,
 
 			GString *id = g_list_nth_data(arguments, 0);
 
-			GebrJob *job = g_hash_table_lookup(maestro->priv->jobs, id->str);
+			gpointer key;
+			GebrJob *job;
 
-			gebr_job_remove(job);
+			if (g_hash_table_lookup_extended(maestro->priv->jobs, id->str, &key, (gpointer *)&job)) {
+				g_hash_table_remove(maestro->priv->jobs, id->str);
+				g_hash_table_remove(maestro->priv->subscriptions, id->str);
+				g_free(key);
+				gebr_job_remove(job);
+			}
 
 			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
 		}
@@ -1239,6 +1461,8 @@ gebr_maestro_server_finalize(GObject *object)
 	g_hash_table_unref(maestro->priv->temp_jobs);
 	g_free(maestro->priv->nfsid);
 	g_free(maestro->priv->home);
+	g_free(maestro->priv->cursor);
+	g_hash_table_destroy(maestro->priv->subscriptions);
 	unmount_gvfs(maestro, FALSE);
 
 	G_OBJECT_CLASS(gebr_maestro_server_parent_class)->finalize(object);
@@ -1431,6 +1655,9 @@ gebr_maestro_server_init(GebrMaestroServer *maestro)
 	maestro->priv->window = NULL;
 	maestro->priv->clocks_diff = 0;
 	maestro->priv->wizard_setup = FALSE;
+	maestro->priv->cursor = NULL;
+	maestro->priv->subscriptions = g_hash_table_new_full(g_str_hash, g_str_equal,
+							     g_free, NULL);
 
 	maestro->priv->maestro_info_iface.maestro = maestro;
 	maestro->priv->maestro_info_iface.iface.get_home_uri = gebr_maestro_server_get_home_uri;
@@ -2028,6 +2255,78 @@ gebr_maestro_server_get_clocks_diff(GebrMaestroServer *maestro)
 	return maestro->priv->clocks_diff;
 }
 
+void
+gebr_maestro_server_subscribe_output(GebrMaestroServer *maestro,
+				     GebrJob *job)
+{
+	g_return_if_fail(GEBR_IS_MAESTRO_SERVER(maestro));
+
+	const gchar *id = gebr_job_get_id(job);
+
+	if (g_hash_table_lookup(maestro->priv->subscriptions, id)
+	    && gebr_job_get_output_loaded(job))
+		return;
+
+	g_hash_table_insert(maestro->priv->subscriptions,
+			    g_strdup(id), GINT_TO_POINTER(TRUE));
+	send_subscribe_request(maestro, "/subscribe", id);
+}
+
+void
+gebr_maestro_server_unsubscribe_output(GebrMaestroServer *maestro,
+				       GebrJob *job)
+{
+	g_return_if_fail(GEBR_IS_MAESTRO_SERVER(maestro));
+
+	const gchar *id = gebr_job_get_id(job);
+
+	if (!g_hash_table_remove(maestro->priv->subscriptions, id))
+		return;
+
+	send_subscribe_request(maestro, "/unsubscribe", id);
+
+	/* What arrives from now on is missed, the output is sent again
+	 * on the next subscription */
+	gebr_job_set_output_loaded(job, FALSE);
+}
+
+void
+gebr_maestro_server_request_earlier_output(GebrMaestroServer *maestro,
+					   GebrJob *job)
+{
+	g_return_if_fail(GEBR_IS_MAESTRO_SERVER(maestro));
+
+	gint n;
+	GebrJobTask *tasks = gebr_job_get_tasks(job, &n);
+
+	for (gint i = 0; i < n; i++) {
+		gsize end = tasks[i].output_offset;
+		if (!end)
+			continue;
+
+		gsize start = end > OUTPUT_PAGE_SIZE ? end - OUTPUT_PAGE_SIZE : 0;
+		gchar *frac = g_strdup_printf("%d", tasks[i].frac);
+		gchar *offset = g_strdup_printf("%" G_GSIZE_FORMAT, start);
+		gchar *length = g_strdup_printf("%" G_GSIZE_FORMAT, end - start);
+
+		GebrCommUri *uri = gebr_comm_uri_new();
+		gebr_comm_uri_set_prefix(uri, "/output");
+		gebr_comm_uri_add_param(uri, "id", gebr_job_get_id(job));
+		gebr_comm_uri_add_param(uri, "frac", frac);
+		gebr_comm_uri_add_param(uri, "offset", offset);
+		gebr_comm_uri_add_param(uri, "length", length);
+		gchar *url = gebr_comm_uri_to_string(uri);
+		gebr_comm_uri_free(uri);
+
+		gebr_comm_protocol_socket_send_request(maestro->priv->server->socket,
+						       GEBR_COMM_HTTP_METHOD_PUT, url, NULL);
+		g_free(url);
+		g_free(frac);
+		g_free(offset);
+		g_free(length);
+	}
+}
+
 static gchar *
 gebr_maestro_server_get_home_uri(GebrMaestroInfo *iface)
 {
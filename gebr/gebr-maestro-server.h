@@ -214,6 +214,35 @@ void gebr_maestro_server_set_clocks_diff(GebrMaestroServer *maestro, gint secs);
 
 gint gebr_maestro_server_get_clocks_diff(GebrMaestroServer *maestro);
 
+/**
+ * gebr_maestro_server_subscribe_output:
+ *
+ * Asks @maestro for the last page of the output of each task of @job,
+ * which is set when it arrives, see gebr_job_set_output(), and then for
+ * the rest of its output as the job runs. Maestro only sends the output
+ * of the jobs we subscribed to, and of the jobs we submitted.
+ */
+void gebr_maestro_server_subscribe_output(GebrMaestroServer *maestro,
+					  GebrJob *job);
+
+/**
+ * gebr_maestro_server_unsubscribe_output:
+ *
+ * Stops the output of @job, which is no longer shown. Its output is
+ * marked as not loaded.
+ */
+void gebr_maestro_server_unsubscribe_output(GebrMaestroServer *maestro,
+					    GebrJob *job);
+
+/**
+ * gebr_maestro_server_request_earlier_output:
+ *
+ * Asks @maestro for the page of output before the one we have, for each
+ * task of @job, see gebr_job_get_output_complete().
+ */
+void gebr_maestro_server_request_earlier_output(GebrMaestroServer *maestro,
+						GebrJob *job);
+
 gboolean gebr_maestro_server_get_need_gvfs(GebrMaestroInfo *iface);
 
 GebrMaestroInfo *gebr_maestro_server_get_info(GebrMaestroServer *maestro);
@@ -38,6 +38,7 @@ struct _GebrUiFlowExecutionPriv {
 	GtkComboBox *server_combo;
 	GtkComboBox *queue_combo;
 	GtkToggleButton *parallelism_button;
+	GtkToggleButton *auto_speed_button;
 	GtkToggleButton *save_default_button;
 	GtkWidget *window;
 	GtkLabel *number_cores_label;
@@ -245,7 +246,11 @@ run_flow(GebrUiFlowExecution *ui_flow_execution,
 		niceness =  gebr_interface_get_niceness();
 
 
-	gchar *speed_str = g_strdup_printf("%lf", speed);
+	gchar *speed_str;
+	if (is_detailed && speed > 0 && gtk_toggle_button_get_active(ui_flow_execution->priv->auto_speed_button))
+		speed_str = g_strdup(GEBR_COMM_RUNNER_SPEED_AUTO);
+	else
+		speed_str = g_strdup_printf("%lf", speed);
 	gchar *nice =  g_strdup_printf("%d", niceness);
 
 	const gchar *hostname = g_get_host_name();
@@ -887,6 +892,14 @@ on_show_scale(GtkWidget * scale,
 	                    gebr_ui_flow_execution_calculate_slider_from_speed(ui_flow_execution->priv->exec_speed));
 }
 
+static void
+on_auto_speed_toggled(GtkToggleButton *button,
+                      GebrUiFlowExecution *ui_flow_execution)
+{
+	gtk_widget_set_sensitive(ui_flow_execution->priv->speed_slider,
+	                         !gtk_toggle_button_get_active(button));
+}
+
 static void
 restore_execution_servers(GebrUiFlowExecution *ui_flow_execution, GebrMaestroServer *maestro)
 {
@@ -1152,11 +1165,14 @@ gebr_ui_flow_execution_details_setup_ui(gboolean slider_sensitiviness,
 	ui_flow_execution->priv->save_default_button = GTK_TOGGLE_BUTTON(gtk_builder_get_object(builder, "save_default_button"));
 	ui_flow_execution->priv->nice_button_high = GTK_WIDGET(gtk_builder_get_object(builder, "high_priority_button")); 
 	ui_flow_execution->priv->parallelism_button = GTK_TOGGLE_BUTTON(gtk_builder_get_object(builder, "simultaneous_button"));
+	ui_flow_execution->priv->auto_speed_button = GTK_TOGGLE_BUTTON(gtk_builder_get_object(builder, "auto_speed_button"));
 	ui_flow_execution->priv->number_cores_label = GTK_LABEL(gtk_builder_get_object(builder, "number_cores_label")); 
 
 	gtk_window_set_title(GTK_WINDOW(main_dialog), _("Run"));
 
 	speed_slider_setup_ui(ui_flow_execution, gebr.config.flow_exec_speed);
+	g_signal_connect(ui_flow_execution->priv->auto_speed_button, "toggled",
+	                 G_CALLBACK(on_auto_speed_toggled), ui_flow_execution);
 
 	GebrMaestroServer *maestro = gebr_maestro_controller_get_maestro(gebr.maestro_controller);
 
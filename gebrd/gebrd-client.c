@@ -54,6 +54,36 @@ static void client_process_response(GebrCommProtocolSocket * socket, GebrCommHtt
 				    GebrCommHttpMsg * response, struct client *client);
 static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct client *client);
 
+static gboolean client_send_telemetry(gpointer user_data);
+
+static gboolean client_sample_load(gpointer user_data);
+
+static gboolean client_measure_bandwidth(gpointer user_data);
+
+static void client_send_bandwidth(void);
+
+static guint telemetry_source = 0;
+
+static guint sample_source = 0;
+
+static GebrdLoadSampler *load_sampler = NULL;
+
+typedef struct {
+	gboolean measured;
+	gdouble read;  /* Bytes per second */
+	gdouble write;
+	gchar *dir;    /* Where it was measured */
+} Bandwidth;
+
+static guint bandwidth_source = 0;
+
+static gboolean measuring_bandwidth = FALSE;
+
+static Bandwidth bandwidth = { FALSE, 0, 0, NULL };
+
+/* BASE of the line of the last flow run, see client_set_bandwidth_dir() */
+static gchar *bandwidth_dir = NULL;
+
 
 /*
  * Public functions
@@ -87,14 +117,70 @@ void client_free(struct client *client)
 	g_free(client);
 }
 
+void client_stop_monitoring(void)
+{
+	if (telemetry_source) {
+		g_source_remove(telemetry_source);
+		telemetry_source = 0;
+	}
+	if (sample_source) {
+		g_source_remove(sample_source);
+		sample_source = 0;
+	}
+	if (bandwidth_source) {
+		g_source_remove(bandwidth_source);
+		bandwidth_source = 0;
+	}
+	if (load_sampler) {
+		gebrd_load_sampler_free(load_sampler);
+		load_sampler = NULL;
+	}
+}
+
 void
 client_disconnected(GebrCommProtocolSocket * socket,
 		    struct client *client)
 {
 	gebrd_message(GEBR_LOG_DEBUG, "client_disconnected");
+
+	/* Only maestro would let them continue */
+	job_continue_all();
+
+	/* The tasks keep running for a maestro that restarts to recover
+	 * them, see job_list(). The daemon quits when the last one ends. */
+	if (job_has_running_jobs()) {
+		gebrd_user_set_connection(gebrd->user, NULL);
+		return;
+	}
+
 	gebrd_quit();
 }
 
+typedef struct {
+	GebrCommProtocolSocket *socket;
+	GebrCommHttpMsg *request;
+} PendingRequest;
+
+/*
+ * Answers a GET kept by client_process_request(), reading the property
+ * only now.
+ */
+static gboolean client_answer_request(gpointer user_data)
+{
+	PendingRequest *pending = user_data;
+	const gchar *property = pending->request->url->str+1;
+
+	GebrCommJsonContent *json = gebr_comm_json_content_new_from_property(G_OBJECT(gebrd->user), property);
+	gebr_comm_protocol_socket_send_response_to(pending->socket, pending->request, 200, json);
+	gebr_comm_json_content_free(json);
+
+	g_object_unref(pending->socket);
+	gebr_comm_http_msg_free(pending->request);
+	g_free(pending);
+
+	return FALSE;
+}
+
 static void client_process_request(GebrCommProtocolSocket * socket, GebrCommHttpMsg * request, struct client *client)
 {
 	if (!g_str_has_prefix(request->url->str, "/"))
@@ -104,9 +190,14 @@ static void client_process_request(GebrCommProtocolSocket * socket, GebrCommHttp
 	const gchar *property = request->url->str+1;
 
 	if (request->method == GEBR_COMM_HTTP_METHOD_GET) {
-		GebrCommJsonContent *json = gebr_comm_json_content_new_from_property(object, property);
-		gebr_comm_protocol_socket_send_response(socket, 200, json);
-		gebr_comm_json_content_free(json);
+		/* Reading the properties goes to the system, like /proc for
+		 * sys-load. The GETs are answered when the daemon is idle,
+		 * after the jobs and the messages that came with them, and
+		 * maestro matches each answer by its request id. */
+		PendingRequest *pending = g_new(PendingRequest, 1);
+		pending->socket = g_object_ref(socket);
+		pending->request = g_object_ref(request);
+		g_idle_add(client_answer_request, pending);
 	} else if (request->method == GEBR_COMM_HTTP_METHOD_PUT) {
 		GebrCommJsonContent *json = gebr_comm_json_content_new(request->content->str);
 		gebr_comm_json_content_to_property(json, object, property);
@@ -260,6 +351,172 @@ get_mpi_flavors(GebrdMpiConfig *mpi_config, GString *mpi_flavors) {
 }
 
 
+static gboolean client_sample_load(gpointer user_data)
+{
+	GebrdStatInfo *stat = gebrd_stat_info_new();
+	if (stat)
+		gebrd_load_sampler_add(load_sampler, stat);
+	return TRUE;
+}
+
+/*
+ * Sends the load averages, the smoothed usage of each core, the free
+ * memory (in kB), the number of running tasks and the smoothed number of
+ * runnable processes.
+ */
+static gboolean client_send_telemetry(gpointer user_data)
+{
+	struct client *client = gebrd_user_get_connection(gebrd->user);
+
+	if (!client || !client->socket->protocol->logged)
+		return TRUE;
+
+	gchar *loads = NULL;
+	g_object_get(gebrd->user, "sys-load", &loads, NULL);
+
+	/* the numbers must not depend on the locale */
+	gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+	GString *usage = g_string_new("");
+	for (guint i = 0; i < gebrd_load_sampler_n_cores(load_sampler); i++) {
+		if (i)
+			g_string_append_c(usage, ',');
+		g_string_append(usage, g_ascii_formatd(buf, sizeof(buf), "%.3f",
+						       gebrd_load_sampler_get_usage(load_sampler, i)));
+	}
+
+	glong free_memory = 0;
+	GebrdMemInfo *meminfo = gebrd_mem_info_new();
+	if (meminfo) {
+		const gchar *available = gebrd_mem_info_get(meminfo, "MemAvailable");
+		if (available)
+			free_memory = atol(available);
+		else {
+			const gchar *props[] = { "MemFree", "Buffers", "Cached", NULL };
+			for (gint i = 0; props[i]; i++) {
+				const gchar *val = gebrd_mem_info_get(meminfo, props[i]);
+				if (val)
+					free_memory += atol(val);
+			}
+		}
+		gebrd_mem_info_free(meminfo);
+	}
+
+	gchar *free_memory_str = g_strdup_printf("%ld", free_memory);
+	gchar *running = g_strdup_printf("%d", job_count_running());
+	gchar *runnable = g_strdup(g_ascii_formatd(buf, sizeof(buf), "%.3f",
+						   gebrd_load_sampler_get_runnable(load_sampler)));
+
+	gebr_comm_protocol_socket_oldmsg_send(client->socket, FALSE,
+					      gebr_comm_protocol_defs.tlm_def, 5,
+					      loads ? loads : "",
+					      usage->str,
+					      free_memory_str,
+					      running,
+					      runnable);
+
+	g_free(loads);
+	g_free(free_memory_str);
+	g_free(running);
+	g_free(runnable);
+	g_string_free(usage, TRUE);
+
+	return TRUE;
+}
+
+/*
+ * Sends the last bandwidth measured to the home directory, in bytes per
+ * second for reading and writing.
+ */
+static void client_send_bandwidth(void)
+{
+	struct client *client = gebrd_user_get_connection(gebrd->user);
+
+	if (!bandwidth.measured || !client || !client->socket->protocol->logged)
+		return;
+
+	gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+	gchar *read_str = g_strdup(g_ascii_formatd(buf, sizeof(buf), "%.0f", bandwidth.read));
+	gchar *write_str = g_strdup(g_ascii_formatd(buf, sizeof(buf), "%.0f", bandwidth.write));
+
+	gebr_comm_protocol_socket_oldmsg_send(client->socket, FALSE,
+					      gebr_comm_protocol_defs.bwd_def, 2,
+					      read_str, write_str);
+	g_free(read_str);
+	g_free(write_str);
+}
+
+static gboolean on_bandwidth_measured(gpointer user_data)
+{
+	Bandwidth *measure = user_data;
+
+	measuring_bandwidth = FALSE;
+
+	if (measure->measured) {
+		g_free(bandwidth.dir);
+		bandwidth = *measure;
+		client_send_bandwidth();
+	} else {
+		gebrd_message(GEBR_LOG_WARNING, "Could not measure the bandwidth to %s", measure->dir);
+		g_free(measure->dir);
+	}
+
+	g_free(measure);
+	return FALSE;
+}
+
+static gpointer measure_bandwidth_thread(gpointer user_data)
+{
+	Bandwidth *measure = user_data;
+
+	measure->measured = gebrd_measure_bandwidth(measure->dir, GEBRD_BANDWIDTH_PROBE_SIZE,
+						    &measure->read, &measure->write);
+
+	/* Back to the main loop to send it */
+	g_idle_add(on_bandwidth_measured, measure);
+	return NULL;
+}
+
+/*
+ * The measure waits for the storage, so it runs in a thread. It is taken
+ * where the flows keep their data, or in the home directory until a flow
+ * runs.
+ */
+static gboolean client_measure_bandwidth(gpointer user_data)
+{
+	if (!measuring_bandwidth) {
+		Bandwidth *measure = g_new0(Bandwidth, 1);
+
+		if (bandwidth_dir && g_file_test(bandwidth_dir, G_FILE_TEST_IS_DIR))
+			measure->dir = g_strdup(bandwidth_dir);
+		else
+			measure->dir = g_build_filename(g_get_home_dir(), ".gebr", "gebrd", NULL);
+
+		measuring_bandwidth = TRUE;
+		g_thread_create(measure_bandwidth_thread, measure, FALSE, NULL);
+	}
+	return TRUE;
+}
+
+/*
+ * Takes the BASE of the line, the first of @paths, as the directory whose
+ * bandwidth is measured. A new one is measured right away if it exists,
+ * otherwise at the next measure, see GEBRD_BANDWIDTH_INTERVAL.
+ */
+static void client_set_bandwidth_dir(const gchar *paths)
+{
+	gchar **dirs = g_strsplit(paths, ",", 2);
+
+	if (dirs[0] && g_path_is_absolute(dirs[0])
+	    && g_strcmp0(dirs[0], bandwidth_dir) != 0) {
+		g_free(bandwidth_dir);
+		bandwidth_dir = g_strdup(dirs[0]);
+
+		if (bandwidth_source && g_file_test(bandwidth_dir, G_FILE_TEST_IS_DIR))
+			client_measure_bandwidth(NULL);
+	}
+	g_strfreev(dirs);
+}
+
 static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct client *client)
 {
 	GList *link;
@@ -276,8 +533,13 @@ static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct cl
 			GString *queue_list = g_string_new("");
 			GString *display_port = g_string_new("");
 
-			/* organize message data */
-			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 3)) == NULL)
+			/* organize message data; older peers don't send the framing */
+			gint framing = GEBR_COMM_PROTOCOL_FRAMING_TEXT;
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 4)) != NULL) {
+				GString *peer_framing = g_list_nth_data(arguments, 3);
+				if (atoi(peer_framing->str) == GEBR_COMM_PROTOCOL_FRAMING_BINARY)
+					framing = GEBR_COMM_PROTOCOL_FRAMING_BINARY;
+			} else if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 3)) == NULL)
 				goto err;
 
 			GString *version = g_list_nth_data(arguments, 0);
@@ -337,9 +599,10 @@ static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct cl
 			gchar *gebrm_path = g_find_program_in_path("gebrm");
 			const gchar *has_maestro = gebrm_path ? "1" : "0";
 			g_free(gebrm_path);
+			gchar *framing_str = g_strdup_printf("%d", framing);
 
 			gebr_comm_protocol_socket_return_message(client->socket, FALSE,
-								 gebr_comm_protocol_defs.ini_def, 12,
+								 gebr_comm_protocol_defs.ini_def, 13,
 								 gebrd->hostname,
 								 server_type,
 								 accounts_list->str,
@@ -351,7 +614,35 @@ static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct cl
 								 gebrd_user_get_daemon_id(gebrd->user),
 								 g_get_home_dir(),
 								 mpi_flavors->str,
-								 has_maestro);
+								 has_maestro,
+								 framing_str);
+
+			/* the reply above still goes in text, everything after it
+			 * uses the agreed framing */
+			client->socket->protocol->framing = framing;
+
+			/* keep maestro informed about our load, so it doesn't
+			 * need to ask before each job */
+			if (!telemetry_source) {
+				load_sampler = gebrd_load_sampler_new();
+				client_sample_load(NULL);
+				sample_source = g_timeout_add(GEBRD_LOAD_SAMPLER_INTERVAL,
+							      client_sample_load, NULL);
+				telemetry_source = g_timeout_add_seconds(GEBRD_TELEMETRY_INTERVAL,
+									 client_send_telemetry, NULL);
+			}
+			client_send_telemetry(NULL);
+
+			/* maestro prefers the daemons with faster access to
+			 * the data, measured once in a while */
+			if (!bandwidth_source) {
+				bandwidth_source = g_timeout_add_seconds(GEBRD_BANDWIDTH_INTERVAL,
+									 client_measure_bandwidth, NULL);
+				client_measure_bandwidth(NULL);
+			} else
+				client_send_bandwidth();
+
+			g_free(framing_str);
 			gebrd_cpu_info_free(cpuinfo);
 			gebrd_mem_info_free(meminfo);
 			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
@@ -423,6 +714,7 @@ static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct cl
 
 			/* try to run and send return */
 			job_new(&job, client, gid, id, frac, numproc, nice, flow_xml, account, paths, servers_mpi);
+			client_set_bandwidth_dir(paths->str);
 
 #ifdef DEBUG
 			gchar *env_delay = getenv("GEBRD_RUN_DELAY_SEC");
@@ -500,6 +792,47 @@ static void client_old_parse_messages(GebrCommProtocolSocket * socket, struct cl
 			}
 
 			/* frees */
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.kfr_def.code_hash) {
+			GList *arguments;
+			GebrdJob *job;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 2)) == NULL)
+				goto err;
+
+			job = job_find_fraction(g_list_nth_data(arguments, 0),
+						g_list_nth_data(arguments, 1));
+			if (job != NULL)
+				job_kill(job);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.pre_def.code_hash) {
+			GList *arguments;
+			GebrdJob *job;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 3)) == NULL)
+				goto err;
+
+			GString *stop = g_list_nth_data(arguments, 2);
+
+			job = job_find_fraction(g_list_nth_data(arguments, 0),
+						g_list_nth_data(arguments, 1));
+			if (job != NULL)
+				job_preempt(job, g_strcmp0(stop->str, "1") == 0);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.spl_def.code_hash) {
+			GList *arguments;
+			GebrdJob *job;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 2)) == NULL)
+				goto err;
+
+			job = job_find_fraction(g_list_nth_data(arguments, 0),
+						g_list_nth_data(arguments, 1));
+			if (job != NULL)
+				job_stop_early(job);
+
 			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
 		} else if (message->hash == gebr_comm_protocol_defs.path_def.code_hash) {
 			GList *arguments;
@@ -26,6 +26,22 @@ G_BEGIN_DECLS
 
 struct gebr_comm_protocol;
 
+/**
+ * GEBRD_TELEMETRY_INTERVAL:
+ *
+ * Seconds between two telemetry messages sent to maestro.
+ */
+#define GEBRD_TELEMETRY_INTERVAL 2
+
+/**
+ * GEBRD_BANDWIDTH_INTERVAL:
+ *
+ * Seconds between two measures of the bandwidth to the BASE directory of
+ * the line of the last flow run, where its data is, or to the home
+ * directory before a flow runs, see gebrd_measure_bandwidth().
+ */
+#define GEBRD_BANDWIDTH_INTERVAL 600
+
 struct client {
 	GebrCommProtocolSocket *socket;
 	GebrCommServerLocation server_location;
@@ -39,6 +55,14 @@ void client_add(GebrCommProtocolSocket *client);
 
 void client_free(struct client *client);
 
+/**
+ * client_stop_monitoring:
+ *
+ * Stops sampling the load and sending the telemetry and the bandwidth to
+ * maestro, and frees the load sampler.
+ */
+void client_stop_monitoring(void);
+
 void client_disconnected(GebrCommProtocolSocket * socket,
                          struct client *client);
 
@@ -17,6 +17,9 @@
 
 #define OUTPUT_FLUSH_TIMEOUT 0
 
+/* Milliseconds between two samples of the memory and cpu used by a task */
+#define USAGE_SAMPLE_INTERVAL 1000
+
 #define _XOPEN_SOURCE
 #include <stdlib.h>
 #include <stdio.h>
@@ -38,6 +41,7 @@
 #include "gebrd-job.h"
 #include "gebrd.h"
 #include "gebrd-mpi-implementations.h"
+#include "gebrd-sysinfo.h"
 
 /* GOBJECT STUFF */
 enum {
@@ -106,7 +110,11 @@ static void job_send_clients_output(GebrdJob *job, GString * output)
 	if (!job->parent.jid->len)
 		return;
 
+	/* Sent again by job_list() when maestro comes back */
 	struct client *client = gebrd_user_get_connection(gebrd->user);
+	if (!client)
+		return;
+
 	gebr_comm_protocol_socket_oldmsg_send(client->socket, FALSE,
 					      gebr_comm_protocol_defs.out_def, 4, job->parent.jid->str, output->str,
 					      job->parent.run_id->str, job->frac->str);
@@ -235,16 +243,97 @@ static void job_status_notify_finished(GebrdJob *job)
 	job_status_notify(job, new_status, job->parent.finish_date->str);
 }
 
+/**
+ * \internal
+ * The child is reaped by GLib, so its rusage is lost. Instead, the memory
+ * and cpu time of the whole process tree are sampled while it runs. The
+ * cpu time of the last sample is kept, so up to USAGE_SAMPLE_INTERVAL of it
+ * is missed.
+ */
+static gboolean job_sample_usage(GebrdJob *job)
+{
+	gdouble cpu_time;
+	glong rss;
+
+	if (!gebrd_process_tree_get_usage(gebr_comm_process_get_pid(job->process), &rss, &cpu_time))
+		return TRUE;
+
+	if (rss > job->peak_rss)
+		job->peak_rss = rss;
+	if (cpu_time > job->cpu_time)
+		job->cpu_time = cpu_time;
+
+	return TRUE;
+}
+
+/**
+ * \internal
+ */
+static void job_stop_usage_sampling(GebrdJob *job)
+{
+	if (job->usage_timeout) {
+		g_source_remove(job->usage_timeout);
+		job->usage_timeout = 0;
+	}
+}
+
+/*
+ * File through which the loop of @job is stopped early, see
+ * job_stop_early(). When the loop stops, it writes there how many
+ * iterations it finished.
+ */
+static gchar *job_get_stop_file(GebrdJob *job)
+{
+	gchar *name = g_strdup_printf("stop-%s-%s", job->parent.run_id->str, job->frac->str);
+	gchar *path = g_build_filename(g_get_home_dir(), ".gebr", "gebrd", gebrd->hostname, name, NULL);
+	g_free(name);
+	return path;
+}
+
 /**
  * \internal
  * Only for regular jobs
  */
 static void job_process_finished(GebrCommProcess * process, gint status, GebrdJob *job)
 {
+	job_stop_usage_sampling(job);
+
+	struct client *client = gebrd_user_get_connection(gebrd->user);
+	if ((job->peak_rss > 0 || job->cpu_time > 0) && client) {
+		gchar *peak = g_strdup_printf("%ld", job->peak_rss);
+		gchar cpu_time[G_ASCII_DTOSTR_BUF_SIZE];
+		g_ascii_formatd(cpu_time, sizeof(cpu_time), "%.2f", job->cpu_time);
+		/* Written immediately, like the status, to arrive before it */
+		gebr_comm_protocol_socket_oldmsg_send(client->socket, TRUE,
+						      gebr_comm_protocol_defs.mem_def, 4,
+						      job->parent.run_id->str, job->frac->str,
+						      peak, cpu_time);
+		g_free(peak);
+	}
+
+	gchar *stop_file = job_get_stop_file(job);
+	gchar *done;
+	if (g_file_get_contents(stop_file, &done, NULL, NULL)) {
+		/* Empty if the loop ended before seeing the request */
+		g_strstrip(done);
+		if (*done && client)
+			gebr_comm_protocol_socket_oldmsg_send(client->socket, TRUE,
+							      gebr_comm_protocol_defs.itr_def, 3,
+							      job->parent.run_id->str, job->frac->str, done);
+		g_unlink(stop_file);
+		g_free(done);
+	}
+	g_free(stop_file);
+
 	if (WEXITSTATUS(status) == 0)
 		job_status_notify_finished(job);
 	else
 		job_status_notify(job, JOB_STATUS_FAILED, gebr_iso_date());
+
+	/* Maestro went away and there is nothing left to recover, see
+	 * client_disconnected() */
+	if (!client && !job_has_running_jobs())
+		gebrd_quit();
 }
 
 /**
@@ -378,6 +467,17 @@ GebrdJob *job_find(GString * rid)
 	return job;
 }
 
+GebrdJob *job_find_fraction(GString *rid, GString *frac)
+{
+	for (GList *link = gebrd->user->jobs; link != NULL; link = g_list_next(link)) {
+		GebrdJob *i = (GebrdJob *)link->data;
+		if (!strcmp(i->parent.run_id->str, rid->str) && !strcmp(i->frac->str, frac->str))
+			return i;
+	}
+
+	return NULL;
+}
+
 void
 job_new(GebrdJob **_job,
 	struct client *client,
@@ -469,6 +569,12 @@ void job_free(GebrdJob *job)
 	if (link != NULL)
 		gebrd->user->jobs = g_list_delete_link(gebrd->user->jobs, link);
 
+	job_stop_usage_sampling(job);
+
+	gchar *stop_file = job_get_stop_file(job);
+	g_unlink(stop_file);
+	g_free(stop_file);
+
 	/* free data */
 	gebr_comm_process_free(job->process);
 	if (gebrd_get_server_type() == GEBR_COMM_SERVER_TYPE_MOAB)
@@ -537,10 +643,11 @@ void job_status_notify(GebrdJob *job, GebrCommJobStatus status, const gchar *_pa
 	/* warn all clients of the new status */
 	struct client *client = gebrd_user_get_connection(gebrd->user);
 
-	gebr_comm_protocol_socket_oldmsg_send(client->socket, TRUE,
-					      gebr_comm_protocol_defs.sta_def, 5,
-					      job->parent.jid->str, status_enum_to_string(status),
-					      parameter, job->parent.run_id->str, job->frac->str);
+	if (client)
+		gebr_comm_protocol_socket_oldmsg_send(client->socket, TRUE,
+						      gebr_comm_protocol_defs.sta_def, 5,
+						      job->parent.jid->str, status_enum_to_string(status),
+						      parameter, job->parent.run_id->str, job->frac->str);
 
 	g_free(parameter);
 }
@@ -648,6 +755,9 @@ void job_run_flow(GebrdJob *job)
 		job_status_notify(job, JOB_STATUS_RUNNING, job->parent.start_date->str);
 		gebr_comm_process_start(job->process, cmd_line);
 
+		job_sample_usage(job);
+		job->usage_timeout = g_timeout_add(USAGE_SAMPLE_INTERVAL, (GSourceFunc)job_sample_usage, job);
+
 		/* for program that waits stdin EOF (like sfmath) */
 		gebr_geoxml_flow_get_program(job->flow, &program, 0);
 		if (gebr_geoxml_program_get_stdin(GEBR_GEOXML_PROGRAM(program)) == FALSE)
@@ -683,6 +793,10 @@ void job_end(GebrdJob *job)
 		} else {
 			job->user_finished = TRUE;
 			gebr_comm_process_terminate(job->process);
+			/* Stopped processes only handle the signal once
+			 * continued */
+			if (job->stopped)
+				gebr_comm_process_continue(job->process);
 		}
 	} else if (gebrd_get_server_type() == GEBR_COMM_SERVER_TYPE_MOAB)
 		job_send_signal_on_moab("SIGTERM", job);
@@ -702,6 +816,38 @@ void job_kill(GebrdJob *job)
 		job_send_signal_on_moab("SIGKILL", job);
 }
 
+void job_preempt(GebrdJob *job, gboolean stop)
+{
+	if (gebrd_get_server_type() != GEBR_COMM_SERVER_TYPE_REGULAR
+	    || job->parent.status != JOB_STATUS_RUNNING
+	    || stop == job->stopped)
+		return;
+
+	/* The flow runs in the process group of the shell, see
+	 * gebr_comm_process_start(). Letting it continue needs no
+	 * privileges, so a stop can always be undone */
+	if (stop)
+		gebr_comm_process_stop(job->process);
+	else
+		gebr_comm_process_continue(job->process);
+
+	job->stopped = stop;
+}
+
+void job_stop_early(GebrdJob *job)
+{
+	if (gebrd_get_server_type() != GEBR_COMM_SERVER_TYPE_REGULAR
+	    || job->parent.status != JOB_STATUS_RUNNING
+	    || !job->is_parallelizable)
+		return;
+
+	/* Read by the loop between its batches, see job_assembly_cmdline() */
+	gchar *stop_file = job_get_stop_file(job);
+	if (!g_file_set_contents(stop_file, "", 0, NULL))
+		gebrd_message(GEBR_LOG_WARNING, "Could not stop job %s early", job->parent.run_id->str);
+	g_free(stop_file);
+}
+
 void job_notify(GebrdJob *job, struct client *client)
 {
 	gebr_comm_protocol_socket_oldmsg_send(client->socket, FALSE,
@@ -718,6 +864,24 @@ void job_list(struct client *client)
 	for (GList *link = gebrd->user->jobs; link != NULL; link = g_list_next(link)) {
 		GebrdJob *job = (GebrdJob *)link->data;
 		job_notify(job, client);
+
+		/* A maestro that was restarted knows nothing about the task */
+		if (job->parent.output->len)
+			gebr_comm_protocol_socket_oldmsg_send(client->socket, FALSE,
+							      gebr_comm_protocol_defs.out_def, 4,
+							      job->parent.jid->str,
+							      job->parent.output->str,
+							      job->parent.run_id->str,
+							      job->frac->str);
+
+		if (job->parent.status != JOB_STATUS_RUNNING)
+			gebr_comm_protocol_socket_oldmsg_send(client->socket, FALSE,
+							      gebr_comm_protocol_defs.sta_def, 5,
+							      job->parent.jid->str,
+							      status_enum_to_string(job->parent.status),
+							      job->parent.finish_date->str,
+							      job->parent.run_id->str,
+							      job->frac->str);
 	}
 }
 
@@ -732,11 +896,30 @@ job_has_running_jobs(void)
 	return FALSE;
 }
 
+void
+job_continue_all(void)
+{
+	for (GList *link = gebrd->user->jobs; link != NULL; link = g_list_next(link))
+		job_preempt(link->data, FALSE);
+}
+
+gint
+job_count_running(void)
+{
+	gint n = 0;
+	for (GList *link = gebrd->user->jobs; link != NULL; link = g_list_next(link)) {
+		GebrdJob *job = (GebrdJob *)link->data;
+		if (job->parent.status == JOB_STATUS_RUNNING)
+			n++;
+	}
+	return n;
+}
 
 void job_send_clients_job_notify(GebrdJob *job)
 {
 	struct client *client = gebrd_user_get_connection(gebrd->user);
-	job_notify(job, client);
+	if (client)
+		job_notify(job, client);
 }
 
 /**
@@ -1504,6 +1687,8 @@ static void job_assembly_cmdline(GebrdJob *job)
 			nprocs = job->numproc;
 			nice = job->niceness;
 			gchar *fcomm, *scomm, *ffcomm;
+			gchar *stop_file = job_get_stop_file(job);
+			gchar *stop = escape_quote_and_slash(stop_file);
 			fcomm = g_strdup_printf(_("\n# Setting the number of cores \n"));
 			scomm = g_strdup_printf(_("# Command Line"));
 			ffcomm = g_strdup_printf(_("\n# Setting the niceness of the process \n"));
@@ -1512,14 +1697,18 @@ static void job_assembly_cmdline(GebrdJob *job)
 						 "%s"
 						 "NICE=%d\n"
 						 "exec=\"nice -n $NICE\"\n"
+						 "STOP=\"%s\"\n"
 						 "for (( _outter=0; _outter < %s; _outter+=$PROC ))\n"
 						 "do\n"
+						 "  test -e \"$STOP\" && { echo $_outter > \"$STOP\"; break; }\n"
 						 "  (for (( counter=$_outter; counter < $_outter+$PROC && counter < %s; counter++ ))\n"
 						 "  do\n"
 						 "    %s\n%s \n%s\n",
-						 fcomm,nprocs, ffcomm,nice, n, n, expr_buf->str, str_buf->str,scomm);
+						 fcomm,nprocs, ffcomm,nice, stop, n, n, expr_buf->str, str_buf->str,scomm);
 			g_string_append(job->parent.cmd_line, " ) &\n");
 			g_string_prepend_c(job->parent.cmd_line, '(');
+			g_free(stop_file);
+			g_free(stop);
 			g_free(fcomm);
 			g_free(scomm);
 			g_free(ffcomm);
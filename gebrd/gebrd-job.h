@@ -51,6 +51,7 @@ struct _GebrdJob {
 	GebrGeoXmlFlow *flow;
 	gboolean critical_error; /* the flow can't be run if TRUE! */
 	gboolean user_finished;
+	gboolean stopped; /* by job_preempt() */
 
 	GList *children;
 
@@ -75,6 +76,12 @@ struct _GebrdJob {
 
 	GString *buf[2];
 	gint timeout[2];
+
+	/* Peak resident memory of the task, in kB, and its cpu time in
+	 * seconds */
+	glong peak_rss;
+	gdouble cpu_time;
+	guint usage_timeout;
 };
 
 struct _GebrdJobClass {
@@ -85,6 +92,14 @@ struct _GebrdJobClass {
  */
 GebrdJob *job_find(GString * jid);
 
+/**
+ * job_find_fraction:
+ *
+ * Like job_find(), for the task @frac of the job @rid. A daemon may run
+ * several tasks of the same job.
+ */
+GebrdJob *job_find_fraction(GString *rid, GString *frac);
+
 /**
  */
 void job_new(GebrdJob **_job,
@@ -134,6 +149,31 @@ void job_end(GebrdJob *job);
  */
 void job_kill(GebrdJob *job);
 
+/**
+ * job_preempt:
+ *
+ * Stops every process of @job, which must be running, if @stop is %TRUE,
+ * or lets them continue otherwise.
+ */
+void job_preempt(GebrdJob *job, gboolean stop);
+
+/**
+ * job_continue_all:
+ *
+ * Lets every job stopped by job_preempt() continue.
+ */
+void job_continue_all(void);
+
+/**
+ * job_stop_early:
+ *
+ * Asks the loop of @job to stop before its next batch of iterations, so
+ * the iterations left can run elsewhere. The batches already started are
+ * not interrupted. When @job ends, the number of its iterations done is
+ * sent to maestro before its status.
+ */
+void job_stop_early(GebrdJob *job);
+
 /**
  */
 void job_notify(GebrdJob *job, struct client *client);
@@ -145,6 +185,13 @@ void job_list(struct client *client);
  */
 gboolean job_has_running_jobs(void);
 
+/**
+ * job_count_running:
+ *
+ * Returns: the number of tasks running in this daemon.
+ */
+gint job_count_running(void);
+
 /**
  */
 void job_send_clients_job_notify(GebrdJob *job);
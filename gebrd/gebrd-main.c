@@ -53,6 +53,7 @@ int main(int argc, char **argv)
 	GOptionContext *context;
 
 	g_type_init();
+	g_thread_init(NULL);
 
 	gebr_libinit(GETTEXT_PACKAGE);
 	gebr_geoxml_init();
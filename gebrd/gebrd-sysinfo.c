@@ -1,4 +1,6 @@
 #include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -189,3 +191,364 @@ void gebrd_mem_info_free (GebrdMemInfo *self)
 	g_hash_table_unref (self->props);
 	g_free (self);
 }
+
+typedef struct {
+	guint64 busy;
+	guint64 total;
+} CoreTime;
+
+struct _GebrdStatInfo {
+	guint length;
+	CoreTime *cores;
+	guint procs_running;
+};
+
+GebrdStatInfo *
+gebrd_stat_info_new_from_file (const gchar *file)
+{
+	gchar *contents;
+	gchar **lines;
+	GArray *cores;
+	GebrdStatInfo *stat;
+	guint procs_running = 0;
+
+	if (!g_file_get_contents(file, &contents, NULL, NULL))
+		return NULL;
+
+	cores = g_array_new(FALSE, TRUE, sizeof(CoreTime));
+	lines = g_strsplit(contents, "\n", 0);
+
+	for (gint i = 0; lines[i]; i++) {
+		guint64 user, nice, system, idle, iowait, irq, softirq, steal;
+		guint id;
+
+		if (g_str_has_prefix(lines[i], "procs_running "))
+			procs_running = atoi(lines[i] + strlen("procs_running "));
+
+		/* The first line is the sum of all cores, skip it */
+		if (!g_str_has_prefix(lines[i], "cpu") || !g_ascii_isdigit(lines[i][3]))
+			continue;
+
+		iowait = irq = softirq = steal = 0;
+		if (sscanf(lines[i], "cpu%u %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT
+			   " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT
+			   " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT,
+			   &id, &user, &nice, &system, &idle,
+			   &iowait, &irq, &softirq, &steal) < 5)
+			continue;
+
+		CoreTime t;
+		t.busy = user + nice + system + irq + softirq + steal;
+		t.total = t.busy + idle + iowait;
+		g_array_append_val(cores, t);
+	}
+
+	g_strfreev(lines);
+	g_free(contents);
+
+	stat = g_new(GebrdStatInfo, 1);
+	stat->length = cores->len;
+	stat->cores = (CoreTime *) g_array_free(cores, FALSE);
+	stat->procs_running = procs_running;
+
+	return stat;
+}
+
+GebrdStatInfo *
+gebrd_stat_info_new (void)
+{
+	return gebrd_stat_info_new_from_file("/proc/stat");
+}
+
+guint gebrd_stat_info_n_cores (GebrdStatInfo *self)
+{
+	return self->length;
+}
+
+gdouble gebrd_stat_info_get_usage (GebrdStatInfo *self,
+				   GebrdStatInfo *prev,
+				   guint core)
+{
+	g_return_val_if_fail (core < self->length, 0);
+
+	guint64 busy = self->cores[core].busy;
+	guint64 total = self->cores[core].total;
+
+	if (prev && core < prev->length) {
+		busy -= MIN(busy, prev->cores[core].busy);
+		total -= MIN(total, prev->cores[core].total);
+	}
+
+	if (total == 0)
+		return 0;
+
+	return MIN(1.0, (gdouble) busy / total);
+}
+
+void gebrd_stat_info_free (GebrdStatInfo *self)
+{
+	g_free (self->cores);
+	g_free (self);
+}
+
+guint gebrd_stat_info_get_procs_running (GebrdStatInfo *self)
+{
+	return self->procs_running;
+}
+
+/*
+ * Weight of the newest sample in the moving averages. With samples every
+ * GEBRD_LOAD_SAMPLER_INTERVAL, a change shows up in about a second.
+ */
+#define SAMPLER_ALPHA 0.5
+
+struct _GebrdLoadSampler {
+	GebrdStatInfo *last;
+	gdouble *usage;
+	guint length;
+	gdouble runnable;
+};
+
+GebrdLoadSampler *
+gebrd_load_sampler_new (void)
+{
+	return g_new0(GebrdLoadSampler, 1);
+}
+
+void gebrd_load_sampler_add (GebrdLoadSampler *self,
+			     GebrdStatInfo *stat)
+{
+	gdouble runnable = MAX(1, stat->procs_running) - 1;
+
+	if (!self->last) {
+		self->runnable = runnable;
+		self->last = stat;
+		return;
+	}
+
+	if (!self->usage || self->length != stat->length) {
+		g_free(self->usage);
+		self->length = stat->length;
+		self->usage = g_new(gdouble, self->length);
+		for (guint i = 0; i < self->length; i++)
+			self->usage[i] = gebrd_stat_info_get_usage(stat, self->last, i);
+	} else {
+		for (guint i = 0; i < self->length; i++)
+			self->usage[i] = SAMPLER_ALPHA * gebrd_stat_info_get_usage(stat, self->last, i)
+				+ (1 - SAMPLER_ALPHA) * self->usage[i];
+	}
+
+	self->runnable = SAMPLER_ALPHA * runnable + (1 - SAMPLER_ALPHA) * self->runnable;
+
+	gebrd_stat_info_free(self->last);
+	self->last = stat;
+}
+
+guint gebrd_load_sampler_n_cores (GebrdLoadSampler *self)
+{
+	return self->length;
+}
+
+gdouble gebrd_load_sampler_get_usage (GebrdLoadSampler *self,
+				      guint core)
+{
+	g_return_val_if_fail (core < self->length, 0);
+	return self->usage[core];
+}
+
+gdouble gebrd_load_sampler_get_runnable (GebrdLoadSampler *self)
+{
+	return self->runnable;
+}
+
+void gebrd_load_sampler_free (GebrdLoadSampler *self)
+{
+	if (self->last)
+		gebrd_stat_info_free(self->last);
+	g_free(self->usage);
+	g_free(self);
+}
+
+typedef struct {
+	GPid ppid;
+	glong rss;
+	glong ticks;
+} ProcStat;
+
+/*
+ * Reads the parent, the resident set size, in pages, and the cpu time, in
+ * clock ticks, out of a `/proc/[pid]/stat' file. The cpu time includes the
+ * children already waited for, which left the process tree. The command name is skipped up to the last
+ * parenthesis since it may contain spaces.
+ */
+static gboolean
+read_proc_stat(const gchar *file,
+	       ProcStat *stat)
+{
+	gchar *contents;
+	gboolean ok = FALSE;
+
+	if (!g_file_get_contents(file, &contents, NULL, NULL))
+		return FALSE;
+
+	gchar *fields = strrchr(contents, ')');
+	if (fields) {
+		gchar **v = g_strsplit(g_strstrip(fields + 1), " ", 0);
+		/* Fields from the state on: ppid is the 2nd, utime, stime,
+		 * cutime and cstime the 12th to the 15th, rss the 22nd */
+		if (g_strv_length(v) > 21) {
+			stat->ppid = atoi(v[1]);
+			stat->rss = atol(v[21]);
+			stat->ticks = atol(v[11]) + atol(v[12]) + atol(v[13]) + atol(v[14]);
+			ok = TRUE;
+		}
+		g_strfreev(v);
+	}
+	g_free(contents);
+
+	return ok;
+}
+
+gboolean
+gebrd_process_tree_get_usage_from_dir (const gchar *proc_dir,
+				       GPid pid,
+				       glong *rss,
+				       gdouble *cpu_time)
+{
+	GDir *dir;
+	const gchar *name;
+	GHashTable *procs;
+	glong pages = 0;
+	glong ticks = 0;
+	gboolean found = FALSE;
+
+	dir = g_dir_open(proc_dir, 0, NULL);
+	if (!dir)
+		return FALSE;
+
+	procs = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+	while ((name = g_dir_read_name(dir))) {
+		if (!g_ascii_isdigit(*name))
+			continue;
+
+		gchar *file = g_build_filename(proc_dir, name, "stat", NULL);
+		ProcStat *stat = g_new(ProcStat, 1);
+		if (read_proc_stat(file, stat))
+			g_hash_table_insert(procs, GINT_TO_POINTER(atoi(name)), stat);
+		else
+			g_free(stat);
+		g_free(file);
+	}
+	g_dir_close(dir);
+
+	GHashTableIter iter;
+	gpointer key;
+	ProcStat *stat;
+
+	g_hash_table_iter_init(&iter, procs);
+	while (g_hash_table_iter_next(&iter, &key, (gpointer *) &stat)) {
+		GPid p = GPOINTER_TO_INT(key);
+		ProcStat *s = stat;
+
+		/* Walk up the parents until @pid or the root, the depth is
+		 * bounded by the number of processes in case of a cycle */
+		for (guint depth = 0; p != pid && s && depth < g_hash_table_size(procs); depth++) {
+			p = s->ppid;
+			s = g_hash_table_lookup(procs, GINT_TO_POINTER(p));
+		}
+
+		if (p == pid) {
+			pages += stat->rss;
+			ticks += stat->ticks;
+			found = TRUE;
+		}
+	}
+	g_hash_table_destroy(procs);
+
+	if (!found)
+		return FALSE;
+
+	*rss = pages * (sysconf(_SC_PAGESIZE) / 1024);
+	*cpu_time = ticks / (gdouble) sysconf(_SC_CLK_TCK);
+
+	return TRUE;
+}
+
+gboolean
+gebrd_process_tree_get_usage (GPid pid,
+			      glong *rss,
+			      gdouble *cpu_time)
+{
+	return gebrd_process_tree_get_usage_from_dir("/proc", pid, rss, cpu_time);
+}
+
+#define BANDWIDTH_BLOCK_SIZE (1024 * 1024)
+
+gboolean
+gebrd_measure_bandwidth (const gchar *dir,
+			 gsize size,
+			 gdouble *read_bw,
+			 gdouble *write_bw)
+{
+	gchar *path = g_build_filename(dir, ".gebrd-bandwidth-XXXXXX", NULL);
+	gchar *block = g_malloc(BANDWIDTH_BLOCK_SIZE);
+	GTimer *timer = g_timer_new();
+	gboolean ok = FALSE;
+	gsize done;
+	gint fd;
+
+	/* Not zeros, some filesystems would compress them */
+	for (gsize i = 0; i < BANDWIDTH_BLOCK_SIZE; i++)
+		block[i] = g_random_int_range(0, 256);
+
+	fd = g_mkstemp(path);
+	if (fd < 0)
+		goto out;
+
+	g_timer_start(timer);
+	for (done = 0; done < size; ) {
+		gssize n = write(fd, block, MIN(size - done, BANDWIDTH_BLOCK_SIZE));
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			goto out_close;
+		done += n;
+	}
+	if (fsync(fd) != 0)
+		goto out_close;
+	*write_bw = size / MAX(g_timer_elapsed(timer, NULL), 1e-6);
+
+#ifdef POSIX_FADV_DONTNEED
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+
+	/* Reopening makes network filesystems check the file again */
+	close(fd);
+	fd = g_open(path, O_RDONLY, 0);
+	if (fd < 0) {
+		g_unlink(path);
+		goto out;
+	}
+
+	g_timer_start(timer);
+	for (done = 0; done < size; ) {
+		gssize n = read(fd, block, BANDWIDTH_BLOCK_SIZE);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			goto out_close;
+		done += n;
+	}
+	*read_bw = size / MAX(g_timer_elapsed(timer, NULL), 1e-6);
+	ok = TRUE;
+
+out_close:
+	close(fd);
+	g_unlink(path);
+out:
+	g_timer_destroy(timer);
+	g_free(block);
+	g_free(path);
+
+	return ok;
+}
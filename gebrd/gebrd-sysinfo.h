@@ -102,4 +102,157 @@ const gchar *gebrd_mem_info_get (GebrdMemInfo *self,
  */
 void gebrd_mem_info_free (GebrdMemInfo *self);
 
+typedef struct _GebrdStatInfo GebrdStatInfo;
+
+/**
+ * gebrd_stat_info_new:
+ *
+ * Returns: a snapshot of the time spent by each core, read from
+ * `/proc/stat'. Free with gebrd_stat_info_free().
+ */
+GebrdStatInfo *gebrd_stat_info_new (void);
+
+/**
+ * gebrd_stat_info_new_from_file:
+ * @file: The file to parse.
+ *
+ * Returns: a new #GebrdStatInfo object from file @file.
+ * Free with gebrd_stat_info_free().
+ */
+GebrdStatInfo *gebrd_stat_info_new_from_file (const gchar *file);
+
+/**
+ * gebrd_stat_info_n_cores:
+ *
+ * Returns: the number of cores listed in the snapshot.
+ */
+guint gebrd_stat_info_n_cores (GebrdStatInfo *self);
+
+/**
+ * gebrd_stat_info_get_usage:
+ * @self: The most recent snapshot
+ * @prev: An older snapshot, or %NULL
+ * @core: Which core to get the usage from
+ *
+ * Returns: the fraction of time, between 0 and 1, that @core was busy
+ * between @prev and @self. If @prev is %NULL, the usage since boot.
+ */
+gdouble gebrd_stat_info_get_usage (GebrdStatInfo *self,
+				   GebrdStatInfo *prev,
+				   guint core);
+
+/**
+ * gebrd_stat_info_get_procs_running:
+ *
+ * Returns: the number of processes running or waiting for a core, as seen
+ * in the `procs_running' line.
+ */
+guint gebrd_stat_info_get_procs_running (GebrdStatInfo *self);
+
+/**
+ * gebrd_stat_info_free:
+ */
+void gebrd_stat_info_free (GebrdStatInfo *self);
+
+typedef struct _GebrdLoadSampler GebrdLoadSampler;
+
+/**
+ * GEBRD_LOAD_SAMPLER_INTERVAL:
+ *
+ * Milliseconds between two samples of `/proc/stat'.
+ */
+#define GEBRD_LOAD_SAMPLER_INTERVAL 500
+
+/**
+ * gebrd_load_sampler_new:
+ *
+ * Returns: a new #GebrdLoadSampler, which smooths the usage of the cores
+ * and the number of runnable processes over the last samples.
+ */
+GebrdLoadSampler *gebrd_load_sampler_new (void);
+
+/**
+ * gebrd_load_sampler_add:
+ * @stat: A new snapshot, owned by @self from now on
+ */
+void gebrd_load_sampler_add (GebrdLoadSampler *self,
+			     GebrdStatInfo *stat);
+
+/**
+ * gebrd_load_sampler_n_cores:
+ */
+guint gebrd_load_sampler_n_cores (GebrdLoadSampler *self);
+
+/**
+ * gebrd_load_sampler_get_usage:
+ *
+ * Returns: the smoothed busy fraction of @core.
+ */
+gdouble gebrd_load_sampler_get_usage (GebrdLoadSampler *self,
+				      guint core);
+
+/**
+ * gebrd_load_sampler_get_runnable:
+ *
+ * Returns: the smoothed number of processes running or waiting for a core,
+ * not counting the sampler itself.
+ */
+gdouble gebrd_load_sampler_get_runnable (GebrdLoadSampler *self);
+
+/**
+ * gebrd_load_sampler_free:
+ */
+void gebrd_load_sampler_free (GebrdLoadSampler *self);
+
+/**
+ * gebrd_process_tree_get_usage_from_dir:
+ * @proc_dir: A directory laid out like `/proc'
+ *
+ * Same as gebrd_process_tree_get_usage(), but reads the processes from
+ * @proc_dir.
+ */
+gboolean gebrd_process_tree_get_usage_from_dir (const gchar *proc_dir,
+						GPid pid,
+						glong *rss,
+						gdouble *cpu_time);
+
+/**
+ * gebrd_process_tree_get_usage:
+ * @rss: Returns the resident memory, in kB
+ * @cpu_time: Returns the user and system time, in seconds
+ *
+ * Measures @pid and all its descendants, including the descendants that
+ * already finished.
+ *
+ * Returns: %FALSE if @pid is not running.
+ */
+gboolean gebrd_process_tree_get_usage (GPid pid,
+				       glong *rss,
+				       gdouble *cpu_time);
+
+/**
+ * GEBRD_BANDWIDTH_PROBE_SIZE:
+ *
+ * Bytes written and read back to measure the bandwidth to a filesystem.
+ */
+#define GEBRD_BANDWIDTH_PROBE_SIZE (8 * 1024 * 1024)
+
+/**
+ * gebrd_measure_bandwidth:
+ * @dir: A directory in the filesystem to measure
+ * @size: Number of bytes to write and read back
+ * @read_bw: Return location for the read bandwidth, in bytes per second
+ * @write_bw: Return location for the write bandwidth, in bytes per second
+ *
+ * Writes @size bytes to a temporary file in @dir, waits for them to reach
+ * the storage, drops them from the page cache where the system allows and
+ * reads them back. The file is removed. Blocks until it is done.
+ *
+ * Returns: %FALSE if the file could not be written or read.
+ */
+gboolean gebrd_measure_bandwidth (const gchar *dir,
+				  gsize size,
+				  gdouble *read_bw,
+				  gdouble *write_bw);
+
 #endif /* __GEBRD_SYSINFO_H__ */
@@ -244,6 +244,7 @@ void gebrd_quit(void)
 	}
 	g_list_foreach(gebrd->mpi_flavors, (GFunc)gebrd_mpi_config_free, NULL);
 	g_list_free(gebrd->mpi_flavors);
+	client_stop_monitoring();
 	server_quit();
 	g_main_loop_quit(gebrd->main_loop);
 }
@@ -15,6 +15,9 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "../gebrd-sysinfo.h"
 
@@ -43,6 +46,81 @@ test_meminfo_get(void)
 	gebrd_mem_info_free(mem);
 }
 
+static void
+test_stat_info_usage(void)
+{
+	GebrdStatInfo *stat = gebrd_stat_info_new_from_file(TEST_DIR"/stat");
+	GebrdStatInfo *prev = gebrd_stat_info_new_from_file(TEST_DIR"/stat-prev");
+
+	g_assert_cmpint(gebrd_stat_info_n_cores(stat), ==, 2);
+	g_assert_cmpint(gebrd_stat_info_get_procs_running(stat), ==, 2);
+
+	/* cpu0 was busy 75 out of 100 jiffies, cpu1 was idle */
+	g_assert_cmpfloat(gebrd_stat_info_get_usage(stat, prev, 0), ==, 0.75);
+	g_assert_cmpfloat(gebrd_stat_info_get_usage(stat, prev, 1), ==, 0);
+
+	gebrd_stat_info_free(stat);
+	gebrd_stat_info_free(prev);
+}
+
+static void
+test_load_sampler(void)
+{
+	GebrdLoadSampler *sampler = gebrd_load_sampler_new();
+
+	gebrd_load_sampler_add(sampler, gebrd_stat_info_new_from_file(TEST_DIR"/stat-prev"));
+	g_assert_cmpint(gebrd_load_sampler_n_cores(sampler), ==, 0);
+
+	gebrd_load_sampler_add(sampler, gebrd_stat_info_new_from_file(TEST_DIR"/stat"));
+	g_assert_cmpint(gebrd_load_sampler_n_cores(sampler), ==, 2);
+	g_assert_cmpfloat(gebrd_load_sampler_get_usage(sampler, 0), ==, 0.75);
+	g_assert_cmpfloat(gebrd_load_sampler_get_usage(sampler, 1), ==, 0);
+
+	/* procs_running went from 1 to 2, the sampler itself is not counted */
+	g_assert_cmpfloat(gebrd_load_sampler_get_runnable(sampler), ==, 0.5);
+
+	gebrd_load_sampler_free(sampler);
+}
+
+static void
+test_process_tree_usage(void)
+{
+	glong page = sysconf(_SC_PAGESIZE) / 1024;
+	gdouble ticks = sysconf(_SC_CLK_TCK);
+	gdouble cpu_time;
+	glong rss;
+
+	/* 100 is the shell, 101 its child and 102 a grandchild; 200 is an
+	 * unrelated process. Each one ran for 10 ticks in user mode and 2 in
+	 * system mode. */
+	g_assert(gebrd_process_tree_get_usage_from_dir(TEST_DIR"/proc", 100, &rss, &cpu_time));
+	g_assert_cmpint(rss, ==, 4250 * page);
+	g_assert_cmpfloat(cpu_time, ==, 36 / ticks);
+
+	g_assert(gebrd_process_tree_get_usage_from_dir(TEST_DIR"/proc", 101, &rss, &cpu_time));
+	g_assert_cmpint(rss, ==, 4000 * page);
+	g_assert_cmpfloat(cpu_time, ==, 24 / ticks);
+
+	g_assert(!gebrd_process_tree_get_usage_from_dir(TEST_DIR"/proc", 300, &rss, &cpu_time));
+}
+
+static void
+test_measure_bandwidth(void)
+{
+	gchar *dir = g_build_filename(g_get_tmp_dir(), "gebrd-test-XXXXXX", NULL);
+	gdouble read_bw = 0, write_bw = 0;
+
+	g_assert(mkdtemp(dir) != NULL);
+	g_assert(gebrd_measure_bandwidth(dir, 256 * 1024, &read_bw, &write_bw));
+	g_assert_cmpfloat(read_bw, >, 0);
+	g_assert_cmpfloat(write_bw, >, 0);
+
+	/* The probe file is gone */
+	g_assert(g_rmdir(dir) == 0);
+
+	g_assert(!gebrd_measure_bandwidth("/nonexistent", 1024, &read_bw, &write_bw));
+	g_free(dir);
+}
 
 int main(int argc, char * argv[])
 {
@@ -51,6 +129,10 @@ int main(int argc, char * argv[])
 	g_test_add_func("/gebrd/sysinfo/cpu_info_get", test_cpuinfo_get);
 	g_test_add_func("/gebrd/sysinfo/cpu_info_n_procs", test_cpuinfo_n_procs);
 	g_test_add_func("/gebrd/sysinfo/mem_info_get", test_meminfo_get);
+	g_test_add_func("/gebrd/sysinfo/stat_info_usage", test_stat_info_usage);
+	g_test_add_func("/gebrd/sysinfo/load_sampler", test_load_sampler);
+	g_test_add_func("/gebrd/sysinfo/process_tree_usage", test_process_tree_usage);
+	g_test_add_func("/gebrd/sysinfo/measure_bandwidth", test_measure_bandwidth);
 
 	return g_test_run();
 }
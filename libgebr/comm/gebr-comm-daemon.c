@@ -68,3 +68,32 @@ gebr_comm_daemon_get_flavors(GebrCommDaemon *daemon)
 {
 	return GEBR_COMM_DAEMON_GET_IFACE(daemon)->get_flavors(daemon);
 }
+
+void
+gebr_comm_daemon_reserve_cores(GebrCommDaemon *daemon,
+			       const gchar *job_id,
+			       gint frac,
+			       gint ncores)
+{
+	GEBR_COMM_DAEMON_GET_IFACE(daemon)->reserve_cores(daemon, job_id, frac, ncores);
+}
+
+gint
+gebr_comm_daemon_get_reserved_cores(GebrCommDaemon *daemon)
+{
+	return GEBR_COMM_DAEMON_GET_IFACE(daemon)->get_reserved_cores(daemon);
+}
+
+const GebrCommTelemetry *
+gebr_comm_daemon_get_telemetry(GebrCommDaemon *daemon)
+{
+	return GEBR_COMM_DAEMON_GET_IFACE(daemon)->get_telemetry(daemon);
+}
+
+gboolean
+gebr_comm_daemon_get_bandwidth(GebrCommDaemon *daemon,
+			       gdouble *read_bw,
+			       gdouble *write_bw)
+{
+	return GEBR_COMM_DAEMON_GET_IFACE(daemon)->get_bandwidth(daemon, read_bw, write_bw);
+}
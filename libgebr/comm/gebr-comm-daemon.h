@@ -36,6 +36,22 @@
 typedef struct _GebrCommDaemon GebrCommDaemon;
 typedef struct _GebrCommDaemonIface GebrCommDaemonIface;
 
+/**
+ * GebrCommTelemetry:
+ *
+ * The state of a daemon, as periodically pushed by it.
+ */
+typedef struct {
+	gchar *load;           /* The 1, 5 and 15 minutes load averages */
+	gdouble *core_usage;   /* Smoothed busy fraction of each core */
+	gint ncores;
+	glong free_memory;     /* In kB */
+	gint running_tasks;
+	gdouble runnable;      /* Smoothed number of processes running or waiting */
+	gdouble age;           /* Seconds since it was received */
+	gint pending_cores;    /* Cores reserved by tasks the counters don't show yet */
+} GebrCommTelemetry;
+
 struct _GebrCommDaemonIface {
 	GTypeInterface g_iface;
 
@@ -50,6 +66,19 @@ struct _GebrCommDaemonIface {
 	gboolean  (*can_execute) (GebrCommDaemon *daemon);
 
 	const gchar * (*get_flavors) (GebrCommDaemon *daemon);
+
+	void  (*reserve_cores) (GebrCommDaemon *daemon,
+				const gchar *job_id,
+				gint frac,
+				gint ncores);
+
+	gint  (*get_reserved_cores) (GebrCommDaemon *daemon);
+
+	const GebrCommTelemetry * (*get_telemetry) (GebrCommDaemon *daemon);
+
+	gboolean (*get_bandwidth) (GebrCommDaemon *daemon,
+				   gdouble *read_bw,
+				   gdouble *write_bw);
 };
 
 GType gebr_comm_daemon_get_type(void) G_GNUC_CONST;
@@ -66,4 +95,45 @@ gboolean gebr_comm_daemon_can_execute(GebrCommDaemon *daemon);
 
 const gchar *gebr_comm_daemon_get_flavors(GebrCommDaemon *daemon);
 
+/**
+ * gebr_comm_daemon_reserve_cores:
+ *
+ * Reserves @ncores of @daemon for the task @frac of the job @job_id. The
+ * reservation is held until the task completes, so runners deciding at the
+ * same time do not count on the same cores.
+ */
+void gebr_comm_daemon_reserve_cores(GebrCommDaemon *daemon,
+				    const gchar *job_id,
+				    gint frac,
+				    gint ncores);
+
+/**
+ * gebr_comm_daemon_get_reserved_cores:
+ *
+ * Returns: the number of cores of @daemon reserved by tasks not completed.
+ */
+gint gebr_comm_daemon_get_reserved_cores(GebrCommDaemon *daemon);
+
+/**
+ * gebr_comm_daemon_get_telemetry:
+ *
+ * Returns: the last telemetry received from @daemon, or %NULL if it never
+ * sent one. The structure belongs to @daemon.
+ */
+const GebrCommTelemetry *gebr_comm_daemon_get_telemetry(GebrCommDaemon *daemon);
+
+/**
+ * gebr_comm_daemon_get_bandwidth:
+ *
+ * Gets the bandwidth, in bytes per second, that @daemon measured for
+ * reading and writing the directory where the flows keep their data, the
+ * BASE of the line of the last flow it ran. Daemons of a maestro share it,
+ * but not all reach it as fast.
+ *
+ * Returns: %FALSE if @daemon did not measure it.
+ */
+gboolean gebr_comm_daemon_get_bandwidth(GebrCommDaemon *daemon,
+					gdouble *read_bw,
+					gdouble *write_bw);
+
 #endif /* __GEBR_COMM_DAEMON_H__ */
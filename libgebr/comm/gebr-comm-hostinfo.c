@@ -17,187 +17,155 @@
  *   Inspired on Qt 4.3 version of QHostInfo, by Trolltech
  */
 
-#include <unistd.h>
-#include <netdb.h>
-extern int h_errno;
-#include <sys/socket.h>
-#include <netinet/in.h>
+#include <string.h>
 #include <arpa/inet.h>
+#include <gio/gio.h>
 
 #include "gebr-comm-hostinfo.h"
 
-// PORT TO getaddrinfo
-
 /*
  * Internal functions
  */
 
-// struct thread_data {
-//      GString *       hostname;
-//      GebrCommHostInfoFunc    callback;
-//      gpointer        user_data;
-// };
-// 
-// void
-// __g_host_info_init(GebrCommHostInfo * host_info)
-// {
-//      host_info->error = GEBR_COMM_HOST_INFO_ERROR_NONE;
-//      host_info->addresses = NULL;
-// }
-// 
-// GebrCommHostInfo *
-// __g_host_info_new(void)
-// {
-//      GebrCommHostInfo *      new;
-// 
-//      new = g_malloc(sizeof(GebrCommHostInfo));
-//      if (new == NULL)
-//              return NULL;
-//      __g_host_info_init(new);
-// 
-//      return new;
-// }
-// 
-// GebrCommHostInfo *
-// __g_host_info_lookup_thread(struct thread_data * thread_data)
-// {
-//      GebrCommHostInfo *              new;
-//      struct hostent *        hostent;
-//      gchar *                 address;
-//      gint                    i;
-// 
-//      new = __g_host_info_new();
-//      if ((hostent = gethostbyname(thread_data->hostname->str)) == NULL) {
-//              switch (h_errno) {
-//              case HOST_NOT_FOUND:
-//                      new->error = GEBR_COMM_HOST_INFO_ERROR_NOT_FOUND;
-//                      break;
-//              case NO_ADDRESS:
-//                      new->error = GEBR_COMM_HOST_INFO_ERROR_NO_ADDRESS;
-//                      break;
-//              case TRY_AGAIN:
-//                      new->error = GEBR_COMM_HOST_INFO_ERROR_TRY_AGAIN;
-//                      break;
-// //           case NO_RECOVERY:
-//              default:
-//                      new->error = GEBR_COMM_HOST_INFO_ERROR_UNKNOWN;
-//                      break;
-//              }
-//              goto out;
-//      }
-//      new->error = GEBR_COMM_HOST_INFO_ERROR_NONE;
-// 
-//      /* create list of GebrCommSocketAddress */
-//      i = 0;
-//      while (1) {
-//              address = hostent->h_addr_list[i++];
-//              if (address == NULL)
-//                      break;
-// 
-//              GebrCommSocketAddress * socket_address;
-// 
-//              /* TODO: check _address_ family */
-//              socket_address = gebr_comm_socket_address_new("", GEBR_COMM_SOCKET_ADDRESS_TYPE_IPV4);
-//              gebr_comm_socket_address_set_ipv4(socket_address, address.s_addr);
-//              new->addresses = g_list_append(new->addresses, socket_address);
-//      }
-// 
-// out: if (thread_data->callback != NULL)
-//              thread_data->callback(new, thread_data->user_data);
-// 
-//      g_string_free(thread_data->hostname, TRUE);
-//      g_free(thread_data);
-//      return new;
-// }
-// 
-// GebrCommHostInfo *
-// __g_host_info_lookup(GString * hostname, GebrCommHostInfoFunc callback, gpointer user_data)
-// {
-//      struct thread_data *    thread_data;
-//      GThread *               thread;
-//      GError *                error;
-//      gboolean                joinable;
-// 
-//      thread_data = g_malloc(sizeof(struct thread_data));
-//      if (thread_data == NULL)
-//              return NULL;
-//      *thread_data = (struct thread_data) {
-//              .hostname = g_string_new(hostname->str),
-//              .callback = callback,
-//              .user_data = user_data
-//      };
-// 
-//      if (!g_thread_supported())
-//               g_thread_init(NULL);
-//      error = NULL;
-//      joinable = (callback == NULL) ? TRUE : FALSE;
-//      thread = g_thread_create((GThreadFunc)__g_host_info_lookup_thread,
-//              thread_data, joinable, &error);
-//      if (joinable)
-//              return (GebrCommHostInfo*)g_thread_join(thread);
-// 
-//      return NULL;
-// }
-// 
-// /*
-//  * API functions
-//  */
-// 
-// void
-// gebr_comm_host_info_lookup(GString * hostname, GebrCommHostInfoFunc callback, gpointer user_data)
-// {
-//      __g_host_info_lookup(hostname, callback, user_data);
-// }
-// 
-// void
-// gebr_comm_host_info_free(GebrCommHostInfo * host_info)
-// {
-//      g_list_foreach(host_info->addresses, (GFunc)gebr_comm_socket_address_free, NULL);
-//      g_list_free(host_info->addresses);
-//      g_free(host_info);
-// }
-// 
-// enum GebrCommHostInfoError
-// gebr_comm_host_info_error(GebrCommHostInfo * host_info)
-// {
-//      return host_info->error;
-// }
-// 
-// GList *
-// gebr_comm_host_info_addesses(GebrCommHostInfo * host_info)
-// {
-//      return host_info->addresses;
-// }
-// 
-// GebrCommSocketAddress *
-// gebr_comm_host_info_first_address(GebrCommHostInfo * host_info)
-// {
-//      GList * link;
-// 
-//      link = g_list_first(host_info->addresses);
-//      if (link == NULL)
-//              return NULL;
-// 
-//      return (GebrCommSocketAddress*)link->data;
-// }
-// 
-// GebrCommHostInfo *
-// gebr_comm_host_info_lookup_blocking(GString * hostname)
-// {
-//      return __g_host_info_lookup(hostname, NULL, NULL);
-// }
-// 
-// GebrCommHostInfo *
-// gebr_comm_host_info_lookup_local(void)
-// {
-//      GebrCommHostInfo *      host_info;
-//      GString *       hostname;
-//      char            name[512];
-// 
-//      gethostname(name, 512);
-//      hostname = g_string_new(name);
-//      host_info = __g_host_info_lookup(hostname, NULL, NULL);
-// 
-//      g_string_free(hostname, TRUE);
-//      return host_info;
-// }
+static GebrCommHostInfo *
+host_info_new(enum GebrCommHostInfoError error)
+{
+	GebrCommHostInfo *host_info = g_new(GebrCommHostInfo, 1);
+	host_info->error = error;
+	host_info->addresses = NULL;
+	return host_info;
+}
+
+static GebrCommHostInfo *
+host_info_from_resolver(GList *inet_addresses,
+			GError *error)
+{
+	if (error) {
+		switch (error->code) {
+		case G_RESOLVER_ERROR_NOT_FOUND:
+			return host_info_new(GEBR_COMM_HOST_INFO_ERROR_NOT_FOUND);
+		case G_RESOLVER_ERROR_TEMPORARY_FAILURE:
+			return host_info_new(GEBR_COMM_HOST_INFO_ERROR_TRY_AGAIN);
+		default:
+			return host_info_new(GEBR_COMM_HOST_INFO_ERROR_UNKNOWN);
+		}
+	}
+
+	GebrCommHostInfo *host_info = host_info_new(GEBR_COMM_HOST_INFO_ERROR_NONE);
+
+	/* GebrCommSocketAddress only knows IPv4 */
+	for (GList *i = inet_addresses; i; i = i->next) {
+		GInetAddress *inet_address = i->data;
+		GebrCommSocketAddress *socket_address;
+
+		if (g_inet_address_get_family(inet_address) != G_SOCKET_FAMILY_IPV4)
+			continue;
+
+		socket_address = g_new0(GebrCommSocketAddress, 1);
+		socket_address->type = GEBR_COMM_SOCKET_ADDRESS_TYPE_IPV4;
+		socket_address->address.inet_sockaddr.sin_family = AF_INET;
+		memcpy(&socket_address->address.inet_sockaddr.sin_addr,
+		       g_inet_address_to_bytes(inet_address), sizeof(struct in_addr));
+		host_info->addresses = g_list_append(host_info->addresses, socket_address);
+	}
+
+	if (!host_info->addresses)
+		host_info->error = GEBR_COMM_HOST_INFO_ERROR_NO_ADDRESS;
+
+	return host_info;
+}
+
+/*
+ * Addresses given as numbers need no lookup at all.
+ */
+static GebrCommHostInfo *
+lookup_numeric(const gchar *hostname)
+{
+	struct in_addr in_addr;
+
+	if (inet_aton(hostname, &in_addr) == 0)
+		return NULL;
+
+	GebrCommSocketAddress *address = g_new0(GebrCommSocketAddress, 1);
+	address->type = GEBR_COMM_SOCKET_ADDRESS_TYPE_IPV4;
+	address->address.inet_sockaddr.sin_family = AF_INET;
+	address->address.inet_sockaddr.sin_addr = in_addr;
+
+	GebrCommHostInfo *host_info = host_info_new(GEBR_COMM_HOST_INFO_ERROR_NONE);
+	host_info->addresses = g_list_append(NULL, address);
+	return host_info;
+}
+
+/*
+ * API functions
+ */
+
+void
+gebr_comm_host_info_free(GebrCommHostInfo * host_info)
+{
+	if (!host_info)
+		return;
+
+	g_list_foreach(host_info->addresses, (GFunc)g_free, NULL);
+	g_list_free(host_info->addresses);
+	g_free(host_info);
+}
+
+enum GebrCommHostInfoError
+gebr_comm_host_info_error(GebrCommHostInfo * host_info)
+{
+	return host_info->error;
+}
+
+GList *
+gebr_comm_host_info_addesses(GebrCommHostInfo * host_info)
+{
+	return host_info->addresses;
+}
+
+GebrCommSocketAddress *
+gebr_comm_host_info_first_address(GebrCommHostInfo * host_info)
+{
+	if (!host_info->addresses)
+		return NULL;
+
+	return host_info->addresses->data;
+}
+
+GebrCommHostInfo *
+gebr_comm_host_info_lookup_blocking(GString * hostname)
+{
+	GebrCommHostInfo *host_info;
+	GError *error = NULL;
+	GList *inet_addresses;
+
+	g_return_val_if_fail(hostname != NULL, NULL);
+
+	if ((host_info = lookup_numeric(hostname->str)))
+		return host_info;
+
+	GResolver *resolver = g_resolver_get_default();
+	inet_addresses = g_resolver_lookup_by_name(resolver, hostname->str, NULL, &error);
+	g_object_unref(resolver);
+
+	host_info = host_info_from_resolver(inet_addresses, error);
+	if (error)
+		g_error_free(error);
+	else
+		g_resolver_free_addresses(inet_addresses);
+
+	return host_info;
+}
+
+GebrCommHostInfo *
+gebr_comm_host_info_lookup_local(void)
+{
+	GebrCommHostInfo *host_info;
+	GString *hostname;
+
+	hostname = g_string_new(g_get_host_name());
+	host_info = gebr_comm_host_info_lookup_blocking(hostname);
+	g_string_free(hostname, TRUE);
+
+	return host_info;
+}
@@ -41,10 +41,6 @@ struct _GebrCommHostInfo {
 	GList *addresses;
 };
 
-typedef void (*GebrCommHostInfoFunc) (GebrCommHostInfo * host_info, gpointer user_data);
-
-void gebr_comm_host_info_lookup(GString * hostname, GebrCommHostInfoFunc callback, gpointer user_data);
-
 void gebr_comm_host_info_free(GebrCommHostInfo * host_info);
 
 enum GebrCommHostInfoError gebr_comm_host_info_error(GebrCommHostInfo * host_info);
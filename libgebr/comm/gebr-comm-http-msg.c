@@ -19,6 +19,7 @@
 #include <stdlib.h>
 
 #include "gebr-comm-http-msg.h"
+#include "../marshalers.h"
 
 static void gebr_g_hash_table_fill_with_headers(GHashTable *dict, GString *headers)
 {
@@ -83,6 +84,7 @@ enum {
 //};
 enum {
 	RESPONSE_RECEIVED,
+	RESPONSE_CHUNK_RECEIVED,
 	LAST_SIGNAL
 };
 static guint object_signals[LAST_SIGNAL];
@@ -97,6 +99,8 @@ static void gebr_comm_http_msg_init(GebrCommHttpMsg * msg)
 	msg->raw = g_string_new("");
 	msg->parsed = FALSE;
 	msg->parsed_headers = FALSE;
+	msg->content_received = 0;
+	msg->stream_content = FALSE;
 }
 static void gebr_comm_http_msg_finalize(GObject * object)
 {
@@ -146,6 +150,11 @@ static void gebr_comm_http_msg_class_init(GebrCommHttpMsgClass * klass)
 							 (GSignalFlags) (G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION),
 							 G_STRUCT_OFFSET(GebrCommHttpMsgClass, response_received), NULL,
 							 NULL, g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+	object_signals[RESPONSE_CHUNK_RECEIVED] = g_signal_new("response-chunk-received", GEBR_COMM_HTTP_MSG_TYPE,
+							       (GSignalFlags) (G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION),
+							       G_STRUCT_OFFSET(GebrCommHttpMsgClass, response_chunk_received), NULL,
+							       NULL, _gebr_gui_marshal_VOID__POINTER_POINTER,
+							       G_TYPE_NONE, 2, G_TYPE_POINTER, G_TYPE_POINTER);
 }
 
 GebrCommHttpMsg *gebr_comm_http_msg_new(GebrCommHttpRequestType type, GebrCommHttpRequestMethod method)
@@ -187,15 +196,14 @@ GebrCommHttpMsg *gebr_comm_http_msg_new_parsing(GebrCommHttpMsg *partial, GStrin
 			const gchar *tmp = g_hash_table_lookup(msg->headers, "content-length");
 			if (tmp) {
 				gsize content_length = atol(tmp);
-				gsize remaining = content_length-msg->content->len;
-				if (data->len >= remaining) {
-					g_string_append_len(msg->content, data->str, remaining);
-					g_string_append_len(msg->raw, data->str, remaining);
+				gsize remaining = content_length-msg->content_received;
+				gsize len = MIN(data->len, remaining);
+
+				g_string_append_len(msg->content, data->str, len);
+				g_string_append_len(msg->raw, data->str, len);
+				msg->content_received += len;
+				if (msg->content_received == content_length)
 					msg->parsed = TRUE;
-				} else {
-					g_string_append(msg->content, data->str);
-					g_string_append(msg->raw, data->str);
-				}
 			} //else
 		} else { 
 			GString *full_data = g_string_new(msg->raw->str);
@@ -310,3 +318,14 @@ void gebr_comm_http_msg_response_received(GebrCommHttpMsg *request, GebrCommHttp
 {
 	g_signal_emit(request, object_signals[RESPONSE_RECEIVED], 0, response);
 }
+
+void gebr_comm_http_msg_response_chunk_received(GebrCommHttpMsg *request, GebrCommHttpMsg *response, GString *chunk)
+{
+	g_signal_emit(request, object_signals[RESPONSE_CHUNK_RECEIVED], 0, response, chunk);
+}
+
+guint gebr_comm_http_msg_get_id(GebrCommHttpMsg *msg)
+{
+	const gchar *id = g_hash_table_lookup(msg->headers, "request-id");
+	return id ? strtoul(id, NULL, 10) : 0;
+}
@@ -62,6 +62,12 @@ struct _GebrCommHttpMsg {
 	GString *raw;
 	gboolean parsed;
 	gboolean parsed_headers;
+	/* bytes of content received so far, even if streamed */
+	gsize content_received;
+
+	/* for requests: deliver the response content in chunks through
+	 * "response-chunk-received" instead of keeping it on response->content */
+	gboolean stream_content;
 };
 struct _GebrCommHttpMsgClass {
 	GObjectClass parent;
@@ -82,6 +88,13 @@ struct _GebrCommHttpMsgClass {
  *
  */
 	void (*response_received)(GebrCommHttpMsg *request, GebrCommHttpMsg *response);
+
+/**
+ * Emitted on the request for each part of the response content received,
+ * if request->stream_content is TRUE. @chunk is only valid during the
+ * emission; "response-received" is still emitted at the end.
+ */
+	void (*response_chunk_received)(GebrCommHttpMsg *request, GebrCommHttpMsg *response, GString *chunk);
 };
 
 GebrCommHttpMsg *gebr_comm_http_msg_new(GebrCommHttpRequestType type, GebrCommHttpRequestMethod method);
@@ -92,6 +105,16 @@ void gebr_comm_http_msg_free(GebrCommHttpMsg *msg);
 
 void gebr_comm_http_msg_response_received(GebrCommHttpMsg *request, GebrCommHttpMsg *response);
 
+void gebr_comm_http_msg_response_chunk_received(GebrCommHttpMsg *request, GebrCommHttpMsg *response, GString *chunk);
+
+/**
+ * gebr_comm_http_msg_get_id:
+ *
+ * Returns: the value of the "request-id" header of @msg, which a response
+ * echoes from its request, or 0 if it has none.
+ */
+guint gebr_comm_http_msg_get_id(GebrCommHttpMsg *msg);
+
 G_END_DECLS
 
 #endif //__GEBR_COMM_HTTP_MSG_H
@@ -41,6 +41,10 @@
 struct _GebrCommPortForward {
 	GebrCommSsh *ssh;
 	gchar *address;
+
+	/* forwards made through a multiplexed connection */
+	gchar *control_path;
+	gchar *spec;
 };
 
 typedef enum {
@@ -83,6 +87,12 @@ static gboolean get_port_from_command_output(GebrCommPortProvider *self,
 
 static void create_local_forward(GebrCommPortProvider *self);
 
+static void create_local_forward_ssh(GebrCommPortProvider *self);
+
+static void create_x11_forward_ssh(GebrCommPortProvider *self);
+
+static gboolean release_ssh_object(gpointer data);
+
 GQuark
 gebr_comm_port_provider_error_quark(void)
 {
@@ -627,7 +637,7 @@ on_local_forward_ssh_error(GebrCommSsh *ssh, const gchar *msg, GebrCommPortProvi
 	if (g_strcmp0(msg, GEBR_COMM_SSH_ERROR_LOCAL_FORWARD) == 0) {
 		clear_forward(self);
 		self->priv->port = 0;
-		create_local_forward(self);
+		create_local_forward_ssh(self);
 	} else {
 		on_ssh_error(ssh, msg, self);
 	}
@@ -732,7 +742,7 @@ get_port_from_command_output(GebrCommPortProvider *self,
 }
 
 static void
-create_local_forward(GebrCommPortProvider *self)
+create_local_forward_ssh(GebrCommPortProvider *self)
 {
 	guint port;
 	gchar *command = get_local_forward_command(self, &port, "127.0.0.1", self->priv->remote_port);
@@ -756,6 +766,340 @@ create_local_forward(GebrCommPortProvider *self)
 	self->priv->port_timeout = g_timeout_add(200, tunnel_poll_port, data);
 }
 
+/* SSH connection multiplexing {{{ */
+/*
+ * Everything a provider runs on a host goes through a single ssh master
+ * connection: gebrd or gebrm is launched with "ssh -S", and the forward to
+ * its port is added with "ssh -O forward". This saves the key exchange and
+ * authentication of each ssh, and the forward is ready as soon as that
+ * command exits.
+ *
+ * The master is started with ControlPersist, so its foreground process
+ * exits once the user is authenticated and the control socket is created.
+ * The master is ready if the socket exists at that point. It lingers for
+ * SSH_MASTER_PERSIST after its last channel is closed.
+ *
+ * If the master cannot be created, or is gone when the launch returns,
+ * each ssh connects by itself, and the next launch tries to create the
+ * master again.
+ */
+#define SSH_MASTER_PERSIST "10m"
+
+typedef enum {
+	MASTER_STARTING,
+	MASTER_READY,
+	MASTER_FAILED,
+} SshMasterState;
+
+typedef struct {
+	SshMasterState state;
+	gchar *address;
+	gchar *control_path;
+
+	/* Authenticates and creates the control socket, then exits */
+	GebrCommSsh *ssh;
+
+	/* GebrCommPortProvider's waiting the master to be ready */
+	GList *waiting;
+
+	gboolean released; // Freed once its ssh exits
+} SshMaster;
+
+struct MuxForwardData {
+	GebrCommPortProvider *self;
+	GebrCommProcess *process;
+	gchar *control_path;
+	gchar *spec;
+	guint port;
+	GString *output;
+};
+
+static GHashTable *ssh_masters = NULL;
+
+static void forward_through_master(GebrCommPortProvider *self, SshMaster *master);
+
+static void launch_program(GebrCommPortProvider *self, SshMaster *master);
+
+static void
+forward_without_master(GebrCommPortProvider *self)
+{
+	if (self->priv->type == GEBR_COMM_PORT_TYPE_X11)
+		create_x11_forward_ssh(self);
+	else
+		create_local_forward_ssh(self);
+}
+
+/*
+ * Providers still in STATE_INIT wait to launch their program, the others
+ * wait to forward their port.
+ */
+static void
+ssh_master_flush(SshMaster *master)
+{
+	GList *waiting = master->waiting;
+	SshMaster *ready = master->state == MASTER_READY ? master : NULL;
+
+	master->waiting = NULL;
+
+	for (GList *i = waiting; i; i = i->next) {
+		GebrCommPortProvider *self = i->data;
+		if (self->priv->state == STATE_INIT)
+			launch_program(self, ready);
+		else if (ready)
+			forward_through_master(self, ready);
+		else
+			forward_without_master(self);
+		g_object_unref(self);
+	}
+	g_list_free(waiting);
+}
+
+static void
+ssh_master_free(SshMaster *master)
+{
+	g_free(master->address);
+	g_free(master->control_path);
+	g_free(master);
+}
+
+/*
+ * Forgets @master, so the next launch to its host creates another one.
+ */
+static void
+ssh_master_drop(SshMaster *master)
+{
+	if (g_hash_table_lookup(ssh_masters, master->address) == master)
+		g_hash_table_remove(ssh_masters, master->address);
+
+	if (master->ssh)
+		master->released = TRUE;
+	else
+		ssh_master_free(master);
+}
+
+/*
+ * The providers waiting for @master connect by themselves.
+ */
+static void
+ssh_master_fail(SshMaster *master)
+{
+	master->state = MASTER_FAILED;
+	ssh_master_flush(master);
+	ssh_master_drop(master);
+}
+
+static void
+on_ssh_master_error(GebrCommSsh *ssh, const gchar *msg, SshMaster *master)
+{
+	g_debug("Could not create a multiplexed connection to %s: %s", master->address, msg);
+
+	if (master->state == MASTER_STARTING) {
+		ssh_master_fail(master);
+		gebr_comm_ssh_kill(ssh);
+	}
+}
+
+static void
+on_ssh_master_finished(GebrCommSsh *ssh, SshMaster *master)
+{
+	g_idle_add(release_ssh_object, master->ssh);
+	master->ssh = NULL;
+
+	if (master->released) {
+		ssh_master_free(master);
+		return;
+	}
+
+	if (master->state != MASTER_STARTING)
+		return;
+
+	if (g_file_test(master->control_path, G_FILE_TEST_EXISTS)) {
+		master->state = MASTER_READY;
+		ssh_master_flush(master);
+	} else {
+		g_debug("Multiplexed connection to %s exited before its socket was created",
+			master->address);
+		ssh_master_fail(master);
+	}
+}
+
+/*
+ * Returns: the master connection to the host of @self, or %NULL if there is
+ * none and @create is %FALSE or no control socket can be created safely.
+ */
+static SshMaster *
+ssh_master_get(GebrCommPortProvider *self, gboolean create)
+{
+	SshMaster *master;
+
+	if (!ssh_masters)
+		ssh_masters = g_hash_table_new(g_str_hash, g_str_equal);
+
+	master = g_hash_table_lookup(ssh_masters, self->priv->address);
+
+	/* The master exits on its own after SSH_MASTER_PERSIST */
+	if (master && master->state == MASTER_READY
+	    && !g_file_test(master->control_path, G_FILE_TEST_EXISTS)) {
+		ssh_master_drop(master);
+		master = NULL;
+	}
+
+	if (master || !create)
+		return master;
+
+	gchar *control_path = gebr_comm_get_ssh_control_path(self->priv->address);
+	if (!control_path)
+		return NULL;
+
+	master = g_new0(SshMaster, 1);
+	master->state = MASTER_STARTING;
+	master->address = g_strdup(self->priv->address);
+	master->control_path = control_path;
+	g_hash_table_insert(ssh_masters, master->address, master);
+
+	gchar *ssh_cmd = gebr_comm_get_ssh_command_with_key(self->priv->check_host);
+	gchar *path = g_shell_quote(master->control_path);
+	gchar *command = g_strdup_printf("%s -x -M -S %s -o ControlPersist=%s -f -N %s",
+					 ssh_cmd, path, SSH_MASTER_PERSIST, self->priv->address);
+
+	/* The provider that created the master answers its questions */
+	master->ssh = gebr_comm_ssh_new();
+	g_signal_connect(master->ssh, "ssh-password", G_CALLBACK(on_ssh_password), self);
+	g_signal_connect(master->ssh, "ssh-question", G_CALLBACK(on_ssh_question), self);
+	g_signal_connect(master->ssh, "ssh-error", G_CALLBACK(on_ssh_master_error), master);
+	g_signal_connect(master->ssh, "ssh-finished", G_CALLBACK(on_ssh_master_finished), master);
+	gebr_comm_ssh_set_command(master->ssh, command);
+	gebr_comm_ssh_run(master->ssh);
+
+	g_free(ssh_cmd);
+	g_free(path);
+	g_free(command);
+
+	return master;
+}
+
+static void
+mux_forward_data_free(struct MuxForwardData *data)
+{
+	g_object_unref(data->self);
+	g_free(data->control_path);
+	g_free(data->spec);
+	g_string_free(data->output, TRUE);
+	g_free(data);
+}
+
+static gboolean
+release_process_object(gpointer data)
+{
+	gebr_comm_process_free(data);
+	return FALSE;
+}
+
+static void
+on_mux_forward_stdout(GebrCommProcess *process, struct MuxForwardData *data)
+{
+	GString *out = gebr_comm_process_read_stdout_string_all(process);
+	g_string_append(data->output, out->str);
+	g_string_free(out, TRUE);
+}
+
+static void
+on_mux_forward_finished(GebrCommProcess *process, gint status, struct MuxForwardData *data)
+{
+	GebrCommPortProvider *self = data->self;
+	guint port = data->port;
+
+	/* remote forwards with port 0 print the port allocated */
+	if (self->priv->type == GEBR_COMM_PORT_TYPE_X11)
+		port = atoi(data->output->str);
+
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || port == 0) {
+		g_debug("Multiplexed forward %s to %s failed", data->spec, self->priv->address);
+
+		SshMaster *master = ssh_masters ? g_hash_table_lookup(ssh_masters, self->priv->address) : NULL;
+		if (master && master->state == MASTER_READY
+		    && g_strcmp0(master->control_path, data->control_path) == 0)
+			ssh_master_drop(master);
+
+		self->priv->port = 0;
+		forward_without_master(self);
+	} else {
+		set_forward(self, NULL);
+		self->priv->forward->control_path = g_strdup(data->control_path);
+		self->priv->forward->spec = g_strdup(data->spec);
+		emit_signals(self, port, NULL);
+	}
+
+	g_idle_add(release_process_object, process);
+	mux_forward_data_free(data);
+}
+
+static void
+forward_through_master(GebrCommPortProvider *self, SshMaster *master)
+{
+	struct MuxForwardData *data = g_new0(struct MuxForwardData, 1);
+
+	data->self = g_object_ref(self);
+	data->control_path = g_strdup(master->control_path);
+	data->output = g_string_new(NULL);
+
+	if (self->priv->type == GEBR_COMM_PORT_TYPE_X11)
+		data->spec = g_strdup_printf("-R 0:127.0.0.1:%d", self->priv->display_port);
+	else {
+		data->port = get_port(self);
+		data->spec = g_strdup_printf("-L %d:127.0.0.1:%d", data->port, self->priv->remote_port);
+	}
+
+	gchar *path = g_shell_quote(master->control_path);
+	GString *command = g_string_new(NULL);
+	g_string_printf(command, "ssh -S %s -O forward %s %s", path, data->spec, self->priv->address);
+
+	data->process = gebr_comm_process_new();
+	g_signal_connect(data->process, "ready-read-stdout", G_CALLBACK(on_mux_forward_stdout), data);
+	g_signal_connect(data->process, "finished", G_CALLBACK(on_mux_forward_finished), data);
+	gebr_comm_process_start(data->process, command);
+
+	g_string_free(command, TRUE);
+	g_free(path);
+}
+
+/*
+ * Forwards the port of @self through the master of its host. Launches
+ * create the master, so @create is %FALSE after one: if the master is not
+ * up by then, the forward does not wait for another authentication.
+ */
+static void
+forward_with_master(GebrCommPortProvider *self, gboolean create)
+{
+	SshMaster *master = ssh_master_get(self, create);
+
+	self->priv->state = STATE_FORWARD;
+
+	if (!master) {
+		forward_without_master(self);
+		return;
+	}
+
+	switch (master->state) {
+	case MASTER_READY:
+		forward_through_master(self, master);
+		break;
+	case MASTER_STARTING:
+		master->waiting = g_list_append(master->waiting, g_object_ref(self));
+		break;
+	case MASTER_FAILED:
+		forward_without_master(self);
+		break;
+	}
+}
+
+static void
+create_local_forward(GebrCommPortProvider *self)
+{
+	forward_with_master(self, FALSE);
+}
+/* }}} */
+
 static void
 on_ssh_stdout(GebrCommSsh *_ssh, const GString *buffer, GebrCommPortProvider *self)
 {
@@ -779,9 +1123,14 @@ on_ssh_stdin(GebrCommSsh *ssh, GebrCommPortProvider *self)
 	g_free(tmp);
 }
 
+/*
+ * Returns: the command that launches gebrm or gebrd, through @master if
+ * not %NULL. If the master is gone by then, ssh connects by itself.
+ */
 static gchar *
-get_launch_command(GebrCommPortProvider *self, gboolean is_maestro)
+get_launch_command(GebrCommPortProvider *self, SshMaster *master)
 {
+	gboolean is_maestro = self->priv->type == GEBR_COMM_PORT_TYPE_MAESTRO;
 	const gchar *binary = is_maestro ? "gebrm" : "gebrd";
 	gboolean force_init = FALSE;
 
@@ -789,22 +1138,31 @@ get_launch_command(GebrCommPortProvider *self, gboolean is_maestro)
 		force_init = TRUE;
 
 	gchar *ssh_cmd = gebr_comm_get_ssh_command_with_key(self->priv->check_host);
+	gchar *mux = NULL;
+
+	if (master) {
+		gchar *path = g_shell_quote(master->control_path);
+		mux = g_strdup_printf(" -S %s", path);
+		g_free(path);
+	}
 
 	GString *cmd_line = g_string_new(NULL);
-	g_string_printf(cmd_line, "%s -v -x %s \"bash -l -c '%s%s'\"",
-	                ssh_cmd, self->priv->address, binary, force_init? " -f" : "");
+	g_string_printf(cmd_line, "%s -v -x%s %s \"bash -l -c '%s%s'\"",
+	                ssh_cmd, mux ? mux : "", self->priv->address,
+			binary, force_init? " -f" : "");
 	gchar *cmd = g_shell_quote(cmd_line->str);
 
 	g_string_printf(cmd_line, "bash -c %s", cmd);
 
 	g_free(cmd);
+	g_free(mux);
 	g_free(ssh_cmd);
 
 	return g_string_free(cmd_line, FALSE);
 }
 
-void
-remote_get_port(GebrCommPortProvider *self, gboolean is_maestro)
+static void
+launch_program(GebrCommPortProvider *self, SshMaster *master)
 {
 	GebrCommSsh *ssh = gebr_comm_ssh_new();
 	g_signal_connect(ssh, "ssh-password", G_CALLBACK(on_ssh_password), self);
@@ -814,12 +1172,31 @@ remote_get_port(GebrCommPortProvider *self, gboolean is_maestro)
 	g_signal_connect(ssh, "ssh-stdin", G_CALLBACK(on_ssh_stdin), self);
 	g_signal_connect(ssh, "ssh-key", G_CALLBACK(on_ssh_key), self);
 	g_signal_connect(ssh, "ssh-finished", G_CALLBACK(on_ssh_finished), self);
-	gchar *command = get_launch_command(self, is_maestro);
+	gchar *command = get_launch_command(self, master);
 	gebr_comm_ssh_set_command(ssh, command);
 	gebr_comm_ssh_run(ssh);
 	g_free(command);
 }
 
+/*
+ * Starts the master of the host first, so the program and the forward to
+ * its port go through it.
+ */
+void
+remote_get_port(GebrCommPortProvider *self, gboolean is_maestro)
+{
+	SshMaster *master = ssh_master_get(self, TRUE);
+
+	self->priv->state = STATE_INIT;
+
+	if (master && master->state == MASTER_STARTING) {
+		master->waiting = g_list_append(master->waiting, g_object_ref(self));
+		return;
+	}
+
+	launch_program(self, master);
+}
+
 void
 remote_get_maestro_port(GebrCommPortProvider *self)
 {
@@ -868,8 +1245,8 @@ on_ssh_x11_stdout(GebrCommSsh *ssh,
 	g_strfreev(parts);
 }
 
-void
-remote_get_x11_port(GebrCommPortProvider *self)
+static void
+create_x11_forward_ssh(GebrCommPortProvider *self)
 {
 	GebrCommSsh *ssh = gebr_comm_ssh_new();
 	g_signal_connect(ssh, "ssh-password", G_CALLBACK(on_ssh_password), self);
@@ -883,6 +1260,12 @@ remote_get_x11_port(GebrCommPortProvider *self)
 	g_free(command);
 }
 
+void
+remote_get_x11_port(GebrCommPortProvider *self)
+{
+	forward_with_master(self, TRUE);
+}
+
 static gchar *
 get_local_forward_command(GebrCommPortProvider *self,
 			  guint *port,
@@ -908,7 +1291,7 @@ remote_get_sftp_port(GebrCommPortProvider *self)
 	self->priv->remote_port = 22;
 	self->priv->remote_address = "127.0.0.1";
 
-	create_local_forward(self);
+	forward_with_master(self, TRUE);
 }
 
 /* Authentication keys methods*/
@@ -1012,6 +1395,17 @@ gebr_comm_port_forward_close(GebrCommPortForward *port_forward)
 		g_idle_add(release_ssh_object, port_forward->ssh);
 		port_forward->ssh = NULL;
 	}
+
+	if (port_forward->spec) {
+		gchar *path = g_shell_quote(port_forward->control_path);
+		gchar *command = g_strdup_printf("ssh -S %s -O cancel %s %s", path,
+						 port_forward->spec, port_forward->address);
+		g_spawn_command_line_async(command, NULL);
+		g_free(command);
+		g_free(path);
+		g_free(port_forward->spec);
+		port_forward->spec = NULL;
+	}
 }
 
 void
@@ -1021,6 +1415,8 @@ gebr_comm_port_forward_free(GebrCommPortForward *port_forward)
 		return;
 
 	g_free(port_forward->address);
+	g_free(port_forward->control_path);
+	g_free(port_forward->spec);
 	g_free(port_forward);
 }
 
@@ -304,8 +304,10 @@ gboolean gebr_comm_process_start(GebrCommProcess * process, GString * cmd_line)
 
 		if (execvp(argv[0], argv) == -1)
 			exit(0);
-	} else 
-	       setpgid(process->pid, getpgrp());	
+	} else
+		/* Same group as the child sets, whichever runs first, so the
+		 * flow can be signaled by its group */
+		setpgid(process->pid, process->pid);
 
 	close(stdin_pipe[0]);
 	close(stdout_pipe[1]);
@@ -372,6 +374,24 @@ void gebr_comm_process_terminate(GebrCommProcess * process)
 	killpg(process->pid, SIGTERM);
 }
 
+void gebr_comm_process_stop(GebrCommProcess * process)
+{
+	g_return_if_fail(GEBR_COMM_IS_PROCESS(process));
+
+	if (!process->pid)
+		return;
+	killpg(process->pid, SIGSTOP);
+}
+
+void gebr_comm_process_continue(GebrCommProcess * process)
+{
+	g_return_if_fail(GEBR_COMM_IS_PROCESS(process));
+
+	if (!process->pid)
+		return;
+	killpg(process->pid, SIGCONT);
+}
+
 void gebr_comm_process_close_stdin(GebrCommProcess * process)
 {
 	g_return_if_fail(GEBR_COMM_IS_PROCESS(process));
@@ -88,6 +88,13 @@ void gebr_comm_process_kill(GebrCommProcess *);
 
 void gebr_comm_process_terminate(GebrCommProcess *);
 
+/**
+ * Stops the process group of \p process, until gebr_comm_process_continue().
+ */
+void gebr_comm_process_stop(GebrCommProcess *);
+
+void gebr_comm_process_continue(GebrCommProcess *);
+
 void gebr_comm_process_close_stdin(GebrCommProcess *);
 
 gulong gebr_comm_process_stdout_bytes_available(GebrCommProcess *);
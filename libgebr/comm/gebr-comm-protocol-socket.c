@@ -42,8 +42,14 @@
 	(G_TYPE_INSTANCE_GET_PRIVATE((o), GEBR_COMM_PROTOCOL_SOCKET_TYPE, GebrCommProtocolSocketPrivate))
 struct _GebrCommProtocolSocketPrivate {
 	GebrCommHttpMsg *incoming_msg;
+	/* the request being answered by incoming_msg, once its headers arrive */
+	GebrCommHttpMsg *incoming_request;
+	/* the request being processed on "process-request" */
+	GebrCommHttpMsg *current_request;
 
+	/* requests waiting for a response, in the order they were sent */
 	GList *requests_fifo;
+	guint last_request_id;
 	GebrCommStreamSocket *socket;
 };
 enum {
@@ -74,30 +80,67 @@ static void gebr_comm_protocol_socket_disconnected(GebrCommStreamSocket *socket,
 }
 
 
+/*
+ * Removes from the pending requests the one answered by @response. Peers
+ * that don't echo the request id answer in the order requests were sent.
+ */
+static GebrCommHttpMsg *
+take_request_of_response(GebrCommProtocolSocket * self, GebrCommHttpMsg *response)
+{
+	GList *link = self->priv->requests_fifo;
+	guint id = gebr_comm_http_msg_get_id(response);
+
+	if (id)
+		while (link && gebr_comm_http_msg_get_id(link->data) != id)
+			link = link->next;
+	if (!link)
+		return NULL;
+
+	GebrCommHttpMsg *request = link->data;
+	self->priv->requests_fifo = g_list_delete_link(self->priv->requests_fifo, link);
+
+	return request;
+}
+
 static gboolean
 parse_http_msg(GebrCommProtocolSocket * self, GString *data)
 {
 	self->priv->incoming_msg = gebr_comm_http_msg_new_parsing(self->priv->incoming_msg, data);
 	if (!self->priv->incoming_msg)
 		return FALSE;
-	if (!self->priv->incoming_msg->parsed)
+
+	GebrCommHttpMsg *msg = self->priv->incoming_msg;
+
+	if (msg->type == GEBR_COMM_HTTP_TYPE_RESPONSE && msg->parsed_headers) {
+		if (!self->priv->incoming_request)
+			self->priv->incoming_request = take_request_of_response(self, msg);
+
+		GebrCommHttpMsg *request = self->priv->incoming_request;
+		if (request && request->stream_content && msg->content->len) {
+			gebr_comm_http_msg_response_chunk_received(request, msg, msg->content);
+			g_string_truncate(msg->content, 0);
+			g_string_truncate(msg->raw, 0);
+		}
+	}
+
+	if (!msg->parsed)
 		return TRUE; /* more data need... */
 
-	if (self->priv->incoming_msg->type == GEBR_COMM_HTTP_TYPE_REQUEST)
-		g_signal_emit(self, object_signals[PROCESS_REQUEST], 0, self->priv->incoming_msg);
-	else if (self->priv->incoming_msg->type == GEBR_COMM_HTTP_TYPE_RESPONSE) {
-		if (self->priv->requests_fifo != NULL) {
-			GebrCommHttpMsg *request = (GebrCommHttpMsg*)self->priv->requests_fifo->data;
-			GebrCommHttpMsg *response = self->priv->incoming_msg;
-			g_signal_emit(self, object_signals[PROCESS_RESPONSE], 0, request, response);
-			gebr_comm_http_msg_response_received(request, response);
+	if (msg->type == GEBR_COMM_HTTP_TYPE_REQUEST) {
+		self->priv->current_request = msg;
+		g_signal_emit(self, object_signals[PROCESS_REQUEST], 0, msg);
+		self->priv->current_request = NULL;
+	} else if (msg->type == GEBR_COMM_HTTP_TYPE_RESPONSE) {
+		GebrCommHttpMsg *request = self->priv->incoming_request;
+		if (request != NULL) {
+			g_signal_emit(self, object_signals[PROCESS_RESPONSE], 0, request, msg);
+			gebr_comm_http_msg_response_received(request, msg);
 			gebr_comm_http_msg_free(request);
-
-			self->priv->requests_fifo = g_list_remove_link(self->priv->requests_fifo, self->priv->requests_fifo);
 		}
 	}
 	gebr_comm_http_msg_free(self->priv->incoming_msg);
 	self->priv->incoming_msg = NULL;
+	self->priv->incoming_request = NULL;
 
 	return TRUE;
 }
@@ -114,6 +157,19 @@ parse_old_msg(GebrCommProtocolSocket * self, GString *data)
 	return ret;
 }
 
+static gboolean
+parse_binary_msg(GebrCommProtocolSocket * self, GString *data)
+{
+	gboolean ret;
+	guint n_messages = g_list_length(self->protocol->messages);
+
+	ret = gebr_comm_protocol_receive_binary_data(self->protocol, data);
+	if (g_list_length(self->protocol->messages) != n_messages)
+		g_signal_emit(self, object_signals[OLD_PARSE_MESSAGES], 0);
+
+	return ret;
+}
+
 static void gebr_comm_protocol_socket_read(GebrCommStreamSocket *socket, GebrCommProtocolSocket * self)
 {
 	GString *data = gebr_comm_socket_read_string_all(GEBR_COMM_SOCKET(socket));
@@ -126,6 +182,9 @@ static void gebr_comm_protocol_socket_read(GebrCommStreamSocket *socket, GebrCom
 		gboolean ret;
 		if (self->protocol->message->hash)
 			ret = parse_old_msg(self, data);
+		else if (self->protocol->data->len ||
+			 (guchar)data->str[0] == GEBR_COMM_PROTOCOL_BINARY_MAGIC)
+			ret = parse_binary_msg(self, data);
 		else if (self->priv->incoming_msg != NULL)
 			ret = parse_http_msg(self, data);
 		else if (g_str_has_prefix(data->str, "HTTP/1.1 ") ||
@@ -148,7 +207,10 @@ static void gebr_comm_protocol_socket_init(GebrCommProtocolSocket * self)
 	self->protocol = gebr_comm_protocol_new();
 	self->priv = GEBR_COMM_PROTOCOL_SOCKET_GET_PRIVATE(self);
 	self->priv->incoming_msg = NULL;
+	self->priv->incoming_request = NULL;
+	self->priv->current_request = NULL;
 	self->priv->requests_fifo = NULL;
+	self->priv->last_request_id = 0;
 }
 static void gebr_comm_protocol_socket_finalize(GObject * object)
 {
@@ -157,6 +219,7 @@ static void gebr_comm_protocol_socket_finalize(GObject * object)
 	gebr_comm_protocol_free(self->protocol);
 	gebr_comm_socket_close(GEBR_COMM_SOCKET(self->priv->socket));
 	gebr_comm_http_msg_free(self->priv->incoming_msg);
+	gebr_comm_http_msg_free(self->priv->incoming_request);
 	g_list_foreach(self->priv->requests_fifo, (GFunc)gebr_comm_http_msg_free, NULL);
 	g_list_free(self->priv->requests_fifo);
 
@@ -263,9 +326,11 @@ gebr_comm_protocol_socket_send_request(GebrCommProtocolSocket * self,
 	gebr_comm_return_val_if_not_connected(self, NULL);
 
 	const gchar *content = _content ? _content->data->str : "";
-	GHashTable *headers = g_hash_table_new(g_str_hash, g_str_equal);
+	GHashTable *headers = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	if (content)
 	       g_hash_table_insert(headers, g_strdup("content-type"), g_strdup("application/json"));
+	/* lets the response be matched even if other requests are answered first */
+	g_hash_table_insert(headers, g_strdup("request-id"), g_strdup_printf("%u", ++self->priv->last_request_id));
 	GebrCommHttpMsg *msg = gebr_comm_http_msg_new_request(method, url, headers, content);
 	g_hash_table_unref(headers);
 
@@ -276,13 +341,22 @@ gebr_comm_protocol_socket_send_request(GebrCommProtocolSocket * self,
 }
 
 void gebr_comm_protocol_socket_send_response(GebrCommProtocolSocket * self, int status_code, GebrCommJsonContent *_content)
+{
+	gebr_comm_protocol_socket_send_response_to(self, self->priv->current_request, status_code, _content);
+}
+
+void gebr_comm_protocol_socket_send_response_to(GebrCommProtocolSocket * self, GebrCommHttpMsg *request,
+						int status_code, GebrCommJsonContent *_content)
 {
 	gebr_comm_return_if_not_connected(self);
 
 	const gchar *content = _content ? _content->data->str : "";
-	GHashTable *headers = g_hash_table_new(g_str_hash, g_str_equal);
+	GHashTable *headers = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	if (content)
 	       g_hash_table_insert(headers, g_strdup("content-type"), g_strdup("application/json"));
+	if (request && gebr_comm_http_msg_get_id(request))
+		g_hash_table_insert(headers, g_strdup("request-id"),
+				    g_strdup_printf("%u", gebr_comm_http_msg_get_id(request)));
 	GebrCommHttpMsg *msg = gebr_comm_http_msg_new_response(status_code, headers, content);
 	g_hash_table_unref(headers);
 
@@ -297,23 +371,9 @@ gebr_comm_protocol_socket_resend_message(GebrCommProtocolSocket *self,
 {
 	gebr_comm_return_if_not_connected(self);
 
-	struct gebr_comm_message_def *def =
-		g_hash_table_lookup(gebr_comm_protocol_defs.code_hash_table,
-				    GUINT_TO_POINTER(message->hash));
-	GString *message_str = g_string_new(NULL);
-
-	gchar *head;
-	if (message->hash != gebr_comm_protocol_defs.ret_def.code_hash) {
-		head = g_strdup(def->code);
-	} else {
-		struct gebr_comm_message_def *ret_msg =
-			g_hash_table_lookup(gebr_comm_protocol_defs.code_hash_table,
-					    GUINT_TO_POINTER(message->ret_hash));
-		head = g_strdup_printf("%s:%s", def->code,
-				       ret_msg->code);
-	}
-
-	g_string_printf(message_str, "%s %"G_GSIZE_FORMAT" %s\n", head, message->argument_size, message->argument->str);
+	GString *message_str = gebr_comm_protocol_rebuild_message(message, self->protocol->framing);
+	if (!message_str)
+		return;
 
 	/* send it */
 	if (blocking)
@@ -322,7 +382,6 @@ gebr_comm_protocol_socket_resend_message(GebrCommProtocolSocket *self,
 		gebr_comm_socket_write_string(GEBR_COMM_SOCKET(self->priv->socket), message_str);
 
 	g_string_free(message_str, TRUE);
-	g_free(head);
 }
 
 void
@@ -337,7 +396,7 @@ gebr_comm_protocol_socket_return_message(GebrCommProtocolSocket * self,
 	gebr_comm_return_if_not_connected(self);
 
 	va_start(ap, n_params);
-	message = gebr_comm_protocol_build_any_messagev(ret_msg, TRUE, n_params, ap);
+	message = gebr_comm_protocol_build_framed_messagev(ret_msg, TRUE, self->protocol->framing, n_params, ap);
 
 	/* send it */
 	if (blocking)
@@ -357,7 +416,7 @@ void gebr_comm_protocol_socket_oldmsg_send(GebrCommProtocolSocket * self, gboole
 	gebr_comm_return_if_not_connected(self);
 
 	va_start(ap, n_params);
-	message = gebr_comm_protocol_build_messagev(gebr_comm_message_def, n_params, ap);
+	message = gebr_comm_protocol_build_framed_messagev(gebr_comm_message_def, FALSE, self->protocol->framing, n_params, ap);
 
 	/* send it */
 	if (blocking)
@@ -71,8 +71,20 @@ void gebr_comm_protocol_socket_disconnect(GebrCommProtocolSocket * self);
 GebrCommHttpMsg *gebr_comm_protocol_socket_send_request(GebrCommProtocolSocket * self, GebrCommHttpRequestMethod method,
 							const gchar *url, GebrCommJsonContent *content);
 
+/**
+ * Answers the request being processed on "process-request", echoing its
+ * "request-id" header.
+ */
 void gebr_comm_protocol_socket_send_response(GebrCommProtocolSocket * self, int status_code, GebrCommJsonContent *content);
 
+/**
+ * Answers @request, which may have been received earlier. Keep a reference
+ * to @request to answer it after "process-request" returns, so other
+ * requests can be answered meanwhile.
+ */
+void gebr_comm_protocol_socket_send_response_to(GebrCommProtocolSocket * self, GebrCommHttpMsg *request,
+						int status_code, GebrCommJsonContent *content);
+
 void gebr_comm_protocol_socket_resend_message(GebrCommProtocolSocket *self,
 					      gboolean blocking,
 					      struct gebr_comm_message *message);
@@ -36,9 +36,165 @@ void gebr_comm_protocol_split_free_each(GString * string)
 	g_string_free(string, TRUE);
 }
 
+static void gebr_comm_protocol_register_def(struct gebr_comm_message_def *def)
+{
+	def->type_id = gebr_comm_protocol_defs.type_id_table->len;
+	g_ptr_array_add(gebr_comm_protocol_defs.type_id_table, def);
+	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)def->code, def);
+	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(def->code_hash), def);
+}
+
+static void append_varint(GString *string, gsize value)
+{
+	while (value >= 0x80) {
+		g_string_append_c(string, (gchar)((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	g_string_append_c(string, (gchar)value);
+}
+
 /*
- * Public functions
+ * Reads a varint from @iter, not going past @end.
+ * Returns FALSE if the varint is incomplete or too big.
  */
+static gboolean read_varint(const gchar **iter, const gchar *end, gsize *value)
+{
+	guint shift = 0;
+
+	*value = 0;
+	while (*iter < end) {
+		guchar byte = (guchar)**iter;
+		(*iter)++;
+		*value |= ((gsize)(byte & 0x7f)) << shift;
+		if (!(byte & 0x80))
+			return TRUE;
+		shift += 7;
+		if (shift >= sizeof(gsize) * 8)
+			return FALSE;
+	}
+
+	return FALSE;
+}
+
+/*
+ * Assemble a message from @params, either in the text framing
+ * "CODE size len|arg len|arg...\n" or in the binary framing
+ * "MAGIC flags type_id varint(size) varint(argc) [varint(len) arg]...".
+ */
+static GString *build_frame(struct gebr_comm_message_def *msg_def, gboolean is_return, gint framing,
+			    guint n_params, const gchar **params, const gsize *lens)
+{
+	GString *data;
+	GString *message;
+
+	data = g_string_new(NULL);
+	message = g_string_new(NULL);
+
+	if (framing == GEBR_COMM_PROTOCOL_FRAMING_BINARY) {
+		append_varint(data, n_params);
+		for (guint i = 0; i < n_params; ++i) {
+			append_varint(data, lens[i]);
+			g_string_append_len(data, params[i], lens[i]);
+		}
+
+		g_string_append_c(message, (gchar)GEBR_COMM_PROTOCOL_BINARY_MAGIC);
+		g_string_append_c(message, is_return ? GEBR_COMM_PROTOCOL_BINARY_FLAG_RETURN : 0);
+		g_string_append_c(message, (gchar)msg_def->type_id);
+		append_varint(message, data->len);
+		g_string_append_len(message, data->str, data->len);
+	} else {
+		for (guint i = 0; i < n_params; ++i) {
+			g_string_append_printf(data, "%zu|", lens[i]);
+			g_string_append_len(data, params[i], lens[i]);
+			if (i != n_params - 1)
+				g_string_append_c(data, ' ');
+		}
+
+		if (!is_return)
+			g_string_append(message, msg_def->code);
+		else
+			g_string_append_printf(message, "%s:%s", gebr_comm_protocol_defs.ret_def.code, msg_def->code);
+		g_string_append_printf(message, " %zu ", data->len);
+		g_string_append_len(message, data->str, data->len);
+		g_string_append_c(message, '\n');
+	}
+
+	g_string_free(data, TRUE);
+
+	return message;
+}
+
+static gboolean is_binary_argument(GString *arguments)
+{
+	return arguments->len && (guchar)arguments->str[0] == GEBR_COMM_PROTOCOL_BINARY_MAGIC;
+}
+
+/*
+ * Splits a binary argument, which is the payload of a binary frame prefixed
+ * with GEBR_COMM_PROTOCOL_BINARY_MAGIC, into @split. If @parts is negative,
+ * all arguments are split. Returns FALSE if @arguments is malformed.
+ */
+static gboolean split_binary(GString *arguments, gint parts, GList **split)
+{
+	const gchar *iter = arguments->str + 1;
+	const gchar *end = arguments->str + arguments->len;
+	gsize argc;
+
+	*split = NULL;
+	if (!read_varint(&iter, end, &argc))
+		return FALSE;
+	if (parts < 0)
+		parts = argc;
+	if (argc < (gsize)parts)
+		return FALSE;
+
+	for (gint i = 0; i < parts; ++i) {
+		gsize len;
+
+		if (!read_varint(&iter, end, &len) || (gsize)(end - iter) < len) {
+			gebr_comm_protocol_split_free(*split);
+			*split = NULL;
+			return FALSE;
+		}
+		*split = g_list_prepend(*split, g_string_new_len(iter, len));
+		iter += len;
+	}
+	*split = g_list_reverse(*split);
+
+	return TRUE;
+}
+
+/*
+ * Splits all the arguments of a text message into @split.
+ * Returns FALSE if @arguments is malformed.
+ */
+static gboolean split_text_all(GString *arguments, GList **split)
+{
+	const gchar *iarg = arguments->str;
+	const gchar *end = arguments->str + arguments->len;
+
+	*split = NULL;
+	while (iarg < end) {
+		gchar *sep;
+		gsize arg_size = strtoul(iarg, &sep, 10);
+
+		if (*sep != '|' || (gsize)(end - sep - 1) < arg_size) {
+			gebr_comm_protocol_split_free(*split);
+			*split = NULL;
+			return FALSE;
+		}
+		sep++;
+		*split = g_list_prepend(*split, g_string_new_len(sep, arg_size));
+
+		/* jump space between args */
+		iarg = sep + arg_size;
+		if (iarg < end)
+			iarg++;
+	}
+	*split = g_list_reverse(*split);
+
+	return TRUE;
+}
 
 void gebr_comm_protocol_init(void)
 {
@@ -82,86 +238,78 @@ void gebr_comm_protocol_init(void)
 	gebr_comm_protocol_defs.harakiri_def = gebr_comm_message_def_create("HRK", FALSE, 0);
 	gebr_comm_protocol_defs.dsp_def = gebr_comm_message_def_create("DSP", FALSE, 0);
 	gebr_comm_protocol_defs.sftp_def = gebr_comm_message_def_create("SFTP", TRUE, 0);
-
-	/* hashes them */
+	gebr_comm_protocol_defs.tlm_def = gebr_comm_message_def_create("TLM", FALSE, 5);
+	gebr_comm_protocol_defs.eta_def = gebr_comm_message_def_create("ETA", FALSE, 2);
+	gebr_comm_protocol_defs.scl_def = gebr_comm_message_def_create("SCL", FALSE, 3);
+	gebr_comm_protocol_defs.mem_def = gebr_comm_message_def_create("MEM", FALSE, 4);
+	gebr_comm_protocol_defs.kfr_def = gebr_comm_message_def_create("KFR", FALSE, 2);
+	gebr_comm_protocol_defs.cur_def = gebr_comm_message_def_create("CUR", FALSE, 2);
+	gebr_comm_protocol_defs.otr_def = gebr_comm_message_def_create("OTR", FALSE, 5);
+	gebr_comm_protocol_defs.bwd_def = gebr_comm_message_def_create("BWD", FALSE, 2);
+	gebr_comm_protocol_defs.hld_def = gebr_comm_message_def_create("HLD", FALSE, 3);
+	gebr_comm_protocol_defs.pre_def = gebr_comm_message_def_create("PRE", FALSE, 3);
+	gebr_comm_protocol_defs.spl_def = gebr_comm_message_def_create("SPL", FALSE, 2);
+	gebr_comm_protocol_defs.itr_def = gebr_comm_message_def_create("ITR", FALSE, 3);
+
+	/* hashes them; the registration order gives the binary framing type ids,
+	 * so new messages must be appended */
 	gebr_comm_protocol_defs.hash_table = g_hash_table_new(g_str_hash, g_str_equal);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.ret_def.code,  &gebr_comm_protocol_defs.ret_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.err_def.code,  &gebr_comm_protocol_defs.err_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.ini_def.code,  &gebr_comm_protocol_defs.ini_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.qut_def.code,  &gebr_comm_protocol_defs.qut_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.lst_def.code,  &gebr_comm_protocol_defs.lst_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.job_def.code,  &gebr_comm_protocol_defs.job_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.run_def.code,  &gebr_comm_protocol_defs.run_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.rnq_def.code,  &gebr_comm_protocol_defs.rnq_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.flw_def.code,  &gebr_comm_protocol_defs.flw_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.clr_def.code,  &gebr_comm_protocol_defs.clr_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.end_def.code,  &gebr_comm_protocol_defs.end_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.jcl_def.code,  &gebr_comm_protocol_defs.jcl_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.kil_def.code,  &gebr_comm_protocol_defs.kil_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.out_def.code,  &gebr_comm_protocol_defs.out_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.sta_def.code,  &gebr_comm_protocol_defs.sta_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.gid_def.code,  &gebr_comm_protocol_defs.gid_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.prt_def.code,  &gebr_comm_protocol_defs.prt_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.ssta_def.code, &gebr_comm_protocol_defs.ssta_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.srm_def.code, &gebr_comm_protocol_defs.srm_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.cfrm_def.code, &gebr_comm_protocol_defs.cfrm_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.path_def.code, &gebr_comm_protocol_defs.path_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.home_def.code, &gebr_comm_protocol_defs.home_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.nfsid_def.code, &gebr_comm_protocol_defs.nfsid_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.mpi_def.code, &gebr_comm_protocol_defs.mpi_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.ac_def.code, &gebr_comm_protocol_defs.ac_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.agrp_def.code, &gebr_comm_protocol_defs.agrp_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.dgrp_def.code, &gebr_comm_protocol_defs.dgrp_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.tsk_def.code, &gebr_comm_protocol_defs.tsk_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.iss_def.code, &gebr_comm_protocol_defs.iss_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.cmd_def.code, &gebr_comm_protocol_defs.cmd_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.pss_def.code, &gebr_comm_protocol_defs.pss_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.qst_def.code, &gebr_comm_protocol_defs.qst_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.harakiri_def.code, &gebr_comm_protocol_defs.harakiri_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.dsp_def.code, &gebr_comm_protocol_defs.dsp_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.hash_table, (gpointer)gebr_comm_protocol_defs.sftp_def.code, &gebr_comm_protocol_defs.sftp_def);
-
 	gebr_comm_protocol_defs.code_hash_table = g_hash_table_new(NULL, NULL);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.ret_def.code_hash),  &gebr_comm_protocol_defs.ret_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.err_def.code_hash),  &gebr_comm_protocol_defs.err_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.ini_def.code_hash),  &gebr_comm_protocol_defs.ini_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.qut_def.code_hash),  &gebr_comm_protocol_defs.qut_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.lst_def.code_hash),  &gebr_comm_protocol_defs.lst_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.job_def.code_hash),  &gebr_comm_protocol_defs.job_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.run_def.code_hash),  &gebr_comm_protocol_defs.run_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.rnq_def.code_hash),  &gebr_comm_protocol_defs.rnq_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.flw_def.code_hash),  &gebr_comm_protocol_defs.flw_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.clr_def.code_hash),  &gebr_comm_protocol_defs.clr_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.end_def.code_hash),  &gebr_comm_protocol_defs.end_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.jcl_def.code_hash),  &gebr_comm_protocol_defs.jcl_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.kil_def.code_hash),  &gebr_comm_protocol_defs.kil_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.out_def.code_hash),  &gebr_comm_protocol_defs.out_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.sta_def.code_hash),  &gebr_comm_protocol_defs.sta_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.gid_def.code_hash),  &gebr_comm_protocol_defs.gid_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.prt_def.code_hash),  &gebr_comm_protocol_defs.prt_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.ssta_def.code_hash), &gebr_comm_protocol_defs.ssta_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.srm_def.code_hash), &gebr_comm_protocol_defs.srm_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.cfrm_def.code_hash), &gebr_comm_protocol_defs.cfrm_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.path_def.code_hash), &gebr_comm_protocol_defs.path_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.home_def.code_hash), &gebr_comm_protocol_defs.home_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.nfsid_def.code_hash), &gebr_comm_protocol_defs.nfsid_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.mpi_def.code_hash), &gebr_comm_protocol_defs.mpi_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.ac_def.code_hash), &gebr_comm_protocol_defs.ac_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.agrp_def.code_hash), &gebr_comm_protocol_defs.agrp_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.dgrp_def.code_hash), &gebr_comm_protocol_defs.dgrp_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.tsk_def.code_hash), &gebr_comm_protocol_defs.tsk_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.iss_def.code_hash), &gebr_comm_protocol_defs.iss_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.cmd_def.code_hash), &gebr_comm_protocol_defs.cmd_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.pss_def.code_hash), &gebr_comm_protocol_defs.pss_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.qst_def.code_hash), &gebr_comm_protocol_defs.qst_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.harakiri_def.code_hash), &gebr_comm_protocol_defs.harakiri_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.dsp_def.code_hash), &gebr_comm_protocol_defs.dsp_def);
-	g_hash_table_insert(gebr_comm_protocol_defs.code_hash_table, GUINT_TO_POINTER(gebr_comm_protocol_defs.sftp_def.code_hash), &gebr_comm_protocol_defs.sftp_def);
+	gebr_comm_protocol_defs.type_id_table = g_ptr_array_new();
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.ret_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.err_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.ini_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.qut_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.lst_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.job_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.run_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.rnq_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.flw_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.clr_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.end_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.jcl_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.kil_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.out_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.sta_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.gid_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.prt_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.ssta_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.srm_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.cfrm_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.path_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.home_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.nfsid_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.mpi_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.ac_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.agrp_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.dgrp_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.tsk_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.iss_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.cmd_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.pss_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.qst_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.harakiri_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.dsp_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.sftp_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.tlm_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.eta_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.scl_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.mem_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.kfr_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.cur_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.otr_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.bwd_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.hld_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.pre_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.spl_def);
+	gebr_comm_protocol_register_def(&gebr_comm_protocol_defs.itr_def);
 }
 
 void gebr_comm_protocol_destroy(void)
 {
 	g_hash_table_unref(gebr_comm_protocol_defs.hash_table);
+	g_hash_table_unref(gebr_comm_protocol_defs.code_hash_table);
+	g_ptr_array_free(gebr_comm_protocol_defs.type_id_table, TRUE);
 } 
 
 struct gebr_comm_message *gebr_comm_message_new(void)
@@ -203,6 +351,7 @@ void gebr_comm_protocol_reset(struct gebr_comm_protocol *protocol)
 {
 	g_string_assign(protocol->data, "");
 	protocol->logged = FALSE;
+	protocol->framing = GEBR_COMM_PROTOCOL_FRAMING_TEXT;
 
 	gebr_comm_message_free(protocol->message);
 	protocol->message = gebr_comm_message_new();
@@ -317,34 +466,128 @@ GString * gebr_comm_protocol_build_messagev(struct gebr_comm_message_def msg_def
 
 GString *gebr_comm_protocol_build_any_messagev(struct gebr_comm_message_def msg_def, gboolean is_return, guint n_params, va_list ap)
 {
-	GString * data;
-	GString * message;
+	return gebr_comm_protocol_build_framed_messagev(msg_def, is_return, GEBR_COMM_PROTOCOL_FRAMING_TEXT, n_params, ap);
+}
 
-	/* very little code, but very interesting functionality ;) */
-	data = g_string_new(NULL);
-	for (guint i = 1; i <= n_params; ++i) {
-		gchar *param;
-		param = va_arg(ap, char *);
-		if (!param)
-			param = "";
-		g_string_append_printf(data, (i != n_params) ? "%zu|%s " : "%zu|%s", strlen(param), param);
+GString *gebr_comm_protocol_build_framed_messagev(struct gebr_comm_message_def msg_def, gboolean is_return, gint framing, guint n_params, va_list ap)
+{
+	const gchar *params[n_params + 1];
+	gsize lens[n_params + 1];
+
+	for (guint i = 0; i < n_params; ++i) {
+		params[i] = va_arg(ap, char *);
+		if (!params[i])
+			params[i] = "";
+		lens[i] = strlen(params[i]);
 	}
 	va_end(ap);
 
-	/* assembly message */
-	message = g_string_new(NULL);
+	return build_frame(&msg_def, is_return, framing, n_params, params, lens);
+}
+
+GString *gebr_comm_protocol_rebuild_message(struct gebr_comm_message *message, gint framing)
+{
+	struct gebr_comm_message_def *def;
+	gboolean is_return = message->hash == gebr_comm_protocol_defs.ret_def.code_hash;
+
+	def = g_hash_table_lookup(gebr_comm_protocol_defs.code_hash_table,
+				  GUINT_TO_POINTER(is_return ? message->ret_hash : message->hash));
+	if (!def)
+		return NULL;
 
-	gchar *head;
-	if (!is_return)
-		head = g_strdup(msg_def.code);
+	if (!is_binary_argument(message->argument) && framing == GEBR_COMM_PROTOCOL_FRAMING_TEXT) {
+		GString *message_str = g_string_new(NULL);
+		if (is_return)
+			g_string_printf(message_str, "%s:%s", gebr_comm_protocol_defs.ret_def.code, def->code);
+		else
+			g_string_assign(message_str, def->code);
+		g_string_append_printf(message_str, " %"G_GSIZE_FORMAT" ", message->argument->len);
+		g_string_append_len(message_str, message->argument->str, message->argument->len);
+		g_string_append_c(message_str, '\n');
+		return message_str;
+	}
+
+	/* convert between framings going through the arguments */
+	GList *split;
+	gboolean ok;
+	if (is_binary_argument(message->argument))
+		ok = split_binary(message->argument, -1, &split);
 	else
-		head = g_strdup_printf("%s:%s", gebr_comm_protocol_defs.ret_def.code, msg_def.code);
+		ok = split_text_all(message->argument, &split);
+	if (!ok)
+		return NULL;
 
-	g_string_printf(message, "%s %zu %s\n", head, data->len, data->str);
-	g_string_free(data, TRUE);
-	g_free(head);
+	guint n_params = g_list_length(split);
+	const gchar *params[n_params + 1];
+	gsize lens[n_params + 1];
+	guint i = 0;
+	for (GList *j = split; j; j = j->next, i++) {
+		params[i] = ((GString *)j->data)->str;
+		lens[i] = ((GString *)j->data)->len;
+	}
 
-	return message;
+	GString *message_str = build_frame(def, is_return, framing, n_params, params, lens);
+	gebr_comm_protocol_split_free(split);
+
+	return message_str;
+}
+
+gboolean gebr_comm_protocol_receive_binary_data(struct gebr_comm_protocol *protocol, GString * data)
+{
+	/* protocol->data keeps the bytes of an incomplete frame */
+	g_string_append_len(protocol->data, data->str, data->len);
+	g_string_truncate(data, 0);
+
+	while (protocol->data->len) {
+		const gchar *iter = protocol->data->str;
+		const gchar *end = protocol->data->str + protocol->data->len;
+		struct gebr_comm_message_def *def;
+		struct gebr_comm_message *message;
+		gsize size;
+		guint8 flags, type_id;
+
+		/* not a binary frame, give it back to the text parsers */
+		if ((guchar)*iter != GEBR_COMM_PROTOCOL_BINARY_MAGIC) {
+			g_string_append_len(data, protocol->data->str, protocol->data->len);
+			g_string_truncate(protocol->data, 0);
+			break;
+		}
+		if (end - iter < 4)
+			break;
+
+		flags = (guint8)iter[1];
+		type_id = (guint8)iter[2];
+		iter += 3;
+		if (!read_varint(&iter, end, &size)) {
+			if (iter < end)
+				goto err; /* too big */
+			break; /* more data needed */
+		}
+		if ((gsize)(end - iter) < size)
+			break; /* more data needed */
+
+		if (type_id >= gebr_comm_protocol_defs.type_id_table->len)
+			goto err;
+		def = g_ptr_array_index(gebr_comm_protocol_defs.type_id_table, type_id);
+
+		message = gebr_comm_message_new();
+		if (flags & GEBR_COMM_PROTOCOL_BINARY_FLAG_RETURN) {
+			message->hash = gebr_comm_protocol_defs.ret_def.code_hash;
+			message->ret_hash = def->code_hash;
+		} else
+			message->hash = def->code_hash;
+		g_string_append_c(message->argument, (gchar)GEBR_COMM_PROTOCOL_BINARY_MAGIC);
+		g_string_append_len(message->argument, iter, size);
+		message->argument_size = message->argument->len;
+		protocol->messages = g_list_prepend(protocol->messages, message);
+
+		g_string_erase(protocol->data, 0, (iter - protocol->data->str) + size);
+	}
+
+	return TRUE;
+
+err:	g_string_truncate(protocol->data, 0);
+	return FALSE;
 }
 
 GString * gebr_comm_protocol_build_message(struct gebr_comm_message_def msg_def, guint n_params, ...)
@@ -361,6 +604,11 @@ GList *gebr_comm_protocol_split_new(GString * arguments, guint parts)
 
 	/* TODO: use static array instead of a GList */
 
+	if (is_binary_argument(arguments)) {
+		split_binary(arguments, parts, &split);
+		return split;
+	}
+
 	iarg = arguments->str;
 	split = NULL;
 	for (guint i = 0; i < parts; ++i) {
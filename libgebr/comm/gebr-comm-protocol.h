@@ -31,8 +31,13 @@ struct gebr_comm_message_def {
 	const gchar *	code;
 	gboolean	returns; // does this message send return (RET) command?
 	gint		arg_number;
+	guint8		type_id; // index used by the binary framing, assigned on gebr_comm_protocol_init()
 };
 
+/* Framing used to send messages, negotiated on INI */
+#define GEBR_COMM_PROTOCOL_FRAMING_TEXT		1
+#define GEBR_COMM_PROTOCOL_FRAMING_BINARY	2
+
 enum {
 	GEBR_COMM_PROTOCOL_PATH_CREATE,
 	GEBR_COMM_PROTOCOL_PATH_RENAME,
@@ -49,6 +54,7 @@ typedef enum {
 struct gebr_comm_protocol_defs {
 	GHashTable *hash_table;
 	GHashTable *code_hash_table;
+	GPtrArray *type_id_table;
 
 	/* messages identifiers hashes */
 	struct gebr_comm_message_def ret_def;
@@ -94,6 +100,18 @@ struct gebr_comm_protocol_defs {
 	struct gebr_comm_message_def harakiri_def;// Asks daemon to die Maestro -> Daemon
 	struct gebr_comm_message_def dsp_def;   // Display info         Gebr    -> Maestro & Maestro -> Daemon
 	struct gebr_comm_message_def sftp_def;
+	struct gebr_comm_message_def tlm_def;   // Telemetry            Daemon  -> Maestro
+	struct gebr_comm_message_def eta_def;   // Job time estimate    Maestro -> GeBR
+	struct gebr_comm_message_def scl_def;   // Job scaling curve    Maestro -> GeBR
+	struct gebr_comm_message_def mem_def;   // Task memory and cpu  Daemon  -> Maestro
+	struct gebr_comm_message_def kfr_def;   // Kill one task        Maestro -> Daemon
+	struct gebr_comm_message_def cur_def;   // Job events cursor    Maestro -> GeBR
+	struct gebr_comm_message_def otr_def;   // Task output page     Maestro -> GeBR
+	struct gebr_comm_message_def bwd_def;   // Storage bandwidth    Daemon  -> Maestro
+	struct gebr_comm_message_def hld_def;   // Job held in queue    Maestro -> GeBR
+	struct gebr_comm_message_def pre_def;   // Preempt one task     Maestro -> Daemon
+	struct gebr_comm_message_def spl_def;   // Stop a task early    Maestro -> Daemon
+	struct gebr_comm_message_def itr_def;   // Iterations done      Daemon  -> Maestro
 };
 
 struct gebr_comm_message {
@@ -113,6 +131,8 @@ struct gebr_comm_protocol {
 	gboolean logged;
 	/* if we are logged, we received a host name from the peer */
 	GString *hostname;
+	/* GEBR_COMM_PROTOCOL_FRAMING_TEXT or GEBR_COMM_PROTOCOL_FRAMING_BINARY */
+	gint framing;
 };
 
 void gebr_comm_protocol_reset(struct gebr_comm_protocol *protocol);
@@ -25,7 +25,13 @@
 
 G_BEGIN_DECLS
 
-#define gebr_comm_message_def_create(code, resp, arg_number) ((struct gebr_comm_message_def){g_str_hash(code), code, resp, arg_number})
+#define gebr_comm_message_def_create(code, resp, arg_number) ((struct gebr_comm_message_def){g_str_hash(code), code, resp, arg_number, 0})
+
+/* First byte of a binary frame. It never starts a text message nor a HTTP one. */
+#define GEBR_COMM_PROTOCOL_BINARY_MAGIC 0xB2
+
+/* Binary frame flags */
+#define GEBR_COMM_PROTOCOL_BINARY_FLAG_RETURN (1 << 0)
 
 void gebr_comm_protocol_init(void);
 
@@ -43,6 +49,12 @@ GString *gebr_comm_protocol_build_messagev(struct gebr_comm_message_def msg_def,
 
 GString *gebr_comm_protocol_build_any_messagev(struct gebr_comm_message_def msg_def, gboolean is_return, guint n_params, va_list ap);
 
+GString *gebr_comm_protocol_build_framed_messagev(struct gebr_comm_message_def msg_def, gboolean is_return, gint framing, guint n_params, va_list ap);
+
+GString *gebr_comm_protocol_rebuild_message(struct gebr_comm_message *message, gint framing);
+
+gboolean gebr_comm_protocol_receive_binary_data(struct gebr_comm_protocol *protocol, GString * data);
+
 GString *gebr_comm_protocol_build_message(struct gebr_comm_message_def msg_def, guint n_params, ...);
 
 GList *gebr_comm_protocol_split_new(GString * arguments, guint parts);
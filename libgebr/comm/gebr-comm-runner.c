@@ -28,12 +28,33 @@
 #include <math.h>
 #include "gebr-comm-daemon.h"
 
+/*
+ * Largest fraction of the score of the cores that a daemon loses for a slow
+ * access to the data of the flow, see calculate_io_factors().
+ */
+#define IO_WEIGHT 0.5
+
 
 typedef struct {
 	GebrCommDaemon *server;
 	gdouble score;
 } ServerScore;
 
+typedef struct {
+	gint np;        /* Number of cores to use at the daemon */
+	gdouble weight; /* Initial share of the loop, from the scores */
+	gdouble rate;   /* Measured steps per second, 0 if unknown */
+	gint size;      /* Size of the chunk being executed */
+	GTimer *timer;
+} ChunkInfo;
+
+typedef struct {
+	GebrCommDaemon *daemon;
+	gint first; /* First loop step of the task */
+	gint steps;
+	gint np;
+} TaskInfo;
+
 struct _GebrCommRunnerPriv {
 	gchar *id;
 	GebrGeoXmlDocument *flow;
@@ -46,6 +67,10 @@ struct _GebrCommRunnerPriv {
 
 	gint requests;
 	gint responses;
+	guint run_source;  // Idle scoring the daemons from their telemetry
+	guint ran_source;  // Idle calling @ran_func after mpi_run_flow()
+	GHashTable *loads; // GebrCommDaemon -> load averages
+	gdouble max_telemetry_age;
 	GList *cores_scores;
 
 	gint total;
@@ -65,6 +90,24 @@ struct _GebrCommRunnerPriv {
 	gpointer user_data;
 
 	gchar *account; // MOAB
+
+	/* Dynamic distribution of the loop, see gebr_comm_runner_set_dynamic() */
+	gboolean dynamic;
+	gint nsteps;
+	gint next_step;
+	GHashTable *chunks; // GebrCommDaemon -> ChunkInfo
+
+	GArray *tasks; // TaskInfo of each fraction sent
+	gint n_remainders; // Fractions after @total, see gebr_comm_runner_run_remainder()
+	GebrCommRunnerCostFunc cost_func;
+	gpointer cost_data;
+
+	/* Choice of the number of processes, see gebr_comm_runner_set_scaling() */
+	gboolean has_scaling;
+	GebrScaling scaling;
+	gdouble auto_speed;
+
+	glong memory_per_process; // In kB, 0 if unknown
 };
 
 /* Private methods {{{1 */
@@ -157,8 +200,11 @@ gebr_comm_runner_new(GebrGeoXmlDocument *flow,
 	self->priv->validator = validator;
 	self->priv->run_servers = g_list_copy(run_servers);
 	self->priv->cores_scores = NULL;
+	self->priv->loads = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+	self->priv->max_telemetry_age = GEBR_COMM_RUNNER_TELEMETRY_MAX_AGE;
 	self->priv->mpi_owner = g_strdup("");
 	self->priv->mpi_flavor = g_strdup("");
+	self->priv->tasks = g_array_new(FALSE, TRUE, sizeof(TaskInfo));
 
 	self->priv->servers = g_list_copy(submit_servers);
 
@@ -179,117 +225,108 @@ gebr_comm_runner_free(GebrCommRunner *self)
 	g_free(self->priv->mpi_flavor);
 	g_free(self->priv->weights);
 	g_free(self->priv->numprocs);
+	if (self->priv->run_source)
+		g_source_remove(self->priv->run_source);
+	if (self->priv->ran_source)
+		g_source_remove(self->priv->ran_source);
+	if (self->priv->chunks)
+		g_hash_table_destroy(self->priv->chunks);
+	g_hash_table_destroy(self->priv->loads);
+	g_array_free(self->priv->tasks, TRUE);
 }
 
-/*
- * Compute the parameters of a polynomial (2nd order) fit
- */
-void
-create_2ndDegreePoly_model(GList *points, gdouble parameters[])
+static const GebrCommTelemetry *
+get_fresh_telemetry(GebrCommRunner *self,
+		    GebrCommDaemon *daemon)
 {
-	gdouble M, MA, MB, MC, **N;
-	gint j;
-	GList *i;
-	N = g_new(gdouble*, 3);
-	for (i = points, j = 0; i; i = i->next, j++) {
-		gdouble *p = i->data;
-		N[j] = g_new(gdouble, 4);
-		N[j][0] = 1;
-		N[j][1] = p[0];
-		N[j][2] = N[j][1]*N[j][1];
-		N[j][3] = p[1];
-	}
+	const GebrCommTelemetry *telemetry = gebr_comm_daemon_get_telemetry(daemon);
 
-	M = (N[1][1] - N[0][1]) * (N[2][1] - N[0][1]) * (N[2][1] - N[1][1]);
-	MA = N[2][3]*(N[1][1]-N[0][1]) + N[1][3]*(N[0][1]-N[2][1]) + N[0][3]*(N[2][1]-N[1][1]);
-	MB = N[2][3]*(N[0][2]-N[1][2]) + N[1][3]*(N[2][2]-N[0][2]) + N[0][3]*(N[1][2]-N[2][2]);
-	MC = N[2][3]*(N[0][1]*N[1][2] - N[1][1]*N[0][2]) + N[1][3]*(N[2][1]*N[0][2]-N[0][1]*N[2][2]) + N[0][3]*(N[1][1]*N[2][2]-N[2][1]*N[1][2]);
+	if (!telemetry || self->priv->max_telemetry_age == 0)
+		return NULL;
 
-	// Equation Ax2 + Bx + C = 0
-	parameters[0] = MA/M;
-	parameters[1] = MB/M;
-	parameters[2] = MC/M;
+	if (self->priv->max_telemetry_age > 0
+	    && telemetry->age > self->priv->max_telemetry_age)
+		return NULL;
 
-	for (gint j=0; j<3; j++)
-		g_free(N[j]);
-	g_free(N);
+	return telemetry;
 }
 
-/*
- * Predict the future load
- */
-static gdouble
-predict_current_load(GList *points, gdouble delay)
+static gint
+compare_usage(gconstpointer a, gconstpointer b)
 {
-	gdouble prediction;
-	gdouble parameters[3];
-	create_2ndDegreePoly_model(points, parameters);
-	prediction = parameters[0]*delay*delay + parameters[1]*delay + parameters[2];
-
-	return MAX(0, prediction);
+	const gdouble *u1 = a, *u2 = b;
+	return (*u1 > *u2) - (*u1 < *u2);
 }
 
 /*
- * Compute the score of a server
+ * Compute the score of each core of a server, given how busy each one is.
+ * The @pending_cores are taken by tasks already sent but not seen in @usage
+ * yet, they go to the idlest cores and the excess is spread among all. The scores are scaled by @io_factor,
+ * see calculate_io_factors().
  */
 static GList *
-calculate_server_score(GebrCommDaemon *daemon, const gchar *load, gint ncores, gdouble cpu_clock, gint running_jobs)
+calculate_server_score(GebrCommDaemon *daemon, gdouble *usage, gint ncores, gdouble cpu_clock, gint pending_cores,
+		       gdouble io_factor)
 {
-	GList *points = NULL;
-	gdouble delay = 1.0;
-	gdouble p1[2];
-	gdouble p5[2];
-	gdouble p15[2];
-
-	sscanf(load, "%lf %lf %lf", &p1[1], &p5[1], &p15[1]);
-
-	p1[0] = -1.0;
-	p5[0] = -5.0;
-	p15[0] = -15.0;
+	GList *score = NULL;
 
-	points = g_list_prepend(points, p1);
-	points = g_list_prepend(points, p5);
-	points = g_list_prepend(points, p15);
+	qsort(usage, ncores, sizeof(gdouble), compare_usage);
 
-	gdouble current_load = predict_current_load(points, delay);
+	/* One pending task per core, the idlest first. If there are more
+	 * pending than cores, the rest waits for any of them. */
+	gint direct = MIN(pending_cores, ncores);
+	gdouble overflow = (gdouble)(pending_cores - direct) / ncores;
 
-	GList *score = NULL;
-	gdouble base = floor(current_load/ncores);
-	gdouble rest = current_load - base;
+	for (gint i = 0; i < ncores; i++)
+		usage[i] += (i < direct ? 1 : 0) + overflow;
 
-	gdouble factor_correction = 0.9;
-	gint n_jobs = 0;
 	for (gint i = 0; i < ncores; i++) {
 		ServerScore *sc = g_new(ServerScore, 1);
-		sc->score = base;
-		if (rest > 1) {
-			sc->score += 1;
-			rest -= 1;
-		} else if (rest > 0) {
-			sc->score += rest;
-			rest = 0;
-		}
 		sc->server = daemon;
-
-		if (running_jobs > 0) {
-			n_jobs = 1;
-			running_jobs--;
-		} else {
-			n_jobs = 0;
-		}
-
-		sc->score = (cpu_clock/(sc->score + 1)) * pow(factor_correction, n_jobs);
+		sc->score = io_factor * cpu_clock/(usage[i] + 1);
 
 		score = g_list_prepend(score, sc);
 
 		g_debug("SCORE = %lf FOR CORE %d OF DAEMON %s", sc->score, i, gebr_comm_daemon_get_hostname(daemon));
 	}
 
-	g_list_free(points);
-
 	return score;
 }
 
+/*
+ * The usage of each core, as measured by the daemon. Processes waiting for
+ * a core are spread among all of them.
+ */
+static gdouble *
+usage_from_telemetry(const GebrCommTelemetry *telemetry, gint ncores)
+{
+	gdouble *usage = g_new0(gdouble, ncores);
+	gdouble waiting = MAX(0, telemetry->runnable - ncores) / ncores;
+
+	for (gint i = 0; i < ncores; i++)
+		usage[i] = (i < telemetry->ncores ? telemetry->core_usage[i] : 0) + waiting;
+
+	return usage;
+}
+
+/*
+ * For daemons without telemetry, spread the last minute load average among
+ * the cores.
+ */
+static gdouble *
+usage_from_load(const gchar *load, gint ncores)
+{
+	gdouble *usage = g_new0(gdouble, ncores);
+	gdouble load1 = 0;
+
+	sscanf(load, "%lf", &load1);
+
+	for (gint i = 0; i < ncores; i++)
+		usage[i] = load1 / ncores;
+
+	return usage;
+}
+
 typedef struct {
 	GebrCommDaemon *daemon;
 	gdouble weight; /* The sum of all its cores scores */
@@ -297,6 +334,70 @@ typedef struct {
 	gint nsteps; /* Number of steps this @daemon will execute */
 } DaemonExecInfo;
 
+static gint
+server_score_comp_func(ServerScore *a, ServerScore *b)
+{
+	gdouble res = b->score - a->score;
+	if(res < 0)
+		return -1;
+	else if (res > 0)
+		return +1;
+	else
+		return 0;
+}
+
+/*
+ * Number of processes of the flow that fit in the memory @daemon has left,
+ * once the @pending ones allocate theirs. Uses the total memory for daemons
+ * without telemetry. The memory available is returned in @available.
+ */
+static gint
+memory_slots(GebrCommRunner *self,
+	     GebrCommDaemon *daemon,
+	     const GebrCommTelemetry *telemetry,
+	     gint pending,
+	     glong *available)
+{
+	GebrCommServer *server = gebr_comm_daemon_get_server(daemon);
+	glong mem = self->priv->memory_per_process;
+
+	if (telemetry && telemetry->free_memory > 0)
+		*available = telemetry->free_memory;
+	else if (server->memory)
+		*available = atol(server->memory);
+	else
+		return G_MAXINT;
+
+	*available -= pending * mem;
+
+	return *available > 0 ? MIN(*available / mem, G_MAXINT) : 0;
+}
+
+/*
+ * Keeps only the @n cores with best score of @scores.
+ */
+static GList *
+keep_best_cores(GList *scores, gint n)
+{
+	scores = g_list_sort(scores, (GCompareFunc)server_score_comp_func);
+
+	GList *tail = g_list_nth(scores, n);
+	if (!tail)
+		return scores;
+
+	if (tail->prev) {
+		tail->prev->next = NULL;
+		tail->prev = NULL;
+	} else {
+		scores = NULL;
+	}
+
+	g_list_foreach(tail, (GFunc)g_free, NULL);
+	g_list_free(tail);
+
+	return scores;
+}
+
 static gint *
 distribute_tasks_to_cores(GebrCommRunner *self,
                           gint total_procs,
@@ -336,7 +437,6 @@ static GList * /* DaemonExecInfo */
 calculate_servers_scores_and_num_procs(GebrCommRunner *self)
 {
 	gint n_cores = g_list_length(self->priv->cores_scores);
-	gdouble speed = atof(self->priv->speed);
 	GList *j;
 
 	GebrGeoXmlProgram *loop = gebr_geoxml_flow_get_control_program(GEBR_GEOXML_FLOW(self->priv->flow));
@@ -346,7 +446,23 @@ calculate_servers_scores_and_num_procs(GebrCommRunner *self)
 	else
 		nsteps = 1;
 
-	gint total_procs = MIN(gebr_calculate_number_of_processors(n_cores, speed), nsteps);
+	gint total_procs;
+	if (g_strcmp0(self->priv->speed, GEBR_COMM_RUNNER_SPEED_AUTO) == 0) {
+		if (self->priv->has_scaling)
+			total_procs = gebr_calculate_best_number_of_processors(&self->priv->scaling, n_cores,
+									       g_hash_table_size(self->priv->loads));
+		else
+			total_procs = MAX(n_cores, 1);
+		self->priv->auto_speed = n_cores ? 5.0 * total_procs / n_cores : 0;
+	} else {
+		total_procs = gebr_calculate_number_of_processors(n_cores, atof(self->priv->speed));
+	}
+	total_procs = MIN(total_procs, nsteps);
+
+	/* The cores left out for lack of memory must not be used by
+	 * overcommitting the others */
+	if (self->priv->memory_per_process > 0)
+		total_procs = MIN(total_procs, MAX(n_cores, 1));
 
 	gint *distributed_n = distribute_tasks_to_cores(self, total_procs, nsteps);
 
@@ -466,6 +582,50 @@ set_servers_execution_info(GebrCommRunner *self)
 	self->priv->distributed_n = distributed_n;
 }
 
+static void
+send_run_message(GebrCommRunner *self,
+		 GebrCommDaemon *daemon,
+		 GebrGeoXmlFlow *flow,
+		 gint frac,
+		 gint np,
+		 gint first,
+		 gint steps)
+{
+	GebrCommServer *server = gebr_comm_daemon_get_server(daemon);
+	gchar *frac_str = g_strdup_printf("%d", frac);
+	gchar *flow_xml = strip_flow(self->priv->validator, flow);
+	gchar *numproc = g_strdup_printf("%d", np);
+
+	gebr_comm_daemon_add_task(daemon);
+	gebr_comm_daemon_reserve_cores(daemon, self->priv->id, frac, np);
+
+	if (self->priv->tasks->len < (guint)frac)
+		g_array_set_size(self->priv->tasks, frac);
+	TaskInfo *task = &g_array_index(self->priv->tasks, TaskInfo, frac - 1);
+	task->daemon = daemon;
+	task->first = first;
+	task->steps = steps;
+	task->np = np;
+
+	gebr_comm_protocol_socket_oldmsg_send(server->socket, FALSE,
+					      gebr_comm_protocol_defs.run_def, 9,
+					      self->priv->gid,
+					      self->priv->id,
+					      frac_str,
+					      numproc,
+					      self->priv->nice,
+					      flow_xml,
+					      self->priv->paths,
+
+					      /* Moab and MPI settings */
+					      self->priv->account ? self->priv->account : "",
+					      "");
+
+	g_free(frac_str);
+	g_free(flow_xml);
+	g_free(numproc);
+}
+
 static void
 divide_and_run_flows(GebrCommRunner *self)
 {
@@ -494,39 +654,19 @@ divide_and_run_flows(GebrCommRunner *self)
 	GString *server_list = g_string_new("");
 
 	gint k;
+	gint first = 0;
 	GList *i = flows;
 	GList *j = self->priv->servers;
 	for (k = 0; i; k++, i = i->next, j = j->next) {
-		GebrGeoXmlFlow *flow = i->data;
 		GebrCommDaemon *daemon = j->data;
-		GebrCommServer *server = gebr_comm_daemon_get_server(daemon);
-		gchar *frac_str = g_strdup_printf("%d", k+1);
-		gchar *flow_xml = strip_flow(self->priv->validator, flow);
 		const gchar *hostname = gebr_comm_daemon_get_hostname(daemon);
 
-		gebr_comm_daemon_add_task(daemon);
-
 		g_string_append_printf(server_list, "%s,%d,",
 				       hostname, self->priv->weights[k]);
-		gchar *numproc = g_strdup_printf("%d", self->priv->numprocs[k]);
-
-		gebr_comm_protocol_socket_oldmsg_send(server->socket, FALSE,
-						      gebr_comm_protocol_defs.run_def, 9,
-						      self->priv->gid,
-						      self->priv->id,
-						      frac_str,
-						      numproc,
-						      self->priv->nice,
-						      flow_xml,
-						      self->priv->paths,
 
-						      /* Moab and MPI settings */
-						      self->priv->account ? self->priv->account : "",
-						      "");
-
-		g_free(frac_str);
-		g_free(flow_xml);
-		g_free(numproc);
+		send_run_message(self, daemon, i->data, k+1, self->priv->numprocs[k],
+				 first, self->priv->distributed_n[k]);
+		first += self->priv->distributed_n[k];
 	}
 
 	self->priv->total = k;
@@ -537,9 +677,163 @@ divide_and_run_flows(GebrCommRunner *self)
 		self->priv->ran_func(self, self->priv->user_data);
 }
 
+/*
+ * Estimated steps per second of the daemon of @info. A daemon uses its own
+ * measured rate as soon as it finished a chunk. Before that, its rate is
+ * guessed from its score, scaled by how fast the measured daemons turned
+ * out to be for their scores, and never more than what its first chunk
+ * shows so far: a daemon still busy with it is slower than that.
+ */
+static gdouble
+estimated_rate(ChunkInfo *info,
+	       gdouble rate_per_weight)
+{
+	if (info->rate > 0)
+		return info->rate;
+
+	if (rate_per_weight <= 0)
+		return 0;
+
+	gdouble rate = info->weight * rate_per_weight;
+	gdouble elapsed = g_timer_elapsed(info->timer, NULL);
+
+	if (info->size > 0 && elapsed > 0)
+		rate = MIN(rate, info->size / elapsed);
+
+	return rate;
+}
+
+/*
+ * Guided chunk size: a share of half the remaining steps, so chunks shrink
+ * as the loop comes to an end and stragglers have little left to do. The
+ * share comes from the scores until some daemon finished a chunk, and from
+ * the estimated rates of the daemons after that.
+ */
+static gint
+next_chunk_size(GebrCommRunner *self,
+		ChunkInfo *info)
+{
+	gint remaining = self->priv->nsteps - self->priv->next_step;
+	gdouble share = info->weight;
+	gdouble measured_rate = 0;
+	gdouble measured_weight = 0;
+	GHashTableIter iter;
+	ChunkInfo *other;
+
+	g_hash_table_iter_init(&iter, self->priv->chunks);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&other)) {
+		if (other->rate > 0) {
+			measured_rate += other->rate;
+			measured_weight += other->weight;
+		}
+	}
+
+	if (measured_rate > 0) {
+		gdouble rate_per_weight = measured_weight > 0 ? measured_rate / measured_weight : 0;
+		gdouble sum = 0;
+
+		g_hash_table_iter_init(&iter, self->priv->chunks);
+		while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&other))
+			sum += estimated_rate(other, rate_per_weight);
+
+		if (sum > 0)
+			share = estimated_rate(info, rate_per_weight) / sum;
+	}
+
+	gint size = ceil(remaining * share / 2);
+
+	/* Keep all cores of the daemon busy */
+	size = MAX(size, info->np);
+
+	return MIN(size, remaining);
+}
+
+static void
+send_chunk(GebrCommRunner *self,
+	   GebrCommDaemon *daemon,
+	   ChunkInfo *info)
+{
+	info->size = next_chunk_size(self, info);
+
+	GebrGeoXmlFlow *chunk = gebr_geoxml_flow_divide_chunk(GEBR_GEOXML_FLOW(self->priv->flow),
+							      self->priv->validator,
+							      self->priv->next_step,
+							      info->size);
+
+	self->priv->next_step += info->size;
+	self->priv->total++;
+
+	g_debug("Sending chunk %d (%d steps) of job %s to %s",
+		self->priv->total, info->size, self->priv->id,
+		gebr_comm_daemon_get_hostname(daemon));
+
+	send_run_message(self, daemon, chunk, self->priv->total, info->np,
+			 self->priv->next_step - info->size, info->size);
+	g_timer_start(info->timer);
+
+	gebr_geoxml_document_free(GEBR_GEOXML_DOCUMENT(chunk));
+}
+
+static void
+chunk_info_free(ChunkInfo *info)
+{
+	g_timer_destroy(info->timer);
+	g_free(info);
+}
+
+static void
+divide_and_run_chunks(GebrCommRunner *self)
+{
+	gint n = g_list_length(self->priv->servers);
+	gint max_cores = 0;
+
+	self->priv->nsteps = 0;
+	for (gint k = 0; k < n; k++) {
+		max_cores += self->priv->numprocs[k];
+		self->priv->nsteps += self->priv->distributed_n[k];
+	}
+
+	self->priv->ncores = g_strdup_printf("%d", max_cores);
+	self->priv->next_step = 0;
+	self->priv->total = 0;
+	self->priv->chunks = g_hash_table_new_full(NULL, NULL, g_object_unref,
+						   (GDestroyNotify)chunk_info_free);
+
+	GString *server_list = g_string_new("");
+
+	gint k = 0;
+	for (GList *i = self->priv->servers; i; i = i->next, k++) {
+		GebrCommDaemon *daemon = i->data;
+		ChunkInfo *info = g_new0(ChunkInfo, 1);
+
+		info->np = self->priv->numprocs[k];
+		info->weight = self->priv->nsteps ? (gdouble)self->priv->distributed_n[k] / self->priv->nsteps : 0;
+		info->timer = g_timer_new();
+		g_hash_table_insert(self->priv->chunks, g_object_ref(daemon), info);
+
+		g_string_append_printf(server_list, "%s,%d,",
+				       gebr_comm_daemon_get_hostname(daemon),
+				       self->priv->distributed_n[k]);
+	}
+
+	for (GList *i = self->priv->servers; i; i = i->next) {
+		if (self->priv->next_step >= self->priv->nsteps)
+			break;
+		send_chunk(self, i->data, g_hash_table_lookup(self->priv->chunks, i->data));
+	}
+
+	if (server_list->len)
+		g_string_erase(server_list, server_list->len-1, 1);
+	self->priv->servers_list = g_string_free(server_list, FALSE);
+
+	if (self->priv->ran_func)
+		self->priv->ran_func(self, self->priv->user_data);
+}
+
 static gboolean
 call_ran_func(GebrCommRunner *self)
 {
+	self->priv->ran_source = 0;
 	if (self->priv->ran_func)
 		self->priv->ran_func(self, self->priv->user_data);
 
@@ -761,23 +1055,217 @@ mpi_run_flow(GebrCommRunner *self)
 
 	g_string_free(servers, TRUE);
 	g_string_free(servers_weigths, TRUE);
-	g_idle_add((GSourceFunc)call_ran_func, self);
+	self->priv->ran_source = g_idle_add((GSourceFunc)call_ran_func, self);
 
 	g_free(flow_xml);
 }
 
-static gint
-server_score_comp_func(ServerScore *a, ServerScore *b)
+
+/*
+ * Fills @costs with the cost of an iteration at each daemon, as given by
+ * the cost function. Returns the mean ratio between clock and speed of the
+ * daemons with a known cost, or a negative value if there is none.
+ */
+static gdouble
+calibrate_costs(GebrCommRunner *self,
+		gdouble *costs)
 {
-	gdouble res = b->score - a->score;
-	if(res < 0)
-		return -1;
-	else if (res > 0)
-		return +1;
+	gdouble sum = 0;
+	gint n = 0;
+	gint k = 0;
+
+	for (GList *i = self->priv->servers; i; i = i->next, k++) {
+		GebrCommServer *server = gebr_comm_daemon_get_server(i->data);
+
+		costs[k] = -1;
+		if (!self->priv->cost_func)
+			continue;
+
+		costs[k] = self->priv->cost_func(i->data, self->priv->cost_data);
+		if (costs[k] > 0 && server->clock_cpu > 0) {
+			sum += server->clock_cpu * costs[k];
+			n++;
+		}
+	}
+
+	return n ? sum / n : -1;
+}
+
+/*
+ * Fills @factors with the factor that multiplies the scores of the cores of
+ * each daemon, for its bandwidth to the files the flow reads and writes.
+ * These are in the home directory, shared by all daemons, which do not all
+ * reach it equally fast. The daemon with the best bandwidth keeps its
+ * scores, the others lose up to IO_WEIGHT of them.
+ *
+ * Daemons that already ran this flow have their measured speed, which
+ * accounts for their bandwidth, in @costs. Daemons that did not measure
+ * their bandwidth are given the mean one.
+ */
+static void
+calculate_io_factors(GebrCommRunner *self,
+		     const gdouble *costs,
+		     gdouble *factors)
+{
+	gint n = g_list_length(self->priv->servers);
+	gdouble *bandwidth = g_new(gdouble, n);
+	gdouble max = 0, sum = 0;
+	gint measured = 0;
+	gint k = 0;
+
+	gchar *input = gebr_geoxml_flow_io_get_input(GEBR_GEOXML_FLOW(self->priv->flow));
+	gchar *output = gebr_geoxml_flow_io_get_output(GEBR_GEOXML_FLOW(self->priv->flow));
+	gboolean reads = input && *input;
+	gboolean writes = output && *output;
+	g_free(input);
+	g_free(output);
+
+	for (GList *i = self->priv->servers; i; i = i->next, k++) {
+		gdouble read_bw, write_bw;
+
+		factors[k] = 1;
+		bandwidth[k] = -1;
+
+		if ((!reads && !writes)
+		    || !gebr_comm_daemon_get_bandwidth(i->data, &read_bw, &write_bw))
+			continue;
+
+		/* The seconds per byte add up if it reads and writes */
+		if (reads && writes)
+			bandwidth[k] = 1 / (1 / read_bw + 1 / write_bw);
+		else
+			bandwidth[k] = reads ? read_bw : write_bw;
+
+		max = MAX(max, bandwidth[k]);
+		sum += bandwidth[k];
+		measured++;
+	}
+
+	if (measured) {
+		gdouble mean = sum / measured;
+
+		for (k = 0; k < n; k++) {
+			if (costs[k] > 0)
+				continue;
+
+			gdouble b = bandwidth[k] > 0 ? bandwidth[k] : mean;
+			factors[k] = 1 - IO_WEIGHT + IO_WEIGHT * b / max;
+			g_debug("Daemon %d has an I/O factor of %lf", k, factors[k]);
+		}
+	}
+
+	g_free(bandwidth);
+}
+
+static void
+score_and_run(GebrCommRunner *self)
+{
+	gdouble *costs = g_new(gdouble, g_list_length(self->priv->servers));
+	gdouble *io_factors = g_new(gdouble, g_list_length(self->priv->servers));
+	gdouble clock_per_speed = calibrate_costs(self, costs);
+	GList *fallback = NULL;
+	glong fallback_memory = 0;
+	gint k = 0;
+
+	calculate_io_factors(self, costs, io_factors);
+
+	/* Other runners may have reserved cores while the loads were
+	 * on their way, so the scores are computed only now */
+	for (GList *i = self->priv->servers; i; i = i->next, k++) {
+		const gchar *load = g_hash_table_lookup(self->priv->loads, i->data);
+		GebrCommServer *server = gebr_comm_daemon_get_server(i->data);
+		const GebrCommTelemetry *telemetry = get_fresh_telemetry(self, i->data);
+		gdouble clock = server->clock_cpu;
+		gdouble *usage;
+		gint pending;
+
+		if (!load || server->ncores <= 0)
+			continue;
+
+		/* The measured speed of this flow is better than the clock,
+		 * but it is expressed in clock units so daemons that never
+		 * ran it can still be compared */
+		if (costs[k] > 0 && clock_per_speed > 0)
+			clock = clock_per_speed / costs[k];
+
+		if (telemetry && telemetry->ncores > 0) {
+			usage = usage_from_telemetry(telemetry, server->ncores);
+			pending = telemetry->pending_cores;
+		} else {
+			/* The load averages take minutes to show the reserved cores */
+			usage = usage_from_load(load, server->ncores);
+			pending = gebr_comm_daemon_get_reserved_cores(i->data);
+		}
+
+		GList *scores = calculate_server_score(i->data, usage, server->ncores,
+						       clock, pending, io_factors[k]);
+		g_free(usage);
+
+		if (self->priv->memory_per_process > 0) {
+			glong available = 0;
+			gint slots = memory_slots(self, i->data, telemetry, pending, &available);
+
+			if (slots == 0) {
+				/* Remember the best core of the daemon with
+				 * most memory, in case none fits the flow */
+				scores = keep_best_cores(scores, 1);
+				if (!fallback || available > fallback_memory) {
+					g_list_foreach(fallback, (GFunc)g_free, NULL);
+					g_list_free(fallback);
+					fallback = scores;
+					fallback_memory = available;
+				} else {
+					g_list_foreach(scores, (GFunc)g_free, NULL);
+					g_list_free(scores);
+				}
+				continue;
+			}
+
+			if (slots < server->ncores) {
+				g_debug("DAEMON %s HAS MEMORY FOR %d PROCESSES", gebr_comm_daemon_get_hostname(i->data), slots);
+				scores = keep_best_cores(scores, slots);
+			}
+		}
+
+		self->priv->cores_scores = g_list_concat(self->priv->cores_scores, scores);
+	}
+	g_free(costs);
+	g_free(io_factors);
+
+	if (!self->priv->cores_scores && fallback) {
+		g_warning("No daemon has %ld kB free for a process, running on %s",
+			  self->priv->memory_per_process,
+			  gebr_comm_daemon_get_hostname(((ServerScore *)fallback->data)->server));
+		self->priv->cores_scores = fallback;
+	} else {
+		g_list_foreach(fallback, (GFunc)g_free, NULL);
+		g_list_free(fallback);
+	}
+
+	self->priv->cores_scores = g_list_sort(self->priv->cores_scores, (GCompareFunc)server_score_comp_func);
+	set_servers_execution_info(self);
+
+	GebrGeoXmlProgram *mpi_prog = gebr_geoxml_flow_get_first_mpi_program(GEBR_GEOXML_FLOW(self->priv->flow));
+	gboolean mpi = mpi_prog != NULL;
+	gebr_geoxml_object_unref(mpi_prog);
+
+	if (mpi)
+		mpi_run_flow(self);
+	else if (self->priv->dynamic
+		 && gebr_geoxml_flow_is_parallelizable(GEBR_GEOXML_FLOW(self->priv->flow),
+						       self->priv->validator))
+		divide_and_run_chunks(self);
 	else
-		return 0;
+		divide_and_run_flows(self);
 }
 
+static gboolean
+run_from_telemetry(GebrCommRunner *self)
+{
+	self->priv->run_source = 0;
+	score_and_run(self);
+	return FALSE;
+}
 
 static void
 on_response_received(GebrCommHttpMsg *request,
@@ -789,7 +1277,6 @@ on_response_received(GebrCommHttpMsg *request,
 	GebrCommJsonContent *json = gebr_comm_json_content_new(response->content->str);
 	GString *value = gebr_comm_json_content_to_gstring(json);
 	GebrCommDaemon *daemon = g_object_get_data(G_OBJECT(request), "current-server");
-	GebrCommServer *server = gebr_comm_daemon_get_server(daemon);
 
 	GebrGeoXmlProgram *loop = gebr_geoxml_flow_get_control_program(GEBR_GEOXML_FLOW(self->priv->flow));
 
@@ -804,29 +1291,11 @@ on_response_received(GebrCommHttpMsg *request,
 		gebr_geoxml_object_unref(loop);
 	}
 
-	gint running_jobs = gebr_comm_daemon_get_n_running_jobs(GEBR_COMM_DAEMON(daemon));
-
-	self->priv->cores_scores = g_list_concat(self->priv->cores_scores,
-	                                         calculate_server_score(daemon,
-	                                                                value->str,
-	                                                                server->ncores,
-	                                                                server->clock_cpu,
-	                                                                running_jobs));
+	g_hash_table_insert(self->priv->loads, daemon, g_strdup(value->str));
 
 	self->priv->responses++;
-	if (self->priv->responses == self->priv->requests) {
-		self->priv->cores_scores = g_list_sort(self->priv->cores_scores, (GCompareFunc)server_score_comp_func);
-		set_servers_execution_info(self);
-
-		GebrGeoXmlProgram *mpi_prog = gebr_geoxml_flow_get_first_mpi_program(GEBR_GEOXML_FLOW(self->priv->flow));
-		gboolean mpi = mpi_prog != NULL;
-		gebr_geoxml_object_unref(mpi_prog);
-
-		if (mpi)
-			mpi_run_flow(self);
-		else
-			divide_and_run_flows(self);
-	}
+	if (self->priv->responses == self->priv->requests)
+		score_and_run(self);
 }
 
 void
@@ -844,6 +1313,7 @@ gebr_comm_runner_run_async(GebrCommRunner *self)
 {
 	self->priv->requests = 0;
 	self->priv->responses = 0;
+	g_hash_table_remove_all(self->priv->loads);
 	gboolean has_connected = FALSE;
 
 	GList *i = self->priv->servers;
@@ -857,6 +1327,16 @@ gebr_comm_runner_run_async(GebrCommRunner *self)
 			continue;
 		}
 
+		/* Score from the telemetry pushed by the daemon, if it is
+		 * recent enough */
+		const GebrCommTelemetry *telemetry = get_fresh_telemetry(self, daemon);
+		if (telemetry) {
+			g_hash_table_insert(self->priv->loads, daemon, g_strdup(telemetry->load));
+			has_connected = TRUE;
+			i = i->next;
+			continue;
+		}
+
 		GebrCommHttpMsg *request;
 		GebrCommServer *server = gebr_comm_daemon_get_server(daemon);
 		GebrCommUri *uri = gebr_comm_uri_new();
@@ -884,9 +1364,19 @@ gebr_comm_runner_run_async(GebrCommRunner *self)
 		i = i->next;
 	}
 
+	if (has_connected && self->priv->requests == 0)
+		self->priv->run_source = g_idle_add((GSourceFunc)run_from_telemetry, self);
+
 	return has_connected;
 }
 
+void
+gebr_comm_runner_set_max_telemetry_age(GebrCommRunner *self,
+				       gdouble seconds)
+{
+	self->priv->max_telemetry_age = seconds;
+}
+
 GebrValidator *
 gebr_comm_runner_get_validator(GebrCommRunner *self)
 {
@@ -905,12 +1395,192 @@ gebr_comm_runner_get_servers_list(GebrCommRunner *self)
 	return self->priv->servers_list;
 }
 
+GList *
+gebr_comm_runner_get_daemons(GebrCommRunner *self)
+{
+	return self->priv->servers;
+}
+
 gint
 gebr_comm_runner_get_total(GebrCommRunner *self)
 {
+	if (self->priv->chunks && self->priv->next_step < self->priv->nsteps)
+		return -1;
+
 	return self->priv->total;
 }
 
+void
+gebr_comm_runner_set_dynamic(GebrCommRunner *self,
+			     gboolean dynamic)
+{
+	self->priv->dynamic = dynamic;
+}
+
+gboolean
+gebr_comm_runner_chunk_finished(GebrCommRunner *self,
+				GebrCommDaemon *daemon)
+{
+	if (!self->priv->chunks)
+		return FALSE;
+
+	ChunkInfo *info = g_hash_table_lookup(self->priv->chunks, daemon);
+	if (!info)
+		return FALSE;
+
+	gdouble elapsed = g_timer_elapsed(info->timer, NULL);
+	if (elapsed > 0) {
+		gdouble rate = info->size / elapsed;
+		info->rate = info->rate > 0 ? (info->rate + rate) / 2 : rate;
+	}
+
+	if (self->priv->next_step >= self->priv->nsteps)
+		return FALSE;
+
+	send_chunk(self, daemon, info);
+	return TRUE;
+}
+
+void
+gebr_comm_runner_set_cost_func(GebrCommRunner *self,
+			       GebrCommRunnerCostFunc func,
+			       gpointer data)
+{
+	self->priv->cost_func = func;
+	self->priv->cost_data = data;
+}
+
+gint
+gebr_comm_runner_get_task_steps(GebrCommRunner *self,
+				gint frac,
+				GebrCommDaemon **daemon,
+				gint *ncores)
+{
+	if (frac < 1 || (guint)frac > self->priv->tasks->len)
+		return -1;
+
+	TaskInfo *task = &g_array_index(self->priv->tasks, TaskInfo, frac - 1);
+	if (task->np <= 0)
+		return -1;
+
+	if (daemon)
+		*daemon = task->daemon;
+	if (ncores)
+		*ncores = task->np;
+
+	return task->steps;
+}
+
+gboolean
+gebr_comm_runner_can_split(GebrCommRunner *self)
+{
+	GebrGeoXmlFlow *flow = GEBR_GEOXML_FLOW(self->priv->flow);
+
+	if (self->priv->dynamic || self->priv->total <= 1)
+		return FALSE;
+
+	GebrGeoXmlProgram *mpi_prog = gebr_geoxml_flow_get_first_mpi_program(flow);
+	gebr_geoxml_object_unref(mpi_prog);
+	if (mpi_prog || !gebr_geoxml_flow_is_parallelizable(flow, self->priv->validator))
+		return FALSE;
+
+	/* The remainder starts a new output file, which is harmless only if
+	 * each iteration writes its own */
+	gchar *output = gebr_geoxml_flow_io_get_output(flow);
+
+	gboolean can_split = output && *output
+		&& gebr_validator_use_iter(self->priv->validator, output,
+					   GEBR_GEOXML_PARAMETER_TYPE_STRING,
+					   GEBR_GEOXML_DOCUMENT_TYPE_FLOW);
+	g_free(output);
+
+	return can_split;
+}
+
+gint
+gebr_comm_runner_run_remainder(GebrCommRunner *self,
+			       gint frac,
+			       gint done,
+			       GebrCommDaemon *daemon)
+{
+	g_return_val_if_fail(frac >= 1 && frac <= self->priv->total, -1);
+
+	TaskInfo *task = &g_array_index(self->priv->tasks, TaskInfo, frac - 1);
+	GebrCommServer *server = gebr_comm_daemon_get_server(daemon);
+
+	g_return_val_if_fail(done >= 0 && done < task->steps, -1);
+
+	gint first = task->first + done;
+	gint steps = task->steps - done;
+	GebrGeoXmlFlow *rest = gebr_geoxml_flow_divide_chunk(GEBR_GEOXML_FLOW(self->priv->flow),
+							     self->priv->validator,
+							     first, steps);
+	if (!rest)
+		return -1;
+
+	gint remainder = self->priv->total + ++self->priv->n_remainders;
+	gint np = server->ncores > 0 ? MIN(task->np, server->ncores) : task->np;
+
+	g_debug("Task %d of job %s stopped after %d of %d steps, the rest goes to %s as %d",
+		frac, self->priv->id, done, task->steps,
+		gebr_comm_daemon_get_hostname(daemon), remainder);
+
+	/* The stopped task ran only the steps it did */
+	task->steps = done;
+	send_run_message(self, daemon, rest, remainder, np, first, steps);
+	gebr_geoxml_document_free(GEBR_GEOXML_DOCUMENT(rest));
+
+	return remainder;
+}
+
+gchar *
+gebr_comm_runner_get_flow_hash(GebrCommRunner *self)
+{
+	GebrGeoXmlDocument *clone = gebr_geoxml_document_clone(self->priv->flow);
+
+	/* Only what changes the execution is hashed */
+	gebr_geoxml_document_set_title(clone, "");
+	gebr_geoxml_document_set_description(clone, "");
+	gebr_geoxml_document_set_author(clone, "");
+	gebr_geoxml_document_set_email(clone, "");
+	gebr_geoxml_document_set_date_created(clone, "");
+	gebr_geoxml_document_set_date_modified(clone, "");
+	gebr_geoxml_flow_set_date_last_run(GEBR_GEOXML_FLOW(clone), "");
+
+	gchar *xml = strip_flow(self->priv->validator, GEBR_GEOXML_FLOW(clone));
+	gchar *hash = g_compute_checksum_for_string(G_CHECKSUM_MD5, xml, -1);
+
+	g_free(xml);
+	gebr_geoxml_document_free(clone);
+
+	return hash;
+}
+
+void
+gebr_comm_runner_set_scaling(GebrCommRunner *self,
+			     const GebrScaling *scaling)
+{
+	self->priv->has_scaling = scaling != NULL;
+	if (scaling)
+		self->priv->scaling = *scaling;
+}
+
+void
+gebr_comm_runner_set_memory_per_process(GebrCommRunner *self,
+					glong kb)
+{
+	self->priv->memory_per_process = MAX(kb, 0);
+}
+
+gdouble
+gebr_comm_runner_get_speed(GebrCommRunner *self)
+{
+	if (g_strcmp0(self->priv->speed, GEBR_COMM_RUNNER_SPEED_AUTO) == 0)
+		return self->priv->auto_speed;
+
+	return atof(self->priv->speed);
+}
+
 const gchar *
 gebr_comm_runner_get_id(GebrCommRunner *self)
 {
@@ -20,13 +20,40 @@
 
 #include <glib.h>
 #include <libgebr/gebr-validator.h>
+#include <libgebr/utils.h>
 #include <libgebr/comm/gebr-comm-server.h>
+#include <libgebr/comm/gebr-comm-daemon.h>
 
 G_BEGIN_DECLS
 
+/**
+ * GEBR_COMM_RUNNER_TELEMETRY_MAX_AGE:
+ *
+ * Default age, in seconds, above which the telemetry of a daemon is not
+ * trusted and its load is asked before running.
+ */
+#define GEBR_COMM_RUNNER_TELEMETRY_MAX_AGE 10
+
+/**
+ * GEBR_COMM_RUNNER_SPEED_AUTO:
+ *
+ * Speed that lets the runner choose the number of processes, see
+ * gebr_comm_runner_set_scaling().
+ */
+#define GEBR_COMM_RUNNER_SPEED_AUTO "auto"
+
 typedef struct _GebrCommRunner GebrCommRunner;
 typedef struct _GebrCommRunnerPriv GebrCommRunnerPriv;
 
+/**
+ * GebrCommRunnerCostFunc:
+ *
+ * Returns: the time, in seconds, a core of @daemon takes to execute one
+ * iteration of the flow, or a non-positive value if it is not known.
+ */
+typedef gdouble (*GebrCommRunnerCostFunc) (GebrCommDaemon *daemon,
+					   gpointer user_data);
+
 struct _GebrCommRunner {
 	GebrCommRunnerPriv *priv;
 };
@@ -76,8 +103,136 @@ const gchar *gebr_comm_runner_get_ncores(GebrCommRunner *self);
 
 const gchar *gebr_comm_runner_get_servers_list(GebrCommRunner *self);
 
+/**
+ * gebr_comm_runner_get_daemons:
+ *
+ * Returns: the list of #GebrCommDaemon @self may send tasks to, owned by
+ * @self.
+ */
+GList *gebr_comm_runner_get_daemons(GebrCommRunner *self);
+
+/**
+ * gebr_comm_runner_get_total:
+ *
+ * Returns: the number of tasks of the job, or -1 if the loop is being
+ * distributed in chunks and not all of them were sent yet.
+ */
 gint gebr_comm_runner_get_total(GebrCommRunner *self);
 
+/**
+ * gebr_comm_runner_set_max_telemetry_age:
+ *
+ * Sets the staleness bound of the telemetry used to score the daemons. A
+ * negative value accepts any age, zero always asks the daemons.
+ */
+void gebr_comm_runner_set_max_telemetry_age(GebrCommRunner *self,
+					    gdouble seconds);
+
+/**
+ * gebr_comm_runner_set_dynamic:
+ *
+ * If @dynamic is %TRUE, the loop of a parallelizable flow is not divided
+ * upfront among the daemons. Each daemon receives a chunk of the loop and
+ * asks for the next one with gebr_comm_runner_chunk_finished(), so faster
+ * daemons execute more steps. MPI flows are not affected.
+ */
+void gebr_comm_runner_set_dynamic(GebrCommRunner *self,
+				  gboolean dynamic);
+
+/**
+ * gebr_comm_runner_chunk_finished:
+ *
+ * Tells @self that @daemon finished its chunk, sending it the next one.
+ *
+ * Returns: %TRUE if a new chunk was sent to @daemon.
+ */
+gboolean gebr_comm_runner_chunk_finished(GebrCommRunner *self,
+					 GebrCommDaemon *daemon);
+
+/**
+ * gebr_comm_runner_set_cost_func:
+ *
+ * Sets @func to predict how fast each daemon executes the flow. Daemons
+ * with a known cost are scored by it instead of by their clock.
+ */
+void gebr_comm_runner_set_cost_func(GebrCommRunner *self,
+				    GebrCommRunnerCostFunc func,
+				    gpointer data);
+
+/**
+ * gebr_comm_runner_get_task_steps:
+ *
+ * Returns: the number of loop steps sent as the task @frac, storing in
+ * @daemon and @ncores where it runs and the cores it was given, or -1 if
+ * @frac was not sent by @self.
+ */
+gint gebr_comm_runner_get_task_steps(GebrCommRunner *self,
+				     gint frac,
+				     GebrCommDaemon **daemon,
+				     gint *ncores);
+
+/**
+ * gebr_comm_runner_can_split:
+ *
+ * Returns: %TRUE if the tasks of @self may be stopped between two batches
+ * and the rest run elsewhere, which is the case for loops split in static
+ * tasks whose output file depends on the iteration.
+ */
+gboolean gebr_comm_runner_can_split(GebrCommRunner *self);
+
+/**
+ * gebr_comm_runner_run_remainder:
+ *
+ * Sends the loop steps of the task @frac that it did not run, when it
+ * was stopped after @done steps, to @daemon. The rest gets a new
+ * fraction after gebr_comm_runner_get_total().
+ *
+ * Returns: the fraction of the rest, or -1 on error.
+ */
+gint gebr_comm_runner_run_remainder(GebrCommRunner *self,
+				    gint frac,
+				    gint done,
+				    GebrCommDaemon *daemon);
+
+/**
+ * gebr_comm_runner_get_flow_hash:
+ *
+ * Returns: a checksum of the contents of the flow that affect its
+ * execution, ignoring titles, dates and helps. Free with g_free().
+ */
+gchar *gebr_comm_runner_get_flow_hash(GebrCommRunner *self);
+
+/**
+ * gebr_comm_runner_set_scaling:
+ *
+ * Sets how the flow scales with the number of processes per daemon. If the
+ * speed is #GEBR_COMM_RUNNER_SPEED_AUTO, the number of processes is the one
+ * that finishes first according to @scaling. Without a scaling, one process
+ * per core is used.
+ */
+void gebr_comm_runner_set_scaling(GebrCommRunner *self,
+				  const GebrScaling *scaling);
+
+/**
+ * gebr_comm_runner_set_memory_per_process:
+ * @kb: The peak memory of each process of the flow, in kB, or 0 if unknown
+ *
+ * Restricts the processes sent to each daemon to the ones that fit in its
+ * available memory. If no daemon fits a single process, the flow still
+ * runs on the daemon with most memory.
+ */
+void gebr_comm_runner_set_memory_per_process(GebrCommRunner *self,
+					     glong kb);
+
+/**
+ * gebr_comm_runner_get_speed:
+ *
+ * Returns: the speed used by @self. For #GEBR_COMM_RUNNER_SPEED_AUTO, it
+ * is the speed equivalent to the chosen number of processes, available
+ * after the job was submitted.
+ */
+gdouble gebr_comm_runner_get_speed(GebrCommRunner *self);
+
 const gchar *gebr_comm_runner_get_id(GebrCommRunner *self);
 
 const gchar *gebr_comm_runner_get_mpi_owner(GebrCommRunner *self);
@@ -278,6 +278,17 @@ on_comm_port_defined(GebrCommPortProvider *self,
 		     guint port,
 		     GebrCommServer *server)
 {
+	// The connection was given up (e.g. by a connection deadline) while
+	// the port was being forwarded, drop the late forward.
+	if (server->state == SERVER_STATE_DISCONNECTED) {
+		GebrCommPortForward *forward = gebr_comm_port_provider_get_forward(self);
+		if (forward) {
+			gebr_comm_port_forward_close(forward);
+			gebr_comm_port_forward_free(forward);
+		}
+		return;
+	}
+
 	// The connection_forward must be reset when gebr_comm_server_connect
 	// is called.
 	g_warn_if_fail(server->priv->connection_forward == NULL);
@@ -442,12 +453,26 @@ void gebr_comm_server_connect(GebrCommServer *server,
 void gebr_comm_server_disconnect(GebrCommServer *server)
 {
 	if (server->state == SERVER_STATE_CONNECT
-	    || server->state == SERVER_STATE_LOGGED)
+	    || server->state == SERVER_STATE_LOGGED
+	    || gebr_comm_server_is_forwarded(server))
 		gebr_comm_protocol_socket_disconnect(server->socket);
 	else
 		gebr_comm_server_change_state(server, SERVER_STATE_DISCONNECTED);
 }
 
+gboolean
+gebr_comm_server_is_forwarded(GebrCommServer *server)
+{
+	return server->state == SERVER_STATE_RUN
+		&& server->priv->connection_forward != NULL;
+}
+
+gboolean
+gebr_comm_server_is_waiting_user(GebrCommServer *server)
+{
+	return server->priv->pending_connections != NULL;
+}
+
 gboolean
 gebr_comm_server_is_logged(GebrCommServer *server)
 {
@@ -673,11 +698,14 @@ gebr_comm_server_socket_connected(GebrCommProtocolSocket * socket,
 
 		g_free(gebr_time_iso);
 	} else {
+		/* The last argument offers the binary framing. Older
+		 * daemons ignore it and keep using the text one. */
 		gebr_comm_protocol_socket_oldmsg_send(server->socket, FALSE,
-						      gebr_comm_protocol_defs.ini_def, 3,
+						      gebr_comm_protocol_defs.ini_def, 4,
 						      gebr_comm_protocol_get_version(),
 						      hostname,
-						      server->priv->gebr_cookie);
+						      server->priv->gebr_cookie,
+						      G_STRINGIFY(GEBR_COMM_PROTOCOL_FRAMING_BINARY));
 	}
 
 }
@@ -185,6 +185,22 @@ void gebr_comm_server_disconnect(GebrCommServer *gebr_comm_server);
 
 gboolean gebr_comm_server_is_logged(GebrCommServer *gebr_comm_server);
 
+/**
+ * gebr_comm_server_is_forwarded:
+ *
+ * Returns: %TRUE if @server is still launching but its port was already
+ * forwarded, that is, only the connection to the forwarded port is missing.
+ */
+gboolean gebr_comm_server_is_forwarded(GebrCommServer *server);
+
+/**
+ * gebr_comm_server_is_waiting_user:
+ *
+ * Returns: %TRUE if the connection of @server is blocked on a password or a
+ * question that must be answered by the user.
+ */
+gboolean gebr_comm_server_is_waiting_user(GebrCommServer *server);
+
 void gebr_comm_server_set_logged(GebrCommServer *server);
 
 gboolean gebr_comm_server_is_local(GebrCommServer *gebr_comm_server);
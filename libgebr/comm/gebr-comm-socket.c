@@ -433,9 +433,9 @@ GString *gebr_comm_socket_read_string(GebrCommSocket * socket, gsize max_size)
 	if (read_bytes == -1)
 		return NULL;
 
+	/* keep embedded NULs, used by the binary framing */
 	buffer[read_bytes] = '\0';
-	string = g_string_new(NULL);
-	g_string_assign(string, buffer);
+	string = g_string_new_len(buffer, read_bytes);
 
 	return string;
 }
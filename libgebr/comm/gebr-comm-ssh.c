@@ -36,6 +36,7 @@
 #define SSH_ERROR_PREFIX "ssh: "
 #define SENDING_COMMAND "Sending command: "
 #define REMOTE_FORWARD "remote forward success for:"
+#define MUX_SESSION "master session id:"
 #define LIMITED_WRONG_PASSWORD "No more authentication methods to try"
 #define LOCAL_FORWARD_ERROR "Could not request local forwarding."
 #define HOST_VERIFICATION_ERROR "Host key verification failed."
@@ -324,6 +325,13 @@ static void
 ssh_process_finished(GebrCommTerminalProcess *process,
 		     GebrCommSsh *self)
 {
+	/* Through a master connection, nothing is printed after the output */
+	if (self->priv->out_state == SSH_OUT_STATE_COMMAND_OUTPUT
+	    && self->priv->out_buffer->len) {
+		g_signal_emit(self, signals[SSH_STDOUT], 0, self->priv->out_buffer);
+		self->priv->out_state = SSH_OUT_STATE_INIT;
+	}
+
 	self->priv->state = GEBR_COMM_SSH_STATE_FINISHED;
 	gebr_comm_terminal_process_free(process);
 	g_signal_emit(self, signals[SSH_FINISHED], 0);
@@ -416,7 +424,8 @@ process_ssh_line(GebrCommSsh *self,
 			self->priv->state = GEBR_COMM_SSH_STATE_ERROR;
 			g_signal_emit(self, signals[SSH_ERROR], 0, GEBR_COMM_SSH_ERROR_LOCAL_FORWARD);
 		}
-		else if (strstr(line, SENDING_COMMAND) || strstr(line, REMOTE_FORWARD)) {
+		else if (strstr(line, SENDING_COMMAND) || strstr(line, REMOTE_FORWARD)
+			 || strstr(line, MUX_SESSION)) {
 			self->priv->out_state = SSH_OUT_STATE_COMMAND_OUTPUT;
 			schedule_stdin_signal(self);
 		}
@@ -22,10 +22,13 @@
 #include <libgebr/utils.h>
 #include "gebr-comm-listensocket.h"
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <glib/gstdio.h>
 
 void
 gebr_comm_get_display(gchar **x11_file, guint *port, gchar **host)
@@ -148,6 +151,64 @@ gebr_comm_get_ssh_command_with_key(gboolean check_host)
 	return g_string_free(ssh_cmd, FALSE);
 }
 
+/*
+ * Other users can create @dir before us, or replace it by a symbolic link,
+ * to take the control sockets. Only a directory of ours that nobody else
+ * can write is used.
+ */
+static gboolean
+is_private_dir(const gchar *dir)
+{
+	struct stat st;
+
+	if (g_lstat(dir, &st) != 0)
+		return FALSE;
+
+	return S_ISDIR(st.st_mode)
+		&& st.st_uid == getuid()
+		&& (st.st_mode & 0777) == 0700;
+}
+
+gchar *
+gebr_comm_get_ssh_control_path_from_dir(const gchar *tmp_dir,
+					const gchar *address)
+{
+	gchar *dirname = g_strdup_printf("gebr-ssh-%s", g_get_user_name());
+	gchar *dir = g_build_filename(tmp_dir, dirname, NULL);
+	gchar *path = NULL;
+
+	g_free(dirname);
+
+	if (g_mkdir(dir, 0700) != 0 && errno != EEXIST) {
+		g_warning("Could not create directory %s: %s", dir, g_strerror(errno));
+		goto out;
+	}
+
+	if (!is_private_dir(dir)) {
+		g_warning("Directory %s is not private to %s, not sharing ssh connections",
+			  dir, g_get_user_name());
+		goto out;
+	}
+
+	/* Sockets paths are limited to 108 characters, so keep it short. The
+	 * host name tells apart the masters of hosts sharing /tmp */
+	gchar *key = g_strconcat(g_get_host_name(), " ", address, NULL);
+	gchar *name = g_compute_checksum_for_string(G_CHECKSUM_MD5, key, -1);
+	path = g_build_filename(dir, name, NULL);
+	g_free(key);
+	g_free(name);
+
+out:
+	g_free(dir);
+	return path;
+}
+
+gchar *
+gebr_comm_get_ssh_control_path(const gchar *address)
+{
+	return gebr_comm_get_ssh_control_path_from_dir(g_get_tmp_dir(), address);
+}
+
 guint
 gebr_comm_get_available_port(guint start)
 {
@@ -46,6 +46,24 @@ gboolean gebr_comm_is_address_equal(const gchar *addr1, const gchar *addr2);
 
 gchar *gebr_comm_get_ssh_command_with_key(gboolean check_host);
 
+/**
+ * gebr_comm_get_ssh_control_path:
+ *
+ * Returns: the path of the control socket of the multiplexed ssh connection
+ * to @address, in a directory of the temporary dir that is created if
+ * needed. %NULL if that directory is not owned by the user or other users
+ * can access it.
+ */
+gchar *gebr_comm_get_ssh_control_path(const gchar *address);
+
+/**
+ * gebr_comm_get_ssh_control_path_from_dir:
+ *
+ * Same as gebr_comm_get_ssh_control_path(), but in @tmp_dir.
+ */
+gchar *gebr_comm_get_ssh_control_path_from_dir(const gchar *tmp_dir,
+					       const gchar *address);
+
 /**
  * gebr_comm_get_available_port:
  *
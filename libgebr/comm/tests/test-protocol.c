@@ -32,11 +32,76 @@ void test_comm_build_message()
 	g_assert_cmpstr(message->str, ==, "FOO 14 6|teste1 3|123\n");
 }
 
+static GString *build_binary(struct gebr_comm_message_def msg_def, gboolean is_return, guint n_params, ...)
+{
+	va_list ap;
+	va_start(ap, n_params);
+	return gebr_comm_protocol_build_framed_messagev(msg_def, is_return, GEBR_COMM_PROTOCOL_FRAMING_BINARY, n_params, ap);
+}
+
+void test_comm_binary_message()
+{
+	GString *message;
+	GString *data;
+	GList *split;
+	struct gebr_comm_message *received;
+	struct gebr_comm_protocol *protocol;
+
+	gebr_comm_protocol_init();
+	protocol = gebr_comm_protocol_new();
+
+	message = build_binary(gebr_comm_protocol_defs.out_def, FALSE, 4, "1", "", "teste1", "123");
+	g_assert_cmpint((guchar)message->str[0], ==, GEBR_COMM_PROTOCOL_BINARY_MAGIC);
+
+	/* an incomplete frame waits for more data */
+	data = g_string_new_len(message->str, 5);
+	g_assert(gebr_comm_protocol_receive_binary_data(protocol, data));
+	g_assert(protocol->messages == NULL);
+
+	g_string_assign(data, "");
+	g_string_append_len(data, message->str + 5, message->len - 5);
+	g_assert(gebr_comm_protocol_receive_binary_data(protocol, data));
+	g_assert_cmpint(g_list_length(protocol->messages), ==, 1);
+
+	received = protocol->messages->data;
+	g_assert_cmpuint(received->hash, ==, gebr_comm_protocol_defs.out_def.code_hash);
+
+	split = gebr_comm_protocol_split_new(received->argument, 4);
+	g_assert(split != NULL);
+	g_assert_cmpstr(((GString *)g_list_nth_data(split, 1))->str, ==, "");
+	g_assert_cmpstr(((GString *)g_list_nth_data(split, 2))->str, ==, "teste1");
+	g_assert_cmpstr(((GString *)g_list_nth_data(split, 3))->str, ==, "123");
+	gebr_comm_protocol_split_free(split);
+
+	/* converting back gives the text framing */
+	g_string_free(message, TRUE);
+	message = gebr_comm_protocol_rebuild_message(received, GEBR_COMM_PROTOCOL_FRAMING_TEXT);
+	g_assert_cmpstr(message->str, ==, "OUT 21 1|1 0| 6|teste1 3|123\n");
+
+	/* text after a binary frame is handed back */
+	g_string_free(message, TRUE);
+	message = build_binary(gebr_comm_protocol_defs.ini_def, TRUE, 1, "host");
+	g_string_assign(data, "");
+	g_string_append_len(data, message->str, message->len);
+	g_string_append(data, "KIL 3 1|7\n");
+	g_assert(gebr_comm_protocol_receive_binary_data(protocol, data));
+	g_assert_cmpstr(data->str, ==, "KIL 3 1|7\n");
+
+	received = protocol->messages->data;
+	g_assert_cmpuint(received->hash, ==, gebr_comm_protocol_defs.ret_def.code_hash);
+	g_assert_cmpuint(received->ret_hash, ==, gebr_comm_protocol_defs.ini_def.code_hash);
+
+	g_string_free(message, TRUE);
+	g_string_free(data, TRUE);
+	gebr_comm_protocol_free(protocol);
+}
+
 int main(int argc, char *argv[])
 {
 	g_test_init(&argc, &argv, NULL);
 
 	g_test_add_func("/comm/protocol/build-message", test_comm_build_message);
+	g_test_add_func("/comm/protocol/binary-message", test_comm_binary_message);
 
 	return g_test_run();
 }
@@ -0,0 +1,744 @@
+/*   libgebr - GêBR Library
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Drives GebrCommRunner against simulated daemons, in simulated time.
+ *
+ * Jobs arrive at random and each one is a loop whose steps have random
+ * costs. The runner scores the daemons from their telemetry and divides the
+ * loop among them, as it does in the maestro; the simulation then decides
+ * how long each task takes. The contention of a task is fixed when it
+ * starts: its processes share the cores of the daemon with the ones already
+ * there. Nothing is sent, the sockets of the daemons are never connected.
+ *
+ * Run with --bench to replay a workload given in the command line and
+ * print its makespan, utilization and fairness, see --bench --help.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <gebr-comm-daemon.h>
+#include <gebr-comm-protocol.h>
+#include <gebr-comm-protocol-socket.h>
+#include <gebr-comm-runner.h>
+#include <gebr-comm-server.h>
+#include <libgebr/geoxml/geoxml.h>
+#include <libgebr/gebr-validator.h>
+
+/* SimDaemon {{{1 */
+#define SIM_TYPE_DAEMON (sim_daemon_get_type())
+#define SIM_DAEMON(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), SIM_TYPE_DAEMON, SimDaemon))
+
+typedef struct {
+	GObject parent;
+	GebrCommServer *server;
+	gchar *hostname;
+	gdouble speed;   /* Relative speed of a core, also its clock in GHz */
+	gint background; /* Processes not started by GeBR */
+	gint running;    /* Processes of the tasks running */
+	gint n_tasks;
+	GebrCommTelemetry telemetry;
+} SimDaemon;
+
+typedef struct {
+	GObjectClass parent_class;
+} SimDaemonClass;
+
+static void sim_daemon_init_iface(GebrCommDaemonIface *iface);
+
+GType sim_daemon_get_type(void) G_GNUC_CONST;
+
+G_DEFINE_TYPE_WITH_CODE(SimDaemon, sim_daemon, G_TYPE_OBJECT,
+			G_IMPLEMENT_INTERFACE(GEBR_COMM_TYPE_DAEMON, sim_daemon_init_iface));
+
+static void
+sim_daemon_finalize(GObject *object)
+{
+	SimDaemon *self = SIM_DAEMON(object);
+
+	g_string_free(self->server->address, TRUE);
+	g_object_unref(self->server->socket);
+	g_object_unref(self->server);
+	g_free(self->hostname);
+	g_free(self->telemetry.load);
+	g_free(self->telemetry.core_usage);
+
+	G_OBJECT_CLASS(sim_daemon_parent_class)->finalize(object);
+}
+
+static void
+sim_daemon_init(SimDaemon *self)
+{
+}
+
+static void
+sim_daemon_class_init(SimDaemonClass *klass)
+{
+	G_OBJECT_CLASS(klass)->finalize = sim_daemon_finalize;
+}
+
+static SimDaemon *
+sim_daemon_new(const gchar *hostname,
+	       gint ncores,
+	       gdouble speed,
+	       gint background)
+{
+	SimDaemon *self = g_object_new(SIM_TYPE_DAEMON, NULL);
+
+	self->hostname = g_strdup(hostname);
+	self->speed = speed;
+	self->background = background;
+
+	self->server = g_object_new(GEBR_COMM_TYPE_SERVER, NULL);
+	self->server->address = g_string_new(hostname);
+	self->server->socket = gebr_comm_protocol_socket_new();
+	self->server->state = SERVER_STATE_LOGGED;
+	self->server->ncores = ncores;
+	self->server->clock_cpu = speed * 1000;
+
+	self->telemetry.ncores = ncores;
+	self->telemetry.core_usage = g_new0(gdouble, ncores);
+
+	return self;
+}
+
+static GebrCommServer *
+sim_daemon_get_server(GebrCommDaemon *daemon)
+{
+	return SIM_DAEMON(daemon)->server;
+}
+
+static gint
+sim_daemon_get_n_running_jobs(GebrCommDaemon *daemon)
+{
+	return SIM_DAEMON(daemon)->n_tasks;
+}
+
+static const gchar *
+sim_daemon_get_hostname(GebrCommDaemon *daemon)
+{
+	return SIM_DAEMON(daemon)->hostname;
+}
+
+/* Tasks start as soon as the runner is done, see start_job() */
+static void
+sim_daemon_add_task(GebrCommDaemon *daemon)
+{
+}
+
+static gboolean
+sim_daemon_can_execute(GebrCommDaemon *daemon)
+{
+	return TRUE;
+}
+
+static const gchar *
+sim_daemon_get_flavors(GebrCommDaemon *daemon)
+{
+	return "";
+}
+
+static void
+sim_daemon_reserve_cores(GebrCommDaemon *daemon,
+			 const gchar *job_id,
+			 gint frac,
+			 gint ncores)
+{
+}
+
+/* The telemetry is always fresh, reservations are never used */
+static gint
+sim_daemon_get_reserved_cores(GebrCommDaemon *daemon)
+{
+	return 0;
+}
+
+static const GebrCommTelemetry *
+sim_daemon_get_telemetry(GebrCommDaemon *daemon)
+{
+	SimDaemon *self = SIM_DAEMON(daemon);
+	GebrCommTelemetry *telemetry = &self->telemetry;
+	gint busy = self->running + self->background;
+
+	for (gint i = 0; i < telemetry->ncores; i++)
+		telemetry->core_usage[i] = i < busy ? 1 : 0;
+
+	g_free(telemetry->load);
+	telemetry->load = g_strdup_printf("%d.00 %d.00 %d.00", busy, busy, busy);
+	telemetry->runnable = busy;
+	telemetry->running_tasks = self->n_tasks;
+	telemetry->age = 0;
+	telemetry->pending_cores = 0;
+
+	return telemetry;
+}
+
+static gboolean
+sim_daemon_get_bandwidth(GebrCommDaemon *daemon,
+			 gdouble *read_bw,
+			 gdouble *write_bw)
+{
+	return FALSE;
+}
+
+static void
+sim_daemon_init_iface(GebrCommDaemonIface *iface)
+{
+	iface->get_server = sim_daemon_get_server;
+	iface->get_n_running_jobs = sim_daemon_get_n_running_jobs;
+	iface->get_hostname = sim_daemon_get_hostname;
+	iface->add_task = sim_daemon_add_task;
+	iface->can_execute = sim_daemon_can_execute;
+	iface->get_flavors = sim_daemon_get_flavors;
+	iface->reserve_cores = sim_daemon_reserve_cores;
+	iface->get_reserved_cores = sim_daemon_get_reserved_cores;
+	iface->get_telemetry = sim_daemon_get_telemetry;
+	iface->get_bandwidth = sim_daemon_get_bandwidth;
+}
+
+/* Workload {{{1 */
+typedef struct {
+	gint cores;
+	gdouble speed;
+	gint background;
+} NodeSpec;
+
+typedef struct {
+	gint n_jobs;
+	gdouble rate;   /* Jobs arriving per second */
+	gint steps;     /* Mean number of loop steps of a job */
+	gdouble cost;   /* Mean seconds a step takes on a core of speed 1 */
+	gdouble spread; /* Coefficient of variation of the costs */
+	const gchar *speed;
+	guint32 seed;
+	GArray *nodes;  /* NodeSpec */
+} Workload;
+
+typedef struct {
+	gdouble makespan;
+	gdouble utilization;
+	gdouble mean_response;
+	gdouble fairness; /* Jain's index of the slowdowns of the jobs */
+	gint *steps;      /* Steps run by each node */
+} Report;
+
+typedef struct {
+	gdouble arrival;
+	gdouble finish;
+	gdouble cost; /* Seconds all its steps take on a core of speed 1 */
+	gint steps;
+	gint pending; /* Tasks not finished */
+} SimJob;
+
+typedef struct {
+	SimJob *job;
+	SimDaemon *daemon;
+	gint np;
+} SimTask;
+
+typedef struct {
+	gdouble time;
+	guint64 serial;
+	SimJob *job;   /* Arrival of @job, if @task is %NULL */
+	SimTask *task; /* End of @task */
+} SimEvent;
+
+static gint
+compare_events(gconstpointer a, gconstpointer b, gpointer data)
+{
+	const SimEvent *e1 = a, *e2 = b;
+
+	if (e1->time != e2->time)
+		return e1->time < e2->time ? -1 : 1;
+
+	return (e1->serial > e2->serial) - (e1->serial < e2->serial);
+}
+
+/*
+ * A number of mean 1 and coefficient of variation @spread, from a
+ * log-normal distribution.
+ */
+static gdouble
+random_factor(GRand *rand,
+	      gdouble spread)
+{
+	if (spread <= 0)
+		return 1;
+
+	gdouble sigma2 = log(1 + spread * spread);
+	gdouble u1 = g_rand_double(rand);
+	gdouble u2 = g_rand_double(rand);
+	gdouble z = sqrt(-2 * log(1 - u1)) * cos(2 * G_PI * u2);
+
+	return exp(-sigma2 / 2 + sqrt(sigma2) * z);
+}
+
+/* Simulation {{{1 */
+typedef struct {
+	GebrGeoXmlDocument *flow;
+	GebrGeoXmlDocument *line;
+	GebrGeoXmlDocument *proj;
+	GebrValidator *validator;
+	GList *daemons;
+	GSequence *events;
+	guint64 serial;
+	Report *report;
+} Simulation;
+
+static void
+sim_flow_init(Simulation *sim)
+{
+	GebrGeoXmlDocument *loop;
+	GebrGeoXmlProgram *control;
+
+	sim->flow = GEBR_GEOXML_DOCUMENT(gebr_geoxml_flow_new());
+	sim->line = GEBR_GEOXML_DOCUMENT(gebr_geoxml_line_new());
+	sim->proj = GEBR_GEOXML_DOCUMENT(gebr_geoxml_project_new());
+	sim->validator = gebr_validator_new(&sim->flow, &sim->line, &sim->proj);
+
+	gebr_geoxml_document_load(&loop, TEST_DIR"/forloop.mnu", FALSE, NULL);
+	gebr_geoxml_flow_add_flow(GEBR_GEOXML_FLOW(sim->flow), GEBR_GEOXML_FLOW(loop));
+	gebr_geoxml_document_free(loop);
+
+	control = gebr_geoxml_flow_get_control_program(GEBR_GEOXML_FLOW(sim->flow));
+	gebr_geoxml_program_set_status(control, GEBR_GEOXML_PROGRAM_STATUS_CONFIGURED);
+	gebr_geoxml_object_unref(control);
+
+	GebrGeoXmlProgram *program = gebr_geoxml_flow_append_program(GEBR_GEOXML_FLOW(sim->flow));
+	gebr_geoxml_program_set_status(program, GEBR_GEOXML_PROGRAM_STATUS_CONFIGURED);
+	gebr_geoxml_program_set_stdout(program, TRUE);
+	gebr_geoxml_object_unref(program);
+
+	gebr_geoxml_flow_insert_iter_dict(GEBR_GEOXML_FLOW(sim->flow));
+	GebrGeoXmlParameter *iter = GEBR_GEOXML_PARAMETER(gebr_geoxml_document_get_dict_parameter(sim->flow));
+	gebr_validator_insert(sim->validator, iter, NULL, NULL);
+	gebr_geoxml_object_unref(iter);
+
+	gebr_geoxml_flow_io_set_output(GEBR_GEOXML_FLOW(sim->flow), "");
+}
+
+static void
+sim_flow_set_steps(Simulation *sim,
+		   gint steps)
+{
+	GebrGeoXmlProgram *control = gebr_geoxml_flow_get_control_program(GEBR_GEOXML_FLOW(sim->flow));
+	gchar *n = g_strdup_printf("%d", steps);
+
+	gebr_geoxml_program_control_set_n(control, "1", "1", n);
+	gebr_geoxml_flow_update_iter_dict_value(GEBR_GEOXML_FLOW(sim->flow));
+
+	GebrGeoXmlProgramParameter *iter = GEBR_GEOXML_PROGRAM_PARAMETER(gebr_geoxml_document_get_dict_parameter(sim->flow));
+	gchar *value = gebr_geoxml_program_parameter_get_first_value(iter, FALSE);
+	gebr_validator_change_value(sim->validator, GEBR_GEOXML_PARAMETER(iter), value, NULL, NULL);
+
+	g_free(value);
+	g_free(n);
+	gebr_geoxml_object_unref(iter);
+	gebr_geoxml_object_unref(control);
+}
+
+static void
+push_event(Simulation *sim,
+	   gdouble time,
+	   SimJob *job,
+	   SimTask *task)
+{
+	SimEvent *event = g_new(SimEvent, 1);
+
+	event->time = time;
+	event->serial = sim->serial++;
+	event->job = job;
+	event->task = task;
+	g_sequence_insert_sorted(sim->events, event, compare_events, NULL);
+}
+
+static void
+on_runner_ran(GebrCommRunner *runner,
+	      gpointer data)
+{
+	*(gboolean *)data = TRUE;
+}
+
+/*
+ * Runs @job through GebrCommRunner and starts the tasks it sent.
+ */
+static void
+start_job(Simulation *sim,
+	  const Workload *w,
+	  SimJob *job,
+	  gint index,
+	  gdouble now,
+	  GRand *rand)
+{
+	gboolean ran = FALSE;
+	gchar *id = g_strdup_printf("job%d", index);
+
+	sim_flow_set_steps(sim, job->steps);
+
+	GebrCommRunner *runner = gebr_comm_runner_new(sim->flow, sim->daemons, sim->daemons,
+						      id, "sim", "", w->speed, "0", "", "",
+						      sim->validator);
+	gebr_comm_runner_set_ran_func(runner, on_runner_ran, &ran);
+
+	if (!gebr_comm_runner_run_async(runner))
+		g_error("No simulated daemon can run %s", id);
+
+	while (!ran)
+		g_main_context_iteration(NULL, TRUE);
+
+	/* The cost of each step is drawn around the cost of the job */
+	for (gint frac = 1; frac <= gebr_comm_runner_get_total(runner); frac++) {
+		GebrCommDaemon *daemon;
+		gint np;
+		gint steps = gebr_comm_runner_get_task_steps(runner, frac, &daemon, &np);
+
+		if (steps <= 0)
+			continue;
+
+		SimTask *task = g_new(SimTask, 1);
+		task->job = job;
+		task->daemon = SIM_DAEMON(daemon);
+		task->np = MIN(np, steps);
+
+		gdouble cost = 0;
+		for (gint i = 0; i < steps; i++)
+			cost += job->cost / job->steps * random_factor(rand, w->spread);
+
+		gint ncores = task->daemon->server->ncores;
+		gint busy = task->daemon->running + task->daemon->background;
+		gdouble share = MIN(1.0, (gdouble)ncores / (busy + task->np));
+		gdouble duration = cost / (task->daemon->speed * task->np * share);
+
+		task->daemon->running += task->np;
+		task->daemon->n_tasks++;
+		job->pending++;
+
+		sim->report->steps[g_list_index(sim->daemons, daemon)] += steps;
+		sim->report->utilization += cost / task->daemon->speed;
+
+		push_event(sim, now + duration, job, task);
+	}
+
+	if (!job->pending)
+		job->finish = now;
+
+	gebr_comm_runner_free(runner);
+	g_free(id);
+}
+
+static void
+end_task(SimTask *task,
+	 gdouble now)
+{
+	task->daemon->running -= task->np;
+	task->daemon->n_tasks--;
+
+	if (--task->job->pending == 0)
+		task->job->finish = now;
+
+	g_free(task);
+}
+
+static Report *
+simulate(const Workload *w)
+{
+	Simulation sim = { 0, };
+	GRand *rand = g_rand_new_with_seed(w->seed);
+	SimJob *jobs = g_new0(SimJob, w->n_jobs);
+	gint total_cores = 0;
+	gdouble max_speed = 0;
+	gdouble now = 0;
+
+	sim_flow_init(&sim);
+	sim.events = g_sequence_new(g_free);
+	sim.report = g_new0(Report, 1);
+	sim.report->steps = g_new0(gint, w->nodes->len);
+
+	for (guint i = 0; i < w->nodes->len; i++) {
+		NodeSpec *spec = &g_array_index(w->nodes, NodeSpec, i);
+		gchar *hostname = g_strdup_printf("node%u", i);
+		sim.daemons = g_list_append(sim.daemons,
+					    sim_daemon_new(hostname, spec->cores, spec->speed, spec->background));
+		total_cores += spec->cores;
+		max_speed = MAX(max_speed, spec->speed);
+		g_free(hostname);
+	}
+
+	/* Poisson arrivals */
+	gdouble arrival = 0;
+	for (gint i = 0; i < w->n_jobs; i++) {
+		if (i > 0 && w->rate > 0)
+			arrival += -log(1 - g_rand_double(rand)) / w->rate;
+		jobs[i].arrival = arrival;
+		jobs[i].steps = g_rand_int_range(rand, 1, 2 * w->steps);
+		jobs[i].cost = w->cost * jobs[i].steps * random_factor(rand, w->spread);
+		push_event(&sim, arrival, &jobs[i], NULL);
+	}
+
+	while (g_sequence_get_length(sim.events) > 0) {
+		GSequenceIter *first = g_sequence_get_begin_iter(sim.events);
+		SimEvent *event = g_sequence_get(first);
+
+		now = event->time;
+		if (event->task)
+			end_task(event->task, now);
+		else
+			start_job(&sim, w, event->job, event->job - jobs, now, rand);
+
+		g_sequence_remove(first);
+	}
+
+	/* Slowdown against running alone on the fastest cores */
+	Report *report = sim.report;
+	gdouble sum = 0, sum2 = 0;
+	for (gint i = 0; i < w->n_jobs; i++) {
+		gdouble response = jobs[i].finish - jobs[i].arrival;
+		gdouble ideal = jobs[i].cost / (MIN(jobs[i].steps, total_cores) * max_speed);
+		gdouble slowdown = ideal > 0 ? response / ideal : 1;
+
+		report->mean_response += response / w->n_jobs;
+		sum += slowdown;
+		sum2 += slowdown * slowdown;
+	}
+
+	report->makespan = now - jobs[0].arrival;
+	report->utilization = report->makespan > 0 ? report->utilization / (total_cores * report->makespan) : 0;
+	report->fairness = sum2 > 0 ? sum * sum / (w->n_jobs * sum2) : 1;
+
+	g_list_foreach(sim.daemons, (GFunc)g_object_unref, NULL);
+	g_list_free(sim.daemons);
+	g_sequence_free(sim.events);
+	gebr_validator_free(sim.validator);
+	gebr_geoxml_document_free(sim.flow);
+	gebr_geoxml_document_free(sim.line);
+	gebr_geoxml_document_free(sim.proj);
+	g_rand_free(rand);
+	g_free(jobs);
+
+	return report;
+}
+
+static void
+report_free(Report *report)
+{
+	g_free(report->steps);
+	g_free(report);
+}
+
+/*
+ * Parses nodes given as CORESxSPEED[+BUSY], separated by commas, such as
+ * "8x1.0,4x2.5+2".
+ */
+static GArray *
+parse_nodes(const gchar *str)
+{
+	GArray *nodes = g_array_new(FALSE, TRUE, sizeof(NodeSpec));
+	gchar **specs = g_strsplit(str, ",", 0);
+
+	for (gint i = 0; specs[i]; i++) {
+		NodeSpec spec = { 1, 1, 0 };
+		gchar *end;
+
+		spec.cores = strtol(specs[i], &end, 10);
+		if (*end == 'x')
+			spec.speed = g_ascii_strtod(end + 1, &end);
+		if (*end == '+')
+			spec.background = strtol(end + 1, &end, 10);
+
+		if (*end || spec.cores <= 0 || spec.speed <= 0 || spec.background < 0) {
+			g_array_free(nodes, TRUE);
+			nodes = NULL;
+			break;
+		}
+		g_array_append_val(nodes, spec);
+	}
+
+	g_strfreev(specs);
+	return nodes;
+}
+
+static Workload
+default_workload(void)
+{
+	Workload w = {
+		.n_jobs = 20,
+		.rate = 0.05,
+		.steps = 40,
+		.cost = 10,
+		.spread = 0.3,
+		.speed = GEBR_COMM_RUNNER_SPEED_AUTO,
+		.seed = 42,
+		.nodes = parse_nodes("8x1.0,8x1.0+4,4x2.0"),
+	};
+	return w;
+}
+
+/* Tests {{{1 */
+static void
+test_runner_sim_reproducible(void)
+{
+	Workload w = default_workload();
+	Report *r1 = simulate(&w);
+	Report *r2 = simulate(&w);
+
+	g_assert_cmpfloat(r1->makespan, ==, r2->makespan);
+	g_assert_cmpfloat(r1->utilization, ==, r2->utilization);
+	for (guint i = 0; i < w.nodes->len; i++)
+		g_assert_cmpint(r1->steps[i], ==, r2->steps[i]);
+
+	g_assert_cmpfloat(r1->utilization, >, 0);
+	g_assert_cmpfloat(r1->utilization, <=, 1);
+	g_assert_cmpfloat(r1->fairness, >, 0);
+	g_assert_cmpfloat(r1->fairness, <=, 1);
+
+	report_free(r1);
+	report_free(r2);
+	g_array_free(w.nodes, TRUE);
+}
+
+static void
+test_runner_sim_faster_node(void)
+{
+	Workload w = default_workload();
+
+	g_array_free(w.nodes, TRUE);
+	w.nodes = parse_nodes("4x1.0,4x2.0");
+	w.n_jobs = 1;
+	w.steps = 100;
+
+	Report *r = simulate(&w);
+	g_assert_cmpint(r->steps[1], >, r->steps[0]);
+
+	report_free(r);
+	g_array_free(w.nodes, TRUE);
+}
+
+static void
+test_runner_sim_busy_node(void)
+{
+	Workload w = default_workload();
+
+	g_array_free(w.nodes, TRUE);
+	w.nodes = parse_nodes("4x1.0+4,4x1.0");
+	w.n_jobs = 1;
+	w.steps = 100;
+
+	Report *r = simulate(&w);
+	g_assert_cmpint(r->steps[1], >, r->steps[0]);
+
+	report_free(r);
+	g_array_free(w.nodes, TRUE);
+}
+
+/* Benchmark {{{1 */
+static gint
+run_bench(gint argc, gchar **argv)
+{
+	Workload w = default_workload();
+	gchar *nodes = NULL;
+	gchar *speed = NULL;
+	gint seed = w.seed;
+	gboolean bench;
+	GError *error = NULL;
+
+	GOptionEntry entries[] = {
+		{ "bench", 0, 0, G_OPTION_ARG_NONE, &bench, "Replay a workload", NULL },
+		{ "jobs", 'j', 0, G_OPTION_ARG_INT, &w.n_jobs, "Number of jobs", "N" },
+		{ "rate", 'r', 0, G_OPTION_ARG_DOUBLE, &w.rate, "Jobs arriving per second", "RATE" },
+		{ "steps", 's', 0, G_OPTION_ARG_INT, &w.steps, "Mean loop steps of a job", "N" },
+		{ "cost", 'c', 0, G_OPTION_ARG_DOUBLE, &w.cost, "Mean seconds of a step on a core of speed 1", "SECONDS" },
+		{ "spread", 'v', 0, G_OPTION_ARG_DOUBLE, &w.spread, "Coefficient of variation of the costs", "CV" },
+		{ "nodes", 'n', 0, G_OPTION_ARG_STRING, &nodes, "Nodes, such as 8x1.0,4x2.5+2", "CORESxSPEED[+BUSY],..." },
+		{ "speed", 'p', 0, G_OPTION_ARG_STRING, &speed, "Speed of the jobs, 0 to 5 or auto", "SPEED" },
+		{ "seed", 'S', 0, G_OPTION_ARG_INT, &seed, "Seed of the workload", "SEED" },
+		{ NULL }
+	};
+
+	GOptionContext *context = g_option_context_new("- simulate the scheduling of GeBR jobs");
+	g_option_context_add_main_entries(context, entries, NULL);
+
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		return 1;
+	}
+	g_option_context_free(context);
+
+	if (nodes) {
+		g_array_free(w.nodes, TRUE);
+		w.nodes = parse_nodes(nodes);
+		if (!w.nodes) {
+			g_printerr("Invalid nodes: %s\n", nodes);
+			return 1;
+		}
+	}
+	if (speed)
+		w.speed = speed;
+	w.seed = seed;
+
+	if (w.n_jobs <= 0 || w.steps <= 0 || w.cost <= 0) {
+		g_printerr("The number of jobs, steps and the cost must be positive\n");
+		return 1;
+	}
+
+	Report *r = simulate(&w);
+
+	g_print("makespan:      %.2f s\n", r->makespan);
+	g_print("utilization:   %.1f%%\n", 100 * r->utilization);
+	g_print("mean response: %.2f s\n", r->mean_response);
+	g_print("fairness:      %.3f\n", r->fairness);
+	for (guint i = 0; i < w.nodes->len; i++) {
+		NodeSpec *spec = &g_array_index(w.nodes, NodeSpec, i);
+		g_print("node%u (%dx%.2f+%d): %d steps\n", i,
+			spec->cores, spec->speed, spec->background, r->steps[i]);
+	}
+
+	report_free(r);
+	g_array_free(w.nodes, TRUE);
+	g_free(nodes);
+	g_free(speed);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	g_type_init();
+	gebr_geoxml_init();
+	gebr_comm_protocol_init();
+
+	if (argc > 1 && g_strcmp0(argv[1], "--bench") == 0) {
+		gint ret = run_bench(argc, argv);
+		gebr_geoxml_finalize();
+		return ret;
+	}
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/libgebr/comm/runner-sim/reproducible", test_runner_sim_reproducible);
+	g_test_add_func("/libgebr/comm/runner-sim/faster-node", test_runner_sim_faster_node);
+	g_test_add_func("/libgebr/comm/runner-sim/busy-node", test_runner_sim_busy_node);
+
+	gint ret = g_test_run();
+
+	gebr_geoxml_finalize();
+	return ret;
+}
@@ -18,12 +18,15 @@
 #include <glib.h>
 #include <glib-object.h>
 #include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <gebr-comm-listensocket.h>
 #include <gebr-comm-channelsocket.h>
 #include <gebr-comm-streamsocket.h>
 #include <gebr-comm-socketaddress.h>
 #include <gebr-comm-socket.h>
+#include <gebr-comm-protocol-socket.h>
 
 GMainLoop *loop;
 
@@ -122,11 +125,217 @@ void test_comm_socket_tcpunix_channel()
 	g_byte_array_free(test_data.data_read2, TRUE);
 }
 
+struct RequestData {
+	GebrCommStreamSocket *server;
+	GString *received;
+};
+
+static void
+server_read(GebrCommStreamSocket *socket,
+	    struct RequestData *data)
+{
+	GString *str = gebr_comm_socket_read_string_all(GEBR_COMM_SOCKET(socket));
+	g_string_append(data->received, str->str);
+	g_string_free(str, TRUE);
+}
+
+static void
+server_new_connection(GebrCommListenSocket *listener,
+		      struct RequestData *data)
+{
+	data->server = gebr_comm_listen_socket_get_next_pending_connection(listener);
+	g_signal_connect(data->server, "ready-read", G_CALLBACK(server_read), data);
+}
+
+static void
+response_received(GebrCommHttpMsg *request,
+		  GebrCommHttpMsg *response,
+		  gchar **content)
+{
+	*content = g_strdup(response->content->str);
+}
+
+static void
+server_answer(struct RequestData *data,
+	      const gchar *id,
+	      const gchar *content)
+{
+	GString *response = g_string_new("HTTP/1.1 200 OK\n");
+
+	if (id)
+		g_string_append_printf(response, "request-id:%s\n", id);
+	g_string_append_printf(response, "content-length:%zu\n\n%s", strlen(content), content);
+	gebr_comm_socket_write_string(GEBR_COMM_SOCKET(data->server), response);
+	g_string_free(response, TRUE);
+}
+
+void test_comm_socket_request_id()
+{
+	struct RequestData data = { NULL, g_string_new(NULL) };
+	gchar *dir = g_build_filename(g_get_tmp_dir(), "gebr-test-XXXXXX", NULL);
+	g_assert(mkdtemp(dir) != NULL);
+
+	gchar *path = g_build_filename(dir, "socket", NULL);
+	GebrCommSocketAddress address = gebr_comm_socket_address_unix(path);
+	gchar *answers[4] = { NULL, NULL, NULL, NULL };
+	GebrCommHttpMsg *requests[4];
+
+	GebrCommListenSocket *listener = gebr_comm_listen_socket_new();
+	g_assert(gebr_comm_listen_socket_listen(listener, &address));
+	g_signal_connect(listener, "new-connection", G_CALLBACK(server_new_connection), &data);
+
+	GebrCommProtocolSocket *client = gebr_comm_protocol_socket_new();
+	g_assert(gebr_comm_protocol_socket_connect(client, &address, TRUE));
+
+	for (gint i = 0; i < 4; i++) {
+		requests[i] = gebr_comm_protocol_socket_send_request(client, GEBR_COMM_HTTP_METHOD_GET,
+								     i % 2 ? "/odd" : "/even", NULL);
+		g_signal_connect(requests[i], "response-received",
+				 G_CALLBACK(response_received), &answers[i]);
+	}
+
+	/* Waits for the requests, which carry ids 1 to 4 */
+	while (!data.server || !strstr(data.received->str, "request-id:4"))
+		g_main_context_iteration(NULL, TRUE);
+
+	/* Answered out of order, each response goes to its request */
+	server_answer(&data, "2", "second");
+	server_answer(&data, "1", "first");
+	while (!answers[0] || !answers[1])
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpstr(answers[0], ==, "first");
+	g_assert_cmpstr(answers[1], ==, "second");
+
+	/* Peers that do not echo the id answer in order */
+	server_answer(&data, NULL, "third");
+	server_answer(&data, NULL, "fourth");
+	while (!answers[2] || !answers[3])
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpstr(answers[2], ==, "third");
+	g_assert_cmpstr(answers[3], ==, "fourth");
+
+	for (gint i = 0; i < 4; i++)
+		g_free(answers[i]);
+	g_object_unref(client);
+	g_object_unref(data.server);
+	g_object_unref(listener);
+	g_string_free(data.received, TRUE);
+	g_unlink(path);
+	g_rmdir(dir);
+	g_free(path);
+	g_free(dir);
+}
+
+struct ServerData {
+	GebrCommProtocolSocket *server;
+	GebrCommHttpMsg *slow; // Answered later, see server_process_request()
+	gchar *big;
+};
+
+static void
+server_process_request(GebrCommProtocolSocket *socket,
+		       GebrCommHttpMsg *request,
+		       struct ServerData *data)
+{
+	if (g_strcmp0(request->url->str, "/slow") == 0) {
+		data->slow = g_object_ref(request);
+		return;
+	}
+
+	GebrCommJsonContent *json = gebr_comm_json_content_new(g_strcmp0(request->url->str, "/big") == 0 ?
+							       data->big : "fast");
+	gebr_comm_protocol_socket_send_response(socket, 200, json);
+	gebr_comm_json_content_free(json);
+}
+
+static void
+protocol_new_connection(GebrCommListenSocket *listener,
+			struct ServerData *data)
+{
+	GebrCommStreamSocket *stream = gebr_comm_listen_socket_get_next_pending_connection(listener);
+	data->server = gebr_comm_protocol_socket_new_from_socket(stream);
+	g_signal_connect(data->server, "process-request", G_CALLBACK(server_process_request), data);
+}
+
+static void
+response_chunk_received(GebrCommHttpMsg *request,
+			GebrCommHttpMsg *response,
+			GString *chunk,
+			GString *streamed)
+{
+	g_string_append_len(streamed, chunk->str, chunk->len);
+}
+
+void test_comm_socket_deferred_response()
+{
+	struct ServerData data = { NULL, NULL, NULL };
+	gchar *dir = g_build_filename(g_get_tmp_dir(), "gebr-test-XXXXXX", NULL);
+	g_assert(mkdtemp(dir) != NULL);
+
+	gchar *path = g_build_filename(dir, "socket", NULL);
+	GebrCommSocketAddress address = gebr_comm_socket_address_unix(path);
+	gchar *answers[3] = { NULL, NULL, NULL };
+	GString *streamed = g_string_new(NULL);
+
+	/* Large enough to arrive in several reads */
+	data.big = g_strnfill(1 << 20, 'x');
+
+	GebrCommListenSocket *listener = gebr_comm_listen_socket_new();
+	g_assert(gebr_comm_listen_socket_listen(listener, &address));
+	g_signal_connect(listener, "new-connection", G_CALLBACK(protocol_new_connection), &data);
+
+	GebrCommProtocolSocket *client = gebr_comm_protocol_socket_new();
+	g_assert(gebr_comm_protocol_socket_connect(client, &address, TRUE));
+
+	GebrCommHttpMsg *slow = gebr_comm_protocol_socket_send_request(client, GEBR_COMM_HTTP_METHOD_GET, "/slow", NULL);
+	GebrCommHttpMsg *fast = gebr_comm_protocol_socket_send_request(client, GEBR_COMM_HTTP_METHOD_GET, "/fast", NULL);
+	GebrCommHttpMsg *big = gebr_comm_protocol_socket_send_request(client, GEBR_COMM_HTTP_METHOD_GET, "/big", NULL);
+	g_signal_connect(slow, "response-received", G_CALLBACK(response_received), &answers[0]);
+	g_signal_connect(fast, "response-received", G_CALLBACK(response_received), &answers[1]);
+	g_signal_connect(big, "response-received", G_CALLBACK(response_received), &answers[2]);
+	big->stream_content = TRUE;
+	g_signal_connect(big, "response-chunk-received", G_CALLBACK(response_chunk_received), streamed);
+
+	/* The requests behind the slow one are not held by it */
+	while (!answers[1] || !answers[2])
+		g_main_context_iteration(NULL, TRUE);
+	g_assert(answers[0] == NULL);
+	g_assert(data.slow != NULL);
+	g_assert_cmpstr(answers[1], ==, "fast");
+
+	/* The big one came in parts, and was not kept on the response */
+	g_assert_cmpstr(answers[2], ==, "");
+	g_assert_cmpuint(streamed->len, ==, strlen(data.big));
+	g_assert_cmpstr(streamed->str, ==, data.big);
+
+	GebrCommJsonContent *json = gebr_comm_json_content_new("slow");
+	gebr_comm_protocol_socket_send_response_to(data.server, data.slow, 200, json);
+	gebr_comm_json_content_free(json);
+	while (!answers[0])
+		g_main_context_iteration(NULL, TRUE);
+	g_assert_cmpstr(answers[0], ==, "slow");
+
+	for (gint i = 0; i < 3; i++)
+		g_free(answers[i]);
+	gebr_comm_http_msg_free(data.slow);
+	g_object_unref(client);
+	g_object_unref(data.server);
+	g_object_unref(listener);
+	g_string_free(streamed, TRUE);
+	g_free(data.big);
+	g_unlink(path);
+	g_rmdir(dir);
+	g_free(path);
+	g_free(dir);
+}
+
 int main(int argc, char *argv[])
 {
 	g_test_init(&argc, &argv, NULL);
 	loop = g_main_loop_new(NULL, FALSE);
 	g_type_init();
 	//g_test_add_func("/comm/socket/tcpunix-channel", test_comm_socket_tcpunix_channel);
+	g_test_add_func("/comm/socket/request-id", test_comm_socket_request_id);
+	g_test_add_func("/comm/socket/deferred-response", test_comm_socket_deferred_response);
 	return g_test_run();
 }
@@ -0,0 +1,117 @@
+/*   libgebr - GêBR Library
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <gebr-comm-utils.h>
+
+static gchar *
+make_tmp_dir(void)
+{
+	gchar *dir = g_build_filename(g_get_tmp_dir(), "gebr-test-XXXXXX", NULL);
+	g_assert(mkdtemp(dir) != NULL);
+	return dir;
+}
+
+static gchar *
+get_private_dir(const gchar *tmp_dir)
+{
+	gchar *name = g_strdup_printf("gebr-ssh-%s", g_get_user_name());
+	gchar *dir = g_build_filename(tmp_dir, name, NULL);
+	g_free(name);
+	return dir;
+}
+
+static void
+test_comm_utils_control_path(void)
+{
+	gchar *tmp = make_tmp_dir();
+	gchar *dir = get_private_dir(tmp);
+	struct stat st;
+
+	/* The directory is created private */
+	gchar *path1 = gebr_comm_get_ssh_control_path_from_dir(tmp, "user@host1");
+	g_assert(path1 != NULL);
+	g_assert(g_str_has_prefix(path1, dir));
+	g_assert(g_lstat(dir, &st) == 0);
+	g_assert(S_ISDIR(st.st_mode));
+	g_assert_cmpint(st.st_mode & 0777, ==, 0700);
+
+	/* Same address, same socket; other addresses get their own */
+	gchar *path2 = gebr_comm_get_ssh_control_path_from_dir(tmp, "user@host1");
+	gchar *path3 = gebr_comm_get_ssh_control_path_from_dir(tmp, "user@host2");
+	g_assert_cmpstr(path1, ==, path2);
+	g_assert_cmpstr(path1, !=, path3);
+	g_assert_cmpint(strlen(path1), <, 108);
+
+	g_free(path1);
+	g_free(path2);
+	g_free(path3);
+	g_rmdir(dir);
+	g_rmdir(tmp);
+	g_free(dir);
+	g_free(tmp);
+}
+
+static void
+test_comm_utils_control_path_not_private(void)
+{
+	gchar *tmp = make_tmp_dir();
+	gchar *dir = get_private_dir(tmp);
+
+	/* Directories refused are warned about */
+	g_log_set_always_fatal(G_LOG_FATAL_MASK | G_LOG_LEVEL_CRITICAL);
+
+	/* Others could replace the sockets of a directory they can write */
+	g_assert(g_mkdir(dir, 0777) == 0);
+	g_assert(g_chmod(dir, 0777) == 0);
+	g_assert(gebr_comm_get_ssh_control_path_from_dir(tmp, "host") == NULL);
+	g_rmdir(dir);
+
+	/* A symbolic link, even to a private directory, is not followed */
+	gchar *target = make_tmp_dir();
+	g_assert(g_chmod(target, 0700) == 0);
+	g_assert(symlink(target, dir) == 0);
+	g_assert(gebr_comm_get_ssh_control_path_from_dir(tmp, "host") == NULL);
+	g_unlink(dir);
+	g_rmdir(target);
+
+	/* Neither is a file */
+	g_assert(g_file_set_contents(dir, "", 0, NULL));
+	g_assert(gebr_comm_get_ssh_control_path_from_dir(tmp, "host") == NULL);
+	g_unlink(dir);
+
+	g_rmdir(tmp);
+	g_free(target);
+	g_free(dir);
+	g_free(tmp);
+}
+
+int main(int argc, char *argv[])
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/comm/utils/control-path", test_comm_utils_control_path);
+	g_test_add_func("/comm/utils/control-path-not-private", test_comm_utils_control_path_not_private);
+
+	return g_test_run();
+}
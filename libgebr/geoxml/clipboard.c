@@ -24,6 +24,7 @@
 #include "flow.h"
 #include "program.h"
 #include "types.h"
+#include "exception_p.h"
 #include "xml.h"
 
 extern GdomeDocument *clipboard_document;
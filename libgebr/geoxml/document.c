@@ -61,6 +61,7 @@
 #include "program_p.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "value_sequence.h"
 #include "xml.h"
 #include "date.h"
@@ -72,9 +73,9 @@
 /* global variables */
 /**
  * \internal
- * Global variable.
+ * The GdomeException of each thread, see exception_p.h.
  */
-GdomeException exception;
+static GStaticPrivate exception_key = G_STATIC_PRIVATE_INIT;
 
 /**
  * \internal
@@ -176,6 +177,19 @@ void gebr_geoxml_finalize(void)
 	close(xml_error_fd);
 }
 
+GdomeException *
+gebr_geoxml_exception_get(void)
+{
+	GdomeException *e = g_static_private_get(&exception_key);
+
+	if (!e) {
+		e = g_new0(GdomeException, 1);
+		g_static_private_set(&exception_key, e, g_free);
+	}
+
+	return e;
+}
+
 static gchar *
 get_document_property(GebrGeoXmlDocument *doc,
 		      const gchar *prop)
@@ -20,6 +20,7 @@
 #include "enum_option.h"
 #include "xml.h"
 #include "types.h"
+#include "exception_p.h"
 #include "sequence.h"
 
 /*
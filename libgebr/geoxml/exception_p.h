@@ -0,0 +1,46 @@
+/*   libgebr - GeBR Library
+ *   Copyright (C) 2007-2009 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBR_GEOXML_EXCEPTION_P_H
+#define __GEBR_GEOXML_EXCEPTION_P_H
+
+#include <glib.h>
+#include <gdome.h>
+
+G_BEGIN_DECLS
+
+/**
+ * \internal
+ * Returns the GdomeException of the calling thread. Defined in document.c.
+ */
+GdomeException *gebr_geoxml_exception_get(void);
+
+/**
+ * \internal
+ * The extremelly anoying and persintant GdomeException.
+ * Makes possible to use gdome functions in defines, like
+ * gebr_geoxml_document_root_element. Each thread has its own, since some
+ * code reads it back after a call, like gebr_geoxml_sequence_move_after(),
+ * and documents may be loaded by several threads at once.
+ *
+ * Only include this header in the sources of geoxml, other code may have
+ * its own variables named exception.
+ */
+#define exception (*gebr_geoxml_exception_get())
+
+G_END_DECLS
+#endif				//__GEBR_GEOXML_EXCEPTION_P_H
@@ -43,6 +43,7 @@
 #include "program.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "value_sequence.h"
 #include "xml.h"
 
@@ -1404,6 +1405,47 @@ GList *gebr_geoxml_flow_divide_flows(GebrGeoXmlFlow *flow,
 	return flows;
 }
 
+GebrGeoXmlFlow *
+gebr_geoxml_flow_divide_chunk(GebrGeoXmlFlow *flow,
+                              GebrValidator *validator,
+                              gint first,
+                              gint n)
+{
+	if (!gebr_geoxml_flow_is_parallelizable(flow, validator))
+		return NULL;
+
+	GebrGeoXmlFlow *chunk;
+	GebrGeoXmlProgram *loop;
+	gchar *loop_n, *step, *ini;
+	gchar *eval_step, *eval_ini;
+	gchar *chunk_ini, *chunk_n;
+
+	loop = gebr_geoxml_flow_get_control_program(flow);
+	loop_n = gebr_geoxml_program_control_get_n(loop, &step, &ini);
+	gebr_geoxml_object_unref(loop);
+	g_free(loop_n);
+
+	gebr_validator_evaluate(validator, step, GEBR_GEOXML_PARAMETER_TYPE_INT, GEBR_GEOXML_DOCUMENT_TYPE_LINE, &eval_step, NULL);
+	gebr_validator_evaluate(validator, ini, GEBR_GEOXML_PARAMETER_TYPE_INT, GEBR_GEOXML_DOCUMENT_TYPE_LINE, &eval_ini, NULL);
+
+	chunk_ini = g_strdup_printf("%f", g_strtod(eval_ini, NULL) + first * g_strtod(eval_step, NULL));
+	chunk_n = g_strdup_printf("%d", n);
+
+	chunk = GEBR_GEOXML_FLOW(gebr_geoxml_document_clone(GEBR_GEOXML_DOCUMENT(flow)));
+	loop = gebr_geoxml_flow_get_control_program(chunk);
+	gebr_geoxml_program_control_set_n(loop, eval_step, chunk_ini, chunk_n);
+	gebr_geoxml_object_unref(loop);
+
+	g_free(chunk_ini);
+	g_free(chunk_n);
+	g_free(ini);
+	g_free(step);
+	g_free(eval_ini);
+	g_free(eval_step);
+
+	return chunk;
+}
+
 GList *
 gebr_geoxml_flow_get_mpi_flavors(GebrGeoXmlFlow *flow)
 {
@@ -542,6 +542,23 @@ GList *gebr_geoxml_flow_divide_flows(GebrGeoXmlFlow *flow,
                                      gint *distributed_n,
                                      gint distributed_n_len);
 
+/**
+ * gebr_geoxml_flow_divide_chunk:
+ * @flow: A parallelizable #GebrGeoXmlFlow
+ * @validator: The #GebrValidator used to evaluate the loop of @flow
+ * @first: The first iteration of the chunk, counting from zero
+ * @n: The number of iterations of the chunk
+ *
+ * Creates a copy of @flow which runs only the iterations @first to
+ * @first + @n - 1 of its loop.
+ *
+ * Returns: A new #GebrGeoXmlFlow, or %NULL if @flow is not parallelizable
+ */
+GebrGeoXmlFlow *gebr_geoxml_flow_divide_chunk(GebrGeoXmlFlow *flow,
+                                              GebrValidator *validator,
+                                              gint first,
+                                              gint n);
+
 /**
  * gebr_geoxml_flow_calculate_proportional_n:
  * @total_n:
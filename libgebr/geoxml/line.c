@@ -31,6 +31,7 @@
 #include "object.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "value_sequence.h"
 #include "xml.h"
 
@@ -29,6 +29,7 @@
 #include "program.h"
 #include "object.h"
 #include "types.h"
+#include "exception_p.h"
 #include "xml.h"
 #include "value_sequence.h"
 #include "document_p.h"
@@ -38,6 +38,7 @@
 #include "program_parameter_p.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "xml.h"
 
 /*
@@ -24,6 +24,7 @@
 #include "parameter_group_p.h"
 #include "xml.h"
 #include "types.h"
+#include "exception_p.h"
 #include "error.h"
 #include "parameters.h"
 #include "parameters_p.h"
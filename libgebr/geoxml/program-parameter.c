@@ -28,6 +28,7 @@
 #include "program_p.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "value_sequence.h"
 #include "xml.h"
 #include "object.h"
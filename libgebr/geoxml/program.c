@@ -37,6 +37,7 @@
 #include "program-parameter.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "value_sequence.h"
 #include "xml.h"
 
@@ -28,6 +28,7 @@
 #include "project.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "xml.h"
 
 /*
@@ -27,6 +27,7 @@
 #include "parameters_p.h"
 #include "sequence.h"
 #include "types.h"
+#include "exception_p.h"
 #include "xml.h"
 #include "object.h"
 
@@ -711,6 +711,29 @@ void test_gebr_geoxml_flow_divide_flows (Fixture *fixture, gconstpointer data)
 	g_list_free(flows);
 }
 
+void test_gebr_geoxml_flow_divide_chunk (Fixture *fixture, gconstpointer data)
+{
+	gchar *ini, *step;
+
+	fixture_change_iter_value(fixture, "1", "2", "100", NULL);
+	gebr_geoxml_flow_io_set_output(GEBR_GEOXML_FLOW(fixture->flow), "");
+
+	// iterations 10 to 34, ie. from 21 to 69 with step 2
+	GebrGeoXmlFlow *chunk = gebr_geoxml_flow_divide_chunk(GEBR_GEOXML_FLOW(fixture->flow), fixture->validator, 10, 25);
+	GebrGeoXmlProgram *control = gebr_geoxml_flow_get_control_program(chunk);
+
+	gchar *n = gebr_geoxml_program_control_get_n(control, &step, &ini);
+	g_assert_cmpstr(n, ==, "25");
+	g_assert_cmpstr(ini, ==, "21.000000");
+	g_assert_cmpstr(step, ==, "2");
+
+	g_free(n);
+	g_free(ini);
+	g_free(step);
+	gebr_geoxml_object_unref(control);
+	gebr_geoxml_document_free(GEBR_GEOXML_DOCUMENT(chunk));
+}
+
 #if 0
 //FIXME Accomodate this test to receive a flow
 void test_gebr_geoxml_flow_create_dot_code(void)
@@ -865,6 +888,11 @@ int main(int argc, char *argv[])
 		           test_gebr_geoxml_flow_divide_flows,
 		           fixture_teardown);
 
+	g_test_add("/libgebr/geoxml/flow/divide_chunk", Fixture, NULL,
+		           fixture_setup,
+		           test_gebr_geoxml_flow_divide_chunk,
+		           fixture_teardown);
+
 	g_test_add_func("/libgebr/geoxml/flow/server_get_and_set_address", test_gebr_geoxml_flow_server_get_and_set_group);
 	g_test_add_func("/libgebr/geoxml/flow/get_categories_number", test_gebr_geoxml_flow_get_categories_number);
 	g_test_add_func("/libgebr/geoxml/flow/duplicate_categories", test_duplicate_categories);
@@ -32,14 +32,5 @@ extern const int parameter_type_to_str_len;
  */
 #define ENCODING "UTF-8"
 
-/**
- * \internal
- * The extremelly anoying and persintant GdomeException.
- * Declaring one global variable makes possible to use gdome
- * functions in defines, like groxml_document_root_element
- * Defined in document.c.
- */
-extern GdomeException exception;
-
 G_END_DECLS
 #endif				// __GEBR_GEOXML_TYPES_H
@@ -22,6 +22,7 @@
 #include "value_sequence.h"
 #include "xml.h"
 #include "types.h"
+#include "exception_p.h"
 
 /*
  * internal stuff
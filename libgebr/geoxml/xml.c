@@ -21,6 +21,7 @@
 
 #include "xml.h"
 #include "types.h"
+#include "exception_p.h"
 
 /*
  * Internal internal functions
@@ -17,6 +17,7 @@
 
 #include <glib.h>
 #include <glib/gstdio.h>
+#include <math.h>
 
 #include "../utils.h"
 
@@ -262,6 +263,44 @@ test_gebr_calculate_number_of_processors(void)
 	g_assert_cmpint(gebr_calculate_number_of_processors(nprocs[3], agression[3]), ==, 9);
 }
 
+void
+test_gebr_calculate_scaling_fit(void)
+{
+	GebrScaling scaling;
+	gint nprocs[] = {1, 2, 4, 8};
+	gdouble costs[4];
+
+	/* Samples taken from t1 = 2, sigma = 0.1, kappa = 0.01 */
+	for (gint i = 0; i < 4; i++)
+		costs[i] = 2 * (1 + 0.1 * (nprocs[i] - 1) + 0.01 * nprocs[i] * (nprocs[i] - 1));
+
+	g_assert(gebr_calculate_scaling_fit(nprocs, costs, 4, &scaling));
+	g_assert_cmpfloat(fabs(scaling.t1 - 2), <, 1e-6);
+	g_assert_cmpfloat(fabs(scaling.sigma - 0.1), <, 1e-6);
+	g_assert_cmpfloat(fabs(scaling.kappa - 0.01), <, 1e-6);
+
+	/* With two process counts only the contention is fitted */
+	g_assert(gebr_calculate_scaling_fit(nprocs, costs, 2, &scaling));
+	g_assert_cmpfloat(scaling.kappa, ==, 0);
+
+	g_assert(!gebr_calculate_scaling_fit(nprocs, costs, 1, &scaling));
+}
+
+void
+test_gebr_calculate_best_number_of_processors(void)
+{
+	GebrScaling linear = { 1, 0, 0 };
+	GebrScaling usl = { 1, 0.1, 0.02 };
+
+	g_assert_cmpint(gebr_calculate_best_number_of_processors(&linear, 16, 2), ==, 16);
+
+	/* The throughput of the USL peaks at sqrt((1 - sigma) / kappa),
+	 * between 6 and 7 processes per node */
+	g_assert_cmpint(gebr_calculate_best_number_of_processors(&usl, 32, 1), ==, 7);
+	g_assert_cmpint(gebr_calculate_best_number_of_processors(&usl, 32, 2), ==, 14);
+	g_assert_cmpint(gebr_calculate_best_number_of_processors(&usl, 4, 1), ==, 4);
+}
+
 void
 test_gebr_double_list_to_list(void)
 {
@@ -313,6 +352,8 @@ int main(int argc, char *argv[])
 	g_test_add_func("/libgebr/utils/gebr_utf8_is_asc_alnum", test_gebr_utf8_is_asc_alnum);
 	g_test_add_func("/libgebr/utils/gebr_utf8_strstr", test_gebr_utf8_strstr);
 	g_test_add_func("/libgebr/utils/test_gebr_calculate_number_of_processors", test_gebr_calculate_number_of_processors);
+	g_test_add_func("/libgebr/utils/calculate_scaling_fit", test_gebr_calculate_scaling_fit);
+	g_test_add_func("/libgebr/utils/calculate_best_number_of_processors", test_gebr_calculate_best_number_of_processors);
 	g_test_add_func("/libgebr/utils/gebr_double_list_to_list", test_gebr_double_list_to_list);
 	g_test_add_func("/libgebr/utils/gebr_g_string_remove_accents", test_gebr_g_string_remove_accents);
 	
@@ -993,6 +993,109 @@ gebr_calculate_number_of_processors(gint total_nprocs,
 	return MAX((gint)round(total_nprocs * aggressive/5), 1);
 }
 
+/*
+ * Solves the 3x3 system @a * x = @b by Cramer's rule.
+ */
+static gboolean
+solve_3x3(gdouble a[3][3], gdouble b[3], gdouble x[3])
+{
+	gdouble det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+		- a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+		+ a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+
+	if (fabs(det) < 1e-12)
+		return FALSE;
+
+	for (gint k = 0; k < 3; k++) {
+		gdouble m[3][3];
+		for (gint i = 0; i < 3; i++)
+			for (gint j = 0; j < 3; j++)
+				m[i][j] = j == k ? b[i] : a[i][j];
+
+		x[k] = (m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+			- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+			+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0])) / det;
+	}
+
+	return TRUE;
+}
+
+gboolean
+gebr_calculate_scaling_fit(const gint *nprocs,
+			   const gdouble *costs,
+			   gint n,
+			   GebrScaling *scaling)
+{
+	gdouble a[3][3] = { { 0, }, };
+	gdouble b[3] = { 0, };
+	gdouble x[3];
+	gint distinct = 0;
+
+	g_return_val_if_fail(scaling != NULL, FALSE);
+
+	for (gint i = 0; i < n; i++) {
+		gboolean seen = FALSE;
+		for (gint j = 0; j < i && !seen; j++)
+			seen = nprocs[j] == nprocs[i];
+		if (!seen)
+			distinct++;
+	}
+
+	if (distinct < 2)
+		return FALSE;
+
+	/* The cost is linear in (1, n-1, n(n-1)), so the normal equations
+	 * of the least squares give t1, t1*sigma and t1*kappa */
+	for (gint i = 0; i < n; i++) {
+		gdouble v[3] = { 1, nprocs[i] - 1, (gdouble)nprocs[i] * (nprocs[i] - 1) };
+		for (gint j = 0; j < 3; j++) {
+			b[j] += v[j] * costs[i];
+			for (gint k = 0; k < 3; k++)
+				a[j][k] += v[j] * v[k];
+		}
+	}
+
+	/* Amdahl's law, without coherence */
+	if (distinct == 2) {
+		a[2][0] = a[2][1] = a[0][2] = a[1][2] = 0;
+		a[2][2] = 1;
+		b[2] = 0;
+	}
+
+	if (!solve_3x3(a, b, x) || x[0] <= 0)
+		return FALSE;
+
+	scaling->t1 = x[0];
+	scaling->sigma = MAX(x[1] / x[0], 0);
+	scaling->kappa = MAX(x[2] / x[0], 0);
+
+	return TRUE;
+}
+
+gint
+gebr_calculate_best_number_of_processors(const GebrScaling *scaling,
+					 gint total_nprocs,
+					 gint nnodes)
+{
+	gint best = 1;
+	gdouble best_time = G_MAXDOUBLE;
+
+	nnodes = MAX(nnodes, 1);
+
+	for (gint p = 1; p <= total_nprocs; p++) {
+		gint n = (p + nnodes - 1) / nnodes;
+		gdouble time = (1 + scaling->sigma * (n - 1) + scaling->kappa * n * (n - 1)) / p;
+
+		/* Fewer processes win the ties */
+		if (time < best_time * (1 - 1e-6)) {
+			best_time = time;
+			best = p;
+		}
+	}
+
+	return best;
+}
+
 void
 gebr_pairstrfreev(gchar ***strv)
 {
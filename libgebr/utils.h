@@ -286,6 +286,53 @@ gchar *gebr_utf8_strstr(const gchar *haystack,
 gint gebr_calculate_number_of_processors(gint total_nprocs,
                                          gdouble aggressive);
 
+/**
+ * GebrScaling:
+ * @t1: Cost of one iteration with a single process
+ * @sigma: Contention, the serial fraction of Amdahl's law
+ * @kappa: Coherence, the cost of the processes talking to each other
+ *
+ * The Universal Scalability Law: with n processes in one node, each
+ * iteration costs @t1 * (1 + @sigma * (n - 1) + @kappa * n * (n - 1))
+ * processor-seconds.
+ */
+typedef struct {
+	gdouble t1;
+	gdouble sigma;
+	gdouble kappa;
+} GebrScaling;
+
+/**
+ * gebr_calculate_scaling_fit:
+ * @nprocs: Number of processes of each sample
+ * @costs: Processor-seconds per iteration of each sample
+ * @n: Number of samples
+ * @scaling: Return location for the fitted curve
+ *
+ * Fits @scaling to the samples by least squares. Three different process
+ * counts are needed to find the coherence, with two only the contention is
+ * fitted.
+ *
+ * Returns: %FALSE if the samples are not enough to fit any curve.
+ */
+gboolean gebr_calculate_scaling_fit(const gint *nprocs,
+				    const gdouble *costs,
+				    gint n,
+				    GebrScaling *scaling);
+
+/**
+ * gebr_calculate_best_number_of_processors:
+ * @scaling: A curve fitted by gebr_calculate_scaling_fit()
+ * @total_nprocs: Number of processors of the nodes
+ * @nnodes: Number of nodes the processes are spread over
+ *
+ * Returns: the number of processes, up to @total_nprocs, that finishes the
+ * iterations first according to @scaling.
+ */
+gint gebr_calculate_best_number_of_processors(const GebrScaling *scaling,
+					      gint total_nprocs,
+					      gint nnodes);
+
 /**
  * gebr_pairstrfreev:
  *
@@ -22,11 +22,18 @@
 #include "gebrm-app.h"
 
 #include "gebrm-daemon.h"
+#include "gebrm-connect-scheduler.h"
+#include "gebrm-fair-queue.h"
+#include "gebrm-history.h"
 #include "gebrm-job.h"
+#include "gebrm-journal.h"
+#include "gebrm-output.h"
+#include "gebrm-sweep.h"
 #include "gebrm-client.h"
 
 #include <glib/gprintf.h>
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 #include <gio/gio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,6 +47,44 @@
 #include <libgebr/date.h>
 #include <libgebr/gebr-version.h>
 
+/*
+ * Straggler splitting: every STRAGGLER_INTERVAL seconds, once half of the
+ * tasks of a job finished, a task running STRAGGLER_FACTOR times longer
+ * than predicted by the median speed of the finished ones is stopped after
+ * its current batch of iterations, and the ones it did not run are sent to
+ * a daemon that finished its share. Tasks shorter than STRAGGLER_MIN_TIME
+ * seconds are not worth it.
+ */
+#define STRAGGLER_INTERVAL 10
+#define STRAGGLER_FACTOR 2.0
+#define STRAGGLER_MIN_TIME 30
+
+/*
+ * Seconds the jobs recovered from the journal wait for their daemons to
+ * report their tasks, see recover_jobs().
+ */
+#define RECOVERY_TIMEOUT 120
+
+/*
+ * Number of closed jobs remembered for the clients that reconnect, see
+ * sync_client(). Clients that missed older ones receive all jobs again.
+ */
+#define MAX_CLOSED_JOBS 1024
+
+/*
+ * Jobs held in the run queue up to this position have every change of it
+ * sent to the clients. The ones behind only have it sent when their reason
+ * changes, so moving the queue does not cost a message per job waiting.
+ */
+#define HOLD_EXACT_POSITIONS 50
+
+/*
+ * Jobs of the parsed requests submitted per iteration of the main loop, see
+ * submit_parsed_requests(). A sweep of thousands of points is submitted
+ * over many iterations, letting the other events through in between.
+ */
+#define SUBMIT_BATCH 16
+
 struct _GebrmAppPriv {
 	GMainLoop *main_loop;
 	GebrCommListenSocket *listener;
@@ -54,17 +99,44 @@ struct _GebrmAppPriv {
 
 	gboolean connect_all;
 	gboolean respect_ac;
+	GebrmConnectScheduler *scheduler;
 
 	GQueue *job_def_queue;
-	GQueue *job_run_queue;
+	GebrmFairQueue *run_queue; // Runners waiting to be dispatched
+	gint n_dispatching;
+	gint max_dispatching;
+	gdouble target_utilization;
 	GQueue *xauth_queue;
 
+	// Requests of /run and /sweep, loaded by the workers
+	GThreadPool *workers;
+	GQueue *submit_queue;
+	guint submit_source;
+
 	// Server groups: gchar -> GList<GebrDaemon>
 	GTree *groups;
 
 	// Job controller
 	GHashTable *jobs;
 	GHashTable *jobs_counter;
+
+	// Execution history of the flows
+	GebrmHistory *history;
+
+	// GebrmDaemon -> RunningTasks, see preempt_running_task()
+	GHashTable *running;
+
+	// Events of the jobs, to recover them when maestro restarts
+	GebrmJournal *journal;
+	GList *recovering; // Ids of the jobs waiting for their tasks
+
+	// Sequence of the changes of the jobs, see touch_job()
+	gchar *epoch;
+	guint seq;
+	GQueue *closed;     // ClosedJob, oldest first
+	guint closed_floor; // Sequence of the last ClosedJob forgotten
+	guint cursor_source;
+	guint hold_source; // See schedule_held_jobs()
 };
 
 typedef struct {
@@ -72,9 +144,15 @@ typedef struct {
 	GebrmJob *job;
 } AppAndJob;
 
+/*
+ * An edge of the job graph, kept in the "children" list of the job that
+ * must end first. Without @requires_success, @job runs however its parent
+ * ended, as in the queues of GeBR.
+ */
 typedef struct {
 	GebrCommRunner *runner;
 	GebrmJob *job;
+	gboolean requires_success;
 } RunnerAndJob;
 
 typedef struct {
@@ -84,12 +162,37 @@ typedef struct {
 	gchar *host;
 } XauthQueueData;
 
+typedef struct {
+	gchar *id;
+	guint seq;
+} ClosedJob;
+
 typedef struct {
 	GebrmApp *app;
 	GebrmClient *client;
 	GebrmDaemon *daemon;
 } GidInfo;
 
+/*
+ * A /run or /sweep request. Its documents are loaded by the workers, see
+ * parse_request(), and its jobs are submitted in the main loop, in the
+ * order the requests came, see submit_parsed_requests().
+ */
+typedef struct {
+	GebrmApp *app;
+	GebrmClient *client;
+	GebrCommHttpMsg *request;
+	GebrCommUri *uri;
+	gchar *content;
+	gboolean sweep;
+	gboolean parsed;
+	guint submitted; // Jobs already submitted
+
+	/* Set by the worker */
+	GPtrArray *docs;     // Flow, line and project of each job
+	GPtrArray *suffixes; // Title suffix of each job, for sweeps
+} SubmitRequest;
+
 /*
  * Global variables to implement GebrmAppSingleton methods.
  */
@@ -129,14 +232,29 @@ static void gebrm_config_delete_server(const gchar *serv);
 
 static gboolean gebrm_remove_server_from_list(GebrmApp *app, const gchar *address);
 
+static void parse_request(SubmitRequest *req, GebrmApp *app);
+
+static void submit_request_free(SubmitRequest *req);
+
 gboolean gebrm_config_load_servers(GebrmApp *app, const gchar *path);
 
 static void send_job_def_to_clients(GebrmApp *app, GebrmJob *job);
 
 static void send_messages_of_jobs(const gchar *id, GebrmJob *job, GebrCommProtocolSocket *protocol);
 
+static void send_output_of_job(GebrCommProtocolSocket *protocol, GebrmJob *job);
+
+static void send_output_page(GebrCommProtocolSocket *protocol, GebrmJob *job, GebrmTask *task, gsize offset, gsize length);
+
+static void sync_client(GebrmApp *app, GebrCommProtocolSocket *socket, const gchar *cursor);
+
 static gboolean gebrm_app_increment_jobs_counter(GebrmApp *app, const gchar *flow_id);
 
+static void gebrm_app_dispatch_runners(GebrmApp *app);
+
+static void set_job_hold(GebrmApp *app, GebrmJob *job, gint position, const gchar *reason);
+static void gebrm_app_queue_runner(GebrmApp *app, GebrmJob *job, GebrCommRunner *runner);
+
 G_DEFINE_TYPE(GebrmApp, gebrm_app, G_TYPE_OBJECT);
 
 // Refactor this method to GebrmJobController {{{
@@ -154,6 +272,94 @@ gebrm_app_job_controller_add(GebrmApp *app, GebrmJob *job)
 			    job);
 }
 
+/*
+ * Clients keep the cursor "epoch:sequence" of the last change of the jobs
+ * they know about. The epoch changes every time maestro starts, so cursors
+ * of a previous run are never taken for current ones.
+ */
+static gchar *
+get_cursor(GebrmApp *app)
+{
+	return g_strdup_printf("%s:%u", app->priv->epoch, app->priv->seq);
+}
+
+static gboolean
+send_cursor(gpointer data)
+{
+	GebrmApp *app = data;
+	gchar *cursor = get_cursor(app);
+
+	app->priv->cursor_source = 0;
+
+	for (GList *i = app->priv->connections; i; i = i->next) {
+		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
+
+		/* Would make the client skip the jobs it did not sync yet */
+		if (!g_object_get_data(G_OBJECT(socket), "synced"))
+			continue;
+
+		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+						      gebr_comm_protocol_defs.cur_def, 2,
+						      cursor, "0");
+	}
+	g_free(cursor);
+
+	return FALSE;
+}
+
+static void
+schedule_cursor(GebrmApp *app)
+{
+	/* Sent once the messages of the changes were, and only once for a
+	 * burst of them */
+	if (!app->priv->cursor_source)
+		app->priv->cursor_source = g_idle_add(send_cursor, app);
+}
+
+/*
+ * Gives the next sequence number to @job, which changed in a way its
+ * clients must know about. Output is not tracked, clients fetch it when
+ * they need it.
+ */
+static void
+touch_job(GebrmApp *app,
+	  GebrmJob *job)
+{
+	g_object_set_data(G_OBJECT(job), "seq", GUINT_TO_POINTER(++app->priv->seq));
+	schedule_cursor(app);
+}
+
+static guint
+get_job_seq(GebrmJob *job)
+{
+	return GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(job), "seq"));
+}
+
+static void
+closed_job_free(ClosedJob *closed)
+{
+	g_free(closed->id);
+	g_free(closed);
+}
+
+static void
+forget_job(GebrmApp *app,
+	   const gchar *id)
+{
+	ClosedJob *closed = g_new(ClosedJob, 1);
+	closed->id = g_strdup(id);
+	closed->seq = ++app->priv->seq;
+	g_queue_push_tail(app->priv->closed, closed);
+
+	if (g_queue_get_length(app->priv->closed) > MAX_CLOSED_JOBS) {
+		closed = g_queue_pop_head(app->priv->closed);
+		app->priv->closed_floor = closed->seq;
+		closed_job_free(closed);
+	}
+
+	schedule_cursor(app);
+}
+
 // Configuration Methods {{{
 
 GebrMaestroSettings *
@@ -238,8 +444,12 @@ send_server_status_message(GebrmApp *app,
 	if (!memory)
 		memory = "0";
 
+	/* How long the last connection took to be logged in */
+	gdouble seconds = gebrm_daemon_get_time_to_ready(daemon);
+	gchar *ready = seconds >= 0 ? g_strdup_printf("%lf", seconds) : g_strdup("");
+
 	gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
-					      gebr_comm_protocol_defs.ssta_def, 8,
+					      gebr_comm_protocol_defs.ssta_def, 9,
 					      gebrm_daemon_get_hostname(daemon),
 					      gebrm_daemon_get_address(daemon),
 					      state,
@@ -247,12 +457,14 @@ send_server_status_message(GebrmApp *app,
 					      ncores,
 					      g_strtod(clock, NULL) > 0? clock : "",
 					      gebrm_daemon_get_model_name(daemon),
-					      g_strtod(memory, NULL) > 0? memory : "");
+					      g_strtod(memory, NULL) > 0? memory : "",
+					      ready);
 
 	gebrm_daemon_send_error_message(daemon, socket);
 
 	g_free(ncores);
 	g_free(clock);
+	g_free(ready);
 }
 
 static void
@@ -297,6 +509,196 @@ remove_daemon(GebrmApp *app, const gchar *addr)
 	}
 }
 
+/*
+ * Returns: the niceness the daemons run the tasks of @job with, 0 or 19,
+ * see job_new().
+ */
+static gint
+get_job_niceness(GebrmJob *job)
+{
+	return g_strcmp0(gebrm_job_get_nice(job), "0") == 0 ? 0 : 19;
+}
+
+/*
+ * Ranks @task by the priority of the queue its job was admitted from, see
+ * load_queues(), and then by the niceness the job was submitted with: the
+ * clients do not choose queues, but ask for niceness 0 to dispute the
+ * cores, or 19 to use only the free ones.
+ *
+ * Returns: the rank of @task, higher ones run first.
+ */
+static gint
+get_task_rank(GebrmApp *app,
+	      GebrmTask *task)
+{
+	GebrmJob *job = gebrm_app_job_controller_find(app, gebrm_task_get_job_id(task));
+	const gchar *queue = job ? g_object_get_data(G_OBJECT(job), "queue-name") : NULL;
+	gint priority = queue ? gebrm_fair_queue_get_priority(app->priv->run_queue, queue) : 0;
+
+	return 2 * priority + (job && get_job_niceness(job) == 0);
+}
+
+/*
+ * The tasks running on a daemon, see preempt_running_task().
+ */
+typedef struct {
+	GHashTable *ranks; // Rank -> GList<GebrmTask>
+	gint top;          // Highest rank in @ranks
+} RunningTasks;
+
+static void
+running_tasks_free(RunningTasks *running)
+{
+	GHashTableIter iter;
+	GList *tasks;
+
+	g_hash_table_iter_init(&iter, running->ranks);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&tasks)) {
+		for (GList *i = tasks; i; i = i->next) {
+			g_object_set_data(G_OBJECT(i->data), "preempted", NULL);
+			g_object_unref(i->data);
+		}
+		g_list_free(tasks);
+	}
+	g_hash_table_destroy(running->ranks);
+	g_free(running);
+}
+
+static void
+set_task_preempted(GebrmTask *task,
+		   gboolean stop)
+{
+	if (GPOINTER_TO_INT(g_object_get_data(G_OBJECT(task), "preempted")) == stop)
+		return;
+
+	gebrm_task_preempt(task, stop);
+	g_object_set_data(G_OBJECT(task), "preempted", GINT_TO_POINTER(stop));
+
+	/* See record_job_history() */
+	if (stop)
+		g_object_set_data(G_OBJECT(task), "was-preempted", GINT_TO_POINTER(TRUE));
+}
+
+static void
+set_tasks_preempted(GList *tasks,
+		    gboolean stop)
+{
+	for (GList *i = tasks; i; i = i->next)
+		set_task_preempted(i->data, stop);
+}
+
+/*
+ * Keeps the tasks of the highest rank on each daemon running alone, see
+ * get_task_rank(): the ones of a lower rank are stopped by the daemon until
+ * no task of a higher rank is left on it, so bulk jobs stop competing with
+ * urgent ones for the cores. Called when @task starts running.
+ */
+static void
+preempt_running_task(GebrmApp *app,
+		     GebrmTask *task)
+{
+	GebrmDaemon *daemon = gebrm_task_get_daemon(task);
+	RunningTasks *running = g_hash_table_lookup(app->priv->running, daemon);
+	gint rank = get_task_rank(app, task);
+
+	if (!running) {
+		running = g_new(RunningTasks, 1);
+		running->ranks = g_hash_table_new(NULL, NULL);
+		running->top = rank;
+		g_hash_table_insert(app->priv->running, daemon, running);
+	}
+
+	/* The rank is kept, the queue priorities may be reloaded meanwhile */
+	g_object_set_data(G_OBJECT(task), "rank", GINT_TO_POINTER(rank));
+	GList *tasks = g_hash_table_lookup(running->ranks, GINT_TO_POINTER(rank));
+	g_hash_table_insert(running->ranks, GINT_TO_POINTER(rank),
+			    g_list_prepend(tasks, g_object_ref(task)));
+
+	/* The ranks below the top are stopped already */
+	if (rank > running->top) {
+		set_tasks_preempted(g_hash_table_lookup(running->ranks, GINT_TO_POINTER(running->top)), TRUE);
+		running->top = rank;
+	} else if (rank < running->top) {
+		set_task_preempted(task, TRUE);
+	}
+}
+
+/*
+ * Forgets @task, which stopped running, and lets the tasks of the next rank
+ * on its daemon continue if it was the last one of the top rank.
+ */
+static void
+release_running_task(GebrmApp *app,
+		     GebrmTask *task)
+{
+	GebrmDaemon *daemon = gebrm_task_get_daemon(task);
+	RunningTasks *running = g_hash_table_lookup(app->priv->running, daemon);
+	gpointer rank = g_object_get_data(G_OBJECT(task), "rank");
+
+	if (!running)
+		return;
+
+	GList *tasks = g_hash_table_lookup(running->ranks, rank);
+	GList *link = g_list_find(tasks, task);
+
+	/* Running before the daemon reconnected */
+	if (!link)
+		return;
+
+	tasks = g_list_delete_link(tasks, link);
+	g_object_set_data(G_OBJECT(task), "preempted", NULL);
+	g_object_unref(task);
+
+	if (tasks) {
+		g_hash_table_insert(running->ranks, rank, tasks);
+		return;
+	}
+
+	g_hash_table_remove(running->ranks, rank);
+	if (GPOINTER_TO_INT(rank) != running->top)
+		return;
+
+	if (g_hash_table_size(running->ranks) == 0) {
+		g_hash_table_remove(app->priv->running, daemon);
+		return;
+	}
+
+	GHashTableIter iter;
+	gpointer key;
+	gboolean first = TRUE;
+
+	g_hash_table_iter_init(&iter, running->ranks);
+	while (g_hash_table_iter_next(&iter, &key, NULL)) {
+		if (first || GPOINTER_TO_INT(key) > running->top)
+			running->top = GPOINTER_TO_INT(key);
+		first = FALSE;
+	}
+
+	set_tasks_preempted(g_hash_table_lookup(running->ranks, GINT_TO_POINTER(running->top)), FALSE);
+}
+
+/*
+ * The daemon released the cores of @task when it completed, they may admit
+ * a job held in the run queue, see also preempt_running_task().
+ */
+static void
+gebrm_app_on_task_status_change(GebrmTask *task,
+				gint old_status,
+				gint new_status,
+				const gchar *parameter,
+				GebrmApp *app)
+{
+	if (old_status != JOB_STATUS_RUNNING && new_status == JOB_STATUS_RUNNING)
+		preempt_running_task(app, task);
+	else if (old_status == JOB_STATUS_RUNNING && new_status != JOB_STATUS_RUNNING)
+		release_running_task(app, task);
+
+	if (new_status == JOB_STATUS_FINISHED
+	    || new_status == JOB_STATUS_FAILED
+	    || new_status == JOB_STATUS_CANCELED)
+		gebrm_app_dispatch_runners(app);
+}
+
 static void
 gebrm_app_job_controller_on_task_def(GebrmDaemon *daemon,
 				     GebrmTask *task,
@@ -309,6 +711,38 @@ gebrm_app_job_controller_on_task_def(GebrmDaemon *daemon,
 		g_return_if_reached();
 
 	gebrm_job_append_task(job, task);
+
+	/* Connected after the daemon, which releases the reservation */
+	g_signal_connect(task, "status-change",
+			 G_CALLBACK(gebrm_app_on_task_status_change), app);
+}
+
+/*
+ * Records that @job changed to @status in the journal, see recover_jobs().
+ */
+static void
+journal_status(GebrmApp *app,
+	       GebrmJob *job,
+	       GebrCommJobStatus status,
+	       const gchar *parameter)
+{
+	if (app->priv->journal
+	    && status != JOB_STATUS_ISSUED
+	    && status != JOB_STATUS_REQUEUED)
+		gebrm_journal_append(app->priv->journal, gebrm_job_get_id(job),
+				     GEBRM_JOURNAL_STATUS,
+				     gebr_comm_job_get_string_from_status(status),
+				     parameter ? parameter : "", NULL);
+}
+
+static void
+journal_issue(GebrmApp *app,
+	      GebrmJob *job,
+	      const gchar *issues)
+{
+	if (app->priv->journal)
+		gebrm_journal_append(app->priv->journal, gebrm_job_get_id(job),
+				     GEBRM_JOURNAL_ISSUE, issues, NULL);
 }
 
 static void
@@ -316,6 +750,9 @@ gebrm_app_job_controller_on_issued(GebrmJob    *job,
 				   const gchar *issues,
 				   GebrmApp    *app)
 {
+	journal_issue(app, job, issues);
+	touch_job(app, job);
+
 	for (GList *i = app->priv->connections; i; i = i->next) {
 		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
 		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
@@ -332,6 +769,9 @@ gebrm_app_job_controller_on_cmd_line_received(GebrmJob *job,
 					      GebrmApp *app)
 {
 	gchar *frac;
+
+	touch_job(app, job);
+
 	for (GList *i = app->priv->connections; i; i = i->next) {
 		frac = g_strdup_printf("%d", gebrm_task_get_fraction(task));
 		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
@@ -351,6 +791,9 @@ gebrm_app_job_controller_on_output(GebrmJob *job,
 				   GebrmApp *app)
 {
 	for (GList *i = app->priv->connections; i; i = i->next) {
+		if (!gebrm_client_is_subscribed(i->data, gebrm_job_get_id(job)))
+			continue;
+
 		gchar *frac = g_strdup_printf("%d", gebrm_task_get_fraction(task));
 		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
 		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
@@ -362,6 +805,57 @@ gebrm_app_job_controller_on_output(GebrmJob *job,
 	}
 }
 
+/*
+ * Records the duration of each task of @job in the history of its flow.
+ * Tasks of MPI jobs do not have their steps known and are skipped.
+ */
+static void
+record_job_history(GebrmApp *app,
+		   GebrmJob *job)
+{
+	const gchar *key = g_object_get_data(G_OBJECT(job), "history-key");
+
+	if (!app->priv->history || !key)
+		return;
+
+	for (GList *i = gebrm_job_get_list_of_tasks(job); i; i = i->next) {
+		GebrmTask *task = i->data;
+		GebrmDaemon *daemon = gebrm_task_get_daemon(task);
+		const gchar *start_date = gebrm_task_get_start_date(task);
+		const gchar *finish_date = gebrm_task_get_finish_date(task);
+		GebrmHistoryRecord record = { 0, };
+		GTimeVal start, finish;
+
+		/* Tasks stopped before their first batch ran no iteration */
+		if (gebrm_task_get_status(task) != JOB_STATUS_FINISHED)
+			continue;
+
+		/* The wall time of a preempted task includes the time it was
+		 * stopped */
+		if (g_object_get_data(G_OBJECT(task), "was-preempted"))
+			continue;
+
+		record.iterations = gebrm_job_get_task_steps(job, gebrm_task_get_fraction(task),
+							     &record.ncores);
+		if (record.iterations <= 0 || !daemon || !start_date || !finish_date)
+			continue;
+
+		if (!g_time_val_from_iso8601(start_date, &start)
+		    || !g_time_val_from_iso8601(finish_date, &finish))
+			continue;
+
+		record.daemon = (gchar *)gebrm_daemon_get_address(daemon);
+		record.cpu_class = (gchar *)gebrm_daemon_get_model_name(daemon);
+		record.wall_time = (finish.tv_sec - start.tv_sec)
+			+ (finish.tv_usec - start.tv_usec) / (gdouble)G_USEC_PER_SEC;
+		record.date = finish.tv_sec;
+		record.cpu_time = gebrm_task_get_cpu_time(task);
+		record.peak_memory = gebrm_task_get_peak_memory(task);
+
+		gebrm_history_append(app->priv->history, key, &record);
+	}
+}
+
 static void
 gebrm_app_job_controller_on_status_change(GebrmJob *job,
 					  gint old_status,
@@ -369,18 +863,53 @@ gebrm_app_job_controller_on_status_change(GebrmJob *job,
 					  const gchar *parameter,
 					  GebrmApp *app)
 {
+	journal_status(app, job, new_status, parameter);
+	touch_job(app, job);
+
 	if (new_status == JOB_STATUS_FAILED)
 		gebrm_job_kill_tasks(job);
 
+	if (new_status == JOB_STATUS_FINISHED)
+		record_job_history(app, job);
+
 	if (new_status == JOB_STATUS_FINISHED
 	    || new_status == JOB_STATUS_FAILED
 	    || new_status == JOB_STATUS_CANCELED) {
+		g_object_set_data(G_OBJECT(job), "split-runner", NULL);
+
+		const gchar *admitted = g_object_get_data(G_OBJECT(job), "admitted-queue");
+		GebrCommRunner *queued = g_object_get_data(G_OBJECT(job), "queued-runner");
+
+		if (admitted) {
+			gebrm_fair_queue_release(app->priv->run_queue, admitted);
+			g_object_set_data(G_OBJECT(job), "admitted-queue", NULL);
+		} else if (queued) {
+			gebrm_fair_queue_remove(app->priv->run_queue, queued);
+			g_object_set_data(G_OBJECT(job), "queued-runner", NULL);
+			set_job_hold(app, job, 0, NULL);
+		}
+
+		/* Every child whose last prerequisite was @job is released
+		 * now, and the ones that needed it to succeed are canceled,
+		 * which cancels their own children in turn */
 		GList *children = g_object_get_data(G_OBJECT(job), "children");
 		for (GList *i = children; i; i = i->next) {
 			RunnerAndJob *raj = i->data;
-			if (!gebr_comm_runner_run_async(raj->runner))
-				gebrm_job_kill_immediately(raj->job);
+
+			if (gebrm_job_is_stopped(raj->job))
+				continue;
+
+			if (raj->requires_success && new_status != JOB_STATUS_FINISHED) {
+				gebrm_job_unqueue(raj->job);
+				continue;
+			}
+
+			gint pending = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(raj->job), "pending-prerequisites")) - 1;
+			g_object_set_data(G_OBJECT(raj->job), "pending-prerequisites", GINT_TO_POINTER(pending));
+			if (pending <= 0)
+				gebrm_app_queue_runner(app, raj->job, raj->runner);
 		}
+		gebrm_app_dispatch_runners(app);
 		g_list_foreach(children, (GFunc)g_free, NULL);
 		g_list_free(children);
 		g_object_set_data(G_OBJECT(job), "children", NULL);
@@ -406,63 +935,324 @@ gebrm_app_job_controller_on_status_change(GebrmJob *job,
 }
 
 static void
-verify_connect_all(GebrmApp *app)
+connect_job_signals(GebrmApp *app,
+		    GebrmJob *job)
 {
-	for (GList *i = app->priv->daemons; i; i = i->next) {
-		GebrmDaemon *daemon = i->data;
-		if (gebrm_daemon_get_state(daemon) != SERVER_STATE_LOGGED &&
-		    !gebrm_daemon_get_canceled(daemon))
+	g_signal_connect(job, "status-change",
+			 G_CALLBACK(gebrm_app_job_controller_on_status_change), app);
+	g_signal_connect(job, "issued",
+			 G_CALLBACK(gebrm_app_job_controller_on_issued), app);
+	g_signal_connect(job, "cmd-line-received",
+			 G_CALLBACK(gebrm_app_job_controller_on_cmd_line_received), app);
+	g_signal_connect(job, "output",
+			 G_CALLBACK(gebrm_app_job_controller_on_output), app);
+}
+
+/* Arguments of the journal events, see journal_submit() and
+ * journal_dispatch() */
+enum {
+	SUBMIT_TITLE,
+	SUBMIT_DESCRIPTION,
+	SUBMIT_TEMP_ID,
+	SUBMIT_FLOW_ID,
+	SUBMIT_FLOW_TITLE,
+	SUBMIT_HOSTNAME,
+	SUBMIT_PARENT_ID,
+	SUBMIT_NICE,
+	SUBMIT_INPUT,
+	SUBMIT_OUTPUT,
+	SUBMIT_ERROR,
+	SUBMIT_DATE,
+	SUBMIT_GROUP,
+	SUBMIT_GROUP_TYPE,
+	SUBMIT_SPEED,
+	SUBMIT_SNAPSHOT_TITLE,
+	SUBMIT_SNAPSHOT_ID,
+	SUBMIT_JOB_COUNTER,
+	SUBMIT_RUN_TYPE,
+	N_SUBMIT_ARGS
+};
+
+enum {
+	DISPATCH_SERVERS,
+	DISPATCH_NPROCS,
+	DISPATCH_TOTAL,
+	DISPATCH_MPI_OWNER,
+	DISPATCH_MPI_FLAVOR,
+	DISPATCH_SPEED,
+	DISPATCH_HISTORY_KEY,
+	N_DISPATCH_ARGS
+};
+
+static inline const gchar *
+nonnull(const gchar *str)
+{
+	return str ? str : "";
+}
+
+static void
+journal_submit(GebrmApp *app,
+	       GebrmJob *job)
+{
+	gchar *input, *output, *error;
+
+	if (!app->priv->journal)
+		return;
+
+	gebrm_job_get_io(job, &input, &output, &error);
+	gebrm_journal_append(app->priv->journal, gebrm_job_get_id(job),
+			     GEBRM_JOURNAL_SUBMIT,
+			     nonnull(gebrm_job_get_title(job)),
+			     nonnull(gebrm_job_get_description(job)),
+			     nonnull(gebrm_job_get_temp_id(job)),
+			     nonnull(gebrm_job_get_flow_id(job)),
+			     nonnull(gebrm_job_get_flow_title(job)),
+			     nonnull(gebrm_job_get_hostname(job)),
+			     nonnull(gebrm_job_get_queue(job)),
+			     nonnull(gebrm_job_get_nice(job)),
+			     nonnull(input),
+			     nonnull(output),
+			     nonnull(error),
+			     nonnull(gebrm_job_get_submit_date(job)),
+			     nonnull(gebrm_job_get_server_group(job)),
+			     nonnull(gebrm_job_get_server_group_type(job)),
+			     nonnull(gebrm_job_get_exec_speed(job)),
+			     nonnull(gebrm_job_get_snapshot_title(job)),
+			     nonnull(gebrm_job_get_snapshot_id(job)),
+			     nonnull(gebrm_job_get_job_counter(job)),
+			     nonnull(gebrm_job_get_run_type(job)),
+			     NULL);
+	g_free(input);
+	g_free(output);
+	g_free(error);
+}
+
+static void
+journal_dispatch(GebrmApp *app,
+		 GebrmJob *job,
+		 gint total)
+{
+	if (!app->priv->journal)
+		return;
+
+	gchar *total_str = g_strdup_printf("%d", total);
+	gebrm_journal_append(app->priv->journal, gebrm_job_get_id(job),
+			     GEBRM_JOURNAL_DISPATCH,
+			     nonnull(gebrm_job_get_servers_list(job)),
+			     nonnull(gebrm_job_get_nprocs(job)),
+			     total_str,
+			     nonnull(gebrm_job_get_mpi_owner(job)),
+			     nonnull(gebrm_job_get_mpi_flavor(job)),
+			     nonnull(gebrm_job_get_exec_speed(job)),
+			     nonnull(g_object_get_data(G_OBJECT(job), "history-key")),
+			     NULL);
+	g_free(total_str);
+}
+
+static void
+recover_job_event(const gchar *id,
+		  gchar **event,
+		  gpointer user_data)
+{
+	GebrmApp *app = user_data;
+	GebrmJob *job = gebrm_app_job_controller_find(app, id);
+	gchar **args = event + 1;
+	guint n_args = g_strv_length(args);
+
+	if (g_strcmp0(event[0], GEBRM_JOURNAL_SUBMIT) == 0) {
+		if (job || n_args != N_SUBMIT_ARGS)
+			return;
+
+		GebrmJobInfo info = { 0, };
+		info.title = args[SUBMIT_TITLE];
+		info.description = args[SUBMIT_DESCRIPTION];
+		info.temp_id = args[SUBMIT_TEMP_ID];
+		info.flow_id = args[SUBMIT_FLOW_ID];
+		info.flow_title = args[SUBMIT_FLOW_TITLE];
+		info.hostname = args[SUBMIT_HOSTNAME];
+		info.parent_id = args[SUBMIT_PARENT_ID];
+		info.nice = args[SUBMIT_NICE];
+		info.input = args[SUBMIT_INPUT];
+		info.output = args[SUBMIT_OUTPUT];
+		info.error = args[SUBMIT_ERROR];
+		info.submit_date = args[SUBMIT_DATE];
+		info.group = args[SUBMIT_GROUP];
+		info.group_type = args[SUBMIT_GROUP_TYPE];
+		info.speed = args[SUBMIT_SPEED];
+		info.snapshot_title = args[SUBMIT_SNAPSHOT_TITLE];
+		info.snapshot_id = args[SUBMIT_SNAPSHOT_ID];
+		info.job_counter = args[SUBMIT_JOB_COUNTER];
+
+		job = gebrm_job_new_with_id(id);
+		connect_job_signals(app, job);
+		gebrm_job_init_details(job, &info);
+		gebrm_job_set_status(job, JOB_STATUS_INITIAL);
+		gebrm_job_set_run_type(job, args[SUBMIT_RUN_TYPE]);
+		gebrm_app_job_controller_add(app, job);
+
+		/* The next jobs of the flow are numbered after this one */
+		gint *counter = g_hash_table_lookup(app->priv->jobs_counter, info.flow_id);
+		gint job_counter = atoi(info.job_counter);
+		if (!counter || *counter < job_counter) {
+			counter = g_new(gint, 1);
+			*counter = job_counter;
+			g_hash_table_replace(app->priv->jobs_counter, g_strdup(info.flow_id), counter);
+		}
+	} else if (!job) {
+		return;
+	} else if (g_strcmp0(event[0], GEBRM_JOURNAL_DISPATCH) == 0) {
+		if (n_args != N_DISPATCH_ARGS)
 			return;
+
+		gebrm_job_set_servers_list(job, args[DISPATCH_SERVERS]);
+		gebrm_job_set_nprocs(job, args[DISPATCH_NPROCS]);
+		gebrm_job_set_total_tasks(job, atoi(args[DISPATCH_TOTAL]));
+		gebrm_job_set_mpi_owner(job, args[DISPATCH_MPI_OWNER]);
+		gebrm_job_set_mpi_flavor(job, args[DISPATCH_MPI_FLAVOR]);
+		/* Changed by the automatic speed */
+		if (g_strcmp0(args[DISPATCH_SPEED], gebrm_job_get_exec_speed(job)) != 0)
+			gebrm_job_set_exec_speed(job, g_ascii_strtod(args[DISPATCH_SPEED], NULL));
+		if (*args[DISPATCH_HISTORY_KEY])
+			g_object_set_data_full(G_OBJECT(job), "history-key",
+					       g_strdup(args[DISPATCH_HISTORY_KEY]), g_free);
+		g_object_set_data(G_OBJECT(job), "dispatched", GINT_TO_POINTER(TRUE));
+	} else if (g_strcmp0(event[0], GEBRM_JOURNAL_STATUS) == 0) {
+		if (n_args >= 1)
+			gebrm_job_set_status(job, gebr_comm_job_get_status_from_string(args[0]));
+	} else if (g_strcmp0(event[0], GEBRM_JOURNAL_ISSUE) == 0) {
+		if (n_args >= 1)
+			gebrm_job_set_issues(job, args[0]);
 	}
-	app->priv->connect_all = FALSE;
-	return;
 }
 
+/*
+ * Fails @job, whose tasks were lost while maestro was not running.
+ */
 static void
-gebrm_app_continue_connections_of_daemons(GebrmApp *app,
-                                          gboolean from_append_key)
+fail_recovered_job(GebrmApp *app,
+		   GebrmJob *job)
 {
-	for (GList *i = app->priv->daemons; i; i = i->next) {
-		GebrmDaemon *d = i->data;
+	const gchar *issue = _("This job was lost when the maestro was restarted.");
+	gchar *finish_date = gebr_iso_date();
 
-		if (!from_append_key) {
-			GebrCommServer *server = gebrm_daemon_get_server(d);
-			if (gebrm_daemon_get_state(d) == SERVER_STATE_LOGGED &&
-			    gebr_comm_server_get_use_public_key(server))
-				return;
-		}
+	gebrm_job_kill_tasks(job);
+	gebrm_job_set_issues(job, issue);
+	gebrm_job_set_status(job, JOB_STATUS_FAILED);
+	journal_issue(app, job, issue);
+	journal_status(app, job, JOB_STATUS_FAILED, finish_date);
+	touch_job(app, job);
 
-		if (gebrm_daemon_get_state(d) != SERVER_STATE_LOGGED
-		    && (!g_strcmp0(gebrm_daemon_get_autoconnect(d), "on") || !app->priv->respect_ac)
-		    && !gebrm_daemon_get_canceled(d)) {
-			for (GList *j = app->priv->connections; j; j = j->next) {
-				GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(j->data);
-				gebrm_daemon_connect(d, socket);
-			}
-			if (!from_append_key)
-				return;
-		}
+	for (GList *i = app->priv->connections; i; i = i->next) {
+		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
+		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+						      gebr_comm_protocol_defs.sta_def, 3,
+						      gebrm_job_get_id(job),
+						      gebr_comm_job_get_string_from_status(JOB_STATUS_FAILED),
+						      finish_date);
+		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+						      gebr_comm_protocol_defs.iss_def, 2,
+						      gebrm_job_get_id(job),
+						      issue);
 	}
 }
 
 static gboolean
-time_out_daemon(gpointer user_data)
+on_recovery_timeout(gpointer data)
 {
-	g_debug("Daemon TIMEOUT");
+	GebrmApp *app = data;
 
-	GebrmApp *app = user_data;
+	for (GList *i = app->priv->recovering; i; i = i->next) {
+		GebrmJob *job = gebrm_app_job_controller_find(app, i->data);
+
+		if (!job || gebrm_job_is_stopped(job))
+			continue;
 
-	gebrm_app_continue_connections_of_daemons(app, FALSE);
-	verify_connect_all(app);
+		gint total = gebrm_job_get_total_tasks(job);
+		gint n_tasks = g_list_length(gebrm_job_get_list_of_tasks(job));
+
+		if (n_tasks == 0 || n_tasks < total) {
+			g_debug("Job %s was not recovered, %d of its tasks were found",
+				gebrm_job_get_id(job), n_tasks);
+			fail_recovered_job(app, job);
+		}
+	}
+
+	g_list_foreach(app->priv->recovering, (GFunc)g_free, NULL);
+	g_list_free(app->priv->recovering);
+	app->priv->recovering = NULL;
 
 	return FALSE;
 }
 
+/*
+ * Rebuilds the jobs kept in the journal. The daemons keep running the
+ * tasks while maestro is away, and report them when they log in again,
+ * see gebrm_app_daemon_on_state_change(). Jobs that were still waiting
+ * in maestro, or whose loop was being sent in chunks, are lost.
+ */
+static void
+recover_jobs(GebrmApp *app)
+{
+	GHashTableIter iter;
+	GebrmJob *job;
+
+	gebrm_journal_replay(app->priv->journal, recover_job_event, app);
+
+	g_hash_table_iter_init(&iter, app->priv->jobs);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&job)) {
+		if (gebrm_job_is_stopped(job))
+			continue;
+
+		/* Jobs distributed in chunks need their runner to send the
+		 * next ones, and it did not survive */
+		if (g_object_get_data(G_OBJECT(job), "dispatched")
+		    && gebrm_job_get_total_tasks(job) >= 0)
+			app->priv->recovering = g_list_prepend(app->priv->recovering,
+							       g_strdup(gebrm_job_get_id(job)));
+		else
+			fail_recovered_job(app, job);
+	}
+
+	if (app->priv->recovering) {
+		g_debug("Waiting the tasks of %d jobs of the journal",
+			g_list_length(app->priv->recovering));
+		g_timeout_add_seconds(RECOVERY_TIMEOUT, on_recovery_timeout, app);
+	}
+}
+
+static gboolean
+connect_scheduled_daemon(GebrmDaemon *daemon,
+			 gpointer user_data)
+{
+	GebrmApp *app = user_data;
+
+	if (!g_list_find(app->priv->daemons, daemon)
+	    || gebrm_daemon_get_state(daemon) != SERVER_STATE_DISCONNECTED
+	    || !app->priv->connections)
+		return FALSE;
+
+	for (GList *i = app->priv->connections; i; i = i->next) {
+		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
+		gebrm_daemon_connect(daemon, socket);
+	}
+
+	return TRUE;
+}
+
+static void
+on_connect_scheduler_done(gpointer user_data)
+{
+	GebrmApp *app = user_data;
+	app->priv->connect_all = FALSE;
+}
+
 static void
 gebrm_app_daemon_on_state_change(GebrmDaemon *daemon,
 				 GebrCommServerState state,
 				 GebrmApp *app)
 {
+	gebrm_connect_scheduler_state_changed(app->priv->scheduler, daemon, state);
+
 	if (state == SERVER_STATE_DISCONNECTED) {
 		GList *head = g_queue_peek_head_link(app->priv->xauth_queue);
 		for (GList *i = head; i; i = i->next) {
@@ -475,22 +1265,13 @@ gebrm_app_daemon_on_state_change(GebrmDaemon *daemon,
 			}
 		}
 
+		/* The daemon lets the tasks it stopped continue when maestro
+		 * leaves, see client_disconnected() */
+		g_hash_table_remove(app->priv->running, daemon);
+
 		gboolean error = gebrm_daemon_get_error_type(daemon) != NULL;
-		if (error) {
-			guint timeout = gebrm_daemon_get_timeout(daemon);
-			if (timeout != -1) {
-				g_source_remove(timeout);
-				gebrm_daemon_set_timeout(daemon, -1);
-			}
+		if (error)
 			gebrm_daemon_set_canceled(daemon, TRUE);
-		}
-
-		if (gebrm_daemon_get_canceled(daemon)) {
-			if (app->priv->connect_all) {
-				gebrm_app_continue_connections_of_daemons(app, FALSE);
-				verify_connect_all(app);
-			}
-		}
 
 		gboolean reconnect = gebrm_daemon_get_reconnect(daemon);
 		const gchar *err = gebrm_daemon_get_error_type(daemon);
@@ -498,31 +1279,27 @@ gebrm_app_daemon_on_state_change(GebrmDaemon *daemon,
 		if (!err && reconnect) {
 			for (GList *i = app->priv->connections; i; i = i->next) {
 				GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
-				gebrm_daemon_set_reconnect(daemon, FALSE);
-				gebrm_daemon_connect(daemon, socket);
-			}
-		}
-	}
-
-	else if (state == SERVER_STATE_RUN) {
-		if (app->priv->connect_all) {
-			gebrm_daemon_set_canceled(daemon, TRUE);
-			guint timeout = g_timeout_add(6000, time_out_daemon, app);
-			gebrm_daemon_set_timeout(daemon, timeout);
+				gebrm_daemon_set_reconnect(daemon, FALSE);
+				gebrm_daemon_connect(daemon, socket);
+			}
 		}
 	}
 
 	else if (state == SERVER_STATE_LOGGED) {
-		guint timeout = gebrm_daemon_get_timeout(daemon);
-		if (timeout != -1) {
-			g_source_remove(timeout);
-			gebrm_daemon_set_timeout(daemon, -1);
-		}
 		gebrm_daemon_set_canceled(daemon, FALSE);
-		if (app->priv->connect_all) {
-			gebrm_app_continue_connections_of_daemons(app, FALSE);
-			verify_connect_all(app);
-		}
+
+		/* Tasks of the jobs recovered from the journal */
+		if (app->priv->recovering)
+			gebrm_daemon_list_tasks_and_forward_x(daemon);
+
+		// Wait the key to be appended into this daemon, the next ones
+		// probably share the same home and will not ask for passwords.
+		GebrCommServer *server = gebrm_daemon_get_server(daemon);
+		if (app->priv->connect_all && gebr_comm_server_get_use_public_key(server))
+			gebrm_connect_scheduler_set_paused(app->priv->scheduler, TRUE);
+
+		/* Its cores may admit held jobs */
+		gebrm_app_dispatch_runners(app);
 	}
 	for (GList *i = app->priv->connections; i; i = i->next) {
 		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
@@ -536,12 +1313,35 @@ gebrm_app_finalize(GObject *object)
 	GebrmApp *app = GEBRM_APP(object);
 	g_hash_table_unref(app->priv->jobs);
 	g_hash_table_unref(app->priv->jobs_counter);
+	g_hash_table_unref(app->priv->running);
 	g_list_foreach(app->priv->connections, (GFunc)g_object_unref, NULL);
 	g_list_free(app->priv->connections);
 	g_list_free(app->priv->daemons);
+	gebrm_connect_scheduler_free(app->priv->scheduler);
 	g_queue_free(app->priv->job_def_queue);
-	g_queue_free(app->priv->job_run_queue);
+	gebrm_fair_queue_free(app->priv->run_queue);
 	g_queue_free(app->priv->xauth_queue);
+	g_thread_pool_free(app->priv->workers, TRUE, TRUE);
+	for (GList *i = app->priv->submit_queue->head; i; i = i->next) {
+		g_idle_remove_by_data(i->data);
+		submit_request_free(i->data);
+	}
+	g_queue_free(app->priv->submit_queue);
+	if (app->priv->submit_source)
+		g_source_remove(app->priv->submit_source);
+	if (app->priv->history)
+		gebrm_history_free(app->priv->history);
+	if (app->priv->journal)
+		gebrm_journal_free(app->priv->journal);
+	g_list_foreach(app->priv->recovering, (GFunc)g_free, NULL);
+	g_list_free(app->priv->recovering);
+	if (app->priv->cursor_source)
+		g_source_remove(app->priv->cursor_source);
+	if (app->priv->hold_source)
+		g_source_remove(app->priv->hold_source);
+	g_queue_foreach(app->priv->closed, (GFunc)closed_job_free, NULL);
+	g_queue_free(app->priv->closed);
+	g_free(app->priv->epoch);
 	G_OBJECT_CLASS(gebrm_app_parent_class)->finalize(object);
 }
 
@@ -601,6 +1401,179 @@ on_x11_port_defined(GebrCommPortProvider *self,
 	g_free(data);
 }
 
+static gdouble
+task_wall_time(GebrmTask *task)
+{
+	GTimeVal start, finish;
+
+	if (!g_time_val_from_iso8601(gebrm_task_get_start_date(task), &start))
+		return -1;
+
+	if (gebrm_task_get_status(task) == JOB_STATUS_RUNNING)
+		g_get_current_time(&finish);
+	else if (!g_time_val_from_iso8601(gebrm_task_get_finish_date(task), &finish))
+		return -1;
+
+	return (finish.tv_sec - start.tv_sec)
+		+ (finish.tv_usec - start.tv_usec) / (gdouble)G_USEC_PER_SEC;
+}
+
+static gint
+compare_doubles(gconstpointer a, gconstpointer b)
+{
+	const gdouble *d1 = a, *d2 = b;
+	return (*d1 > *d2) - (*d1 < *d2);
+}
+
+/*
+ * The daemons of @job that finished their tasks and run none, in the order
+ * the tasks were received.
+ */
+static GList *
+get_idle_daemons(GebrmJob *job)
+{
+	GList *idle = NULL;
+	GList *busy = NULL;
+
+	for (GList *i = gebrm_job_get_list_of_tasks(job); i; i = i->next) {
+		GebrmTask *task = i->data;
+		GebrmDaemon *daemon = gebrm_task_get_daemon(task);
+
+		if (gebrm_task_get_status(task) == JOB_STATUS_RUNNING)
+			busy = g_list_prepend(busy, daemon);
+		else if (gebrm_task_get_status(task) == JOB_STATUS_FINISHED
+			 && gebrm_daemon_get_state(daemon) == SERVER_STATE_LOGGED
+			 && !g_list_find(idle, daemon))
+			idle = g_list_prepend(idle, daemon);
+	}
+
+	for (GList *i = busy; i; i = i->next)
+		idle = g_list_remove(idle, i->data);
+	g_list_free(busy);
+
+	return idle;
+}
+
+/*
+ * Stops each straggler of @job at its next batch, see STRAGGLER_FACTOR. The
+ * rest is sent by on_job_task_split(). Speeds are in loop steps per second
+ * per core.
+ */
+static void
+split_stragglers(GebrmJob *job,
+		 GebrCommRunner *runner)
+{
+	gint total = gebr_comm_runner_get_total(runner);
+	GArray *speeds = g_array_new(FALSE, FALSE, sizeof(gdouble));
+	GList *tasks = gebrm_job_get_list_of_tasks(job);
+	GList *idle = NULL;
+
+	for (GList *i = tasks; i; i = i->next) {
+		GebrmTask *task = i->data;
+		gint ncores;
+		gint steps = gebrm_job_get_task_steps(job, gebrm_task_get_fraction(task), &ncores);
+		gdouble wall = task_wall_time(task);
+
+		if (gebrm_task_get_status(task) == JOB_STATUS_FINISHED
+		    && steps > 0 && ncores > 0 && wall > 0) {
+			gdouble speed = steps / (wall * ncores);
+			g_array_append_val(speeds, speed);
+		}
+	}
+
+	if (speeds->len == 0 || 2 * speeds->len < (guint)total)
+		goto out;
+
+	g_array_sort(speeds, compare_doubles);
+	gdouble median = g_array_index(speeds, gdouble, speeds->len / 2);
+
+	/* One straggler per daemon that can take its rest */
+	idle = get_idle_daemons(job);
+
+	for (GList *i = tasks; i && idle; i = i->next) {
+		GebrmTask *task = i->data;
+		gint frac = gebrm_task_get_fraction(task);
+		gint ncores;
+
+		if (gebrm_task_get_status(task) != JOB_STATUS_RUNNING
+		    || gebrm_task_is_split(task)
+		    || gebrm_job_is_remainder(job, frac))
+			continue;
+
+		gint steps = gebrm_job_get_task_steps(job, frac, &ncores);
+		gdouble wall = task_wall_time(task);
+		if (steps <= 0 || ncores <= 0
+		    || wall < STRAGGLER_MIN_TIME
+		    || wall < STRAGGLER_FACTOR * steps / (median * ncores))
+			continue;
+
+		g_debug("Task %d of job %s is a straggler, stopping it at its next batch",
+			frac, gebrm_job_get_id(job));
+
+		gebrm_task_split(task);
+		idle = g_list_delete_link(idle, idle);
+	}
+
+out:
+	g_array_free(speeds, TRUE);
+	g_list_free(idle);
+}
+
+/*
+ * The straggler @task stopped after the iterations it reported, sends the
+ * rest to an idle daemon of @job, or back to the daemon of @task if none
+ * is left. If nothing is sent, the job fails.
+ */
+static void
+on_job_task_split(GebrmJob *job,
+		  GebrmTask *task,
+		  GebrmApp *app)
+{
+	GebrCommRunner *runner = g_object_get_data(G_OBJECT(job), "split-runner");
+	gint frac = gebrm_task_get_fraction(task);
+	gint done = gebrm_task_get_done_steps(task);
+	gint ncores;
+
+	if (!runner)
+		return;
+
+	GList *idle = get_idle_daemons(job);
+	GebrmDaemon *daemon = idle ? idle->data : gebrm_task_get_daemon(task);
+	g_list_free(idle);
+
+	if (gebrm_daemon_get_state(daemon) != SERVER_STATE_LOGGED)
+		return;
+
+	gint remainder = gebr_comm_runner_run_remainder(runner, frac, done, GEBR_COMM_DAEMON(daemon));
+	if (remainder < 0)
+		return;
+
+	gebrm_job_add_remainder(job, frac, remainder);
+
+	gebr_comm_runner_get_task_steps(runner, frac, NULL, &ncores);
+	gebrm_job_set_task_steps(job, frac, done, ncores);
+	gint steps = gebr_comm_runner_get_task_steps(runner, remainder, NULL, &ncores);
+	gebrm_job_set_task_steps(job, remainder, steps, ncores);
+}
+
+static gboolean
+check_stragglers(gpointer data)
+{
+	GebrmApp *app = data;
+	GHashTableIter iter;
+	GebrmJob *job;
+
+	g_hash_table_iter_init(&iter, app->priv->jobs);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&job)) {
+		GebrCommRunner *runner = g_object_get_data(G_OBJECT(job), "split-runner");
+
+		if (runner && gebrm_job_get_status(job) == JOB_STATUS_RUNNING)
+			split_stragglers(job, runner);
+	}
+
+	return TRUE;
+}
+
 static void
 gebrm_app_init(GebrmApp *app)
 {
@@ -614,14 +1587,47 @@ gebrm_app_init(GebrmApp *app)
 						g_free, NULL);
 	app->priv->jobs_counter = g_hash_table_new_full(g_str_hash, g_str_equal,
 	                                                g_free, NULL);
+	app->priv->running = g_hash_table_new_full(NULL, NULL, NULL,
+						   (GDestroyNotify)running_tasks_free);
 	app->priv->job_def_queue = g_queue_new();
-	app->priv->job_run_queue = g_queue_new();
+	app->priv->run_queue = gebrm_fair_queue_new();
 	app->priv->xauth_queue = g_queue_new();
+	app->priv->epoch = gebr_id_random_create(8);
+	app->priv->seq = 0;
+	app->priv->closed = g_queue_new();
+
+	const gchar *dispatch = g_getenv("GEBRM_DISPATCH_PARALLEL");
+	app->priv->max_dispatching = dispatch ? atoi(dispatch) : 0;
+	if (app->priv->max_dispatching <= 0)
+		app->priv->max_dispatching = GEBRM_APP_DISPATCH_PARALLEL;
+
+	const gchar *utilization = g_getenv("GEBRM_TARGET_UTILIZATION");
+	app->priv->target_utilization = utilization ? g_ascii_strtod(utilization, NULL) : 0;
+	if (app->priv->target_utilization <= 0)
+		app->priv->target_utilization = GEBRM_APP_TARGET_UTILIZATION;
+
+	const gchar *workers = g_getenv("GEBRM_WORKERS");
+	gint max_workers = workers ? atoi(workers) : 0;
+	if (max_workers <= 0)
+		max_workers = GEBRM_APP_WORKERS;
+	app->priv->workers = g_thread_pool_new((GFunc)parse_request, app,
+					       max_workers, FALSE, NULL);
+	app->priv->submit_queue = g_queue_new();
 
 	app->priv->connect_all = FALSE;
 	app->priv->respect_ac = TRUE;
 
+	const gchar *parallel = g_getenv("GEBRM_CONNECT_PARALLEL");
+	gint max_parallel = parallel ? atoi(parallel) : 0;
+	if (max_parallel <= 0)
+		max_parallel = GEBRM_CONNECT_SCHEDULER_PARALLEL;
+	app->priv->scheduler = gebrm_connect_scheduler_new(max_parallel,
+							   connect_scheduled_daemon,
+							   on_connect_scheduler_done,
+							   app);
+
 	g_timeout_add(1000, process_xauth_queue, app);
+	g_timeout_add_seconds(STRAGGLER_INTERVAL, check_stragglers, app);
 }
 
 void
@@ -795,7 +1801,7 @@ on_daemon_append_key(GebrmDaemon *daemon,
                      GebrmApp *app)
 {
 	if (app->priv->connect_all)
-		gebrm_app_continue_connections_of_daemons(app, TRUE);
+		gebrm_connect_scheduler_set_paused(app->priv->scheduler, FALSE);
 }
 
 static GebrmDaemon *
@@ -951,6 +1957,7 @@ gebrm_remove_server_from_list(GebrmApp *app, const gchar *addr)
 		GebrmDaemon *daemon = i->data;
 		if (g_strcmp0(gebrm_daemon_get_address(daemon), addr) == 0) {
 			app->priv->daemons = g_list_delete_link(app->priv->daemons, i);
+			gebrm_connect_scheduler_cancel(app->priv->scheduler, daemon);
 			gebrm_daemon_disconnect(daemon);
 			g_object_unref(daemon);
 			return TRUE;
@@ -971,6 +1978,8 @@ send_job_def_to_clients(GebrmApp *app, GebrmJob *job)
 	const gchar *snapshot_id = gebrm_job_get_snapshot_id(job);
 	const gchar *description = gebrm_job_get_description(job);
 
+	touch_job(app, job);
+
 	for (GList *i = app->priv->connections; i; i = i->next) {
 		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
 		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
@@ -1004,6 +2013,329 @@ send_job_def_to_clients(GebrmApp *app, GebrmJob *job)
 	}
 }
 
+/*
+ * Puts @runner in the run queue of @job, on behalf of the client that
+ * submitted it.
+ */
+static void
+gebrm_app_queue_runner(GebrmApp *app,
+		       GebrmJob *job,
+		       GebrCommRunner *runner)
+{
+	gebrm_fair_queue_push(app->priv->run_queue,
+			      g_object_get_data(G_OBJECT(job), "queue-name"),
+			      g_object_get_data(G_OBJECT(job), "client-id"),
+			      runner);
+	g_object_set_data(G_OBJECT(job), "queued-runner", runner);
+}
+
+/*
+ * Counts the cores @runner may still take: on each logged daemon of its
+ * group, its cores times the target utilization, minus the ones reserved by
+ * tasks not completed. Each runner being dispatched is supposed to take at
+ * least one, since it did not reserve any yet.
+ *
+ * Returns: the number of free cores, or -1 if no daemon of the group is
+ * logged, in which case the runner is let through to fail as it did before.
+ */
+static gint
+get_free_cores(GebrmApp *app,
+	       GebrCommRunner *runner)
+{
+	gboolean logged = FALSE;
+	gint free_cores = 0;
+
+	for (GList *i = gebr_comm_runner_get_daemons(runner); i; i = i->next) {
+		GebrmDaemon *daemon = i->data;
+
+		if (gebrm_daemon_get_state(daemon) != SERVER_STATE_LOGGED)
+			continue;
+
+		gint ncores = gebrm_daemon_get_ncores(daemon);
+		if (ncores <= 0)
+			continue;
+
+		gint capacity = MAX(1, (gint)(ncores * app->priv->target_utilization));
+		gint reserved = gebr_comm_daemon_get_reserved_cores(GEBR_COMM_DAEMON(daemon));
+
+		free_cores += MAX(0, capacity - reserved);
+		logged = TRUE;
+	}
+
+	if (!logged)
+		return -1;
+
+	return MAX(0, free_cores - app->priv->n_dispatching);
+}
+
+/*
+ * Tells the clients about the change of place of @job in the run queue,
+ * see the HLD message. A @position of 0 means the job left the queue.
+ * Past HOLD_EXACT_POSITIONS the position is only sent along with a new
+ * reason, clients that sync receive the current one anyway.
+ *
+ * Jobs waiting for admission were not defined to the clients yet, so the
+ * first time @job is held its definition is sent.
+ */
+static void
+set_job_hold(GebrmApp *app,
+	     GebrmJob *job,
+	     gint position,
+	     const gchar *reason)
+{
+	gint old_position = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(job), "hold-position"));
+	gint sent_position = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(job), "hold-sent"));
+	const gchar *old_reason = g_object_get_data(G_OBJECT(job), "hold-reason");
+
+	if (!position && !old_position)
+		return;
+
+	if (!reason)
+		reason = "";
+
+	gboolean new_reason = g_strcmp0(reason, old_reason) != 0;
+
+	if (!old_position && position)
+		send_job_def_to_clients(app, job);
+
+	g_object_set_data(G_OBJECT(job), "hold-position", GINT_TO_POINTER(position));
+	if (new_reason)
+		g_object_set_data_full(G_OBJECT(job), "hold-reason", g_strdup(reason), g_free);
+
+	if (position == sent_position && !new_reason)
+		return;
+
+	if (old_position && position && !new_reason && position > HOLD_EXACT_POSITIONS)
+		return;
+
+	g_object_set_data(G_OBJECT(job), "hold-sent", GINT_TO_POINTER(position));
+
+	gchar *pos = g_strdup_printf("%d", position);
+	for (GList *i = app->priv->connections; i; i = i->next) {
+		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
+		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+						      gebr_comm_protocol_defs.hld_def, 3,
+						      gebrm_job_get_id(job), pos, reason);
+	}
+	g_free(pos);
+}
+
+/*
+ * Updates the position and the reason of each job still waiting in the run
+ * queue, see gebrm_fair_queue_list().
+ */
+static gboolean
+update_held_jobs(gpointer data)
+{
+	GebrmApp *app = data;
+	GList *runners = gebrm_fair_queue_list(app->priv->run_queue);
+	gboolean dispatching = app->priv->n_dispatching >= app->priv->max_dispatching;
+	gint position = 1;
+
+	for (GList *i = runners; i; i = i->next, position++) {
+		const gchar *id = gebr_comm_runner_get_id(i->data);
+		GebrmJob *job = gebrm_app_job_controller_find(app, id);
+		const gchar *queue = g_object_get_data(G_OBJECT(job), "queue-name");
+		gchar *reason;
+
+		if (!queue)
+			queue = GEBRM_FAIR_QUEUE_DEFAULT;
+
+		if (get_free_cores(app, i->data) == 0)
+			reason = g_strdup(_("All the cores of the processing nodes are in use"));
+		else if (gebrm_fair_queue_is_full(app->priv->run_queue, queue))
+			reason = g_strdup_printf(_("Queue %s is running as many jobs as it can"), queue);
+		else if (dispatching)
+			reason = g_strdup(_("Other jobs are being dispatched"));
+		else
+			reason = g_strdup(_("Waiting for the jobs before it"));
+
+		set_job_hold(app, job, position, reason);
+		g_free(reason);
+	}
+
+	g_list_free(runners);
+	app->priv->hold_source = 0;
+
+	return FALSE;
+}
+
+static void
+schedule_held_jobs(GebrmApp *app)
+{
+	/* The queue moves several times in a burst of events, the jobs
+	 * waiting are only walked once for all of them */
+	if (!app->priv->hold_source)
+		app->priv->hold_source = g_idle_add(update_held_jobs, app);
+}
+
+/*
+ * Starts the runners waiting in the queue, in the order given by the
+ * priorities of the queues and the shares of the clients, see
+ * gebrm_fair_queue_pop(). Several runners may be waiting for the load of
+ * the daemons at the same time: each one takes the cores reserved by the
+ * others into account when it finally decides, see
+ * gebr_comm_daemon_reserve_cores().
+ *
+ * Runners are held in the queue while the daemons of their group have no
+ * free cores, see get_free_cores(). The runners behind wait too, so a
+ * busy group does not lose its turn. This is called again when a task
+ * completes, a daemon logs in or a runner finishes dispatching.
+ */
+static void
+gebrm_app_dispatch_runners(GebrmApp *app)
+{
+	GebrCommRunner *runner;
+	const gchar *queue;
+
+	while (app->priv->n_dispatching < app->priv->max_dispatching
+	       && (runner = gebrm_fair_queue_peek(app->priv->run_queue))
+	       && get_free_cores(app, runner) != 0) {
+		gebrm_fair_queue_pop(app->priv->run_queue, &queue);
+
+		const gchar *id = gebr_comm_runner_get_id(runner);
+		GebrmJob *job = gebrm_app_job_controller_find(app, id);
+
+		/* Holds a place in the queue until the job ends */
+		g_object_set_data(G_OBJECT(job), "queued-runner", NULL);
+		g_object_set_data_full(G_OBJECT(job), "admitted-queue", g_strdup(queue), g_free);
+		set_job_hold(app, job, 0, NULL);
+
+		if (!gebr_comm_runner_run_async(runner)) {
+			gebrm_job_kill_immediately(job);
+			continue;
+		}
+
+		app->priv->n_dispatching++;
+	}
+
+	schedule_held_jobs(app);
+}
+
+static void
+send_eta_message(GebrCommProtocolSocket *socket,
+		 GebrmJob *job)
+{
+	gdouble eta = gebrm_job_get_eta(job);
+
+	if (eta < 0)
+		return;
+
+	gchar *eta_str = g_strdup_printf("%d", (gint)(eta + 0.5));
+	gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+					      gebr_comm_protocol_defs.eta_def, 2,
+					      gebrm_job_get_id(job),
+					      eta_str);
+	g_free(eta_str);
+}
+
+/*
+ * Tells the clients how the number of processes of @job was chosen, if it
+ * was run with automatic speed. The curve is empty if the flow had no
+ * executions to fit it.
+ */
+static void
+send_scaling_message(GebrCommProtocolSocket *socket,
+		     GebrmJob *job)
+{
+	if (!g_object_get_data(G_OBJECT(job), "auto-speed"))
+		return;
+
+	GebrScaling *scaling = g_object_get_data(G_OBJECT(job), "scaling");
+	gchar sigma[G_ASCII_DTOSTR_BUF_SIZE] = "";
+	gchar kappa[G_ASCII_DTOSTR_BUF_SIZE] = "";
+
+	if (scaling) {
+		g_ascii_formatd(sigma, sizeof(sigma), "%.4f", scaling->sigma);
+		g_ascii_formatd(kappa, sizeof(kappa), "%.5f", scaling->kappa);
+	}
+
+	gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+					      gebr_comm_protocol_defs.scl_def, 3,
+					      gebrm_job_get_id(job),
+					      sigma, kappa);
+}
+
+static gdouble
+predict_daemon_cost(GebrCommDaemon *daemon,
+		    gpointer data)
+{
+	AppAndJob *aap = data;
+	const gchar *key = g_object_get_data(G_OBJECT(aap->job), "history-key");
+
+	if (!aap->app->priv->history || !key)
+		return -1;
+
+	return gebrm_history_get_cost(aap->app->priv->history, key,
+				      gebrm_daemon_get_model_name(GEBRM_DAEMON(daemon)));
+}
+
+/*
+ * Copies the steps of the @total tasks sent by @runner into @job.
+ *
+ * Returns: the predicted duration of @job, that of its slowest task, or -1
+ * if some task never ran on daemons of the same kind.
+ */
+static gdouble
+set_job_tasks_steps(GebrmApp *app,
+		    GebrmJob *job,
+		    GebrCommRunner *runner,
+		    gint total)
+{
+	AppAndJob aap = { app, job };
+	gdouble eta = total > 0 ? 0 : -1;
+
+	for (gint frac = 1; frac <= total; frac++) {
+		GebrCommDaemon *daemon;
+		gint ncores;
+		gint steps = gebr_comm_runner_get_task_steps(runner, frac, &daemon, &ncores);
+
+		if (steps < 0) {
+			eta = -1;
+			continue;
+		}
+
+		gebrm_job_set_task_steps(job, frac, steps, ncores);
+
+		gdouble cost = predict_daemon_cost(daemon, &aap);
+		if (cost <= 0)
+			eta = -1;
+		else if (eta >= 0)
+			eta = MAX(eta, steps * cost / ncores);
+	}
+
+	return eta;
+}
+
+static void
+free_runner(GebrCommRunner *runner)
+{
+	gebr_validator_free(gebr_comm_runner_get_validator(runner));
+	gebr_comm_runner_free(runner);
+}
+
+static void
+on_job_chunk_finished(GebrmJob *job,
+		      GebrmTask *task,
+		      GebrmApp *app)
+{
+	GebrCommRunner *runner = g_object_get_data(G_OBJECT(job), "chunk-runner");
+
+	if (!runner)
+		return;
+
+	gebr_comm_runner_chunk_finished(runner, GEBR_COMM_DAEMON(gebrm_task_get_daemon(task)));
+
+	gint total = gebr_comm_runner_get_total(runner);
+	if (total < 0)
+		return;
+
+	/* All chunks were sent */
+	set_job_tasks_steps(app, job, runner, total);
+	gebrm_job_set_total_tasks(job, total);
+	g_object_set_data(G_OBJECT(job), "chunk-runner", NULL);
+}
+
 static void
 on_execution_response(GebrCommRunner *runner,
 		      gpointer data)
@@ -1016,24 +2348,156 @@ on_execution_response(GebrCommRunner *runner,
 	gebrm_job_set_servers_list(aap->job, gebr_comm_runner_get_servers_list(runner));
 	gebrm_job_set_nprocs(aap->job, gebr_comm_runner_get_ncores(runner));
 
-	g_queue_pop_head(aap->app->priv->job_def_queue);
+	if (g_object_get_data(G_OBJECT(aap->job), "auto-speed"))
+		gebrm_job_set_exec_speed(aap->job, gebr_comm_runner_get_speed(runner));
+
+	/* Chunks are sized as they go, there is no prediction for them */
+	gint total = gebr_comm_runner_get_total(runner);
+	if (total >= 0)
+		gebrm_job_set_eta(aap->job, set_job_tasks_steps(aap->app, aap->job, runner, total));
+
+	journal_dispatch(aap->app, aap->job, total);
+
+	g_queue_remove(aap->app->priv->job_def_queue, aap->job);
 	send_job_def_to_clients(aap->app, aap->job);
 
-	g_queue_pop_head(aap->app->priv->job_run_queue);
-	GebrCommRunner *next_run = g_queue_peek_head(aap->app->priv->job_run_queue);
-	if (next_run && !gebr_comm_runner_run_async(next_run)) {
-		const gchar *id = gebr_comm_runner_get_id(next_run);
-		GebrmJob *job = gebrm_app_job_controller_find(aap->app, id);
-		gebrm_job_kill_immediately(job);
+	for (GList *i = aap->app->priv->connections; i; i = i->next) {
+		GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(i->data);
+		send_eta_message(socket, aap->job);
+		send_scaling_message(socket, aap->job);
 	}
 
-	gebr_validator_free(gebr_comm_runner_get_validator(runner));
-	gebr_comm_runner_free(runner);
+	aap->app->priv->n_dispatching--;
+	gebrm_app_dispatch_runners(aap->app);
+
+	/* The loop is being distributed in chunks, keep the runner around
+	 * until all of them are sent */
+	if (total < 0) {
+		gebr_comm_runner_set_cost_func(runner, NULL, NULL);
+		g_signal_connect(aap->job, "chunk-finished",
+				 G_CALLBACK(on_job_chunk_finished), aap->app);
+		g_object_set_data_full(G_OBJECT(aap->job), "chunk-runner", runner,
+				       (GDestroyNotify)free_runner);
+	} else if (gebr_comm_runner_can_split(runner)) {
+		/* Needed to split the stragglers, see check_stragglers() */
+		g_signal_connect(aap->job, "task-split",
+				 G_CALLBACK(on_job_task_split), aap->app);
+		g_object_set_data_full(G_OBJECT(aap->job), "split-runner", runner,
+				       (GDestroyNotify)free_runner);
+	} else {
+		gebr_validator_free(gebr_comm_runner_get_validator(runner));
+		gebr_comm_runner_free(runner);
+	}
 	g_free(aap);
 }
 
+/*
+ * Makes @job wait for @parent, see RunnerAndJob.
+ */
+static void
+add_job_edge(GebrmJob *parent,
+	     GebrmJob *job,
+	     GebrCommRunner *runner,
+	     gboolean requires_success)
+{
+	GList *l = g_object_get_data(G_OBJECT(parent), "children");
+
+	RunnerAndJob *raj = g_new(RunnerAndJob, 1);
+	raj->runner = runner;
+	raj->job = job;
+	raj->requires_success = requires_success;
+	l = g_list_prepend(l, raj);
+	g_object_set_data(G_OBJECT(parent), "children", l);
+}
+
+/*
+ * Parses @ids, a comma separated list of jobs that must finish before a new
+ * one runs. Each id may also be a temporary id of @client. Returns the jobs
+ * still to finish; jobs that already finished or are gone are satisfied.
+ * Sets @failed if one of them failed or was canceled.
+ */
+static GList *
+get_prerequisites(GebrmApp *app,
+		  GebrmClient *client,
+		  const gchar *ids,
+		  gboolean *failed)
+{
+	GList *jobs = NULL;
+
+	if (!ids || !*ids)
+		return NULL;
+
+	gchar **v = g_strsplit(ids, ",", 0);
+	for (gint i = 0; v[i]; i++) {
+		const gchar *id = gebrm_client_get_job_id_from_temp(client, v[i]);
+		GebrmJob *job = gebrm_app_job_controller_find(app, id ? id : v[i]);
+
+		if (!job || g_list_find(jobs, job))
+			continue;
+
+		GebrCommJobStatus status = gebrm_job_get_status(job);
+		if (status == JOB_STATUS_FAILED || status == JOB_STATUS_CANCELED)
+			*failed = TRUE;
+		else if (status != JOB_STATUS_FINISHED)
+			jobs = g_list_prepend(jobs, job);
+	}
+	g_strfreev(v);
+
+	return jobs;
+}
+
+/*
+ * Loads the flow sent in the JSON @content and splits its dictionaries into
+ * a new line and project, which @line and @proj are set to. Runs in the
+ * workers, see parse_request().
+ *
+ * Returns: the flow, or %NULL if it could not be loaded.
+ */
+static GebrGeoXmlDocument *
+load_flow_of_content(const gchar *content,
+		     GebrGeoXmlDocument **line,
+		     GebrGeoXmlDocument **proj)
+{
+	GebrGeoXmlDocument *flow = NULL;
+	GebrCommJsonContent *json = gebr_comm_json_content_new(content);
+	GString *value = gebr_comm_json_content_to_gstring(json);
+
+	gebr_comm_json_content_free(json);
+
+	if (gebr_geoxml_document_load_buffer(&flow, value->str) != GEBR_GEOXML_RETV_SUCCESS) {
+		g_warning("Could not load the flow of a request");
+		g_string_free(value, TRUE);
+		return NULL;
+	}
+	g_string_free(value, TRUE);
+
+	*proj = GEBR_GEOXML_DOCUMENT(gebr_geoxml_project_new());
+	*line = GEBR_GEOXML_DOCUMENT(gebr_geoxml_line_new());
+
+	gebr_geoxml_document_split_dict(flow, *line, *proj, NULL);
+
+	return flow;
+}
+
+/*
+ * Creates a job for @flow, whose dictionaries were split into @line and
+ * @proj, with the parameters of the request @uri. The documents are kept
+ * by the job. @temp_id is the temporary id of the job, and @title_suffix,
+ * if not %NULL, is appended to its title.
+ *
+ * The runner of the job is queued, but the queue is only dispatched if
+ * @dispatch is %TRUE, so a batch of jobs is dispatched at once.
+ */
 static void
-gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *client, GebrCommUri *uri)
+gebrm_app_submit_flow(GebrmApp *app,
+		      GebrmClient *client,
+		      GebrCommUri *uri,
+		      GebrGeoXmlDocument *flow,
+		      GebrGeoXmlDocument *line,
+		      GebrGeoXmlDocument *proj,
+		      const gchar *temp_id,
+		      const gchar *title_suffix,
+		      gboolean dispatch)
 {
 	const gchar *gid		= gebr_comm_uri_get_param(uri, "gid");
 	const gchar *parent_id		= gebr_comm_uri_get_param(uri, "parent_id");
@@ -1046,30 +2510,24 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 	const gchar *server_host	= gebr_comm_uri_get_param(uri, "server-hostname");
 	const gchar *group_type		= gebr_comm_uri_get_param(uri, "group_type");
 	const gchar *host		= gebr_comm_uri_get_param(uri, "host");
-	const gchar *temp_id		= gebr_comm_uri_get_param(uri, "temp_id");
 	const gchar *paths		= gebr_comm_uri_get_param(uri, "paths");
 	const gchar *snapshot_title	= gebr_comm_uri_get_param(uri, "snapshot_title");
 	const gchar *snapshot_id	= gebr_comm_uri_get_param(uri, "snapshot_id");
+	const gchar *distribution	= gebr_comm_uri_get_param(uri, "distribution");
+	const gchar *queue		= gebr_comm_uri_get_param(uri, "queue");
+	const gchar *after		= gebr_comm_uri_get_param(uri, "prerequisites");
 
 	if (temp_parent)
 		parent_id = gebrm_client_get_job_id_from_temp(client,
 							      temp_parent);
 
-	GebrCommJsonContent *json = gebr_comm_json_content_new(request->content->str);
-	GString *value = gebr_comm_json_content_to_gstring(json);
-
 	GebrGeoXmlProject **pproj = g_new(GebrGeoXmlProject*, 1);
 	GebrGeoXmlLine **pline = g_new(GebrGeoXmlLine*, 1);
 	GebrGeoXmlFlow **pflow = g_new(GebrGeoXmlFlow*, 1);
 
-	gebr_geoxml_document_load_buffer((GebrGeoXmlDocument **)pflow, value->str);
-	*pproj = gebr_geoxml_project_new();
-	*pline = gebr_geoxml_line_new();
-
-	gebr_geoxml_document_split_dict(*((GebrGeoXmlDocument **)pflow),
-					*((GebrGeoXmlDocument **)pline),
-					*((GebrGeoXmlDocument **)pproj),
-					NULL);
+	*pproj = GEBR_GEOXML_PROJECT(proj);
+	*pline = GEBR_GEOXML_LINE(line);
+	*pflow = GEBR_GEOXML_FLOW(flow);
 
 	GebrValidator *validator = gebr_validator_new((GebrGeoXmlDocument **)pflow,
 						      (GebrGeoXmlDocument **)pline,
@@ -1081,7 +2539,10 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 	gint job_counter = gebrm_app_increment_jobs_counter(app, flow_id);
 
 	GebrmJobInfo info = { 0, };
-	info.title = g_strdup(title);
+	if (title_suffix)
+		info.title = g_strdup_printf("%s (%s)", title, title_suffix);
+	else
+		info.title = g_strdup(title);
 	info.description = g_strdup(description);
 	info.temp_id = g_strdup(temp_id);
 	info.flow_id = g_strdup(flow_id);
@@ -1110,18 +2571,18 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 
 	gebrm_client_add_temp_id(client, temp_id, gebrm_job_get_id(job));
 
-	g_signal_connect(job, "status-change",
-			 G_CALLBACK(gebrm_app_job_controller_on_status_change), app);
-	g_signal_connect(job, "issued",
-			 G_CALLBACK(gebrm_app_job_controller_on_issued), app);
-	g_signal_connect(job, "cmd-line-received",
-			 G_CALLBACK(gebrm_app_job_controller_on_cmd_line_received), app);
-	g_signal_connect(job, "output",
-			 G_CALLBACK(gebrm_app_job_controller_on_output), app);
+	/* The client that submits a job shows it */
+	gebrm_client_subscribe(client, gebrm_job_get_id(job));
+	connect_job_signals(app, job);
 
 	gebrm_job_init_details(job, &info);
 	gebrm_app_job_controller_add(app, job);
 
+	g_object_set_data_full(G_OBJECT(job), "queue-name",
+			       g_strdup(queue && *queue ? queue : GEBRM_FAIR_QUEUE_DEFAULT), g_free);
+	g_object_set_data_full(G_OBJECT(job), "client-id",
+			       g_strdup(gebrm_client_get_id(client)), g_free);
+
 	GList *mpi_flavors = gebr_geoxml_flow_get_mpi_flavors(*pflow);
 
 	if (mpi_flavors)
@@ -1129,13 +2590,33 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 	else
 		gebrm_job_set_run_type(job, "normal");
 
+	journal_submit(app, job);
+
+	gboolean prerequisite_failed = FALSE;
+	GList *prerequisites = get_prerequisites(app, client, after, &prerequisite_failed);
+
 	GList *servers = get_comm_servers_list(app, name, group_type);
 
 	GList *min_subset_servers = get_comm_servers_min_subset(servers, mpi_flavors);
 	GList *max_subset_servers = get_comm_servers_max_subset(servers, mpi_flavors);
 
-	if (!min_subset_servers) {
+	if (prerequisite_failed) {
+		gebrm_job_set_status(job, JOB_STATUS_CANCELED);
+		journal_status(app, job, JOB_STATUS_CANCELED, gebr_iso_date());
+		journal_issue(app, job, _("A job this one depends on did not finish successfully."));
+		touch_job(app, job);
+
+		for (GList *i = app->priv->connections; i; i = i->next) {
+			GebrCommProtocolSocket *socket_client = gebrm_client_get_protocol_socket(i->data);
+			send_messages_of_jobs(gebrm_job_get_id(job), job, socket_client);
+			gebr_comm_protocol_socket_oldmsg_send(socket_client, FALSE,
+							      gebr_comm_protocol_defs.iss_def, 2,
+							      gebrm_job_get_id(job),
+							      _("A job this one depends on did not finish successfully."));
+		}
+	} else if (!min_subset_servers) {
 		gebrm_job_set_status(job, JOB_STATUS_FAILED);
+		journal_status(app, job, JOB_STATUS_FAILED, gebr_iso_date());
 
 		GString *tmp = g_string_new(NULL);
 		for (GList *i = mpi_flavors; i; i = i->next) {
@@ -1155,6 +2636,8 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 			mpi_issue_message = g_strdup_printf("The processing node <b>%s</b> does not support %s", info.group, tmp->str);
 
 		g_string_free(tmp, TRUE);
+		journal_issue(app, job, mpi_issue_message);
+		touch_job(app, job);
 
 		for (GList *i = app->priv->connections; i; i = i->next) {
 			GebrCommProtocolSocket *socket_client = gebrm_client_get_protocol_socket(i->data);
@@ -1172,13 +2655,41 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 							      gid, parent_id, speed, nice,
 							      name, paths, validator);
 
+		if (g_strcmp0(distribution, "dynamic") == 0)
+			gebr_comm_runner_set_dynamic(runner, TRUE);
+
+		gchar *hash = gebr_comm_runner_get_flow_hash(runner);
+		g_object_set_data_full(G_OBJECT(job), "history-key",
+				       g_strconcat(flow_id ? flow_id : "", ":", hash, NULL), g_free);
+		g_free(hash);
+
+		if (app->priv->history)
+			gebr_comm_runner_set_memory_per_process(runner,
+				gebrm_history_get_memory(app->priv->history,
+							 g_object_get_data(G_OBJECT(job), "history-key")));
+
+		GebrScaling scaling;
+		if (g_strcmp0(speed, GEBR_COMM_RUNNER_SPEED_AUTO) == 0) {
+			g_object_set_data(G_OBJECT(job), "auto-speed", GINT_TO_POINTER(TRUE));
+			if (app->priv->history
+			    && gebrm_history_get_scaling(app->priv->history,
+							 g_object_get_data(G_OBJECT(job), "history-key"),
+							 &scaling)) {
+				gebr_comm_runner_set_scaling(runner, &scaling);
+				g_object_set_data_full(G_OBJECT(job), "scaling",
+						       g_memdup(&scaling, sizeof(scaling)), g_free);
+			}
+		}
+
 		AppAndJob *aap = g_new(AppAndJob, 1);
 		aap->app = app;
 		aap->job = job;
 		gebr_comm_runner_set_ran_func(runner, on_execution_response, aap);
+		gebr_comm_runner_set_cost_func(runner, predict_daemon_cost, aap);
 
 		GebrmJob *parent;
 		gboolean run_immediately = FALSE;
+		gint pending = 0;
 
 		parent = gebrm_app_job_controller_find(app, parent_id);
 		if (parent) {
@@ -1186,25 +2697,30 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 			run_immediately = status != JOB_STATUS_QUEUED && status != JOB_STATUS_RUNNING && status != JOB_STATUS_INITIAL;
 		}
 
-		if (!parent || run_immediately) {
+		if (parent && !run_immediately) {
+			add_job_edge(parent, job, runner, FALSE);
+			pending++;
+		}
+
+		for (GList *i = prerequisites; i; i = i->next) {
+			add_job_edge(i->data, job, runner, TRUE);
+			pending++;
+		}
+
+		if (!pending) {
 			g_queue_push_head(app->priv->job_def_queue, job);
-			if (g_queue_is_empty(app->priv->job_run_queue)
-			    && !gebr_comm_runner_run_async(runner))
-				gebrm_job_kill_immediately(job);
-			g_queue_push_tail(app->priv->job_run_queue, runner);
+			gebrm_app_queue_runner(app, job, runner);
+			if (dispatch)
+				gebrm_app_dispatch_runners(app);
 		} else {
-			GList *parent_on_queue = g_queue_find(app->priv->job_def_queue, parent);
+			g_object_set_data(G_OBJECT(job), "pending-prerequisites", GINT_TO_POINTER(pending));
+			gebrm_job_set_status(job, JOB_STATUS_QUEUED);
+			journal_status(app, job, JOB_STATUS_QUEUED, parent_id);
+
+			GList *parent_on_queue = parent ? g_queue_find(app->priv->job_def_queue, parent) : NULL;
 			if (parent_on_queue)
 				g_queue_insert_after(app->priv->job_def_queue, parent_on_queue, job);
 
-			GList *l = g_object_get_data(G_OBJECT(parent), "children");
-
-			RunnerAndJob *raj = g_new(RunnerAndJob, 1);
-			raj->runner = runner;
-			raj->job = job;
-			l = g_list_prepend(l, raj);
-			g_object_set_data(G_OBJECT(parent), "children", l);
-
 			if (g_queue_is_empty(app->priv->job_def_queue))
 				send_job_def_to_clients(app, job);
 		}
@@ -1212,16 +2728,281 @@ gebrm_app_handle_run(GebrmApp *app, GebrCommHttpMsg *request, GebrmClient *clien
 
 	g_list_foreach(mpi_flavors, (GFunc)g_free, NULL);
 	g_list_free(mpi_flavors);
+	g_list_free(prerequisites);
 	gebrm_job_info_free(&info);
 	g_list_free(servers);
 	g_free(title);
 	g_free(description);
 }
 
+/*
+ * Returns the variable @keyword of the dictionary of @doc, or %NULL.
+ */
+static GebrGeoXmlProgramParameter *
+get_dict_variable(GebrGeoXmlDocument *doc,
+		  const gchar *keyword)
+{
+	GebrGeoXmlSequence *seq = gebr_geoxml_document_get_dict_parameter(doc);
+
+	for (; seq; gebr_geoxml_sequence_next(&seq)) {
+		if (gebr_geoxml_parameter_get_type(GEBR_GEOXML_PARAMETER(seq)) == GEBR_GEOXML_PARAMETER_TYPE_GROUP)
+			continue;
+
+		gchar *name = gebr_geoxml_program_parameter_get_keyword(GEBR_GEOXML_PROGRAM_PARAMETER(seq));
+		gboolean found = g_strcmp0(name, keyword) == 0;
+		g_free(name);
+
+		if (found)
+			return GEBR_GEOXML_PROGRAM_PARAMETER(seq);
+	}
+
+	return NULL;
+}
+
+static void
+submit_request_free(SubmitRequest *req)
+{
+	g_object_unref(req->client);
+	gebr_comm_http_msg_free(req->request);
+	gebr_comm_uri_free(req->uri);
+	g_free(req->content);
+	g_ptr_array_free(req->docs, TRUE);
+	g_ptr_array_free(req->suffixes, TRUE);
+	g_free(req);
+}
+
+static void
+submit_request_add_job(SubmitRequest *req,
+		       GebrGeoXmlDocument **docs,
+		       const gchar *suffix)
+{
+	for (gint j = 0; j < 3; j++)
+		g_ptr_array_add(req->docs, docs[j]);
+	g_ptr_array_add(req->suffixes, g_strdup(suffix));
+}
+
+/*
+ * Creates a copy of the flow of @req for each point of a parameter sweep.
+ * The parameters of the request are the ones of /run, and:
+ *
+ *   keywords: the variables of the sweep, separated by tabs;
+ *   points: one point per line, with the values of the variables separated
+ *     by tabs, each one escaped by g_strescape();
+ *   product: if "yes", line i of points has the values of variable i, and
+ *     the points are all of their combinations.
+ *
+ * The flow is loaded once, and each job gets a copy with its values in the
+ * dictionary that defines each variable. Each copy is still validated on
+ * its own in gebrm_app_submit_flow(): its expressions evaluate to other
+ * values, and its runner keeps the validator while the job runs. Runs in
+ * the workers.
+ */
+static void
+parse_sweep(SubmitRequest *req)
+{
+	const gchar *keywords = gebr_comm_uri_get_param(req->uri, "keywords");
+	const gchar *points   = gebr_comm_uri_get_param(req->uri, "points");
+	const gchar *product  = gebr_comm_uri_get_param(req->uri, "product");
+
+	if (!keywords || !*keywords || !points) {
+		g_warning("Sweep request without variables");
+		return;
+	}
+
+	gchar **names = gebrm_sweep_split_fields(keywords);
+	gint n = g_strv_length(names);
+	GPtrArray *table = gebrm_sweep_get_points(n, points, g_strcmp0(product, "yes") == 0);
+
+	if (!table) {
+		g_warning("Malformed sweep request, or with more than %d points", GEBRM_SWEEP_MAX_POINTS);
+		g_strfreev(names);
+		return;
+	}
+
+	GebrGeoXmlDocument *template[3];
+	template[0] = load_flow_of_content(req->content, &template[1], &template[2]);
+	if (!template[0]) {
+		g_ptr_array_free(table, TRUE);
+		g_strfreev(names);
+		return;
+	}
+
+	/* The document that defines each variable, only these are copied */
+	gint *owners = g_new(gint, n);
+	gboolean copy[3] = { TRUE, FALSE, FALSE };
+
+	for (gint i = 0; i < n; i++) {
+		owners[i] = -1;
+		for (gint j = 0; j < 3 && owners[i] < 0; j++) {
+			GebrGeoXmlProgramParameter *var = get_dict_variable(template[j], names[i]);
+			if (var) {
+				owners[i] = j;
+				copy[j] = TRUE;
+				gebr_geoxml_object_unref(var);
+			}
+		}
+
+		if (owners[i] < 0) {
+			g_warning("Sweep over variable %s, which is not defined", names[i]);
+			goto out;
+		}
+	}
+
+	for (guint k = 0; k < table->len; k++) {
+		gchar **point = g_ptr_array_index(table, k);
+		GebrGeoXmlDocument *docs[3];
+		GString *suffix = g_string_new(NULL);
+
+		for (gint j = 0; j < 3; j++)
+			docs[j] = copy[j] ? gebr_geoxml_document_clone(template[j]) : template[j];
+
+		for (gint i = 0; i < n; i++) {
+			GebrGeoXmlProgramParameter *var = get_dict_variable(docs[owners[i]], names[i]);
+			gebr_geoxml_program_parameter_set_first_value(var, FALSE, point[i]);
+			gebr_geoxml_object_unref(var);
+
+			g_string_append_printf(suffix, "%s%s=%s", i ? ", " : "", names[i], point[i]);
+		}
+
+		submit_request_add_job(req, docs, suffix->str);
+		g_string_free(suffix, TRUE);
+	}
+
+out:
+	/* Documents not copied are kept by the jobs */
+	for (gint j = 0; j < 3; j++)
+		if (copy[j] || !req->suffixes->len)
+			gebr_geoxml_document_unref(template[j]);
+
+	g_free(owners);
+	g_ptr_array_free(table, TRUE);
+	g_strfreev(names);
+}
+
+/*
+ * Submits up to SUBMIT_BATCH jobs of the requests parsed at the head of
+ * the queue, so they are submitted in the order they came even if the
+ * workers finish them out of order: a job may refer to the temporary id of
+ * a previous one. Job i of a sweep gets the temporary id "temp_id:i".
+ *
+ * Runs again in the next iteration of the main loop while the head of the
+ * queue has jobs left.
+ */
+static gboolean
+submit_parsed_requests(gpointer data)
+{
+	GebrmApp *app = data;
+	guint n = 0;
+
+	while (!g_queue_is_empty(app->priv->submit_queue) && n < SUBMIT_BATCH) {
+		SubmitRequest *req = g_queue_peek_head(app->priv->submit_queue);
+
+		if (!req->parsed)
+			break;
+
+		const gchar *temp_id = gebr_comm_uri_get_param(req->uri, "temp_id");
+
+		for (; req->submitted < req->suffixes->len && n < SUBMIT_BATCH; req->submitted++, n++) {
+			guint k = req->submitted;
+			GebrGeoXmlDocument **docs = (GebrGeoXmlDocument **)req->docs->pdata + 3 * k;
+			gchar *job_temp_id;
+
+			if (req->sweep)
+				job_temp_id = temp_id ? g_strdup_printf("%s:%u", temp_id, k) : NULL;
+			else
+				job_temp_id = g_strdup(temp_id);
+
+			gebrm_app_submit_flow(app, req->client, req->uri, docs[0], docs[1], docs[2],
+					      job_temp_id, g_ptr_array_index(req->suffixes, k), FALSE);
+			g_free(job_temp_id);
+		}
+
+		if (req->submitted == req->suffixes->len) {
+			/* The client may have other requests answered meanwhile */
+			gebr_comm_protocol_socket_send_response_to(gebrm_client_get_protocol_socket(req->client),
+								   req->request, req->submitted ? 200 : 400, NULL);
+			g_queue_pop_head(app->priv->submit_queue);
+			submit_request_free(req);
+		}
+	}
+
+	if (n)
+		gebrm_app_dispatch_runners(app);
+
+	SubmitRequest *head = g_queue_peek_head(app->priv->submit_queue);
+	if (head && head->parsed)
+		return TRUE;
+
+	app->priv->submit_source = 0;
+	return FALSE;
+}
+
+static gboolean
+on_request_parsed(SubmitRequest *parsed)
+{
+	GebrmApp *app = parsed->app;
+
+	parsed->parsed = TRUE;
+
+	if (!app->priv->submit_source)
+		app->priv->submit_source = g_idle_add(submit_parsed_requests, app);
+
+	return FALSE;
+}
+
+/*
+ * Loads the documents of @req, in a worker. Only the documents of @req are
+ * touched here: the validators, which share a cache of documents, and
+ * everything else are left to the main loop.
+ */
+static void
+parse_request(SubmitRequest *req,
+	      GebrmApp *app)
+{
+	if (req->sweep) {
+		parse_sweep(req);
+	} else {
+		GebrGeoXmlDocument *docs[3];
+		docs[0] = load_flow_of_content(req->content, &docs[1], &docs[2]);
+		if (docs[0])
+			submit_request_add_job(req, docs, NULL);
+	}
+
+	g_idle_add((GSourceFunc)on_request_parsed, req);
+}
+
+/*
+ * Handles /run, and /sweep if @sweep is %TRUE, see parse_sweep(). The flow
+ * is loaded by the workers, so large submissions do not stall the other
+ * clients. @request is answered once its jobs are submitted, with 400 if
+ * none could be loaded, and the client may get answers to its next
+ * requests before that.
+ */
+static void
+gebrm_app_handle_submit(GebrmApp *app,
+			GebrCommHttpMsg *request,
+			GebrmClient *client,
+			gboolean sweep)
+{
+	SubmitRequest *req = g_new0(SubmitRequest, 1);
+
+	req->app = app;
+	req->client = g_object_ref(client);
+	req->request = g_object_ref(request);
+	req->uri = gebr_comm_uri_new();
+	gebr_comm_uri_parse(req->uri, request->url->str);
+	req->content = g_strdup(request->content->str);
+	req->sweep = sweep;
+	req->docs = g_ptr_array_new();
+	req->suffixes = g_ptr_array_new_with_free_func(g_free);
+
+	g_queue_push_tail(app->priv->submit_queue, req);
+	g_thread_pool_push(app->priv->workers, req, NULL);
+}
+
 static void
 connect_all_daemons(GebrmApp *app, GebrCommProtocolSocket *socket, const gchar *addr, gint respect_ac)
 {
-	gboolean connect_daemon = FALSE;
 	app->priv->connect_all = TRUE;
 
 	if (respect_ac)
@@ -1229,16 +3010,16 @@ connect_all_daemons(GebrmApp *app, GebrCommProtocolSocket *socket, const gchar *
 	else
 		app->priv->respect_ac = FALSE;
 
+	gebrm_connect_scheduler_set_paused(app->priv->scheduler, FALSE);
+
 	for (GList *i = app->priv->daemons; i; i = i->next) {
 		GebrmDaemon *daemon = i->data;
 
 		gebrm_daemon_set_canceled(daemon, FALSE);
 
-		if (!connect_daemon && gebrm_daemon_get_state(daemon) == SERVER_STATE_DISCONNECTED &&
-		    (g_strcmp0(gebrm_daemon_get_autoconnect(daemon), "on") == 0 || !respect_ac)) {
-			gebrm_daemon_connect(daemon, socket);
-			connect_daemon = TRUE;
-		}
+		if (gebrm_daemon_get_state(daemon) == SERVER_STATE_DISCONNECTED &&
+		    (g_strcmp0(gebrm_daemon_get_autoconnect(daemon), "on") == 0 || !respect_ac))
+			gebrm_connect_scheduler_push(app->priv->scheduler, daemon);
 	}
 
 	if (addr) {
@@ -1249,7 +3030,7 @@ connect_all_daemons(GebrmApp *app, GebrCommProtocolSocket *socket, const gchar *
 		}
 	}
 
-	if (!connect_daemon)
+	if (!gebrm_connect_scheduler_is_running(app->priv->scheduler))
 		app->priv->connect_all = FALSE;
 }
 
@@ -1341,6 +3122,7 @@ on_client_request(GebrCommProtocolSocket *socket,
 								gebrm_job_kill_immediately(job);
 						}
 						gebrm_daemon_set_disconnecting(daemon, FALSE);
+						gebrm_connect_scheduler_cancel(app->priv->scheduler, daemon);
 						gebrm_daemon_disconnect(daemon);
 						gebrm_client_kill_forward_by_address(client, addr);
 					}
@@ -1394,16 +3176,54 @@ on_client_request(GebrCommProtocolSocket *socket,
 			GebrmJob *job = g_hash_table_lookup(app->priv->jobs, id);
 			if (job) {
 				gebrm_job_close(job);
+				if (app->priv->journal)
+					gebrm_journal_append(app->priv->journal, id,
+							     GEBRM_JOURNAL_CLOSE, NULL);
 				g_hash_table_remove(app->priv->jobs, id);
+				forget_job(app, id);
 
 				for (GList *i = app->priv->connections; i; i = i->next) {
 					GebrCommProtocolSocket *socket_client = gebrm_client_get_protocol_socket(i->data);
+					gebrm_client_unsubscribe(i->data, id);
 					gebr_comm_protocol_socket_oldmsg_send(socket_client, FALSE,
 					                                      gebr_comm_protocol_defs.jcl_def, 1,
 					                                      id);
 				}
 			}
 		}
+		else if (g_strcmp0(prefix, "/sync") == 0) {
+			const gchar *cursor = gebr_comm_uri_get_param(uri, "cursor");
+			sync_client(app, socket, cursor);
+		}
+		else if (g_strcmp0(prefix, "/subscribe") == 0) {
+			const gchar *id = gebr_comm_uri_get_param(uri, "id");
+			GebrmJob *job = g_hash_table_lookup(app->priv->jobs, id);
+
+			/* The output arrived so far, then the rest as it comes */
+			if (job) {
+				gebrm_client_subscribe(client, id);
+				send_output_of_job(socket, job);
+			}
+		}
+		else if (g_strcmp0(prefix, "/unsubscribe") == 0) {
+			const gchar *id = gebr_comm_uri_get_param(uri, "id");
+			gebrm_client_unsubscribe(client, id);
+		}
+		else if (g_strcmp0(prefix, "/output") == 0) {
+			const gchar *id = gebr_comm_uri_get_param(uri, "id");
+			const gchar *frac = gebr_comm_uri_get_param(uri, "frac");
+			const gchar *offset = gebr_comm_uri_get_param(uri, "offset");
+			const gchar *length = gebr_comm_uri_get_param(uri, "length");
+			GebrmJob *job = g_hash_table_lookup(app->priv->jobs, id);
+
+			if (job && frac) {
+				for (GList *i = gebrm_job_get_list_of_tasks(job); i; i = i->next)
+					if (gebrm_task_get_fraction(i->data) == atoi(frac))
+						send_output_page(socket, job, i->data,
+								 offset ? g_ascii_strtoull(offset, NULL, 10) : 0,
+								 length ? g_ascii_strtoull(length, NULL, 10) : GEBRM_OUTPUT_PAGE_SIZE);
+			}
+		}
 		else if (g_strcmp0(prefix, "/kill") == 0) {
 			const gchar *id = gebr_comm_uri_get_param(uri, "id");
 			GebrmJob *job = g_hash_table_lookup(app->priv->jobs, id);
@@ -1411,28 +3231,40 @@ on_client_request(GebrCommProtocolSocket *socket,
 				if (gebrm_job_get_status(job) == JOB_STATUS_QUEUED) {
 					const gchar *parent_id = gebrm_job_get_queue(job);
 					GebrmJob *parent = gebrm_app_job_controller_find(app, parent_id);
+					gboolean parent_waiting = parent && !gebrm_job_is_stopped(parent);
 
-					GList *child_parent = g_object_get_data(G_OBJECT(parent), "children");
+					GList *child_parent = parent ? g_object_get_data(G_OBJECT(parent), "children") : NULL;
 					for (GList *i = child_parent; i; i = i->next) {
 						RunnerAndJob *rj = i->data;
 						if (job == rj->job) {
 							child_parent = g_list_remove(child_parent, rj);
+							g_free(rj);
 							break;
 						}
 					}
 
+					/* The jobs queued after this one take its place
+					 * in the queue, the ones depending on it are
+					 * canceled with it */
 					GList *child_job = g_object_get_data(G_OBJECT(job), "children");
+					GList *dependents = NULL;
 					for (GList *i = child_job; i; i = i->next) {
 						RunnerAndJob *rj = i->data;
 
-						child_job = g_list_remove(child_job, rj);
+						if (rj->requires_success || !parent_waiting) {
+							dependents = g_list_prepend(dependents, rj);
+							continue;
+						}
+
 						gebrm_job_set_queue(rj->job, parent_id);
 						child_parent = g_list_prepend(child_parent, rj);
 						send_job_def_to_clients(app, rj->job);
 					}
+					g_list_free(child_job);
 
-					g_object_set_data(G_OBJECT(parent), "children", child_parent);
-					g_object_set_data(G_OBJECT(job), "children", child_job);
+					if (parent)
+						g_object_set_data(G_OBJECT(parent), "children", child_parent);
+					g_object_set_data(G_OBJECT(job), "children", dependents);
 
 					gebrm_job_unqueue(job);
 				}
@@ -1441,9 +3273,10 @@ on_client_request(GebrCommProtocolSocket *socket,
 			}
 		}
 		else if (g_strcmp0(prefix, "/run") == 0) {
-
-			gebrm_app_handle_run(app, request, client, uri);
-
+			gebrm_app_handle_submit(app, request, client, FALSE);
+		}
+		else if (g_strcmp0(prefix, "/sweep") == 0) {
+			gebrm_app_handle_submit(app, request, client, TRUE);
 		} else if (g_strcmp0(prefix, "/server-tags") == 0) {
 			const gchar *server = gebr_comm_uri_get_param(uri, "server");
 			const gchar *tags   = gebr_comm_uri_get_param(uri, "tags");
@@ -1507,8 +3340,15 @@ on_client_request(GebrCommProtocolSocket *socket,
 			}
 
 		} 
-	gebr_comm_uri_free(uri);
 	}
+
+	/* The submissions are answered once their jobs are, see
+	 * submit_parsed_requests(), the others right away */
+	if (request->method != GEBR_COMM_HTTP_METHOD_PUT
+	    || (g_strcmp0(prefix, "/run") != 0 && g_strcmp0(prefix, "/sweep") != 0))
+		gebr_comm_protocol_socket_send_response(socket, 200, NULL);
+
+	gebr_comm_uri_free(uri);
 }
 
 static void
@@ -2047,19 +3887,9 @@ send_messages_of_jobs(const gchar *id,
 	                                      gebrm_job_get_mpi_flavor(job));
 
 	GList *tasks = gebrm_job_get_list_of_tasks(job);
-	
-	/* Output message*/
 	gchar *frac;
-	for(GList *i = tasks; i; i = i->next) {
-		frac = g_strdup_printf("%d", gebrm_task_get_fraction(i->data));
-		gebr_comm_protocol_socket_oldmsg_send(protocol, FALSE,
-						      gebr_comm_protocol_defs.out_def, 3,
-						      id,
-						      frac,
-						      gebrm_task_get_output(i->data));
 
-		g_free(frac);
-	}
+	/* The output is sent on request, see send_output_of_job() */
 
 	/* Command line message */
 	for(GList *i = tasks; i; i = i->next) {
@@ -2072,6 +3902,9 @@ send_messages_of_jobs(const gchar *id,
 		g_free(frac);
 	}
 
+	send_eta_message(protocol, job);
+	send_scaling_message(protocol, job);
+
 	/* Issues message */
 	const gchar *issues = gebrm_job_get_issues(job);
 	if (issues && *issues)
@@ -2080,11 +3913,150 @@ send_messages_of_jobs(const gchar *id,
 		                                      id,
 		                                      issues);
 
+	/* Hold message */
+	gint position = GPOINTER_TO_INT(g_object_get_data(G_OBJECT(job), "hold-position"));
+	if (position > 0) {
+		gchar *pos = g_strdup_printf("%d", position);
+		gebr_comm_protocol_socket_oldmsg_send(protocol, FALSE,
+		                                      gebr_comm_protocol_defs.hld_def, 3,
+		                                      id,
+		                                      pos,
+		                                      g_object_get_data(G_OBJECT(job), "hold-reason"));
+		g_free(pos);
+	}
+
 	g_free(infile);
 	g_free(outfile);
 	g_free(logfile);
 }
 
+/*
+ * Sends at most @length bytes of the output of @task from @offset. The
+ * page holds only whole characters, the client learns where it starts
+ * from the message and where it ends from its length.
+ */
+static void
+send_output_page(GebrCommProtocolSocket *protocol,
+		 GebrmJob *job,
+		 GebrmTask *task,
+		 gsize offset,
+		 gsize length)
+{
+	gsize total = gebrm_task_get_output_length(task);
+	gchar *data = gebrm_task_read_output_page(task, &offset, MIN(length, GEBRM_OUTPUT_PAGE_SIZE));
+
+	gchar *frac = g_strdup_printf("%d", gebrm_task_get_fraction(task));
+	gchar *offset_str = g_strdup_printf("%" G_GSIZE_FORMAT, offset);
+	gchar *total_str = g_strdup_printf("%" G_GSIZE_FORMAT, total);
+
+	gebr_comm_protocol_socket_oldmsg_send(protocol, FALSE,
+					      gebr_comm_protocol_defs.otr_def, 5,
+					      gebrm_job_get_id(job),
+					      frac, offset_str, total_str, data);
+	g_free(frac);
+	g_free(offset_str);
+	g_free(total_str);
+	g_free(data);
+}
+
+/*
+ * Sends the last page of the output of each task of @job, replacing the
+ * one the client has; it asks for the earlier pages it wants. A job
+ * without tasks gets the fraction 0, so the client knows its output is
+ * up to date anyway.
+ */
+static void
+send_output_of_job(GebrCommProtocolSocket *protocol,
+		   GebrmJob *job)
+{
+	GList *tasks = gebrm_job_get_list_of_tasks(job);
+
+	if (!tasks)
+		gebr_comm_protocol_socket_oldmsg_send(protocol, FALSE,
+						      gebr_comm_protocol_defs.otr_def, 5,
+						      gebrm_job_get_id(job), "0", "0", "0", "");
+
+	for (GList *i = tasks; i; i = i->next) {
+		gsize total = gebrm_task_get_output_length(i->data);
+		gsize offset = total > GEBRM_OUTPUT_PAGE_SIZE ? total - GEBRM_OUTPUT_PAGE_SIZE : 0;
+		send_output_page(protocol, job, i->data, offset, total - offset);
+	}
+}
+
+/*
+ * Returns: %TRUE if the changes after @cursor are all known, then @since
+ * is its sequence number.
+ */
+static gboolean
+parse_cursor(GebrmApp *app,
+	     const gchar *cursor,
+	     guint *since)
+{
+	gboolean valid = FALSE;
+	gchar **parts = g_strsplit(cursor ? cursor : "", ":", 2);
+
+	if (g_strv_length(parts) == 2 && g_strcmp0(parts[0], app->priv->epoch) == 0) {
+		gchar *end;
+		guint64 seq = g_ascii_strtoull(parts[1], &end, 10);
+
+		if (*parts[1] && !*end
+		    && seq <= app->priv->seq
+		    && seq >= app->priv->closed_floor) {
+			*since = seq;
+			valid = TRUE;
+		}
+	}
+	g_strfreev(parts);
+
+	return valid;
+}
+
+/*
+ * Brings a client up to date from its @cursor: only the jobs that changed
+ * after it are sent, and the ones closed since then. An unknown cursor,
+ * or an empty one for clients connecting for the first time, makes the
+ * client drop its jobs and receive all of them.
+ */
+static void
+sync_client(GebrmApp *app,
+	    GebrCommProtocolSocket *socket,
+	    const gchar *cursor)
+{
+	guint since = 0;
+	gboolean reset = !parse_cursor(app, cursor, &since);
+	gchar *current = get_cursor(app);
+	GHashTableIter iter;
+	gpointer id, job;
+
+	if (reset)
+		gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+						      gebr_comm_protocol_defs.cur_def, 2,
+						      current, "1");
+
+	g_hash_table_iter_init(&iter, app->priv->jobs);
+	while (g_hash_table_iter_next(&iter, &id, &job))
+		if (reset || get_job_seq(job) > since)
+			send_messages_of_jobs(id, job, socket);
+
+	if (!reset) {
+		for (GList *i = app->priv->closed->head; i; i = i->next) {
+			ClosedJob *closed = i->data;
+			if (closed->seq > since)
+				gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+								      gebr_comm_protocol_defs.jcl_def, 1,
+								      closed->id);
+		}
+	}
+
+	gebr_comm_protocol_socket_oldmsg_send(socket, FALSE,
+					      gebr_comm_protocol_defs.cur_def, 2,
+					      current, "0");
+	g_free(current);
+
+	/* From now on it receives the cursor of each change, see send_cursor() */
+	g_object_set_data(G_OBJECT(socket), "synced", GINT_TO_POINTER(TRUE));
+}
+
 static void
 on_new_connection(GebrCommListenSocket *listener,
 		  GebrmApp *app)
@@ -2115,7 +4087,7 @@ on_new_connection(GebrCommListenSocket *listener,
 		g_signal_connect(socket, "old-parse-messages",
 				 G_CALLBACK(on_client_parse_messages), app);
 
-		g_hash_table_foreach(app->priv->jobs, (GHFunc)send_messages_of_jobs, socket);
+		/* The jobs are sent when the client asks, see sync_client() */
 	}
 }
 
@@ -2140,6 +4112,85 @@ gebrm_app_create_possible_daemon_list(GebrMaestroSettings *ms,
 	gebrm_add_server_to_list(app, g_get_host_name(), "");
 }
 
+/*
+ * Reads the named queues and the shares of the clients from the queues
+ * file, which looks like:
+ *
+ *   [urgent]
+ *   priority=10
+ *   max-running=2
+ *
+ *   [weights]
+ *   <gebr id>=2
+ *
+ * Every group but "weights" is a queue. Queues not listed have priority 0
+ * and no limit.
+ *
+ * Queues are chosen only through the API, with the "queue" parameter of
+ * /run and /sweep. The run dialog of GêBR does not send it, so the jobs of
+ * the interface go to GEBRM_FAIR_QUEUE_DEFAULT, which can be given a
+ * priority and a limit here like any other queue.
+ */
+static void
+load_queues(GebrmApp *app)
+{
+	GKeyFile *keyfile = g_key_file_new();
+
+	if (!g_key_file_load_from_file(keyfile, gebrm_app_get_queues_file(), G_KEY_FILE_NONE, NULL)) {
+		g_key_file_free(keyfile);
+		return;
+	}
+
+	gchar **groups = g_key_file_get_groups(keyfile, NULL);
+	for (gint i = 0; groups[i]; i++) {
+		if (g_strcmp0(groups[i], "weights") == 0) {
+			gchar **ids = g_key_file_get_keys(keyfile, groups[i], NULL, NULL);
+			for (gint j = 0; ids && ids[j]; j++) {
+				gdouble weight = g_key_file_get_double(keyfile, groups[i], ids[j], NULL);
+				if (weight > 0)
+					gebrm_fair_queue_set_weight(app->priv->run_queue, ids[j], weight);
+			}
+			g_strfreev(ids);
+			continue;
+		}
+
+		gint priority = g_key_file_get_integer(keyfile, groups[i], "priority", NULL);
+		gint max_running = g_key_file_get_integer(keyfile, groups[i], "max-running", NULL);
+		gebrm_fair_queue_set_queue(app->priv->run_queue, groups[i], priority, MAX(max_running, 0));
+	}
+	g_strfreev(groups);
+	g_key_file_free(keyfile);
+}
+
+/*
+ * The output of the tasks is written to files below the maestro directory.
+ * Files left by a previous run are removed, the daemons send the whole
+ * output of their tasks again.
+ */
+static void
+prepare_output_dir(void)
+{
+	const gchar *dir = gebrm_app_get_output_dir();
+	const gchar *name;
+
+	if (g_mkdir_with_parents(dir, 0700) != 0) {
+		g_warning("Could not create directory %s, the output of the jobs is kept in memory", dir);
+		return;
+	}
+
+	GDir *gdir = g_dir_open(dir, 0, NULL);
+	if (gdir) {
+		while ((name = g_dir_read_name(gdir))) {
+			gchar *path = g_build_filename(dir, name, NULL);
+			g_unlink(path);
+			g_free(path);
+		}
+		g_dir_close(gdir);
+	}
+
+	gebrm_task_set_output_dir(dir);
+}
+
 gboolean
 gebrm_app_run(GebrmApp *app, int fd, const gchar *version, GebrAuth *auth)
 {
@@ -2209,6 +4260,14 @@ gebrm_app_run(GebrmApp *app, int fd, const gchar *version, GebrAuth *auth)
 	// Create configuration for NFS
 	app->priv->settings = gebrm_app_create_configuration();
 
+	app->priv->history = gebrm_history_new(gebrm_app_get_history_file());
+	load_queues(app);
+
+	prepare_output_dir();
+
+	app->priv->journal = gebrm_journal_new(gebrm_app_get_journal_file());
+	recover_jobs(app);
+
 	g_main_loop_run(app->priv->main_loop);
 
 	return TRUE;
@@ -2253,6 +4312,50 @@ gebrm_app_get_version_file(void)
 	return version;
 }
 
+const gchar *
+gebrm_app_get_history_file(void)
+{
+	static gchar *history = NULL;
+
+	if (!history)
+		history = gebrm_app_build_path("history");
+
+	return history;
+}
+
+const gchar *
+gebrm_app_get_journal_file(void)
+{
+	static gchar *journal = NULL;
+
+	if (!journal)
+		journal = gebrm_app_build_path("journal");
+
+	return journal;
+}
+
+const gchar *
+gebrm_app_get_output_dir(void)
+{
+	static gchar *output = NULL;
+
+	if (!output)
+		output = gebrm_app_build_path("output");
+
+	return output;
+}
+
+const gchar *
+gebrm_app_get_queues_file(void)
+{
+	static gchar *queues = NULL;
+
+	if (!queues)
+		queues = gebrm_app_build_path("queues");
+
+	return queues;
+}
+
 const gchar *
 gebrm_app_get_log_file_for_address(const gchar *addr)
 {
@@ -34,6 +34,32 @@
 
 G_BEGIN_DECLS
 
+/**
+ * GEBRM_APP_DISPATCH_PARALLEL:
+ *
+ * Default number of jobs being dispatched to the daemons at the same time.
+ * It can be overridden with the GEBRM_DISPATCH_PARALLEL environment
+ * variable.
+ */
+#define GEBRM_APP_DISPATCH_PARALLEL 8
+
+/**
+ * GEBRM_APP_TARGET_UTILIZATION:
+ *
+ * Default fraction of the cores of the daemons that jobs may take before
+ * new ones are held in the run queue. It can be overridden with the
+ * GEBRM_TARGET_UTILIZATION environment variable.
+ */
+#define GEBRM_APP_TARGET_UTILIZATION 1.0
+
+/**
+ * GEBRM_APP_WORKERS:
+ *
+ * Default number of threads loading the flows of /run and /sweep requests.
+ * It can be overridden with the GEBRM_WORKERS environment variable.
+ */
+#define GEBRM_APP_WORKERS 2
+
 typedef struct _GebrmApp GebrmApp;
 typedef struct _GebrmAppPriv GebrmAppPriv;
 typedef struct _GebrmAppClass GebrmAppClass;
@@ -123,6 +149,32 @@ const gchar *gebrm_app_get_lock_file(void);
 
 const gchar * gebrm_app_get_version_file(void);
 
+const gchar *gebrm_app_get_history_file(void);
+
+/**
+ * gebrm_app_get_journal_file:
+ *
+ * Returns: the file with the events of the jobs, replayed when maestro
+ * starts.
+ */
+const gchar *gebrm_app_get_journal_file(void);
+
+/**
+ * gebrm_app_get_output_dir:
+ *
+ * Returns: the directory where the output of the tasks is written, see
+ * gebrm_task_set_output_dir().
+ */
+const gchar *gebrm_app_get_output_dir(void);
+
+/**
+ * gebrm_app_get_queues_file:
+ *
+ * Returns: the file with the named queues and the shares of the clients,
+ * read when maestro starts.
+ */
+const gchar *gebrm_app_get_queues_file(void);
+
 const gchar *gebrm_app_get_log_file_for_address(const gchar *addr);
 
 const gchar *gebrm_app_get_version_file_for_addr(const gchar *addr);
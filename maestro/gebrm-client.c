@@ -29,6 +29,7 @@ struct _GebrmClientPriv {
 	gchar *gebr_cookie;
 	GList *forwards;
 	GHashTable *job_ids;
+	GHashTable *subscriptions; // Ids of the jobs whose output is sent
 	guint x11_port;
 	gchar *x11_host;
 	gboolean sent_nfsid;
@@ -92,6 +93,8 @@ gebrm_client_init(GebrmClient *client)
 
 	client->priv->job_ids = g_hash_table_new_full(g_str_hash, g_str_equal,
 						      g_free, g_free);
+	client->priv->subscriptions = g_hash_table_new_full(g_str_hash, g_str_equal,
+							    g_free, NULL);
 	client->priv->sent_nfsid = FALSE;
 }
 
@@ -114,6 +117,7 @@ gebrm_client_finalize(GObject *object)
 	g_free(client->priv->id);
 	g_free(client->priv->x11_host);
 	g_hash_table_destroy(client->priv->job_ids);
+	g_hash_table_destroy(client->priv->subscriptions);
 
 	G_OBJECT_CLASS(gebrm_client_parent_class)->finalize(object);
 }
@@ -268,6 +272,28 @@ gebrm_client_get_job_id_from_temp(GebrmClient *client,
 	return g_hash_table_lookup(client->priv->job_ids, temp_id);
 }
 
+void
+gebrm_client_subscribe(GebrmClient *client,
+		       const gchar *job_id)
+{
+	g_hash_table_insert(client->priv->subscriptions,
+			    g_strdup(job_id), GINT_TO_POINTER(TRUE));
+}
+
+void
+gebrm_client_unsubscribe(GebrmClient *client,
+			 const gchar *job_id)
+{
+	g_hash_table_remove(client->priv->subscriptions, job_id);
+}
+
+gboolean
+gebrm_client_is_subscribed(GebrmClient *client,
+			   const gchar *job_id)
+{
+	return g_hash_table_lookup(client->priv->subscriptions, job_id) != NULL;
+}
+
 guint
 gebrm_client_get_display_port(GebrmClient *self)
 {
@@ -106,6 +106,22 @@ void gebrm_client_add_temp_id(GebrmClient *client,
 const gchar *gebrm_client_get_job_id_from_temp(GebrmClient *client,
 					       const gchar *temp_id);
 
+/**
+ * gebrm_client_subscribe:
+ *
+ * Makes @client receive the output of the job @job_id as it arrives.
+ * Clients receive the status of every job, but only the output of the
+ * jobs they show.
+ */
+void gebrm_client_subscribe(GebrmClient *client,
+			    const gchar *job_id);
+
+void gebrm_client_unsubscribe(GebrmClient *client,
+			      const gchar *job_id);
+
+gboolean gebrm_client_is_subscribed(GebrmClient *client,
+				    const gchar *job_id);
+
 guint gebrm_client_get_display_port(GebrmClient *self);
 
 const gchar *gebrm_client_get_display_host(GebrmClient *self);
@@ -0,0 +1,31 @@
+/*
+ * gebrm-compaction.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-compaction.h"
+
+/* Public methods {{{1 */
+gboolean
+gebrm_compaction_needed(gint n_lines,
+			gint n_kept,
+			gint min_lines)
+{
+	return n_lines >= min_lines
+		&& n_lines >= GEBRM_COMPACTION_RATIO * n_kept;
+}
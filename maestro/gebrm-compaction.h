@@ -0,0 +1,51 @@
+/*
+ * gebrm-compaction.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_COMPACTION_H__
+#define __GEBRM_COMPACTION_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_COMPACTION_RATIO:
+ *
+ * How many times more lines than entries kept an append-only file may
+ * have before it is rewritten.
+ */
+#define GEBRM_COMPACTION_RATIO 2
+
+/**
+ * gebrm_compaction_needed:
+ * @n_lines: Number of lines in the file
+ * @n_kept: Number of entries still kept, each one a line once rewritten
+ * @min_lines: Files shorter than this are never rewritten
+ *
+ * Tells if an append-only file, like the history or the journal, should be
+ * rewritten with only the entries kept.
+ */
+gboolean gebrm_compaction_needed(gint n_lines,
+				 gint n_kept,
+				 gint min_lines);
+
+G_END_DECLS
+
+#endif /* __GEBRM_COMPACTION_H__ */
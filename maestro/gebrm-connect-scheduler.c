@@ -0,0 +1,475 @@
+/*
+ * gebrm-connect-scheduler.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-connect-scheduler.h"
+
+#include <libgebr/comm/gebr-comm.h>
+
+/*
+ * Number of times a daemon is connected before giving up, and the delay
+ * (in seconds) before the first retry. The delay doubles at each retry.
+ */
+#define MAX_ATTEMPTS  4
+#define BACKOFF_BASE  2
+#define BACKOFF_MAX   60
+
+/*
+ * Seconds a daemon waiting for a password or a question keeps its entry.
+ * After that the connection is dropped, so it does not hang around forever
+ * if nobody answers.
+ */
+#define PARK_DEADLINE 300
+
+/*
+ * Deadlines in seconds of each phase. A daemon which expires the ssh
+ * deadline while waiting for a password or a question is not disconnected,
+ * it just gives its slot to the next daemon.
+ */
+static const guint phase_deadline[] = {
+	[GEBRM_CONNECT_PHASE_QUEUED]    = 0,
+	[GEBRM_CONNECT_PHASE_SSH]       = 30,
+	[GEBRM_CONNECT_PHASE_PORT]      = 10,
+	[GEBRM_CONNECT_PHASE_HANDSHAKE] = 15,
+	[GEBRM_CONNECT_PHASE_READY]     = 0,
+};
+
+typedef struct _ConnectEntry ConnectEntry;
+
+struct _ConnectEntry {
+	GebrmConnectScheduler *scheduler;
+	GebrmDaemon *daemon;
+	GebrmConnectPhase phase;
+
+	GTimer *timer;
+	gdouble phase_start;
+
+	guint attempt;
+	guint retry_source;
+
+	gboolean parked;
+	gboolean expired;
+};
+
+struct _GebrmConnectScheduler {
+	guint max_parallel;
+	gboolean paused;
+
+	GQueue *queue;
+	GList *running;
+	GList *retrying;
+
+	guint tick;
+
+	GebrmConnectFunc connect_func;
+	GebrmConnectDoneFunc done_func;
+	gpointer user_data;
+};
+
+static void scheduler_pump(GebrmConnectScheduler *self);
+
+static ConnectEntry *
+entry_new(GebrmConnectScheduler *self,
+	  GebrmDaemon *daemon)
+{
+	ConnectEntry *entry = g_new0(ConnectEntry, 1);
+	entry->scheduler = self;
+	entry->daemon = g_object_ref(daemon);
+	entry->phase = GEBRM_CONNECT_PHASE_QUEUED;
+	return entry;
+}
+
+static void
+entry_free(ConnectEntry *entry)
+{
+	if (entry->retry_source)
+		g_source_remove(entry->retry_source);
+	if (entry->timer)
+		g_timer_destroy(entry->timer);
+	g_object_unref(entry->daemon);
+	g_free(entry);
+}
+
+static void
+entry_set_phase(ConnectEntry *entry,
+		GebrmConnectPhase phase)
+{
+	if (entry->phase == phase)
+		return;
+
+	gdouble now = g_timer_elapsed(entry->timer, NULL);
+
+	g_debug("Connection of %s: %s took %.2lfs",
+		gebrm_daemon_get_address(entry->daemon),
+		gebrm_connect_phase_to_string(entry->phase),
+		now - entry->phase_start);
+
+	/* The user answered, the connection goes on with its deadlines. */
+	entry->parked = FALSE;
+	entry->phase = phase;
+	entry->phase_start = now;
+}
+
+static ConnectEntry *
+find_entry(GList *list,
+	   GebrmDaemon *daemon)
+{
+	for (GList *i = list; i; i = i->next) {
+		ConnectEntry *entry = i->data;
+		if (entry->daemon == daemon)
+			return entry;
+	}
+	return NULL;
+}
+
+static guint
+count_active(GebrmConnectScheduler *self)
+{
+	guint n = 0;
+	for (GList *i = self->running; i; i = i->next) {
+		ConnectEntry *entry = i->data;
+		if (!entry->parked)
+			n++;
+	}
+	return n;
+}
+
+static void
+entry_finish(ConnectEntry *entry)
+{
+	GebrmConnectScheduler *self = entry->scheduler;
+	self->running = g_list_remove(self->running, entry);
+	entry_free(entry);
+}
+
+static void
+entry_start(ConnectEntry *entry)
+{
+	GebrmConnectScheduler *self = entry->scheduler;
+	GebrmDaemon *daemon = g_object_ref(entry->daemon);
+
+	if (!entry->timer)
+		entry->timer = g_timer_new();
+
+	self->running = g_list_prepend(self->running, entry);
+	entry->parked = FALSE;
+	entry->expired = FALSE;
+	entry->phase_start = g_timer_elapsed(entry->timer, NULL);
+	entry->phase = GEBRM_CONNECT_PHASE_SSH;
+
+	/* The connection may fail right away, so @entry can be gone
+	 * when connect_func returns. */
+	if (!self->connect_func(daemon, self->user_data)) {
+		ConnectEntry *e = find_entry(self->running, daemon);
+		if (e)
+			entry_finish(e);
+	}
+
+	g_object_unref(daemon);
+}
+
+static gboolean
+on_retry_timeout(gpointer user_data)
+{
+	ConnectEntry *entry = user_data;
+	GebrmConnectScheduler *self = entry->scheduler;
+
+	entry->retry_source = 0;
+	self->retrying = g_list_remove(self->retrying, entry);
+	g_queue_push_head(self->queue, entry);
+	scheduler_pump(self);
+
+	return FALSE;
+}
+
+static void
+entry_retry(ConnectEntry *entry)
+{
+	GebrmConnectScheduler *self = entry->scheduler;
+	guint delay = MIN(BACKOFF_BASE << entry->attempt, BACKOFF_MAX);
+
+	entry->attempt++;
+	g_debug("Connection of %s failed on %s, retrying in %us (attempt %u of %u)",
+		gebrm_daemon_get_address(entry->daemon),
+		gebrm_connect_phase_to_string(entry->phase),
+		delay, entry->attempt + 1, MAX_ATTEMPTS);
+
+	self->running = g_list_remove(self->running, entry);
+	entry_set_phase(entry, GEBRM_CONNECT_PHASE_QUEUED);
+	entry->retry_source = g_timeout_add_seconds(delay, on_retry_timeout, entry);
+	self->retrying = g_list_prepend(self->retrying, entry);
+}
+
+static void
+entry_expire(ConnectEntry *entry)
+{
+	GebrCommServer *server = gebrm_daemon_get_server(entry->daemon);
+
+	g_debug("Connection of %s expired the %s deadline (%us)",
+		gebrm_daemon_get_address(entry->daemon),
+		gebrm_connect_phase_to_string(entry->phase),
+		phase_deadline[entry->phase]);
+
+	if (entry->attempt + 1 >= MAX_ATTEMPTS)
+		gebr_comm_server_set_last_error(server, SERVER_ERROR_CONNECT,
+						"Timed out on %s phase of the connection.",
+						gebrm_connect_phase_to_string(entry->phase));
+
+	entry->expired = TRUE;
+	gebr_comm_server_disconnect(server);
+}
+
+static void
+entry_give_up(ConnectEntry *entry)
+{
+	GebrmDaemon *daemon = g_object_ref(entry->daemon);
+	GebrCommServer *server = gebrm_daemon_get_server(daemon);
+
+	g_debug("Connection of %s waited %us for the user, giving up",
+		gebrm_daemon_get_address(daemon), PARK_DEADLINE);
+
+	/* Asking the password again would just park it once more, so this
+	 * connection is not retried. */
+	entry_finish(entry);
+	gebr_comm_server_set_last_error(server, SERVER_ERROR_CONNECT,
+					"Timed out waiting for the password.");
+	gebr_comm_server_disconnect(server);
+	g_object_unref(daemon);
+}
+
+static gboolean
+on_tick(gpointer user_data)
+{
+	GebrmConnectScheduler *self = user_data;
+	GList *running = g_list_copy(self->running);
+
+	for (GList *i = running; i; i = i->next) {
+		ConnectEntry *entry = i->data;
+
+		if (!g_list_find(self->running, entry))
+			continue;
+
+		GebrCommServer *server = gebrm_daemon_get_server(entry->daemon);
+
+		if (entry->phase == GEBRM_CONNECT_PHASE_SSH
+		    && gebr_comm_server_is_forwarded(server))
+			entry_set_phase(entry, GEBRM_CONNECT_PHASE_PORT);
+
+		gdouble elapsed = g_timer_elapsed(entry->timer, NULL) - entry->phase_start;
+
+		if (entry->parked) {
+			if (elapsed >= PARK_DEADLINE)
+				entry_give_up(entry);
+			continue;
+		}
+
+		if (elapsed < phase_deadline[entry->phase])
+			continue;
+
+		switch (entry->phase) {
+		case GEBRM_CONNECT_PHASE_SSH:
+			if (gebr_comm_server_is_waiting_user(server)) {
+				g_debug("Connection of %s is waiting for the user, "
+					"starting the next one",
+					gebrm_daemon_get_address(entry->daemon));
+				entry->parked = TRUE;
+				break;
+			}
+			entry_expire(entry);
+			break;
+		case GEBRM_CONNECT_PHASE_PORT:
+		case GEBRM_CONNECT_PHASE_HANDSHAKE:
+			entry_expire(entry);
+			break;
+		default:
+			break;
+		}
+	}
+	g_list_free(running);
+
+	scheduler_pump(self);
+
+	return self->tick != 0;
+}
+
+static void
+scheduler_pump(GebrmConnectScheduler *self)
+{
+	while (!self->paused
+	       && !g_queue_is_empty(self->queue)
+	       && count_active(self) < self->max_parallel)
+		entry_start(g_queue_pop_head(self->queue));
+
+	if (self->running || self->retrying || !g_queue_is_empty(self->queue)) {
+		if (!self->tick)
+			self->tick = g_timeout_add_seconds(1, on_tick, self);
+		return;
+	}
+
+	if (self->tick) {
+		g_source_remove(self->tick);
+		self->tick = 0;
+		if (self->done_func)
+			self->done_func(self->user_data);
+	}
+}
+
+GebrmConnectScheduler *
+gebrm_connect_scheduler_new(guint max_parallel,
+			    GebrmConnectFunc connect_func,
+			    GebrmConnectDoneFunc done_func,
+			    gpointer user_data)
+{
+	GebrmConnectScheduler *self = g_new0(GebrmConnectScheduler, 1);
+	self->max_parallel = MAX(max_parallel, 1);
+	self->queue = g_queue_new();
+	self->connect_func = connect_func;
+	self->done_func = done_func;
+	self->user_data = user_data;
+	return self;
+}
+
+void
+gebrm_connect_scheduler_free(GebrmConnectScheduler *self)
+{
+	if (self->tick)
+		g_source_remove(self->tick);
+
+	g_queue_foreach(self->queue, (GFunc)entry_free, NULL);
+	g_queue_free(self->queue);
+	g_list_foreach(self->running, (GFunc)entry_free, NULL);
+	g_list_free(self->running);
+	g_list_foreach(self->retrying, (GFunc)entry_free, NULL);
+	g_list_free(self->retrying);
+	g_free(self);
+}
+
+void
+gebrm_connect_scheduler_push(GebrmConnectScheduler *self,
+			     GebrmDaemon *daemon)
+{
+	if (find_entry(self->queue->head, daemon)
+	    || find_entry(self->running, daemon)
+	    || find_entry(self->retrying, daemon))
+		return;
+
+	g_queue_push_tail(self->queue, entry_new(self, daemon));
+	scheduler_pump(self);
+}
+
+void
+gebrm_connect_scheduler_cancel(GebrmConnectScheduler *self,
+			       GebrmDaemon *daemon)
+{
+	ConnectEntry *entry;
+
+	if ((entry = find_entry(self->queue->head, daemon))) {
+		g_queue_remove(self->queue, entry);
+		entry_free(entry);
+	} else if ((entry = find_entry(self->retrying, daemon))) {
+		self->retrying = g_list_remove(self->retrying, entry);
+		entry_free(entry);
+	} else if ((entry = find_entry(self->running, daemon)))
+		entry_finish(entry);
+	else
+		return;
+
+	scheduler_pump(self);
+}
+
+void
+gebrm_connect_scheduler_state_changed(GebrmConnectScheduler *self,
+				      GebrmDaemon *daemon,
+				      GebrCommServerState state)
+{
+	ConnectEntry *entry = find_entry(self->running, daemon);
+
+	if (!entry)
+		return;
+
+	switch (state) {
+	case SERVER_STATE_RUN:
+	case SERVER_STATE_REDIRECT:
+		entry_set_phase(entry, GEBRM_CONNECT_PHASE_SSH);
+		return;
+	case SERVER_STATE_CONNECT:
+		entry_set_phase(entry, GEBRM_CONNECT_PHASE_HANDSHAKE);
+		return;
+	case SERVER_STATE_LOGGED: {
+		gdouble time_to_ready = g_timer_elapsed(entry->timer, NULL);
+		entry_set_phase(entry, GEBRM_CONNECT_PHASE_READY);
+		gebrm_daemon_set_time_to_ready(daemon, time_to_ready);
+		g_message("Machine %s ready in %.2lfs (%u attempt(s))",
+			  gebrm_daemon_get_address(daemon), time_to_ready,
+			  entry->attempt + 1);
+		entry_finish(entry);
+		break;
+	}
+	case SERVER_STATE_DISCONNECTED: {
+		GebrCommServer *server = gebrm_daemon_get_server(daemon);
+
+		/* Only failures after ssh succeeded are retried, ssh errors
+		 * are usually authentication problems. */
+		gboolean transient = entry->expired
+			|| (server->error == SERVER_ERROR_CONNECT
+			    && entry->phase >= GEBRM_CONNECT_PHASE_PORT);
+
+		if (transient && entry->attempt + 1 < MAX_ATTEMPTS)
+			entry_retry(entry);
+		else
+			entry_finish(entry);
+		break;
+	}
+	}
+
+	scheduler_pump(self);
+}
+
+void
+gebrm_connect_scheduler_set_paused(GebrmConnectScheduler *self,
+				   gboolean paused)
+{
+	self->paused = paused;
+	if (!paused)
+		scheduler_pump(self);
+}
+
+gboolean
+gebrm_connect_scheduler_is_running(GebrmConnectScheduler *self)
+{
+	return self->running || self->retrying || !g_queue_is_empty(self->queue);
+}
+
+const gchar *
+gebrm_connect_phase_to_string(GebrmConnectPhase phase)
+{
+	switch (phase) {
+	case GEBRM_CONNECT_PHASE_QUEUED:
+		return "queued";
+	case GEBRM_CONNECT_PHASE_SSH:
+		return "ssh";
+	case GEBRM_CONNECT_PHASE_PORT:
+		return "port";
+	case GEBRM_CONNECT_PHASE_HANDSHAKE:
+		return "handshake";
+	case GEBRM_CONNECT_PHASE_READY:
+		return "ready";
+	}
+	return NULL;
+}
@@ -0,0 +1,124 @@
+/*
+ * gebrm-connect-scheduler.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_CONNECT_SCHEDULER_H__
+#define __GEBRM_CONNECT_SCHEDULER_H__
+
+#include <glib.h>
+#include "gebrm-daemon.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_CONNECT_SCHEDULER_PARALLEL:
+ *
+ * Default number of daemons brought up at the same time. It can be
+ * overridden with the GEBRM_CONNECT_PARALLEL environment variable.
+ */
+#define GEBRM_CONNECT_SCHEDULER_PARALLEL 4
+
+typedef struct _GebrmConnectScheduler GebrmConnectScheduler;
+
+/**
+ * GebrmConnectPhase:
+ *
+ * The phases a daemon goes through until it is ready to receive jobs. Each
+ * phase has its own deadline, see gebrm-connect-scheduler.c.
+ */
+typedef enum {
+	GEBRM_CONNECT_PHASE_QUEUED,
+	GEBRM_CONNECT_PHASE_SSH,
+	GEBRM_CONNECT_PHASE_PORT,
+	GEBRM_CONNECT_PHASE_HANDSHAKE,
+	GEBRM_CONNECT_PHASE_READY,
+} GebrmConnectPhase;
+
+/**
+ * GebrmConnectFunc:
+ *
+ * Starts the connection of @daemon. Returns %FALSE if @daemon must not be
+ * connected anymore, in which case it is dropped from the scheduler.
+ */
+typedef gboolean (*GebrmConnectFunc) (GebrmDaemon *daemon,
+				      gpointer user_data);
+
+/**
+ * GebrmConnectDoneFunc:
+ *
+ * Called when the scheduler has no more daemons to bring up.
+ */
+typedef void (*GebrmConnectDoneFunc) (gpointer user_data);
+
+GebrmConnectScheduler *gebrm_connect_scheduler_new(guint max_parallel,
+						   GebrmConnectFunc connect_func,
+						   GebrmConnectDoneFunc done_func,
+						   gpointer user_data);
+
+void gebrm_connect_scheduler_free(GebrmConnectScheduler *self);
+
+/**
+ * gebrm_connect_scheduler_push:
+ *
+ * Queues @daemon to be connected. At most @max_parallel daemons are
+ * connecting at the same time, the others wait in the queue.
+ */
+void gebrm_connect_scheduler_push(GebrmConnectScheduler *self,
+				  GebrmDaemon *daemon);
+
+/**
+ * gebrm_connect_scheduler_cancel:
+ *
+ * Forgets @daemon, dropping it from the queue or from the retries. A
+ * connection already started is not interrupted.
+ */
+void gebrm_connect_scheduler_cancel(GebrmConnectScheduler *self,
+				    GebrmDaemon *daemon);
+
+/**
+ * gebrm_connect_scheduler_state_changed:
+ *
+ * Must be called for every state change of the daemons, so the scheduler
+ * can follow their phases.
+ */
+void gebrm_connect_scheduler_state_changed(GebrmConnectScheduler *self,
+					   GebrmDaemon *daemon,
+					   GebrCommServerState state);
+
+/**
+ * gebrm_connect_scheduler_set_paused:
+ *
+ * While paused, no new connection is started. The connections already
+ * running go on.
+ */
+void gebrm_connect_scheduler_set_paused(GebrmConnectScheduler *self,
+					gboolean paused);
+
+/**
+ * gebrm_connect_scheduler_is_running:
+ *
+ * Returns: %TRUE if there are daemons queued or being connected.
+ */
+gboolean gebrm_connect_scheduler_is_running(GebrmConnectScheduler *self);
+
+const gchar *gebrm_connect_phase_to_string(GebrmConnectPhase phase);
+
+G_END_DECLS
+
+#endif /* __GEBRM_CONNECT_SCHEDULER_H__ */
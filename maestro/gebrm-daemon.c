@@ -21,6 +21,7 @@
 #include "gebrm-daemon.h"
 #include "gebrm-marshal.h"
 #include <stdlib.h>
+#include <string.h>
 #include "gebrm-job.h"
 #include "gebrm-task.h"
 
@@ -34,7 +35,7 @@ struct _GebrmDaemonPriv {
 	gboolean is_canceled;
 	gboolean reconnnect;
 
-	guint timeout;
+	gdouble time_to_ready;
 
 	GHashTable *tasks;
 
@@ -52,10 +53,28 @@ struct _GebrmDaemonPriv {
 	gchar *error_msg;
 
 	gint uncompleted_tasks;
+	gint reserved_cores;
+	GHashTable *reservations; // Task id -> Reservation
+
+	GebrCommTelemetry telemetry;
+	glong telemetry_time;
+	gdouble read_bandwidth;  // Bytes per second to the home, 0 if unknown
+	gdouble write_bandwidth;
 	gchar *mpi_flavors;
 	gboolean has_gebrm;
 };
 
+/*
+ * Seconds a task must be running before its cores show up in the
+ * telemetry, see GEBRD_TELEMETRY_INTERVAL.
+ */
+#define TELEMETRY_LAG 2
+
+typedef struct {
+	gint ncores;
+	glong started; /* When the task started running, 0 if it did not yet */
+} Reservation;
+
 enum {
 	PROP_0,
 	PROP_ADDRESS,
@@ -126,6 +145,75 @@ gebrm_daemon_iface_get_flavors(GebrCommDaemon *idaemon)
 	return daemon->priv->mpi_flavors;
 }
 
+void
+gebrm_daemon_iface_reserve_cores(GebrCommDaemon *idaemon,
+				 const gchar *job_id,
+				 gint frac,
+				 gint ncores)
+{
+	GebrmDaemon *daemon = GEBRM_DAEMON(idaemon);
+	gchar *frac_str = g_strdup_printf("%d", frac);
+	gchar *tid = gebrm_task_build_id(job_id, frac_str);
+
+	Reservation *r = g_hash_table_lookup(daemon->priv->reservations, tid);
+	if (r) {
+		daemon->priv->reserved_cores -= r->ncores;
+		g_free(tid);
+	} else {
+		r = g_new0(Reservation, 1);
+		g_hash_table_insert(daemon->priv->reservations, tid, r);
+	}
+	r->ncores = ncores;
+	r->started = 0;
+	daemon->priv->reserved_cores += ncores;
+
+	g_free(frac_str);
+}
+
+gint
+gebrm_daemon_iface_get_reserved_cores(GebrCommDaemon *idaemon)
+{
+	return GEBRM_DAEMON(idaemon)->priv->reserved_cores;
+}
+
+const GebrCommTelemetry *
+gebrm_daemon_iface_get_telemetry(GebrCommDaemon *idaemon)
+{
+	GebrmDaemon *daemon = GEBRM_DAEMON(idaemon);
+	GHashTableIter iter;
+	Reservation *r;
+	GTimeVal now;
+
+	if (!daemon->priv->telemetry.load)
+		return NULL;
+
+	g_get_current_time(&now);
+	daemon->priv->telemetry.age = now.tv_sec - daemon->priv->telemetry_time;
+
+	daemon->priv->telemetry.pending_cores = 0;
+	g_hash_table_iter_init(&iter, daemon->priv->reservations);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&r))
+		if (!r->started || r->started + TELEMETRY_LAG > daemon->priv->telemetry_time)
+			daemon->priv->telemetry.pending_cores += r->ncores;
+
+	return &daemon->priv->telemetry;
+}
+
+gboolean
+gebrm_daemon_iface_get_bandwidth(GebrCommDaemon *idaemon,
+				 gdouble *read_bw,
+				 gdouble *write_bw)
+{
+	GebrmDaemon *daemon = GEBRM_DAEMON(idaemon);
+
+	if (daemon->priv->read_bandwidth <= 0 || daemon->priv->write_bandwidth <= 0)
+		return FALSE;
+
+	*read_bw = daemon->priv->read_bandwidth;
+	*write_bw = daemon->priv->write_bandwidth;
+	return TRUE;
+}
+
 static void
 gebrm_daemon_init_iface(GebrCommDaemonIface *iface)
 {
@@ -135,6 +223,10 @@ gebrm_daemon_init_iface(GebrCommDaemonIface *iface)
 	iface->add_task = gebrm_daemon_iface_add_task;
 	iface->can_execute = gebrm_daemon_iface_can_execute;
 	iface->get_flavors = gebrm_daemon_iface_get_flavors;
+	iface->reserve_cores = gebrm_daemon_iface_reserve_cores;
+	iface->get_reserved_cores = gebrm_daemon_iface_get_reserved_cores;
+	iface->get_telemetry = gebrm_daemon_iface_get_telemetry;
+	iface->get_bandwidth = gebrm_daemon_iface_get_bandwidth;
 }
 
 static void
@@ -188,6 +280,42 @@ gebrm_server_op_log_message(GebrCommServer *server,
 	g_debug("[DAEMON] %s: (type: %d) %s", __func__, type, message);
 }
 
+static void
+gebrm_daemon_clear_telemetry(GebrmDaemon *daemon)
+{
+	g_free(daemon->priv->telemetry.load);
+	g_free(daemon->priv->telemetry.core_usage);
+	memset(&daemon->priv->telemetry, 0, sizeof(GebrCommTelemetry));
+}
+
+static void
+gebrm_daemon_set_telemetry(GebrmDaemon *daemon,
+			   const gchar *load,
+			   const gchar *core_usage,
+			   const gchar *free_memory,
+			   const gchar *running_tasks,
+			   const gchar *runnable)
+{
+	GTimeVal now;
+	gchar **usage = g_strsplit(core_usage, ",", 0);
+
+	gebrm_daemon_clear_telemetry(daemon);
+
+	daemon->priv->telemetry.load = g_strdup(load);
+	daemon->priv->telemetry.ncores = g_strv_length(usage);
+	daemon->priv->telemetry.core_usage = g_new(gdouble, daemon->priv->telemetry.ncores);
+	for (gint i = 0; usage[i]; i++)
+		daemon->priv->telemetry.core_usage[i] = g_ascii_strtod(usage[i], NULL);
+	daemon->priv->telemetry.free_memory = atol(free_memory);
+	daemon->priv->telemetry.running_tasks = atoi(running_tasks);
+	daemon->priv->telemetry.runnable = g_ascii_strtod(runnable, NULL);
+
+	g_get_current_time(&now);
+	daemon->priv->telemetry_time = now.tv_sec;
+
+	g_strfreev(usage);
+}
+
 static void
 gebrm_server_op_state_changed(GebrCommServer *server,
 			      gpointer user_data)
@@ -201,6 +329,11 @@ gebrm_server_op_state_changed(GebrCommServer *server,
 		}
 		daemon->priv->is_initialized = FALSE;
 		daemon->priv->uncompleted_tasks = 0;
+		daemon->priv->reserved_cores = 0;
+		g_hash_table_remove_all(daemon->priv->reservations);
+		gebrm_daemon_clear_telemetry(daemon);
+		daemon->priv->read_bandwidth = 0;
+		daemon->priv->write_bandwidth = 0;
 	}
 	else if (server->state == SERVER_STATE_CONNECT) {
 		gebrm_daemon_set_error_type(daemon, NULL);
@@ -238,13 +371,40 @@ gebrm_daemon_on_task_status_change(GebrmTask *task,
 	switch (new_status) {
 	case JOB_STATUS_FAILED:
 	case JOB_STATUS_FINISHED:
-	case JOB_STATUS_CANCELED:
+	case JOB_STATUS_CANCELED: {
+		gchar *frac = g_strdup_printf("%d", gebrm_task_get_fraction(task));
+		gchar *tid = gebrm_task_build_id(gebrm_task_get_job_id(task), frac);
+		Reservation *r = g_hash_table_lookup(daemon->priv->reservations, tid);
+
+		if (r) {
+			daemon->priv->reserved_cores -= r->ncores;
+			g_hash_table_remove(daemon->priv->reservations, tid);
+		}
 		daemon->priv->uncompleted_tasks--;
+
+		g_free(frac);
+		g_free(tid);
+		break;
+	}
+
+	case JOB_STATUS_RUNNING: {
+		gchar *frac = g_strdup_printf("%d", gebrm_task_get_fraction(task));
+		gchar *tid = gebrm_task_build_id(gebrm_task_get_job_id(task), frac);
+		Reservation *r = g_hash_table_lookup(daemon->priv->reservations, tid);
+
+		if (r && !r->started) {
+			GTimeVal now;
+			g_get_current_time(&now);
+			r->started = now.tv_sec;
+		}
+
+		g_free(frac);
+		g_free(tid);
 		break;
+	}
 
 	case JOB_STATUS_INITIAL:
 	case JOB_STATUS_QUEUED:
-	case JOB_STATUS_RUNNING:
 	case JOB_STATUS_ISSUED:
 	case JOB_STATUS_REQUEUED:
 		break;
@@ -269,8 +429,13 @@ gebrm_server_op_parse_messages(GebrCommServer *server,
 			if (ret_hash == gebr_comm_protocol_defs.ini_def.code_hash) {
 				GList *arguments;
 
-				if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 12)) == NULL)
-					goto err;
+				/* older daemons don't answer the framing */
+				gboolean has_framing = TRUE;
+				if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 13)) == NULL) {
+					has_framing = FALSE;
+					if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 12)) == NULL)
+						goto err;
+				}
 
 				GString *hostname     = g_list_nth_data(arguments, 0);
 				gchar  **accounts     = g_strsplit(((GString *)g_list_nth_data(arguments, 2))->str, ",", 0);
@@ -284,6 +449,12 @@ gebrm_server_op_parse_messages(GebrCommServer *server,
 				GString *mpi_flavors  = g_list_nth_data (arguments, 10);
 				GString *has_gebrm    = g_list_nth_data (arguments, 11);
 
+				if (has_framing) {
+					GString *framing = g_list_nth_data(arguments, 12);
+					if (atoi(framing->str) == GEBR_COMM_PROTOCOL_FRAMING_BINARY)
+						server->socket->protocol->framing = GEBR_COMM_PROTOCOL_FRAMING_BINARY;
+				}
+
 				gebr_comm_server_set_logged(server);
 				daemon->priv->is_initialized = TRUE;
 				server->socket->protocol->hostname = g_string_assign(server->socket->protocol->hostname, hostname->str);
@@ -377,6 +548,76 @@ gebrm_server_op_parse_messages(GebrCommServer *server,
 			GebrmTask *task = gebrm_task_find(rid->str, frac->str);
 			gebrm_task_emit_output_signal(task, output->str);
 
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.tlm_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 5)) == NULL)
+				goto err;
+
+			GString *load = g_list_nth_data(arguments, 0);
+			GString *usage = g_list_nth_data(arguments, 1);
+			GString *free_memory = g_list_nth_data(arguments, 2);
+			GString *running = g_list_nth_data(arguments, 3);
+			GString *runnable = g_list_nth_data(arguments, 4);
+
+			if (load->len)
+				gebrm_daemon_set_telemetry(daemon, load->str, usage->str,
+							   free_memory->str, running->str,
+							   runnable->str);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.bwd_def.code_hash) {
+			GList *arguments;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 2)) == NULL)
+				goto err;
+
+			GString *read_bw = g_list_nth_data(arguments, 0);
+			GString *write_bw = g_list_nth_data(arguments, 1);
+
+			daemon->priv->read_bandwidth = g_ascii_strtod(read_bw->str, NULL);
+			daemon->priv->write_bandwidth = g_ascii_strtod(write_bw->str, NULL);
+			g_debug("Daemon %s reads its data at %.0f B/s and writes at %.0f B/s",
+				gebrm_daemon_get_address(daemon),
+				daemon->priv->read_bandwidth, daemon->priv->write_bandwidth);
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.mem_def.code_hash) {
+			GList *arguments;
+			GString *rid, *frac, *peak, *cpu_time;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 4)) == NULL)
+				goto err;
+
+			rid = g_list_nth_data(arguments, 0);
+			frac = g_list_nth_data(arguments, 1);
+			peak = g_list_nth_data(arguments, 2);
+			cpu_time = g_list_nth_data(arguments, 3);
+
+			GebrmTask *task = gebrm_task_find(rid->str, frac->str);
+			if (task) {
+				gebrm_task_set_peak_memory(task, atol(peak->str));
+				gebrm_task_set_cpu_time(task, g_ascii_strtod(cpu_time->str, NULL));
+			}
+
+			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
+		} else if (message->hash == gebr_comm_protocol_defs.itr_def.code_hash) {
+			GList *arguments;
+			GString *rid, *frac, *done;
+
+			if ((arguments = gebr_comm_protocol_socket_oldmsg_split(message->argument, 3)) == NULL)
+				goto err;
+
+			rid = g_list_nth_data(arguments, 0);
+			frac = g_list_nth_data(arguments, 1);
+			done = g_list_nth_data(arguments, 2);
+
+			/* Arrives before the task finishes, see gebrm_task_split() */
+			GebrmTask *task = gebrm_task_find(rid->str, frac->str);
+			if (task)
+				gebrm_task_set_done_steps(task, atoi(done->str));
+
 			gebr_comm_protocol_socket_oldmsg_split_free(arguments);
 		} else if (message->hash == gebr_comm_protocol_defs.sta_def.code_hash) {
 			GList *arguments;
@@ -525,6 +766,8 @@ gebrm_daemon_finalize(GObject *object)
 	g_free(daemon->priv->error_type);
 	g_free(daemon->priv->mpi_flavors);
 	g_hash_table_destroy(daemon->priv->tasks);
+	g_hash_table_destroy(daemon->priv->reservations);
+	gebrm_daemon_clear_telemetry(daemon);
 	if (daemon->priv->client)
 		g_object_unref(daemon->priv->client);
 
@@ -653,8 +896,9 @@ gebrm_daemon_init(GebrmDaemon *daemon)
 	daemon->priv->ac = g_strdup("on");
 	daemon->priv->is_initialized = FALSE;
 	daemon->priv->tasks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	daemon->priv->reservations = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
 	daemon->priv->mpi_flavors = NULL;
-	daemon->priv->timeout = -1;
+	daemon->priv->time_to_ready = -1;
 	daemon->priv->has_gebrm = FALSE;
 }
 
@@ -1082,16 +1326,16 @@ gebrm_daemon_get_canceled(GebrmDaemon *daemon)
 }
 
 void
-gebrm_daemon_set_timeout(GebrmDaemon *daemon,
-                         guint timeout)
+gebrm_daemon_set_time_to_ready(GebrmDaemon *daemon,
+                               gdouble seconds)
 {
-	daemon->priv->timeout = timeout;
+	daemon->priv->time_to_ready = seconds;
 }
 
-guint
-gebrm_daemon_get_timeout(GebrmDaemon *daemon)
+gdouble
+gebrm_daemon_get_time_to_ready(GebrmDaemon *daemon)
 {
-	return daemon->priv->timeout;
+	return daemon->priv->time_to_ready;
 }
 
 void
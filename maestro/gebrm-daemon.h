@@ -237,10 +237,16 @@ void gebrm_daemon_set_canceled(GebrmDaemon *daemon,
 
 gboolean gebrm_daemon_get_canceled(GebrmDaemon *daemon);
 
-void gebrm_daemon_set_timeout(GebrmDaemon *daemon,
-                              guint timeout);
+void gebrm_daemon_set_time_to_ready(GebrmDaemon *daemon,
+                                    gdouble seconds);
 
-guint gebrm_daemon_get_timeout(GebrmDaemon *daemon);
+/**
+ * gebrm_daemon_get_time_to_ready:
+ *
+ * Returns: the time, in seconds, the last connection of @daemon took to be
+ * logged in, or -1 if it was never connected.
+ */
+gdouble gebrm_daemon_get_time_to_ready(GebrmDaemon *daemon);
 
 void gebrm_daemon_set_has_gebrm(GebrmDaemon *daemon, gboolean has_gebrm);
 
@@ -0,0 +1,425 @@
+/*
+ * gebrm-fair-queue.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-fair-queue.h"
+
+#include <stdlib.h>
+
+/*
+ * Each queue keeps one FIFO per client and serves the clients by stride
+ * scheduling: a client's pass grows by 1/weight each time it is served, and
+ * the client with the lowest pass goes next. A client that becomes active
+ * starts at the pass of the last client served, so it gets no credit for
+ * the time it was idle.
+ *
+ * The queues that can admit an item are kept sorted by priority, and the
+ * active clients of each queue by pass, in GSequences (balanced trees).
+ */
+
+typedef struct _Queue Queue;
+
+typedef struct {
+	gchar *id;
+	Queue *queue;
+	GQueue *entries; // Entry, oldest first
+	gdouble pass;
+	guint64 serial;  // Breaks ties of pass, in activation order
+	GSequenceIter *iter; // In queue->active, NULL if no entries
+} ClientQueue;
+
+struct _Queue {
+	gchar *name;
+	gint priority;
+	gint max_running;
+	gint running;
+	gdouble vtime;  // Pass of the last client served
+	guint64 served; // Breaks ties of priority, least recently served first
+	GHashTable *clients; // id -> ClientQueue
+	GSequence *active;   // ClientQueue with entries, by pass
+	GSequenceIter *iter; // In self->ready, NULL if it cannot admit
+};
+
+typedef struct {
+	gpointer item;
+	ClientQueue *client;
+	GList *link; // In client->entries
+} Entry;
+
+struct _GebrmFairQueue {
+	GHashTable *queues;  // name -> Queue
+	GHashTable *weights; // client id -> gdouble *
+	GHashTable *entries; // item -> Entry
+	GSequence *ready;    // Queue that can admit an item, by priority
+	guint64 serial;
+};
+
+static void
+client_queue_free(ClientQueue *client)
+{
+	g_queue_free(client->entries);
+	g_free(client->id);
+	g_free(client);
+}
+
+static void
+queue_free(Queue *queue)
+{
+	g_sequence_free(queue->active);
+	g_hash_table_destroy(queue->clients);
+	g_free(queue->name);
+	g_free(queue);
+}
+
+static gint
+compare_clients(gconstpointer a, gconstpointer b, gpointer data)
+{
+	const ClientQueue *c1 = a, *c2 = b;
+
+	if (c1->pass != c2->pass)
+		return c1->pass < c2->pass ? -1 : 1;
+
+	return (c1->serial > c2->serial) - (c1->serial < c2->serial);
+}
+
+static gint
+compare_queues(gconstpointer a, gconstpointer b, gpointer data)
+{
+	const Queue *q1 = a, *q2 = b;
+
+	if (q1->priority != q2->priority)
+		return q2->priority - q1->priority;
+
+	if (q1->served != q2->served)
+		return (q1->served > q2->served) - (q1->served < q2->served);
+
+	/* Neither was served yet */
+	return g_strcmp0(q1->name, q2->name);
+}
+
+static Queue *
+get_queue(GebrmFairQueue *self,
+	  const gchar *name)
+{
+	Queue *queue = g_hash_table_lookup(self->queues, name);
+
+	if (!queue) {
+		queue = g_new0(Queue, 1);
+		queue->name = g_strdup(name);
+		queue->clients = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+						       (GDestroyNotify)client_queue_free);
+		queue->active = g_sequence_new(NULL);
+		g_hash_table_insert(self->queues, queue->name, queue);
+	}
+
+	return queue;
+}
+
+static gdouble
+get_weight(GebrmFairQueue *self,
+	   const gchar *client_id)
+{
+	gdouble *weight = g_hash_table_lookup(self->weights, client_id);
+	return weight ? *weight : 1;
+}
+
+/*
+ * Puts @queue in or out of the ready set, or moves it after its priority or
+ * limit changed.
+ */
+static void
+update_ready(GebrmFairQueue *self,
+	     Queue *queue)
+{
+	gboolean can_admit = g_sequence_get_length(queue->active) > 0
+		&& (queue->max_running <= 0 || queue->running < queue->max_running);
+
+	if (can_admit && !queue->iter) {
+		queue->iter = g_sequence_insert_sorted(self->ready, queue, compare_queues, NULL);
+	} else if (!can_admit && queue->iter) {
+		g_sequence_remove(queue->iter);
+		queue->iter = NULL;
+	} else if (can_admit) {
+		g_sequence_sort_changed(queue->iter, compare_queues, NULL);
+	}
+}
+
+/*
+ * Takes @entry out of its client, deactivating the client if it has no
+ * more entries.
+ */
+static void
+unlink_entry(GebrmFairQueue *self,
+	     Entry *entry)
+{
+	ClientQueue *client = entry->client;
+
+	g_queue_delete_link(client->entries, entry->link);
+	g_hash_table_remove(self->entries, entry->item);
+
+	if (g_queue_is_empty(client->entries)) {
+		g_sequence_remove(client->iter);
+		client->iter = NULL;
+	}
+}
+
+/*
+ * An item of gebrm_fair_queue_list(): the client gets its @index-th entry
+ * at pass + index / weight.
+ */
+typedef struct {
+	Entry *entry;
+	gdouble pass;
+} Scheduled;
+
+static gint
+compare_scheduled(gconstpointer a, gconstpointer b)
+{
+	const Scheduled *s1 = a, *s2 = b;
+	const Queue *q1 = s1->entry->client->queue;
+	const Queue *q2 = s2->entry->client->queue;
+
+	if (q1 != q2)
+		return compare_queues(q1, q2, NULL);
+
+	if (s1->pass != s2->pass)
+		return s1->pass < s2->pass ? -1 : 1;
+
+	return compare_clients(s1->entry->client, s2->entry->client, NULL);
+}
+
+/* Public methods {{{1 */
+GebrmFairQueue *
+gebrm_fair_queue_new(void)
+{
+	GebrmFairQueue *self = g_new0(GebrmFairQueue, 1);
+
+	self->queues = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+					     (GDestroyNotify)queue_free);
+	self->weights = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	self->entries = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+	self->ready = g_sequence_new(NULL);
+
+	return self;
+}
+
+void
+gebrm_fair_queue_free(GebrmFairQueue *self)
+{
+	g_sequence_free(self->ready);
+	g_hash_table_destroy(self->entries);
+	g_hash_table_destroy(self->queues);
+	g_hash_table_destroy(self->weights);
+	g_free(self);
+}
+
+void
+gebrm_fair_queue_set_queue(GebrmFairQueue *self,
+			   const gchar *name,
+			   gint priority,
+			   gint max_running)
+{
+	Queue *queue = get_queue(self, name);
+
+	queue->priority = priority;
+	queue->max_running = max_running;
+	update_ready(self, queue);
+}
+
+void
+gebrm_fair_queue_set_weight(GebrmFairQueue *self,
+			    const gchar *client_id,
+			    gdouble weight)
+{
+	g_return_if_fail(weight > 0);
+
+	g_hash_table_insert(self->weights, g_strdup(client_id),
+			    g_memdup(&weight, sizeof(weight)));
+}
+
+void
+gebrm_fair_queue_push(GebrmFairQueue *self,
+		      const gchar *name,
+		      const gchar *client_id,
+		      gpointer item)
+{
+	g_return_if_fail(item != NULL);
+	g_return_if_fail(g_hash_table_lookup(self->entries, item) == NULL);
+
+	Queue *queue = get_queue(self, name ? name : GEBRM_FAIR_QUEUE_DEFAULT);
+
+	if (!client_id)
+		client_id = "";
+
+	ClientQueue *client = g_hash_table_lookup(queue->clients, client_id);
+	if (!client) {
+		client = g_new0(ClientQueue, 1);
+		client->id = g_strdup(client_id);
+		client->queue = queue;
+		client->entries = g_queue_new();
+		g_hash_table_insert(queue->clients, client->id, client);
+	}
+
+	Entry *entry = g_new(Entry, 1);
+	entry->item = item;
+	entry->client = client;
+	g_queue_push_tail(client->entries, entry);
+	entry->link = client->entries->tail;
+	g_hash_table_insert(self->entries, item, entry);
+
+	if (!client->iter) {
+		client->pass = MAX(client->pass, queue->vtime);
+		client->serial = ++self->serial;
+		client->iter = g_sequence_insert_sorted(queue->active, client, compare_clients, NULL);
+		update_ready(self, queue);
+	}
+}
+
+gpointer
+gebrm_fair_queue_peek(GebrmFairQueue *self)
+{
+	GSequenceIter *first = g_sequence_get_begin_iter(self->ready);
+
+	if (g_sequence_iter_is_end(first))
+		return NULL;
+
+	Queue *queue = g_sequence_get(first);
+	ClientQueue *client = g_sequence_get(g_sequence_get_begin_iter(queue->active));
+	Entry *entry = g_queue_peek_head(client->entries);
+
+	return entry->item;
+}
+
+gpointer
+gebrm_fair_queue_pop(GebrmFairQueue *self,
+		     const gchar **name)
+{
+	GSequenceIter *first = g_sequence_get_begin_iter(self->ready);
+
+	if (g_sequence_iter_is_end(first))
+		return NULL;
+
+	Queue *queue = g_sequence_get(first);
+	ClientQueue *client = g_sequence_get(g_sequence_get_begin_iter(queue->active));
+	Entry *entry = g_queue_peek_head(client->entries);
+	gpointer item = entry->item;
+
+	queue->vtime = client->pass;
+	client->pass += 1 / get_weight(self, client->id);
+
+	unlink_entry(self, entry);
+	if (client->iter)
+		g_sequence_sort_changed(client->iter, compare_clients, NULL);
+
+	queue->running++;
+	queue->served = ++self->serial;
+	update_ready(self, queue);
+
+	if (name)
+		*name = queue->name;
+
+	return item;
+}
+
+void
+gebrm_fair_queue_release(GebrmFairQueue *self,
+			 const gchar *name)
+{
+	Queue *queue = g_hash_table_lookup(self->queues, name);
+
+	g_return_if_fail(queue != NULL && queue->running > 0);
+
+	queue->running--;
+	update_ready(self, queue);
+}
+
+gboolean
+gebrm_fair_queue_remove(GebrmFairQueue *self,
+			gpointer item)
+{
+	Entry *entry = g_hash_table_lookup(self->entries, item);
+
+	if (!entry)
+		return FALSE;
+
+	Queue *queue = entry->client->queue;
+	unlink_entry(self, entry);
+	update_ready(self, queue);
+
+	return TRUE;
+}
+
+guint
+gebrm_fair_queue_get_length(GebrmFairQueue *self)
+{
+	return g_hash_table_size(self->entries);
+}
+
+gboolean
+gebrm_fair_queue_is_full(GebrmFairQueue *self,
+			 const gchar *name)
+{
+	Queue *queue = g_hash_table_lookup(self->queues, name);
+
+	return queue && queue->max_running > 0 && queue->running >= queue->max_running;
+}
+
+gint
+gebrm_fair_queue_get_priority(GebrmFairQueue *self,
+			      const gchar *name)
+{
+	Queue *queue = g_hash_table_lookup(self->queues, name);
+
+	return queue ? queue->priority : 0;
+}
+
+GList *
+gebrm_fair_queue_list(GebrmFairQueue *self)
+{
+	guint n = g_hash_table_size(self->entries);
+	Scheduled *scheduled = g_new(Scheduled, n);
+	GHashTableIter iter;
+	Queue *queue;
+	guint k = 0;
+
+	g_hash_table_iter_init(&iter, self->queues);
+	while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&queue)) {
+		GSequenceIter *i = g_sequence_get_begin_iter(queue->active);
+		for (; !g_sequence_iter_is_end(i); i = g_sequence_iter_next(i)) {
+			ClientQueue *client = g_sequence_get(i);
+			gdouble stride = 1 / get_weight(self, client->id);
+			gint index = 0;
+			for (GList *j = client->entries->head; j; j = j->next, index++) {
+				scheduled[k].entry = j->data;
+				scheduled[k].pass = client->pass + index * stride;
+				k++;
+			}
+		}
+	}
+
+	qsort(scheduled, k, sizeof(Scheduled), compare_scheduled);
+
+	GList *list = NULL;
+	while (k--)
+		list = g_list_prepend(list, scheduled[k].entry->item);
+
+	g_free(scheduled);
+
+	return list;
+}
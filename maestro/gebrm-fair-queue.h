@@ -0,0 +1,154 @@
+/*
+ * gebrm-fair-queue.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_FAIR_QUEUE_H__
+#define __GEBRM_FAIR_QUEUE_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_FAIR_QUEUE_DEFAULT:
+ *
+ * Name of the queue used by jobs that do not ask for one.
+ */
+#define GEBRM_FAIR_QUEUE_DEFAULT "default"
+
+typedef struct _GebrmFairQueue GebrmFairQueue;
+
+GebrmFairQueue *gebrm_fair_queue_new(void);
+
+void gebrm_fair_queue_free(GebrmFairQueue *self);
+
+/**
+ * gebrm_fair_queue_set_queue:
+ * @priority: Queues with higher priority are always served first
+ * @max_running: Items of this queue admitted at the same time, 0 for no
+ * limit
+ *
+ * Creates or updates the queue called @name. Queues not set are created on
+ * the first push with priority 0 and no limit.
+ */
+void gebrm_fair_queue_set_queue(GebrmFairQueue *self,
+				const gchar *name,
+				gint priority,
+				gint max_running);
+
+/**
+ * gebrm_fair_queue_set_weight:
+ *
+ * Sets the share of the client @client_id, which is 1 by default. Within a
+ * queue, a client with weight 2 is served twice as often as a client with
+ * weight 1 while both have items waiting.
+ */
+void gebrm_fair_queue_set_weight(GebrmFairQueue *self,
+				 const gchar *client_id,
+				 gdouble weight);
+
+/**
+ * gebrm_fair_queue_push:
+ *
+ * Appends @item, submitted by @client_id, to the queue @name. Items of the
+ * same client leave in the order they were pushed.
+ */
+void gebrm_fair_queue_push(GebrmFairQueue *self,
+			   const gchar *name,
+			   const gchar *client_id,
+			   gpointer item);
+
+/**
+ * gebrm_fair_queue_pop:
+ * @name: Return location for the queue of the item, owned by @self
+ *
+ * Takes the next item to run: the queue with highest priority that is
+ * under its limit, and within it the client that was served least relative
+ * to its weight. The item counts towards the limit of its queue until
+ * gebrm_fair_queue_release() is called. Runs in logarithmic time.
+ *
+ * Returns: the item, or %NULL if none can be admitted now.
+ */
+gpointer gebrm_fair_queue_pop(GebrmFairQueue *self,
+			      const gchar **name);
+
+/**
+ * gebrm_fair_queue_peek:
+ *
+ * Returns: the item gebrm_fair_queue_pop() would take, leaving it in @self,
+ * or %NULL if none can be admitted now.
+ */
+gpointer gebrm_fair_queue_peek(GebrmFairQueue *self);
+
+/**
+ * gebrm_fair_queue_release:
+ *
+ * Tells an item popped from the queue @name has finished, letting another
+ * one be admitted.
+ */
+void gebrm_fair_queue_release(GebrmFairQueue *self,
+			      const gchar *name);
+
+/**
+ * gebrm_fair_queue_remove:
+ *
+ * Drops @item, which has not been popped yet.
+ *
+ * Returns: %FALSE if @item was not waiting in @self.
+ */
+gboolean gebrm_fair_queue_remove(GebrmFairQueue *self,
+				 gpointer item);
+
+/**
+ * gebrm_fair_queue_get_length:
+ *
+ * Returns: the number of items waiting.
+ */
+guint gebrm_fair_queue_get_length(GebrmFairQueue *self);
+
+/**
+ * gebrm_fair_queue_is_full:
+ *
+ * Returns: %TRUE if the queue @name has as many items admitted as its
+ * limit allows.
+ */
+gboolean gebrm_fair_queue_is_full(GebrmFairQueue *self,
+				  const gchar *name);
+
+/**
+ * gebrm_fair_queue_get_priority:
+ *
+ * Returns: the priority of the queue @name, 0 if it was never set.
+ */
+gint gebrm_fair_queue_get_priority(GebrmFairQueue *self,
+				   const gchar *name);
+
+/**
+ * gebrm_fair_queue_list:
+ *
+ * Lists the items waiting in the order they would be popped if nothing
+ * else were pushed or released, ignoring the limits of the queues.
+ *
+ * Returns: a newly allocated list of the items, free it with g_list_free().
+ */
+GList *gebrm_fair_queue_list(GebrmFairQueue *self);
+
+G_END_DECLS
+
+#endif /* __GEBRM_FAIR_QUEUE_H__ */
@@ -0,0 +1,356 @@
+/*
+ * gebrm-history.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-history.h"
+#include "gebrm-compaction.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The history is a text file with one record per line, appended as jobs
+ * finish:
+ *
+ *   key <TAB> daemon <TAB> cpu class <TAB> cores <TAB> iterations <TAB>
+ *   wall time <TAB> cpu time <TAB> date <TAB> peak memory
+ *
+ * Records dropped by the bounds stay in the file until it has
+ * GEBRM_COMPACTION_RATIO times more lines than records kept, then it
+ * is rewritten.
+ */
+#define GEBRM_HISTORY_HEADER "# gebrm history 1\n"
+
+typedef struct {
+	gchar *key;
+	GQueue *records; // GebrmHistoryRecord, oldest first
+} FlowHistory;
+
+struct _GebrmHistory {
+	gchar *path;
+	GHashTable *flows; // key -> FlowHistory
+	GQueue *lru;       // FlowHistory, least recently updated first
+	gint n_records;
+	gint n_lines;
+};
+
+static void
+record_free(GebrmHistoryRecord *record)
+{
+	g_free(record->daemon);
+	g_free(record->cpu_class);
+	g_free(record);
+}
+
+static void
+flow_history_free(FlowHistory *flow)
+{
+	g_queue_foreach(flow->records, (GFunc)record_free, NULL);
+	g_queue_free(flow->records);
+	g_free(flow->key);
+	g_free(flow);
+}
+
+static gchar *
+sanitize(const gchar *str)
+{
+	return g_strdelimit(g_strdup(str ? str : ""), "\t\n", ' ');
+}
+
+static gchar *
+record_to_line(const gchar *key,
+	       const GebrmHistoryRecord *record)
+{
+	gchar wall[G_ASCII_DTOSTR_BUF_SIZE];
+	gchar cpu[G_ASCII_DTOSTR_BUF_SIZE];
+	gchar *daemon = sanitize(record->daemon);
+	gchar *cpu_class = sanitize(record->cpu_class);
+
+	g_ascii_formatd(wall, sizeof(wall), "%.3f", record->wall_time);
+	g_ascii_formatd(cpu, sizeof(cpu), "%.3f", record->cpu_time);
+
+	gchar *line = g_strdup_printf("%s\t%s\t%s\t%d\t%d\t%s\t%s\t%" G_GINT64_FORMAT "\t%ld\n",
+				      key, daemon, cpu_class,
+				      record->ncores, record->iterations,
+				      wall, cpu, record->date, record->peak_memory);
+	g_free(daemon);
+	g_free(cpu_class);
+
+	return line;
+}
+
+/*
+ * Inserts @record into memory, enforcing the bounds. Does not touch the
+ * file.
+ */
+static void
+history_insert(GebrmHistory *self,
+	       const gchar *key,
+	       GebrmHistoryRecord *record)
+{
+	FlowHistory *flow = g_hash_table_lookup(self->flows, key);
+
+	if (flow) {
+		g_queue_remove(self->lru, flow);
+	} else {
+		flow = g_new0(FlowHistory, 1);
+		flow->key = g_strdup(key);
+		flow->records = g_queue_new();
+		g_hash_table_insert(self->flows, flow->key, flow);
+	}
+	g_queue_push_tail(self->lru, flow);
+
+	g_queue_push_tail(flow->records, record);
+	self->n_records++;
+
+	if (g_queue_get_length(flow->records) > GEBRM_HISTORY_RECORDS_PER_FLOW) {
+		record_free(g_queue_pop_head(flow->records));
+		self->n_records--;
+	}
+
+	if (g_hash_table_size(self->flows) > GEBRM_HISTORY_MAX_FLOWS) {
+		FlowHistory *old = g_queue_pop_head(self->lru);
+		self->n_records -= g_queue_get_length(old->records);
+		g_hash_table_remove(self->flows, old->key);
+	}
+}
+
+static void
+history_load(GebrmHistory *self)
+{
+	gchar *contents;
+
+	if (!g_file_get_contents(self->path, &contents, NULL, NULL))
+		return;
+
+	gchar **lines = g_strsplit(contents, "\n", 0);
+	for (gint i = 0; lines[i]; i++) {
+		if (!*lines[i] || *lines[i] == '#')
+			continue;
+
+		self->n_lines++;
+
+		gchar **fields = g_strsplit(lines[i], "\t", 0);
+		if (g_strv_length(fields) != 9) {
+			g_strfreev(fields);
+			continue;
+		}
+
+		GebrmHistoryRecord *record = g_new0(GebrmHistoryRecord, 1);
+		record->daemon = g_strdup(fields[1]);
+		record->cpu_class = g_strdup(fields[2]);
+		record->ncores = atoi(fields[3]);
+		record->iterations = atoi(fields[4]);
+		record->wall_time = g_ascii_strtod(fields[5], NULL);
+		record->cpu_time = g_ascii_strtod(fields[6], NULL);
+		record->date = g_ascii_strtoll(fields[7], NULL, 10);
+		record->peak_memory = atol(fields[8]);
+
+		if (record->ncores > 0 && record->iterations > 0)
+			history_insert(self, fields[0], record);
+		else
+			record_free(record);
+
+		g_strfreev(fields);
+	}
+	g_strfreev(lines);
+	g_free(contents);
+}
+
+static gboolean
+needs_compaction(GebrmHistory *self)
+{
+	return gebrm_compaction_needed(self->n_lines, self->n_records,
+				       GEBRM_HISTORY_RECORDS_PER_FLOW);
+}
+
+/* Public methods {{{1 */
+GebrmHistory *
+gebrm_history_new(const gchar *path)
+{
+	GebrmHistory *self = g_new0(GebrmHistory, 1);
+
+	self->path = g_strdup(path);
+	self->flows = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+					    (GDestroyNotify)flow_history_free);
+	self->lru = g_queue_new();
+
+	history_load(self);
+
+	if (needs_compaction(self))
+		gebrm_history_compact(self);
+
+	return self;
+}
+
+void
+gebrm_history_free(GebrmHistory *self)
+{
+	g_queue_free(self->lru);
+	g_hash_table_destroy(self->flows);
+	g_free(self->path);
+	g_free(self);
+}
+
+void
+gebrm_history_append(GebrmHistory *self,
+		     const gchar *key,
+		     const GebrmHistoryRecord *record)
+{
+	g_return_if_fail(key != NULL && record != NULL);
+
+	if (record->ncores <= 0 || record->iterations <= 0)
+		return;
+
+	GebrmHistoryRecord *copy = g_new(GebrmHistoryRecord, 1);
+	*copy = *record;
+	copy->daemon = g_strdup(record->daemon);
+	copy->cpu_class = g_strdup(record->cpu_class);
+	history_insert(self, key, copy);
+
+	gboolean exists = g_file_test(self->path, G_FILE_TEST_EXISTS);
+	FILE *fp = fopen(self->path, "a");
+	if (!fp) {
+		g_warning("Could not append to history file %s", self->path);
+		return;
+	}
+
+	if (!exists)
+		fputs(GEBRM_HISTORY_HEADER, fp);
+
+	gchar *line = record_to_line(key, record);
+	fputs(line, fp);
+	fclose(fp);
+	g_free(line);
+
+	self->n_lines++;
+
+	if (needs_compaction(self))
+		gebrm_history_compact(self);
+}
+
+gdouble
+gebrm_history_get_cost(GebrmHistory *self,
+		       const gchar *key,
+		       const gchar *cpu_class)
+{
+	FlowHistory *flow = g_hash_table_lookup(self->flows, key);
+	gdouble sum = 0;
+	gint n = 0;
+
+	if (!flow)
+		return -1;
+
+	for (GList *i = flow->records->head; i; i = i->next) {
+		GebrmHistoryRecord *record = i->data;
+
+		if (g_strcmp0(record->cpu_class, cpu_class) != 0)
+			continue;
+
+		sum += record->wall_time * record->ncores / record->iterations;
+		n++;
+	}
+
+	return n ? sum / n : -1;
+}
+
+gboolean
+gebrm_history_get_scaling(GebrmHistory *self,
+			  const gchar *key,
+			  GebrScaling *scaling)
+{
+	FlowHistory *flow = g_hash_table_lookup(self->flows, key);
+
+	if (!flow)
+		return FALSE;
+
+	/* Records of all processor models are mixed, their differences
+	 * show up as noise in the fit */
+	gint n = g_queue_get_length(flow->records);
+	gint *nprocs = g_new(gint, n);
+	gdouble *costs = g_new(gdouble, n);
+
+	gint k = 0;
+	for (GList *i = flow->records->head; i; i = i->next, k++) {
+		GebrmHistoryRecord *record = i->data;
+		nprocs[k] = record->ncores;
+		costs[k] = record->wall_time * record->ncores / record->iterations;
+	}
+
+	gboolean ok = gebr_calculate_scaling_fit(nprocs, costs, n, scaling);
+
+	g_free(nprocs);
+	g_free(costs);
+
+	return ok;
+}
+
+glong
+gebrm_history_get_memory(GebrmHistory *self,
+			 const gchar *key)
+{
+	FlowHistory *flow = g_hash_table_lookup(self->flows, key);
+	glong peak = -1;
+
+	if (!flow)
+		return -1;
+
+	/* The largest, not the mean: underestimating makes the daemon swap */
+	for (GList *i = flow->records->head; i; i = i->next) {
+		GebrmHistoryRecord *record = i->data;
+
+		if (record->peak_memory <= 0)
+			continue;
+
+		peak = MAX(peak, (record->peak_memory + record->ncores - 1) / record->ncores);
+	}
+
+	return peak;
+}
+
+gboolean
+gebrm_history_compact(GebrmHistory *self)
+{
+	GError *error = NULL;
+	GString *contents = g_string_new(GEBRM_HISTORY_HEADER);
+	gint n_lines = 0;
+
+	for (GList *i = self->lru->head; i; i = i->next) {
+		FlowHistory *flow = i->data;
+		for (GList *j = flow->records->head; j; j = j->next) {
+			gchar *line = record_to_line(flow->key, j->data);
+			g_string_append(contents, line);
+			g_free(line);
+			n_lines++;
+		}
+	}
+
+	/* g_file_set_contents() replaces the file atomically */
+	gboolean ok = g_file_set_contents(self->path, contents->str, contents->len, &error);
+	g_string_free(contents, TRUE);
+
+	if (!ok) {
+		g_warning("Could not compact history file %s: %s", self->path, error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	self->n_lines = n_lines;
+	return TRUE;
+}
@@ -0,0 +1,127 @@
+/*
+ * gebrm-history.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_HISTORY_H__
+#define __GEBRM_HISTORY_H__
+
+#include <glib.h>
+#include <libgebr/utils.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_HISTORY_MAX_FLOWS:
+ *
+ * Number of flows kept in the history. The flow updated least recently is
+ * forgotten when a new one arrives.
+ */
+#define GEBRM_HISTORY_MAX_FLOWS 256
+
+/**
+ * GEBRM_HISTORY_RECORDS_PER_FLOW:
+ *
+ * Number of executions kept for each flow, the oldest are dropped.
+ */
+#define GEBRM_HISTORY_RECORDS_PER_FLOW 32
+
+typedef struct _GebrmHistory GebrmHistory;
+
+/**
+ * GebrmHistoryRecord:
+ *
+ * One task of a finished job. @cpu_class identifies daemons of the same
+ * processor model. @cpu_time is the user and system time of the task in
+ * seconds, and @peak_memory its largest resident memory in kB, both 0 when
+ * unknown.
+ */
+typedef struct {
+	gchar *daemon;
+	gchar *cpu_class;
+	gint ncores;
+	gint iterations;
+	gdouble wall_time;
+	gdouble cpu_time;
+	gint64 date;
+	glong peak_memory;
+} GebrmHistoryRecord;
+
+/**
+ * gebrm_history_new:
+ *
+ * Loads the history kept at @path, which is created on the first append.
+ */
+GebrmHistory *gebrm_history_new(const gchar *path);
+
+void gebrm_history_free(GebrmHistory *self);
+
+/**
+ * gebrm_history_append:
+ *
+ * Records @record for the flow identified by @key, see
+ * gebr_comm_runner_get_flow_hash().
+ */
+void gebrm_history_append(GebrmHistory *self,
+			  const gchar *key,
+			  const GebrmHistoryRecord *record);
+
+/**
+ * gebrm_history_get_cost:
+ *
+ * Returns: the mean time, in seconds, a core of class @cpu_class takes to
+ * execute one iteration of the flow identified by @key, or a negative
+ * value if it never ran there.
+ */
+gdouble gebrm_history_get_cost(GebrmHistory *self,
+			       const gchar *key,
+			       const gchar *cpu_class);
+
+/**
+ * gebrm_history_get_scaling:
+ *
+ * Fits how the flow identified by @key scales with the number of
+ * processes per daemon, see gebr_calculate_scaling_fit().
+ *
+ * Returns: %FALSE if the flow did not run with enough different numbers
+ * of processes.
+ */
+gboolean gebrm_history_get_scaling(GebrmHistory *self,
+				   const gchar *key,
+				   GebrScaling *scaling);
+
+/**
+ * gebrm_history_get_memory:
+ *
+ * Returns: the largest memory, in kB, each process of the flow identified
+ * by @key has used, or a negative value if it was never measured.
+ */
+glong gebrm_history_get_memory(GebrmHistory *self,
+			       const gchar *key);
+
+/**
+ * gebrm_history_compact:
+ *
+ * Rewrites the file of @self with the records still kept. This is done
+ * automatically when the file grows too large.
+ */
+gboolean gebrm_history_compact(GebrmHistory *self);
+
+G_END_DECLS
+
+#endif /* __GEBRM_HISTORY_H__ */
@@ -41,19 +41,35 @@ struct _GebrmJobPriv {
 	gboolean has_issued;
 
 	GList *children; // A list of GebrCommRunner
+
+	GArray *task_steps; // TaskSteps of each fraction
+	gdouble eta;
+
+	GHashTable *remainders; // Fraction of a remainder -> fraction that was split
+
+	gchar *issues; // Used until a task arrives, see gebrm_job_set_issues()
 };
 
+typedef struct {
+	gint steps;
+	gint ncores;
+} TaskSteps;
+
 enum {
 	STATUS_CHANGE,
 	ISSUED,
 	CMD_LINE_RECEIVED,
 	OUTPUT,
 	DISCONNECT,
+	CHUNK_FINISHED,
+	TASK_SPLIT,
 	N_SIGNALS
 };
 
 static guint signals[N_SIGNALS] = { 0, };
 
+static gint next_id = 0;
+
 static void gebrm_job_append_task_output(GebrmTask *task,
 					 const gchar *output,
 					 GebrmJob *job);
@@ -99,6 +115,9 @@ gebrm_job_finalize(GObject *object)
 	g_free(job->priv->info.snapshot_id);
 	g_list_foreach(job->priv->tasks, (GFunc)g_object_unref, NULL);
 	g_list_free(job->priv->tasks);
+	g_array_free(job->priv->task_steps, TRUE);
+	g_hash_table_destroy(job->priv->remainders);
+	g_free(job->priv->issues);
 
 	G_OBJECT_CLASS(gebrm_job_parent_class)->finalize(object);
 }
@@ -116,6 +135,9 @@ gebrm_job_init(GebrmJob *job)
 	job->priv->run_type = g_strdup("");
 	job->priv->mpi_owner = g_strdup("");
 	job->priv->mpi_flavor = g_strdup("");
+	job->priv->task_steps = g_array_new(FALSE, TRUE, sizeof(TaskSteps));
+	job->priv->remainders = g_hash_table_new(NULL, NULL);
+	job->priv->eta = -1;
 }
 
 static void
@@ -169,6 +191,24 @@ gebrm_job_class_init(GebrmJobClass *klass)
 			     g_cclosure_marshal_VOID__VOID,
 			     G_TYPE_NONE, 0);
 
+	signals[CHUNK_FINISHED] =
+		g_signal_new("chunk-finished",
+			     G_OBJECT_CLASS_TYPE(gobject_class),
+			     G_SIGNAL_RUN_FIRST,
+			     G_STRUCT_OFFSET(GebrmJobClass, chunk_finished),
+			     NULL, NULL,
+			     g_cclosure_marshal_VOID__OBJECT,
+			     G_TYPE_NONE, 1, GEBRM_TYPE_TASK);
+
+	signals[TASK_SPLIT] =
+		g_signal_new("task-split",
+			     G_OBJECT_CLASS_TYPE(gobject_class),
+			     G_SIGNAL_RUN_FIRST,
+			     G_STRUCT_OFFSET(GebrmJobClass, task_split),
+			     NULL, NULL,
+			     g_cclosure_marshal_VOID__OBJECT,
+			     G_TYPE_NONE, 1, GEBRM_TYPE_TASK);
+
 	g_type_class_add_private(klass, sizeof(GebrmJobPriv));
 }
 
@@ -191,6 +231,58 @@ gebrm_job_is_stopped(GebrmJob *job)
 		|| job->priv->status == JOB_STATUS_CANCELED;
 }
 
+static gboolean
+fraction_finished(GebrmJob *job,
+		  gint frac)
+{
+	for (GList *i = job->priv->tasks; i; i = i->next)
+		if (gebrm_task_get_fraction(i->data) == frac)
+			return gebrm_task_get_status(i->data) == JOB_STATUS_FINISHED;
+
+	return FALSE;
+}
+
+static gboolean
+has_remainder(GebrmJob *job,
+	      gint frac)
+{
+	GHashTableIter iter;
+	gpointer split;
+
+	g_hash_table_iter_init(&iter, job->priv->remainders);
+	while (g_hash_table_iter_next(&iter, NULL, &split))
+		if (GPOINTER_TO_INT(split) == frac)
+			return TRUE;
+
+	return FALSE;
+}
+
+/*
+ * Whether all iterations of @job are done: every task finished, the ones
+ * stopped early have their remainder, and every remainder finished.
+ */
+static gboolean
+iterations_finished(GebrmJob *job)
+{
+	GHashTableIter iter;
+	gpointer remainder;
+
+	for (GList *i = job->priv->tasks; i; i = i->next) {
+		if (gebrm_task_get_status(i->data) != JOB_STATUS_FINISHED)
+			return FALSE;
+		if (gebrm_task_get_done_steps(i->data) >= 0
+		    && !has_remainder(job, gebrm_task_get_fraction(i->data)))
+			return FALSE;
+	}
+
+	g_hash_table_iter_init(&iter, job->priv->remainders);
+	while (g_hash_table_iter_next(&iter, &remainder, NULL))
+		if (!fraction_finished(job, GPOINTER_TO_INT(remainder)))
+			return FALSE;
+
+	return TRUE;
+}
+
 gboolean
 gebrm_job_is_queueable(GebrmJob *job)
 {
@@ -228,22 +320,45 @@ gebrm_job_change_task_status(GebrmTask *task,
 	GebrCommJobStatus old = job->priv->status;
 	gint frac, total, ntasks;
 
-	frac = gebrm_task_get_fraction(task);
-	total = job->priv->total;
-	ntasks = g_list_length(job->priv->tasks);
-
 	if (gebrm_job_is_stopped(job)) {
 		gebrm_task_kill(task);
 		return;
 	}
 
+	/* The handlers may send the next chunk of the job or set its total
+	 * number of tasks, so read them afterwards */
+	if (job->priv->total < 0 && new_status == JOB_STATUS_FINISHED)
+		g_signal_emit(job, signals[CHUNK_FINISHED], 0, task);
+
+	/* A task stopped early by gebrm_task_split() finished only part of
+	 * its iterations, the handlers send the rest as a new task */
+	frac = gebrm_task_get_fraction(task);
+	if (new_status == JOB_STATUS_FINISHED
+	    && gebrm_task_get_done_steps(task) >= 0
+	    && !has_remainder(job, frac)) {
+		g_signal_emit(job, signals[TASK_SPLIT], 0, task);
+		if (!has_remainder(job, frac)) {
+			g_warning("The rest of task %d of job %s could not be sent",
+				  frac, job->priv->info.id);
+			new_status = JOB_STATUS_FAILED;
+		}
+	}
+
+	total = job->priv->total;
+	ntasks = 0;
+	for (i = job->priv->tasks; i; i = i->next)
+		if (!gebrm_job_is_remainder(job, gebrm_task_get_fraction(i->data)))
+			ntasks++;
+
 	/* Do not change the status if the job isn't complete.
 	 * But if the new status is Failed or Canceled, let this
-	 * change pass.
+	 * change pass. If the total is not known yet, the job is
+	 * being distributed in chunks and only the end must wait.
 	 */
 	if (ntasks != total &&
 	    (new_status != JOB_STATUS_CANCELED &&
-	     new_status != JOB_STATUS_FAILED))
+	     new_status != JOB_STATUS_FAILED) &&
+	    (total >= 0 || new_status == JOB_STATUS_FINISHED))
 		return;
 
 	switch (new_status)
@@ -266,10 +381,7 @@ gebrm_job_change_task_status(GebrmTask *task,
 			      old, job->priv->status, parameter);
 		break;
 	case JOB_STATUS_FINISHED:
-		for (i = job->priv->tasks; i; i = i->next)
-			if (gebrm_task_get_status(i->data) != JOB_STATUS_FINISHED)
-				break;
-		if (ntasks == total && i == NULL) { // If i == NULL, all tasks are finished
+		if (ntasks == total && iterations_finished(job)) {
 			job->priv->status = JOB_STATUS_FINISHED;
 			g_signal_emit(job, signals[STATUS_CHANGE], 0,
 				      old, job->priv->status, parameter);
@@ -303,13 +415,21 @@ on_task_destroy(GebrmJob *job,
 GebrmJob *
 gebrm_job_new(void)
 {
-	static gint id = 0;
-	gchar *rid = g_strdup_printf("%d", id++);
+	gchar *rid = g_strdup_printf("%d", next_id++);
 	GebrmJob *job = g_object_new(GEBRM_TYPE_JOB, NULL);
 	job->priv->info.id = rid;
 	return job;
 }
 
+GebrmJob *
+gebrm_job_new_with_id(const gchar *id)
+{
+	GebrmJob *job = g_object_new(GEBRM_TYPE_JOB, NULL);
+	job->priv->info.id = g_strdup(id);
+	next_id = MAX(next_id, atoi(id) + 1);
+	return job;
+}
+
 void
 gebrm_job_init_details(GebrmJob *job, GebrmJobInfo *info)
 {
@@ -396,7 +516,14 @@ gebrm_job_append_task(GebrmJob *job, GebrmTask *task)
 	g_object_weak_ref(G_OBJECT(task), (GWeakNotify)on_task_destroy, job);
 
 	g_signal_emit(job, signals[CMD_LINE_RECEIVED], 0, task, gebrm_task_get_cmd_line(task));
-	g_signal_emit(job, signals[OUTPUT], 0, task, gebrm_task_get_output(task));
+
+	/* Output that arrived before @task joined @job, usually none */
+	gsize length = gebrm_task_get_output_length(task);
+	if (length > 0) {
+		gchar *output = gebrm_task_read_output(task, 0, length);
+		g_signal_emit(job, signals[OUTPUT], 0, task, output);
+		g_free(output);
+	}
 
 	if (strlen(issues))
 		gebrm_job_change_task_status(task, job->priv->status,
@@ -435,17 +562,6 @@ gebrm_job_get_id(GebrmJob *job)
 	return job->priv->info.id;
 }
 
-gchar *
-gebrm_job_get_output(GebrmJob *job)
-{
-	GString *output = g_string_new(NULL);
-
-	for (GList *i = job->priv->tasks; i; i = i->next)
-		g_string_append(output, gebrm_task_get_output(i->data));
-
-	return g_string_free(output, FALSE);
-}
-
 const gchar *
 gebrm_job_get_submit_date(GebrmJob *job)
 {
@@ -508,14 +624,21 @@ gebrm_job_get_issues(GebrmJob *job)
 	if (job->priv->tasks)
 		return g_strdup(gebrm_task_get_issues(job->priv->tasks->data));
 
-	return NULL;
+	return g_strdup(job->priv->issues);
+}
+
+void
+gebrm_job_set_issues(GebrmJob *job, const gchar *issues)
+{
+	g_free(job->priv->issues);
+	job->priv->issues = g_strdup(issues);
 }
 
 gboolean
 gebrm_job_has_issues(GebrmJob *job)
 {
 	if (!job->priv->tasks)
-		return FALSE;
+		return job->priv->issues && *job->priv->issues;
 
 	return gebrm_task_get_issues(job->priv->tasks->data)[0] == '\0' ? FALSE : TRUE;
 }
@@ -653,6 +776,13 @@ gebrm_job_get_exec_speed(GebrmJob *job)
 	return job->priv->info.speed;
 }
 
+void
+gebrm_job_set_exec_speed(GebrmJob *job, gdouble exec_speed)
+{
+	g_free(job->priv->info.speed);
+	job->priv->info.speed = g_strdup_printf("%lf", exec_speed);
+}
+
 GebrmTask *
 gebrm_job_get_task_from_server(GebrmJob *job,
 			       const gchar *server)
@@ -760,6 +890,12 @@ gebrm_job_set_total_tasks(GebrmJob *job, gint total)
 	job->priv->total = total;
 }
 
+gint
+gebrm_job_get_total_tasks(GebrmJob *job)
+{
+	return job->priv->total;
+}
+
 void
 gebrm_job_set_run_type(GebrmJob *job,
                        const gchar *type)
@@ -880,3 +1016,59 @@ gebrm_job_set_job_counter(GebrmJob *job, const gchar *job_counter)
 {
 	job->priv->info.job_counter = g_strdup(job_counter);
 }
+
+void
+gebrm_job_set_task_steps(GebrmJob *job, gint frac, gint steps, gint ncores)
+{
+	g_return_if_fail(frac > 0);
+
+	if (job->priv->task_steps->len < (guint)frac)
+		g_array_set_size(job->priv->task_steps, frac);
+
+	TaskSteps *task = &g_array_index(job->priv->task_steps, TaskSteps, frac - 1);
+	task->steps = steps;
+	task->ncores = ncores;
+}
+
+gint
+gebrm_job_get_task_steps(GebrmJob *job, gint frac, gint *ncores)
+{
+	if (frac < 1 || (guint)frac > job->priv->task_steps->len)
+		return -1;
+
+	TaskSteps *task = &g_array_index(job->priv->task_steps, TaskSteps, frac - 1);
+	if (task->ncores <= 0)
+		return -1;
+
+	if (ncores)
+		*ncores = task->ncores;
+
+	return task->steps;
+}
+
+void
+gebrm_job_set_eta(GebrmJob *job, gdouble eta)
+{
+	job->priv->eta = eta;
+}
+
+gdouble
+gebrm_job_get_eta(GebrmJob *job)
+{
+	return job->priv->eta;
+}
+
+void
+gebrm_job_add_remainder(GebrmJob *job,
+			gint frac,
+			gint remainder)
+{
+	g_hash_table_insert(job->priv->remainders, GINT_TO_POINTER(remainder), GINT_TO_POINTER(frac));
+}
+
+gboolean
+gebrm_job_is_remainder(GebrmJob *job,
+		       gint frac)
+{
+	return g_hash_table_lookup_extended(job->priv->remainders, GINT_TO_POINTER(frac), NULL, NULL);
+}
@@ -61,6 +61,12 @@ struct _GebrmJobClass {
 			const gchar *output);
 
 	void (*disconnect) (GebrmJob *job);
+
+	void (*chunk_finished) (GebrmJob  *job,
+				GebrmTask *task);
+
+	void (*task_split) (GebrmJob  *job,
+			    GebrmTask *task);
 };
 
 typedef struct {
@@ -97,6 +103,14 @@ GType gebrm_job_get_type() G_GNUC_CONST;
  */
 GebrmJob *gebrm_job_new(void);
 
+/**
+ * gebrm_job_new_with_id:
+ *
+ * Creates a job that was known by @id, for instance before maestro was
+ * restarted. Jobs created afterwards by gebrm_job_new() get other ids.
+ */
+GebrmJob *gebrm_job_new_with_id(const gchar *id);
+
 void gebrm_job_init_details(GebrmJob *job,
 			    GebrmJobInfo *info);
 
@@ -139,8 +153,6 @@ GebrCommJobStatus gebrm_job_get_status(GebrmJob *job);
 
 const gchar *gebrm_job_get_id(GebrmJob *job);
 
-gchar *gebrm_job_get_output(GebrmJob *job);
-
 const gchar *gebrm_job_get_submit_date(GebrmJob *job);
 
 const gchar *gebrm_job_get_last_run_date(GebrmJob *job);
@@ -151,6 +163,14 @@ const gchar *gebrm_job_get_finish_date(GebrmJob *job);
 
 gchar *gebrm_job_get_issues(GebrmJob *job);
 
+/**
+ * gebrm_job_set_issues:
+ *
+ * Sets the issues of a job whose tasks were not appended, the issues of
+ * the tasks are used otherwise.
+ */
+void gebrm_job_set_issues(GebrmJob *job, const gchar *issues);
+
 gboolean gebrm_job_has_issues(GebrmJob *job);
 
 gboolean gebrm_job_close(GebrmJob *job);
@@ -185,7 +205,7 @@ gchar *gebrm_job_get_elapsed_time(GebrmJob *job);
 
 const gchar *gebrm_job_get_exec_speed(GebrmJob *job);
 
-void gebrm_job_set_exec_speed(GebrmJob *job, gint exec_speed);
+void gebrm_job_set_exec_speed(GebrmJob *job, gdouble exec_speed);
 
 GList *gebrm_job_get_list_of_tasks(GebrmJob *job);
 
@@ -229,8 +249,17 @@ const gchar *gebrm_job_get_nprocs(GebrmJob *job);
 
 const gchar *gebrm_job_get_servers_list(GebrmJob *job);
 
+/**
+ * gebrm_job_set_total_tasks:
+ *
+ * Sets the number of tasks of @job. A negative @total means it is not known
+ * yet, because the job is still being distributed in chunks. In this case
+ * the signal #GebrmJob::chunk-finished is emitted for each finished task.
+ */
 void gebrm_job_set_total_tasks(GebrmJob *job, gint total);
 
+gint gebrm_job_get_total_tasks(GebrmJob *job);
+
 void gebrm_job_set_run_type(GebrmJob *job,
                             const gchar *type);
 
@@ -270,6 +299,40 @@ const gchar *gebrm_job_get_job_counter(GebrmJob *job);
 
 void gebrm_job_set_job_counter(GebrmJob *job, const gchar *job_counter);
 
+/**
+ * gebrm_job_set_task_steps:
+ *
+ * Remembers that the task @frac of @job executes @steps loop steps on
+ * @ncores cores.
+ */
+void gebrm_job_set_task_steps(GebrmJob *job, gint frac, gint steps, gint ncores);
+
+/**
+ * gebrm_job_get_task_steps:
+ *
+ * Returns: the loop steps of the task @frac, or -1 if unknown.
+ */
+gint gebrm_job_get_task_steps(GebrmJob *job, gint frac, gint *ncores);
+
+/**
+ * gebrm_job_set_eta:
+ *
+ * Sets the predicted duration of @job, in seconds. Negative if unknown.
+ */
+void gebrm_job_set_eta(GebrmJob *job, gdouble eta);
+
+gdouble gebrm_job_get_eta(GebrmJob *job);
+
+/**
+ * gebrm_job_add_remainder:
+ *
+ * Tells the task @remainder runs the iterations the task @frac did not,
+ * when it was stopped early. Both must finish for the job to finish.
+ */
+void gebrm_job_add_remainder(GebrmJob *job, gint frac, gint remainder);
+
+gboolean gebrm_job_is_remainder(GebrmJob *job, gint frac);
+
 G_END_DECLS
 
 #endif /* __GEBRM_JOB_H__ */
@@ -0,0 +1,361 @@
+/*
+ * gebrm-journal.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-journal.h"
+#include "gebrm-compaction.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+/*
+ * The journal is a text file with one event per line, appended as they
+ * happen:
+ *
+ *   job id <TAB> event <TAB> argument <TAB> ...
+ *
+ * with each field escaped by g_strescape(). Jobs are forgotten when
+ * closed, but their lines stay in the file until it has
+ * GEBRM_COMPACTION_RATIO times more lines than events kept, then it is
+ * rewritten.
+ */
+#define GEBRM_JOURNAL_HEADER "# gebrm journal 1\n"
+#define GEBRM_JOURNAL_COMPACT_MIN_LINES 1024
+
+/* Milliseconds before writing again the events that could not be */
+#define GEBRM_JOURNAL_RETRY_INTERVAL 5000
+
+typedef struct {
+	gchar *id;
+	GPtrArray *events; // gchar **, the event name first
+	gint status;       // Index of the last status event, or -1
+} JournalJob;
+
+struct _GebrmJournal {
+	gchar *path;
+	FILE *fp;
+	GHashTable *jobs; // id -> JournalJob
+	GQueue *order;    // JournalJob, in the order they were submitted
+	GString *pending; // Lines not written yet
+	guint sync_source;
+	gint n_events;
+	gint n_lines;
+};
+
+static void
+journal_job_free(JournalJob *job)
+{
+	g_ptr_array_foreach(job->events, (GFunc)g_strfreev, NULL);
+	g_ptr_array_free(job->events, TRUE);
+	g_free(job->id);
+	g_free(job);
+}
+
+static gchar *
+event_to_line(const gchar *id,
+	      gchar **event)
+{
+	GString *line = g_string_new(NULL);
+	gchar *escaped = g_strescape(id, NULL);
+
+	g_string_append(line, escaped);
+	g_free(escaped);
+
+	for (gint i = 0; event[i]; i++) {
+		escaped = g_strescape(event[i], NULL);
+		g_string_append_c(line, '\t');
+		g_string_append(line, escaped);
+		g_free(escaped);
+	}
+	g_string_append_c(line, '\n');
+
+	return g_string_free(line, FALSE);
+}
+
+/*
+ * Keeps @event, which is taken, in memory. Does not touch the file.
+ *
+ * Returns: %FALSE if @event was discarded.
+ */
+static gboolean
+journal_insert(GebrmJournal *self,
+	       const gchar *id,
+	       gchar **event)
+{
+	JournalJob *job = g_hash_table_lookup(self->jobs, id);
+	const gchar *name = event[0];
+
+	if (g_strcmp0(name, GEBRM_JOURNAL_SUBMIT) == 0) {
+		if (job) {
+			g_queue_remove(self->order, job);
+			self->n_events -= job->events->len;
+			g_hash_table_remove(self->jobs, id);
+		}
+		job = g_new(JournalJob, 1);
+		job->id = g_strdup(id);
+		job->events = g_ptr_array_new();
+		job->status = -1;
+		g_hash_table_insert(self->jobs, job->id, job);
+		g_queue_push_tail(self->order, job);
+	} else if (!job) {
+		g_strfreev(event);
+		return FALSE;
+	} else if (g_strcmp0(name, GEBRM_JOURNAL_CLOSE) == 0) {
+		g_queue_remove(self->order, job);
+		self->n_events -= job->events->len;
+		g_hash_table_remove(self->jobs, id);
+		g_strfreev(event);
+		return TRUE;
+	} else if (g_strcmp0(name, GEBRM_JOURNAL_STATUS) == 0 && job->status >= 0) {
+		g_strfreev(g_ptr_array_index(job->events, job->status));
+		g_ptr_array_index(job->events, job->status) = event;
+		return TRUE;
+	}
+
+	if (g_strcmp0(name, GEBRM_JOURNAL_STATUS) == 0)
+		job->status = job->events->len;
+
+	g_ptr_array_add(job->events, event);
+	self->n_events++;
+
+	return TRUE;
+}
+
+static void
+journal_load(GebrmJournal *self)
+{
+	gchar *contents;
+
+	if (!g_file_get_contents(self->path, &contents, NULL, NULL))
+		return;
+
+	gchar **lines = g_strsplit(contents, "\n", 0);
+	for (gint i = 0; lines[i]; i++) {
+		if (!*lines[i] || *lines[i] == '#')
+			continue;
+
+		self->n_lines++;
+
+		gchar **fields = g_strsplit(lines[i], "\t", 0);
+		if (g_strv_length(fields) < 2) {
+			g_strfreev(fields);
+			continue;
+		}
+
+		for (gint j = 0; fields[j]; j++) {
+			gchar *tmp = fields[j];
+			fields[j] = g_strcompress(tmp);
+			g_free(tmp);
+		}
+
+		/* The event takes the fields after the id */
+		gchar *id = fields[0];
+		journal_insert(self, id, g_strdupv(fields + 1));
+		g_strfreev(fields);
+	}
+	g_strfreev(lines);
+	g_free(contents);
+}
+
+static gboolean
+needs_snapshot(GebrmJournal *self)
+{
+	return gebrm_compaction_needed(self->n_lines, self->n_events,
+				       GEBRM_JOURNAL_COMPACT_MIN_LINES);
+}
+
+static gboolean
+on_sync_timeout(gpointer data)
+{
+	GebrmJournal *self = data;
+
+	self->sync_source = 0;
+
+	/* The events stay pending until they are written */
+	if (!gebrm_journal_sync(self)) {
+		self->sync_source = g_timeout_add(GEBRM_JOURNAL_RETRY_INTERVAL,
+						  on_sync_timeout, self);
+		return FALSE;
+	}
+
+	if (needs_snapshot(self))
+		gebrm_journal_snapshot(self);
+
+	return FALSE;
+}
+
+/* Public methods {{{1 */
+GebrmJournal *
+gebrm_journal_new(const gchar *path)
+{
+	GebrmJournal *self = g_new0(GebrmJournal, 1);
+
+	self->path = g_strdup(path);
+	self->jobs = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+					   (GDestroyNotify)journal_job_free);
+	self->order = g_queue_new();
+	self->pending = g_string_new(NULL);
+
+	journal_load(self);
+
+	if (needs_snapshot(self))
+		gebrm_journal_snapshot(self);
+
+	return self;
+}
+
+void
+gebrm_journal_free(GebrmJournal *self)
+{
+	if (self->sync_source)
+		g_source_remove(self->sync_source);
+
+	gebrm_journal_sync(self);
+
+	if (self->fp)
+		fclose(self->fp);
+
+	g_string_free(self->pending, TRUE);
+	g_queue_free(self->order);
+	g_hash_table_destroy(self->jobs);
+	g_free(self->path);
+	g_free(self);
+}
+
+void
+gebrm_journal_append(GebrmJournal *self,
+		     const gchar *id,
+		     const gchar *event,
+		     ...)
+{
+	g_return_if_fail(id != NULL && event != NULL);
+
+	GPtrArray *array = g_ptr_array_new();
+	const gchar *arg;
+	va_list ap;
+
+	g_ptr_array_add(array, g_strdup(event));
+	va_start(ap, event);
+	while ((arg = va_arg(ap, const gchar *)))
+		g_ptr_array_add(array, g_strdup(arg));
+	va_end(ap);
+	g_ptr_array_add(array, NULL);
+
+	gchar **strv = (gchar **)g_ptr_array_free(array, FALSE);
+	gchar *line = event_to_line(id, strv);
+
+	if (journal_insert(self, id, strv)) {
+		g_string_append(self->pending, line);
+		self->n_lines++;
+
+		if (!self->sync_source)
+			self->sync_source = g_timeout_add(GEBRM_JOURNAL_SYNC_INTERVAL,
+							  on_sync_timeout, self);
+	}
+
+	g_free(line);
+}
+
+void
+gebrm_journal_replay(GebrmJournal *self,
+		     GebrmJournalFunc func,
+		     gpointer user_data)
+{
+	for (GList *i = self->order->head; i; i = i->next) {
+		JournalJob *job = i->data;
+		for (guint j = 0; j < job->events->len; j++)
+			func(job->id, g_ptr_array_index(job->events, j), user_data);
+	}
+}
+
+gboolean
+gebrm_journal_sync(GebrmJournal *self)
+{
+	if (!self->pending->len)
+		return TRUE;
+
+	if (!self->fp) {
+		self->fp = fopen(self->path, "a");
+		if (!self->fp) {
+			g_warning("Could not append to journal file %s", self->path);
+			return FALSE;
+		}
+	}
+
+	/* On failure the file is cut back here, so the events are written
+	 * again whole on the next try */
+	fseek(self->fp, 0, SEEK_END);
+	long offset = ftell(self->fp);
+
+	if ((offset == 0 && fputs(GEBRM_JOURNAL_HEADER, self->fp) == EOF)
+	    || fputs(self->pending->str, self->fp) == EOF
+	    || fflush(self->fp) != 0 || fsync(fileno(self->fp)) != 0) {
+		g_warning("Could not sync journal file %s", self->path);
+		if (offset >= 0 && ftruncate(fileno(self->fp), offset) != 0)
+			g_warning("Could not restore journal file %s", self->path);
+		fclose(self->fp);
+		self->fp = NULL;
+		return FALSE;
+	}
+
+	g_string_truncate(self->pending, 0);
+
+	return TRUE;
+}
+
+gboolean
+gebrm_journal_snapshot(GebrmJournal *self)
+{
+	GError *error = NULL;
+	GString *contents = g_string_new(GEBRM_JOURNAL_HEADER);
+	gint n_lines = 0;
+
+	for (GList *i = self->order->head; i; i = i->next) {
+		JournalJob *job = i->data;
+		for (guint j = 0; j < job->events->len; j++) {
+			gchar *line = event_to_line(job->id, g_ptr_array_index(job->events, j));
+			g_string_append(contents, line);
+			g_free(line);
+			n_lines++;
+		}
+	}
+
+	/* g_file_set_contents() replaces the file atomically, the stream
+	 * would still point to the old one */
+	if (self->fp) {
+		fclose(self->fp);
+		self->fp = NULL;
+	}
+
+	gboolean ok = g_file_set_contents(self->path, contents->str, contents->len, &error);
+	g_string_free(contents, TRUE);
+
+	if (!ok) {
+		g_warning("Could not write snapshot of journal file %s: %s", self->path, error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	/* The pending events are in the snapshot already */
+	g_string_truncate(self->pending, 0);
+	self->n_lines = n_lines;
+
+	return TRUE;
+}
@@ -0,0 +1,115 @@
+/*
+ * gebrm-journal.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_JOURNAL_H__
+#define __GEBRM_JOURNAL_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_JOURNAL_SYNC_INTERVAL:
+ *
+ * Events are written and synced to the disk in batches, at most this
+ * number of milliseconds after they happen.
+ */
+#define GEBRM_JOURNAL_SYNC_INTERVAL 500
+
+/**
+ * GEBRM_JOURNAL_SUBMIT:
+ *
+ * Event that starts a job, which is forgotten at #GEBRM_JOURNAL_CLOSE.
+ * For #GEBRM_JOURNAL_STATUS, only the last event of a job is kept.
+ */
+#define GEBRM_JOURNAL_SUBMIT	"submit"
+#define GEBRM_JOURNAL_DISPATCH	"dispatch"
+#define GEBRM_JOURNAL_STATUS	"status"
+#define GEBRM_JOURNAL_ISSUE	"issue"
+#define GEBRM_JOURNAL_CLOSE	"close"
+
+typedef struct _GebrmJournal GebrmJournal;
+
+/**
+ * GebrmJournalFunc:
+ * @id: the job id
+ * @event: the event name followed by its arguments
+ */
+typedef void (*GebrmJournalFunc) (const gchar *id,
+				  gchar **event,
+				  gpointer user_data);
+
+/**
+ * gebrm_journal_new:
+ *
+ * Loads the journal kept at @path, which is created on the first append.
+ */
+GebrmJournal *gebrm_journal_new(const gchar *path);
+
+/**
+ * gebrm_journal_free:
+ *
+ * Writes the pending events and frees @self.
+ */
+void gebrm_journal_free(GebrmJournal *self);
+
+/**
+ * gebrm_journal_append:
+ *
+ * Records the event @event of the job @id, with the %NULL-terminated list
+ * of string arguments. Events of a job before its #GEBRM_JOURNAL_SUBMIT
+ * are ignored.
+ */
+void gebrm_journal_append(GebrmJournal *self,
+			  const gchar *id,
+			  const gchar *event,
+			  ...) G_GNUC_NULL_TERMINATED;
+
+/**
+ * gebrm_journal_replay:
+ *
+ * Calls @func for each event kept, job by job in the order they were
+ * submitted.
+ */
+void gebrm_journal_replay(GebrmJournal *self,
+			  GebrmJournalFunc func,
+			  gpointer user_data);
+
+/**
+ * gebrm_journal_sync:
+ *
+ * Writes the pending events and waits for the disk.
+ *
+ * Returns: %FALSE on error, in which case the events are kept pending
+ * and written on the next call.
+ */
+gboolean gebrm_journal_sync(GebrmJournal *self);
+
+/**
+ * gebrm_journal_snapshot:
+ *
+ * Rewrites the file of @self with the events still kept. This is done
+ * automatically when the file grows too large.
+ */
+gboolean gebrm_journal_snapshot(GebrmJournal *self);
+
+G_END_DECLS
+
+#endif /* __GEBRM_JOURNAL_H__ */
@@ -0,0 +1,209 @@
+/*
+ * gebrm-output.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-output.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
+
+/*
+ * The whole output is appended to the file, and its last bytes are also
+ * kept in @tail, which starts at @tail_offset. The tail grows up to twice
+ * GEBRM_OUTPUT_TAIL_SIZE before its beginning is dropped, so appending
+ * does not move memory every time.
+ *
+ * If the file can not be written anymore, nothing is dropped from the tail
+ * from then on: the file still has everything before it.
+ */
+struct _GebrmOutput {
+	gchar *path;
+	gint fd;
+	gboolean writable;
+	gsize length;
+	GString *tail;
+	gsize tail_offset;
+};
+
+static gboolean
+write_all(gint fd,
+	  const gchar *data,
+	  gsize len)
+{
+	while (len > 0) {
+		gssize n = write(fd, data, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return FALSE;
+		}
+		data += n;
+		len -= n;
+	}
+	return TRUE;
+}
+
+static gboolean
+read_all(gint fd,
+	 gchar *data,
+	 gsize len,
+	 gsize offset)
+{
+	while (len > 0) {
+		gssize n = pread(fd, data, len, offset);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return FALSE;
+		data += n;
+		len -= n;
+		offset += n;
+	}
+	return TRUE;
+}
+
+/* Public methods {{{1 */
+GebrmOutput *
+gebrm_output_new(const gchar *path)
+{
+	GebrmOutput *self = g_new0(GebrmOutput, 1);
+
+	self->fd = -1;
+	self->tail = g_string_new(NULL);
+
+	if (path) {
+		self->path = g_strdup(path);
+		self->fd = g_open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+		if (self->fd < 0)
+			g_warning("Could not create output file %s: %s", path, g_strerror(errno));
+		self->writable = self->fd >= 0;
+	}
+
+	return self;
+}
+
+void
+gebrm_output_free(GebrmOutput *self)
+{
+	if (self->fd >= 0) {
+		close(self->fd);
+		g_unlink(self->path);
+	}
+
+	g_string_free(self->tail, TRUE);
+	g_free(self->path);
+	g_free(self);
+}
+
+void
+gebrm_output_append(GebrmOutput *self,
+		    const gchar *data,
+		    gsize len)
+{
+	if (self->writable && !write_all(self->fd, data, len)) {
+		g_warning("Could not write output file %s: %s", self->path, g_strerror(errno));
+		self->writable = FALSE;
+
+		/* Whatever part of @data was written is overwritten */
+		lseek(self->fd, self->length, SEEK_SET);
+	}
+
+	g_string_append_len(self->tail, data, len);
+	self->length += len;
+
+	if (self->writable && self->tail->len > 2 * GEBRM_OUTPUT_TAIL_SIZE) {
+		gsize drop = self->tail->len - GEBRM_OUTPUT_TAIL_SIZE;
+		g_string_erase(self->tail, 0, drop);
+		self->tail_offset += drop;
+	}
+}
+
+gsize
+gebrm_output_get_length(GebrmOutput *self)
+{
+	return self->length;
+}
+
+gchar *
+gebrm_output_read(GebrmOutput *self,
+		  gsize offset,
+		  gsize length)
+{
+	if (offset >= self->length)
+		return g_strdup("");
+
+	length = MIN(length, self->length - offset);
+
+	gchar *data = g_malloc(length + 1);
+	gsize from_file = 0;
+
+	if (offset < self->tail_offset) {
+		from_file = MIN(length, self->tail_offset - offset);
+		if (!read_all(self->fd, data, from_file, offset)) {
+			g_warning("Could not read output file %s", self->path);
+			memset(data, ' ', from_file);
+		}
+	}
+
+	if (length > from_file)
+		memcpy(data + from_file,
+		       self->tail->str + (offset + from_file - self->tail_offset),
+		       length - from_file);
+	data[length] = '\0';
+
+	return data;
+}
+
+gchar *
+gebrm_output_read_page(GebrmOutput *self,
+		       gsize *offset,
+		       gsize length)
+{
+	gchar *data = gebrm_output_read(self, *offset, length);
+	gsize end = *offset < self->length ? MIN(length, self->length - *offset) : 0;
+	gsize start = 0;
+
+	/* Continuation bytes of a character started before the page */
+	while (*offset + start > 0 && start < end && (data[start] & 0xC0) == 0x80)
+		start++;
+
+	/* A character cut at the end of the page is left for the next one.
+	 * At the end of the output, the rest of it is still to arrive. */
+	if (*offset + end < self->length) {
+		gsize lead = end;
+		while (lead > start && (data[lead - 1] & 0xC0) == 0x80)
+			lead--;
+		if (lead > start) {
+			guchar c = data[lead - 1];
+			gsize size = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+			if (end - (lead - 1) < size)
+				end = lead - 1;
+		}
+	}
+
+	data[end] = '\0';
+	if (start > 0)
+		memmove(data, data + start, end - start + 1);
+	*offset += start;
+
+	return data;
+}
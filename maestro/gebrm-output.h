@@ -0,0 +1,98 @@
+/*
+ * gebrm-output.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_OUTPUT_H__
+#define __GEBRM_OUTPUT_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_OUTPUT_TAIL_SIZE:
+ *
+ * Number of bytes at the end of the output kept in memory, where most
+ * reads fall. The rest is read back from the file.
+ */
+#define GEBRM_OUTPUT_TAIL_SIZE (64 * 1024)
+
+/**
+ * GEBRM_OUTPUT_PAGE_SIZE:
+ *
+ * Largest number of bytes sent to a client at once.
+ */
+#define GEBRM_OUTPUT_PAGE_SIZE (256 * 1024)
+
+typedef struct _GebrmOutput GebrmOutput;
+
+/**
+ * gebrm_output_new:
+ *
+ * Creates an empty output written to @path, which is truncated. If @path
+ * is %NULL or can not be written, the output is kept in memory.
+ */
+GebrmOutput *gebrm_output_new(const gchar *path);
+
+/**
+ * gebrm_output_free:
+ *
+ * Frees @self and removes its file.
+ */
+void gebrm_output_free(GebrmOutput *self);
+
+void gebrm_output_append(GebrmOutput *self,
+			 const gchar *data,
+			 gsize len);
+
+/**
+ * gebrm_output_get_length:
+ *
+ * Returns: the number of bytes appended to @self.
+ */
+gsize gebrm_output_get_length(GebrmOutput *self);
+
+/**
+ * gebrm_output_read:
+ *
+ * Reads at most @length bytes of @self from @offset, less if the output
+ * is shorter.
+ *
+ * Returns: a newly allocated, nul-terminated string.
+ */
+gchar *gebrm_output_read(GebrmOutput *self,
+			 gsize offset,
+			 gsize length);
+
+/**
+ * gebrm_output_read_page:
+ *
+ * Like gebrm_output_read(), but the page only has whole UTF-8 characters:
+ * @offset is moved forward past the bytes of a character started before
+ * it, and a character cut at the end is left out.
+ *
+ * Returns: a newly allocated, nul-terminated string.
+ */
+gchar *gebrm_output_read_page(GebrmOutput *self,
+			      gsize *offset,
+			      gsize length);
+
+G_END_DECLS
+
+#endif /* __GEBRM_OUTPUT_H__ */
@@ -182,6 +182,23 @@ on_proxy_client_disconnect(GebrCommProtocolSocket *socket,
 	gebrm_proxy_quit(proxy);
 }
 
+/*
+ * Passes the answer of maestro to the request of the client it was
+ * forwarded from, see on_proxy_client_request().
+ */
+static void
+on_proxy_response_received(GebrCommHttpMsg *forwarded,
+			   GebrCommHttpMsg *response,
+			   GebrmProxy *proxy)
+{
+	GebrCommHttpMsg *request = g_object_get_data(G_OBJECT(forwarded), "client-request");
+	GebrCommProtocolSocket *socket = gebrm_client_get_protocol_socket(proxy->client);
+	GebrCommJsonContent *content = gebr_comm_json_content_new(response->content->str);
+
+	gebr_comm_protocol_socket_send_response_to(socket, request, response->status_code, content);
+	gebr_comm_json_content_free(content);
+}
+
 static void
 on_proxy_client_request(GebrCommProtocolSocket *socket,
 			GebrCommHttpMsg *request,
@@ -190,11 +207,18 @@ on_proxy_client_request(GebrCommProtocolSocket *socket,
 	g_return_if_fail(proxy->maestro != NULL);
 
 	GebrCommJsonContent *content = gebr_comm_json_content_new(request->content->str);
-	gebr_comm_protocol_socket_send_request(proxy->maestro->socket,
-					       request->method,
-					       request->url->str,
-					       content);
+	GebrCommHttpMsg *forwarded = gebr_comm_protocol_socket_send_request(proxy->maestro->socket,
+									    request->method,
+									    request->url->str,
+									    content);
 	gebr_comm_json_content_free(content);
+
+	if (forwarded) {
+		g_object_set_data_full(G_OBJECT(forwarded), "client-request",
+				       g_object_ref(request), g_object_unref);
+		g_signal_connect(forwarded, "response-received",
+				 G_CALLBACK(on_proxy_response_received), proxy);
+	}
 }
 
 static void
@@ -0,0 +1,94 @@
+/*
+ * gebrm-sweep.c
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gebrm-sweep.h"
+
+/* Public methods {{{1 */
+gchar **
+gebrm_sweep_split_fields(const gchar *line)
+{
+	gchar **fields = g_strsplit(line, "\t", 0);
+
+	for (gint i = 0; fields[i]; i++) {
+		gchar *tmp = fields[i];
+		fields[i] = g_strcompress(tmp);
+		g_free(tmp);
+	}
+
+	return fields;
+}
+
+GPtrArray *
+gebrm_sweep_get_points(gint n,
+		       const gchar *points,
+		       gboolean product)
+{
+	GPtrArray *rows = g_ptr_array_new_with_free_func((GDestroyNotify)g_strfreev);
+	gchar **lines = g_strsplit(points, "\n", 0);
+
+	for (gint i = 0; lines[i]; i++) {
+		/* Ignores the line break at the end */
+		if (!lines[i + 1] && !*lines[i] && i > 0)
+			break;
+		g_ptr_array_add(rows, gebrm_sweep_split_fields(lines[i]));
+	}
+	g_strfreev(lines);
+
+	if (!product) {
+		for (guint i = 0; i < rows->len; i++)
+			if (g_strv_length(g_ptr_array_index(rows, i)) != n)
+				goto err;
+		if (rows->len > GEBRM_SWEEP_MAX_POINTS)
+			goto err;
+		return rows;
+	}
+
+	if (rows->len != n)
+		goto err;
+
+	gsize total = 1;
+	for (gint i = 0; i < n; i++) {
+		total *= g_strv_length(g_ptr_array_index(rows, i));
+		if (total > GEBRM_SWEEP_MAX_POINTS)
+			goto err;
+	}
+
+	/* Counts in a mixed radix, the last variable changing faster */
+	GPtrArray *combinations = g_ptr_array_new_with_free_func((GDestroyNotify)g_strfreev);
+	for (gsize k = 0; k < total; k++) {
+		gchar **point = g_new0(gchar *, n + 1);
+		gsize rest = k;
+
+		for (gint i = n - 1; i >= 0; i--) {
+			gchar **values = g_ptr_array_index(rows, i);
+			guint len = g_strv_length(values);
+			point[i] = g_strdup(values[rest % len]);
+			rest /= len;
+		}
+		g_ptr_array_add(combinations, point);
+	}
+
+	g_ptr_array_free(rows, TRUE);
+	return combinations;
+
+err:
+	g_ptr_array_free(rows, TRUE);
+	return NULL;
+}
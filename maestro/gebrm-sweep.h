@@ -0,0 +1,61 @@
+/*
+ * gebrm-sweep.h
+ * This file is part of GêBR Project
+ *
+ * Copyright (C) 2012 - GêBR Team <www.gebrproject.com>
+ *
+ * GêBR Project is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * GêBR Project is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GêBR Project. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEBRM_SWEEP_H__
+#define __GEBRM_SWEEP_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GEBRM_SWEEP_MAX_POINTS:
+ *
+ * Largest number of points, and so of jobs, of a parameter sweep.
+ */
+#define GEBRM_SWEEP_MAX_POINTS 10000
+
+/**
+ * gebrm_sweep_split_fields:
+ *
+ * Splits a line of tab separated fields, escaped by g_strescape().
+ *
+ * Returns: a newly allocated %NULL-terminated array of strings.
+ */
+gchar **gebrm_sweep_split_fields(const gchar *line);
+
+/**
+ * gebrm_sweep_get_points:
+ *
+ * Parses the table of values @points of a sweep over @n variables, one
+ * point per line. If @product is %TRUE, line i has the values of variable i
+ * instead, and the points are all of their combinations, the last variable
+ * changing faster.
+ *
+ * Returns: an array of points, each one a list of @n values, or %NULL if
+ * the table is malformed or has more than #GEBRM_SWEEP_MAX_POINTS points.
+ */
+GPtrArray *gebrm_sweep_get_points(gint n,
+				  const gchar *points,
+				  gboolean product);
+
+G_END_DECLS
+
+#endif /* __GEBRM_SWEEP_H__ */
@@ -29,6 +29,7 @@
 #include <libgebr/date.h>
 
 #include "gebrm-marshal.h"
+#include "gebrm-output.h"
 
 enum {
 	OUTPUT,
@@ -48,13 +49,19 @@ struct _GebrmTaskPriv {
 	GString *issues;
 	GString *cmd_line;
 	GString *moab_jid;
-	GString *output;
+	GebrmOutput *output;
+	glong peak_memory;
+	gdouble cpu_time;
+	gint done_steps;
+	gboolean split;
 };
 
 G_DEFINE_TYPE(GebrmTask, gebrm_task, G_TYPE_OBJECT);
 
 static GHashTable *tasks_map = NULL;
 
+static gchar *output_dir = NULL;
+
 static GHashTable *
 get_tasks_map(void)
 {
@@ -73,7 +80,7 @@ gebrm_task_free(GebrmTask *task)
 	g_string_free(task->priv->issues, TRUE);
 	g_string_free(task->priv->cmd_line, TRUE);
 	g_string_free(task->priv->moab_jid, TRUE);
-	g_string_free(task->priv->output, TRUE);
+	gebrm_output_free(task->priv->output);
 }
 
 static void
@@ -91,12 +98,12 @@ static void gebrm_task_init(GebrmTask *task)
 	                                         GebrmTaskPriv);
 
 	task->priv->status = JOB_STATUS_INITIAL;
-	task->priv->output = g_string_new(NULL);
 	task->priv->start_date = g_string_new(NULL);
 	task->priv->finish_date = g_string_new(NULL);
 	task->priv->issues = g_string_new(NULL);
 	task->priv->cmd_line = g_string_new(NULL);
 	task->priv->moab_jid = g_string_new(NULL);
+	task->priv->done_steps = -1;
 }
 
 static void gebrm_task_class_init(GebrmTaskClass *klass)
@@ -153,6 +160,16 @@ gebrm_task_new(GebrmDaemon  *server,
 	task->priv->rid = g_strdup(rid);
 	task->priv->frac = atoi(frac);
 
+	gchar *path = NULL;
+	if (output_dir) {
+		gchar *name = g_strcanon(gebrm_task_get_id(task),
+					 G_CSET_a_2_z G_CSET_A_2_Z G_CSET_DIGITS "-.", '_');
+		path = g_build_filename(output_dir, name, NULL);
+		g_free(name);
+	}
+	task->priv->output = gebrm_output_new(path);
+	g_free(path);
+
 	g_debug("Inserting task %s, rid %s into TASKS hash table (%s)",
 		frac, rid, gebrm_task_get_id(task));
 	g_hash_table_insert(get_tasks_map(), gebrm_task_get_id(task), task);
@@ -231,7 +248,7 @@ void
 gebrm_task_emit_output_signal(GebrmTask *task,
 			     const gchar *output)
 {
-	g_string_append(task->priv->output, output);
+	gebrm_output_append(task->priv->output, output, strlen(output));
 	g_signal_emit(task, signals[OUTPUT], 0, output);
 }
 
@@ -288,10 +305,33 @@ gebrm_task_get_issues(GebrmTask *task)
 {
 	return task->priv->issues->str;
 }
-const gchar *
-gebrm_task_get_output(GebrmTask *task)
+gsize
+gebrm_task_get_output_length(GebrmTask *task)
+{
+	return gebrm_output_get_length(task->priv->output);
+}
+
+gchar *
+gebrm_task_read_output(GebrmTask *task,
+		       gsize offset,
+		       gsize length)
+{
+	return gebrm_output_read(task->priv->output, offset, length);
+}
+
+gchar *
+gebrm_task_read_output_page(GebrmTask *task,
+			    gsize *offset,
+			    gsize length)
+{
+	return gebrm_output_read_page(task->priv->output, offset, length);
+}
+
+void
+gebrm_task_set_output_dir(const gchar *dir)
 {
-	return task->priv->output->str;
+	g_free(output_dir);
+	output_dir = g_strdup(dir);
 }
 
 void
@@ -306,15 +346,68 @@ gebrm_task_close(GebrmTask *task, const gchar *rid)
 
 	g_hash_table_remove(get_tasks_map(), tid);
 	g_free(tid);
+
+	/* The file of the output goes away with the job */
+	gebrm_output_free(task->priv->output);
+	task->priv->output = gebrm_output_new(NULL);
 }
 
 void
 gebrm_task_kill(GebrmTask *task)
 {
 	GebrCommServer *server = gebrm_daemon_get_server(task->priv->daemon);
+	gchar *frac = g_strdup_printf("%d", task->priv->frac);
+
+	/* Other tasks of the job may be running at the same daemon */
+	gebr_comm_protocol_socket_oldmsg_send(server->socket, FALSE,
+					      gebr_comm_protocol_defs.kfr_def, 2,
+					      task->priv->rid, frac);
+	g_free(frac);
+}
+
+void
+gebrm_task_preempt(GebrmTask *task,
+		   gboolean stop)
+{
+	GebrCommServer *server = gebrm_daemon_get_server(task->priv->daemon);
+	gchar *frac = g_strdup_printf("%d", task->priv->frac);
+
 	gebr_comm_protocol_socket_oldmsg_send(server->socket, FALSE,
-					      gebr_comm_protocol_defs.kil_def, 1,
-					      task->priv->rid);
+					      gebr_comm_protocol_defs.pre_def, 3,
+					      task->priv->rid, frac, stop ? "1" : "0");
+	g_free(frac);
+}
+
+void
+gebrm_task_split(GebrmTask *task)
+{
+	GebrCommServer *server = gebrm_daemon_get_server(task->priv->daemon);
+	gchar *frac = g_strdup_printf("%d", task->priv->frac);
+
+	gebr_comm_protocol_socket_oldmsg_send(server->socket, FALSE,
+					      gebr_comm_protocol_defs.spl_def, 2,
+					      task->priv->rid, frac);
+	task->priv->split = TRUE;
+	g_free(frac);
+}
+
+gboolean
+gebrm_task_is_split(GebrmTask *task)
+{
+	return task->priv->split;
+}
+
+void
+gebrm_task_set_done_steps(GebrmTask *task,
+			  gint steps)
+{
+	task->priv->done_steps = steps;
+}
+
+gint
+gebrm_task_get_done_steps(GebrmTask *task)
+{
+	return task->priv->done_steps;
 }
 
 GebrmDaemon *
@@ -328,3 +421,29 @@ gebrm_task_get_server(GebrmTask *task)
 {
 	return gebrm_daemon_get_server(task->priv->daemon);
 }
+
+void
+gebrm_task_set_peak_memory(GebrmTask *task,
+			   glong kb)
+{
+	task->priv->peak_memory = kb;
+}
+
+glong
+gebrm_task_get_peak_memory(GebrmTask *task)
+{
+	return task->priv->peak_memory;
+}
+
+void
+gebrm_task_set_cpu_time(GebrmTask *task,
+			gdouble seconds)
+{
+	task->priv->cpu_time = seconds;
+}
+
+gdouble
+gebrm_task_get_cpu_time(GebrmTask *task)
+{
+	return task->priv->cpu_time;
+}
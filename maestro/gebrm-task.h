@@ -116,12 +116,78 @@ const gchar *gebrm_task_get_finish_date(GebrmTask *task);
 
 const gchar *gebrm_task_get_issues(GebrmTask *task);
 
-const gchar *gebrm_task_get_output(GebrmTask *task);
+/**
+ * gebrm_task_get_output_length:
+ *
+ * Returns: the number of bytes of output @task has, see
+ * gebrm_task_read_output().
+ */
+gsize gebrm_task_get_output_length(GebrmTask *task);
+
+/**
+ * gebrm_task_read_output:
+ *
+ * Reads at most @length bytes of the output of @task from @offset.
+ *
+ * Returns: a newly allocated string.
+ */
+gchar *gebrm_task_read_output(GebrmTask *task,
+			      gsize offset,
+			      gsize length);
+
+/**
+ * gebrm_task_read_output_page:
+ *
+ * Reads a page of whole characters of the output of @task, see
+ * gebrm_output_read_page().
+ */
+gchar *gebrm_task_read_output_page(GebrmTask *task,
+				   gsize *offset,
+				   gsize length);
+
+/**
+ * gebrm_task_set_output_dir:
+ *
+ * Sets the directory where the output of the tasks created from now on
+ * is written. Without one, it is kept in memory.
+ */
+void gebrm_task_set_output_dir(const gchar *dir);
 
 void gebrm_task_close(GebrmTask *task, const gchar *rid);
 
 void gebrm_task_kill(GebrmTask *task);
 
+/**
+ * gebrm_task_preempt:
+ *
+ * Asks the daemon of @task to stop its processes if @stop is %TRUE, or to
+ * let them continue otherwise.
+ */
+void gebrm_task_preempt(GebrmTask *task,
+			gboolean stop);
+
+/**
+ * gebrm_task_split:
+ *
+ * Asks the daemon of @task to stop it at the next batch boundary. The
+ * daemon then reports how many iterations were done, see
+ * gebrm_task_get_done_steps().
+ */
+void gebrm_task_split(GebrmTask *task);
+
+gboolean gebrm_task_is_split(GebrmTask *task);
+
+void gebrm_task_set_done_steps(GebrmTask *task,
+			       gint steps);
+
+/**
+ * gebrm_task_get_done_steps:
+ *
+ * Returns: the number of iterations @task ran before it was stopped by
+ * gebrm_task_split(), or -1 if it was not stopped early.
+ */
+gint gebrm_task_get_done_steps(GebrmTask *task);
+
 const gchar *gebrm_task_get_queue(GebrmTask *task);
 
 GebrmDaemon *gebrm_task_get_daemon(GebrmTask *task);
@@ -132,6 +198,34 @@ const gchar *gebrm_task_get_niceness(GebrmTask *task);
 
 const gchar *gebrm_task_get_last_run_date(GebrmTask *task);
 
+/**
+ * gebrm_task_set_peak_memory:
+ * @kb: The largest resident memory used by the task, in kB
+ */
+void gebrm_task_set_peak_memory(GebrmTask *task,
+				glong kb);
+
+/**
+ * gebrm_task_get_peak_memory:
+ *
+ * Returns: the peak memory of @task in kB, or 0 if it is not known yet.
+ */
+glong gebrm_task_get_peak_memory(GebrmTask *task);
+
+/**
+ * gebrm_task_set_cpu_time:
+ * @seconds: The user and system time of the task and its children
+ */
+void gebrm_task_set_cpu_time(GebrmTask *task,
+			     gdouble seconds);
+
+/**
+ * gebrm_task_get_cpu_time:
+ *
+ * Returns: the cpu time of @task in seconds, or 0 if it is not known yet.
+ */
+gdouble gebrm_task_get_cpu_time(GebrmTask *task);
+
 G_END_DECLS
 
 #endif /* __GEBRM_TASK_H__ */
@@ -0,0 +1,211 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * The daemons are never really connected: the connect function only
+ * records the calls, and the tests report the state changes by hand.
+ */
+
+#include <glib.h>
+
+#include "../gebrm-connect-scheduler.h"
+
+typedef struct {
+	GList *started;
+	gboolean refuse;
+	guint done;
+} Fixture;
+
+static gboolean
+fake_connect(GebrmDaemon *daemon,
+	     gpointer user_data)
+{
+	Fixture *f = user_data;
+	f->started = g_list_append(f->started, daemon);
+	return !f->refuse;
+}
+
+static void
+fake_done(gpointer user_data)
+{
+	Fixture *f = user_data;
+	f->done++;
+}
+
+static GebrmDaemon **
+daemons_new(guint n)
+{
+	GebrmDaemon **daemons = g_new(GebrmDaemon *, n);
+	for (guint i = 0; i < n; i++) {
+		gchar *addr = g_strdup_printf("node%u", i);
+		daemons[i] = gebrm_daemon_new(addr);
+		g_free(addr);
+	}
+	return daemons;
+}
+
+static void
+daemons_free(GebrmDaemon **daemons, guint n)
+{
+	for (guint i = 0; i < n; i++)
+		g_object_unref(daemons[i]);
+	g_free(daemons);
+}
+
+static void
+test_connect_scheduler_parallel(void)
+{
+	Fixture f = { NULL, FALSE, 0 };
+	GebrmDaemon **d = daemons_new(3);
+	GebrmConnectScheduler *s = gebrm_connect_scheduler_new(2, fake_connect, fake_done, &f);
+
+	for (guint i = 0; i < 3; i++)
+		gebrm_connect_scheduler_push(s, d[i]);
+
+	/* Only two connect at once, in the order they were pushed */
+	g_assert_cmpuint(g_list_length(f.started), ==, 2);
+	g_assert(f.started->data == d[0]);
+	g_assert(f.started->next->data == d[1]);
+
+	gebrm_connect_scheduler_state_changed(s, d[0], SERVER_STATE_CONNECT);
+	g_assert_cmpuint(g_list_length(f.started), ==, 2);
+
+	gebrm_connect_scheduler_state_changed(s, d[0], SERVER_STATE_LOGGED);
+	g_assert_cmpuint(g_list_length(f.started), ==, 3);
+	g_assert(g_list_last(f.started)->data == d[2]);
+	g_assert(gebrm_daemon_get_time_to_ready(d[0]) >= 0);
+
+	gebrm_connect_scheduler_state_changed(s, d[1], SERVER_STATE_LOGGED);
+	g_assert(gebrm_connect_scheduler_is_running(s));
+	g_assert_cmpuint(f.done, ==, 0);
+
+	gebrm_connect_scheduler_state_changed(s, d[2], SERVER_STATE_LOGGED);
+	g_assert(!gebrm_connect_scheduler_is_running(s));
+	g_assert_cmpuint(f.done, ==, 1);
+
+	gebrm_connect_scheduler_free(s);
+	g_list_free(f.started);
+	daemons_free(d, 3);
+}
+
+static void
+test_connect_scheduler_push_twice(void)
+{
+	Fixture f = { NULL, FALSE, 0 };
+	GebrmDaemon **d = daemons_new(1);
+	GebrmConnectScheduler *s = gebrm_connect_scheduler_new(1, fake_connect, fake_done, &f);
+
+	gebrm_connect_scheduler_push(s, d[0]);
+	gebrm_connect_scheduler_push(s, d[0]);
+	g_assert_cmpuint(g_list_length(f.started), ==, 1);
+
+	gebrm_connect_scheduler_state_changed(s, d[0], SERVER_STATE_LOGGED);
+	g_assert(!gebrm_connect_scheduler_is_running(s));
+
+	/* Once connected it can be pushed again */
+	gebrm_connect_scheduler_push(s, d[0]);
+	g_assert_cmpuint(g_list_length(f.started), ==, 2);
+
+	gebrm_connect_scheduler_free(s);
+	g_list_free(f.started);
+	daemons_free(d, 1);
+}
+
+static void
+test_connect_scheduler_refused(void)
+{
+	Fixture f = { NULL, TRUE, 0 };
+	GebrmDaemon **d = daemons_new(3);
+	GebrmConnectScheduler *s = gebrm_connect_scheduler_new(1, fake_connect, fake_done, &f);
+
+	for (guint i = 0; i < 3; i++)
+		gebrm_connect_scheduler_push(s, d[i]);
+
+	/* Refused daemons give their slot to the next ones right away */
+	g_assert_cmpuint(g_list_length(f.started), ==, 3);
+	g_assert(!gebrm_connect_scheduler_is_running(s));
+
+	gebrm_connect_scheduler_free(s);
+	g_list_free(f.started);
+	daemons_free(d, 3);
+}
+
+static void
+test_connect_scheduler_disconnected(void)
+{
+	Fixture f = { NULL, FALSE, 0 };
+	GebrmDaemon **d = daemons_new(2);
+	GebrmConnectScheduler *s = gebrm_connect_scheduler_new(1, fake_connect, fake_done, &f);
+
+	gebrm_connect_scheduler_push(s, d[0]);
+	gebrm_connect_scheduler_push(s, d[1]);
+	g_assert_cmpuint(g_list_length(f.started), ==, 1);
+
+	/* A failure on ssh is not retried */
+	gebrm_connect_scheduler_state_changed(s, d[0], SERVER_STATE_DISCONNECTED);
+	g_assert_cmpuint(g_list_length(f.started), ==, 2);
+	g_assert(f.started->next->data == d[1]);
+
+	gebrm_connect_scheduler_state_changed(s, d[1], SERVER_STATE_LOGGED);
+	g_assert(!gebrm_connect_scheduler_is_running(s));
+	g_assert_cmpuint(f.done, ==, 1);
+
+	gebrm_connect_scheduler_free(s);
+	g_list_free(f.started);
+	daemons_free(d, 2);
+}
+
+static void
+test_connect_scheduler_paused(void)
+{
+	Fixture f = { NULL, FALSE, 0 };
+	GebrmDaemon **d = daemons_new(2);
+	GebrmConnectScheduler *s = gebrm_connect_scheduler_new(2, fake_connect, fake_done, &f);
+
+	gebrm_connect_scheduler_set_paused(s, TRUE);
+	gebrm_connect_scheduler_push(s, d[0]);
+	gebrm_connect_scheduler_push(s, d[1]);
+	g_assert(f.started == NULL);
+	g_assert(gebrm_connect_scheduler_is_running(s));
+
+	gebrm_connect_scheduler_cancel(s, d[0]);
+	gebrm_connect_scheduler_set_paused(s, FALSE);
+	g_assert_cmpuint(g_list_length(f.started), ==, 1);
+	g_assert(f.started->data == d[1]);
+
+	gebrm_connect_scheduler_cancel(s, d[1]);
+	g_assert(!gebrm_connect_scheduler_is_running(s));
+	g_assert_cmpuint(f.done, ==, 1);
+
+	gebrm_connect_scheduler_free(s);
+	g_list_free(f.started);
+	daemons_free(d, 2);
+}
+
+int main(int argc, char *argv[])
+{
+	g_type_init();
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/maestro/connect-scheduler/parallel", test_connect_scheduler_parallel);
+	g_test_add_func("/maestro/connect-scheduler/push-twice", test_connect_scheduler_push_twice);
+	g_test_add_func("/maestro/connect-scheduler/refused", test_connect_scheduler_refused);
+	g_test_add_func("/maestro/connect-scheduler/disconnected", test_connect_scheduler_disconnected);
+	g_test_add_func("/maestro/connect-scheduler/paused", test_connect_scheduler_paused);
+
+	return g_test_run();
+}
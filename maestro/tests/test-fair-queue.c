@@ -0,0 +1,242 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <glib.h>
+
+#include "../gebrm-fair-queue.h"
+
+#define ITEM(i) GINT_TO_POINTER(i)
+
+static void
+test_fair_queue_fifo(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+	const gchar *name = NULL;
+
+	g_assert(gebrm_fair_queue_pop(queue, &name) == NULL);
+
+	for (gint i = 1; i <= 3; i++)
+		gebrm_fair_queue_push(queue, NULL, "a", ITEM(i));
+	g_assert_cmpuint(gebrm_fair_queue_get_length(queue), ==, 3);
+
+	for (gint i = 1; i <= 3; i++) {
+		g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(i));
+		g_assert_cmpstr(name, ==, GEBRM_FAIR_QUEUE_DEFAULT);
+	}
+	g_assert_cmpuint(gebrm_fair_queue_get_length(queue), ==, 0);
+
+	gebrm_fair_queue_free(queue);
+}
+
+static void
+test_fair_queue_weights(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+	gint served_a = 0, served_b = 0;
+
+	gebrm_fair_queue_set_weight(queue, "a", 2);
+
+	/* Items of "a" are 1..6, of "b" are 11..16 */
+	for (gint i = 1; i <= 6; i++) {
+		gebrm_fair_queue_push(queue, NULL, "a", ITEM(i));
+		gebrm_fair_queue_push(queue, NULL, "b", ITEM(10 + i));
+	}
+
+	for (gint i = 0; i < 6; i++) {
+		gint item = GPOINTER_TO_INT(gebrm_fair_queue_pop(queue, NULL));
+		if (item < 10)
+			served_a++;
+		else
+			served_b++;
+	}
+
+	/* Twice the weight, twice the share */
+	g_assert_cmpint(served_a, ==, 4);
+	g_assert_cmpint(served_b, ==, 2);
+
+	gebrm_fair_queue_free(queue);
+}
+
+static void
+test_fair_queue_idle_client(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+
+	for (gint i = 1; i <= 4; i++)
+		gebrm_fair_queue_push(queue, NULL, "a", ITEM(i));
+	for (gint i = 1; i <= 3; i++)
+		gebrm_fair_queue_pop(queue, NULL);
+
+	/* A client arriving late starts where the last one served was, so
+	 * it gets no credit for the time it was idle: both alternate */
+	gebrm_fair_queue_push(queue, NULL, "b", ITEM(11));
+	gebrm_fair_queue_push(queue, NULL, "b", ITEM(12));
+	gebrm_fair_queue_push(queue, NULL, "a", ITEM(5));
+
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == ITEM(11));
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == ITEM(4));
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == ITEM(12));
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == ITEM(5));
+
+	gebrm_fair_queue_free(queue);
+}
+
+static void
+test_fair_queue_priorities(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+	const gchar *name = NULL;
+
+	gebrm_fair_queue_set_queue(queue, "urgent", 10, 0);
+	gebrm_fair_queue_set_queue(queue, "batch", -5, 0);
+	g_assert_cmpint(gebrm_fair_queue_get_priority(queue, "urgent"), ==, 10);
+	g_assert_cmpint(gebrm_fair_queue_get_priority(queue, "unknown"), ==, 0);
+
+	gebrm_fair_queue_push(queue, "batch", "a", ITEM(1));
+	gebrm_fair_queue_push(queue, NULL, "a", ITEM(2));
+	gebrm_fair_queue_push(queue, "urgent", "a", ITEM(3));
+
+	GList *list = gebrm_fair_queue_list(queue);
+	g_assert_cmpuint(g_list_length(list), ==, 3);
+	g_assert(g_list_nth_data(list, 0) == ITEM(3));
+	g_assert(g_list_nth_data(list, 1) == ITEM(2));
+	g_assert(g_list_nth_data(list, 2) == ITEM(1));
+	g_list_free(list);
+
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(3));
+	g_assert_cmpstr(name, ==, "urgent");
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(2));
+	g_assert_cmpstr(name, ==, GEBRM_FAIR_QUEUE_DEFAULT);
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(1));
+	g_assert_cmpstr(name, ==, "batch");
+
+	gebrm_fair_queue_free(queue);
+}
+
+static void
+test_fair_queue_same_priority(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+	const gchar *name = NULL;
+
+	gebrm_fair_queue_set_queue(queue, "b", 5, 0);
+	gebrm_fair_queue_set_queue(queue, "a", 5, 0);
+
+	gebrm_fair_queue_push(queue, "b", "x", ITEM(1));
+	gebrm_fair_queue_push(queue, "a", "x", ITEM(2));
+	gebrm_fair_queue_push(queue, "b", "x", ITEM(3));
+	gebrm_fair_queue_push(queue, "a", "x", ITEM(4));
+
+	/* Never served, so ordered by name */
+	GList *list = gebrm_fair_queue_list(queue);
+	g_assert(g_list_nth_data(list, 0) == ITEM(2));
+	g_assert(g_list_nth_data(list, 1) == ITEM(4));
+	g_assert(g_list_nth_data(list, 2) == ITEM(1));
+	g_assert(g_list_nth_data(list, 3) == ITEM(3));
+	g_list_free(list);
+
+	g_assert(gebrm_fair_queue_peek(queue) == ITEM(2));
+	g_assert_cmpuint(gebrm_fair_queue_get_length(queue), ==, 4);
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(2));
+	g_assert_cmpstr(name, ==, "a");
+
+	/* Then the least recently served goes first */
+	g_assert(gebrm_fair_queue_peek(queue) == ITEM(1));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(1));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(4));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(3));
+	g_assert(gebrm_fair_queue_peek(queue) == NULL);
+
+	gebrm_fair_queue_free(queue);
+}
+
+static void
+test_fair_queue_max_running(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+	const gchar *name = NULL;
+
+	gebrm_fair_queue_set_queue(queue, "urgent", 10, 1);
+
+	gebrm_fair_queue_push(queue, "urgent", "a", ITEM(1));
+	gebrm_fair_queue_push(queue, "urgent", "a", ITEM(2));
+	gebrm_fair_queue_push(queue, NULL, "a", ITEM(3));
+
+	g_assert(!gebrm_fair_queue_is_full(queue, "urgent"));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(1));
+	g_assert(gebrm_fair_queue_is_full(queue, "urgent"));
+
+	/* The full queue lets the others go first */
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(3));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == NULL);
+	g_assert_cmpuint(gebrm_fair_queue_get_length(queue), ==, 1);
+
+	gebrm_fair_queue_release(queue, "urgent");
+	g_assert(!gebrm_fair_queue_is_full(queue, "urgent"));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(2));
+	g_assert_cmpstr(name, ==, "urgent");
+
+	/* Raising the limit admits more right away */
+	gebrm_fair_queue_push(queue, "urgent", "a", ITEM(4));
+	g_assert(gebrm_fair_queue_pop(queue, &name) == NULL);
+	gebrm_fair_queue_set_queue(queue, "urgent", 10, 2);
+	g_assert(gebrm_fair_queue_pop(queue, &name) == ITEM(4));
+
+	gebrm_fair_queue_free(queue);
+}
+
+static void
+test_fair_queue_remove(void)
+{
+	GebrmFairQueue *queue = gebrm_fair_queue_new();
+
+	gebrm_fair_queue_push(queue, NULL, "a", ITEM(1));
+	gebrm_fair_queue_push(queue, NULL, "a", ITEM(2));
+	gebrm_fair_queue_push(queue, NULL, "b", ITEM(3));
+
+	g_assert(gebrm_fair_queue_remove(queue, ITEM(2)));
+	g_assert(!gebrm_fair_queue_remove(queue, ITEM(2)));
+	g_assert_cmpuint(gebrm_fair_queue_get_length(queue), ==, 2);
+
+	/* Removing the only item of a client deactivates it */
+	g_assert(gebrm_fair_queue_remove(queue, ITEM(3)));
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == ITEM(1));
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == NULL);
+
+	/* Popped items are no longer in the queue */
+	g_assert(!gebrm_fair_queue_remove(queue, ITEM(1)));
+
+	/* Removed items can be pushed again */
+	gebrm_fair_queue_push(queue, NULL, "a", ITEM(2));
+	g_assert(gebrm_fair_queue_pop(queue, NULL) == ITEM(2));
+
+	gebrm_fair_queue_free(queue);
+}
+
+int main(int argc, char *argv[])
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/maestro/fair-queue/fifo", test_fair_queue_fifo);
+	g_test_add_func("/maestro/fair-queue/weights", test_fair_queue_weights);
+	g_test_add_func("/maestro/fair-queue/idle-client", test_fair_queue_idle_client);
+	g_test_add_func("/maestro/fair-queue/priorities", test_fair_queue_priorities);
+	g_test_add_func("/maestro/fair-queue/same-priority", test_fair_queue_same_priority);
+	g_test_add_func("/maestro/fair-queue/max-running", test_fair_queue_max_running);
+	g_test_add_func("/maestro/fair-queue/remove", test_fair_queue_remove);
+
+	return g_test_run();
+}
@@ -0,0 +1,199 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include "../gebrm-history.h"
+#include "test-utils.h"
+
+static void
+append(GebrmHistory *history,
+       const gchar *key,
+       gint ncores,
+       gint iterations,
+       gdouble wall_time,
+       glong peak_memory)
+{
+	GebrmHistoryRecord record = { 0, };
+
+	record.daemon = (gchar *)"node";
+	record.cpu_class = (gchar *)"xeon";
+	record.ncores = ncores;
+	record.iterations = iterations;
+	record.wall_time = wall_time;
+	record.date = 1000;
+	record.peak_memory = peak_memory;
+
+	gebrm_history_append(history, key, &record);
+}
+
+static void
+test_history_round_trip(void)
+{
+	gchar *path = test_path_new("history");
+	GebrmHistory *history = gebrm_history_new(path);
+
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), <, 0);
+
+	append(history, "flow", 2, 10, 5, 4000);
+	append(history, "flow", 4, 10, 5, 0);
+	append(history, "flow", 0, 10, 5, 0);	/* ignored */
+
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 1.5);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "opteron"), <, 0);
+	g_assert_cmpint(gebrm_history_get_memory(history, "flow"), ==, 2000);
+	gebrm_history_free(history);
+
+	/* Header and two records */
+	g_assert_cmpint(test_count_lines(path), ==, 3);
+
+	history = gebrm_history_new(path);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 1.5);
+	g_assert_cmpint(gebrm_history_get_memory(history, "flow"), ==, 2000);
+
+	g_assert(gebrm_history_compact(history));
+	gebrm_history_free(history);
+	g_assert_cmpint(test_count_lines(path), ==, 3);
+
+	history = gebrm_history_new(path);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 1.5);
+	gebrm_history_free(history);
+
+	test_path_free(path);
+}
+
+static void
+test_history_records_per_flow(void)
+{
+	gchar *path = test_path_new("history");
+	GebrmHistory *history = gebrm_history_new(path);
+
+	/* The slow first record is dropped by the following ones */
+	append(history, "flow", 1, 1, 1000, 0);
+	for (gint i = 0; i < GEBRM_HISTORY_RECORDS_PER_FLOW; i++)
+		append(history, "flow", 1, 1, 2, 0);
+
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 2);
+	gebrm_history_free(history);
+
+	/* The dropped record is still in the file, but not loaded */
+	history = gebrm_history_new(path);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 2);
+	gebrm_history_free(history);
+
+	test_path_free(path);
+}
+
+static void
+test_history_max_flows(void)
+{
+	gchar *path = test_path_new("history");
+	GebrmHistory *history = gebrm_history_new(path);
+
+	for (gint i = 0; i <= GEBRM_HISTORY_MAX_FLOWS; i++) {
+		gchar *key = g_strdup_printf("flow%d", i);
+		append(history, key, 1, 1, 1, 0);
+		g_free(key);
+
+		/* Keeps the first flow in use */
+		if (i == 1)
+			append(history, "flow0", 1, 1, 1, 0);
+	}
+
+	/* The least recently updated flow is forgotten */
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow0", "xeon"), ==, 1);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow1", "xeon"), <, 0);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow2", "xeon"), ==, 1);
+	gebrm_history_free(history);
+
+	history = gebrm_history_new(path);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow0", "xeon"), ==, 1);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow1", "xeon"), <, 0);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow2", "xeon"), ==, 1);
+	gebrm_history_free(history);
+
+	test_path_free(path);
+}
+
+static void
+test_history_compaction(void)
+{
+	gchar *path = test_path_new("history");
+	GebrmHistory *history = gebrm_history_new(path);
+
+	for (gint i = 0; i < 4 * GEBRM_HISTORY_RECORDS_PER_FLOW; i++)
+		append(history, "flow", 1, 1, 1, 0);
+	gebrm_history_free(history);
+
+	/* The file never grows beyond twice the records kept */
+	g_assert_cmpint(test_count_lines(path) - 1, <=, 2 * GEBRM_HISTORY_RECORDS_PER_FLOW);
+
+	history = gebrm_history_new(path);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 1);
+	gebrm_history_free(history);
+
+	test_path_free(path);
+}
+
+static void
+test_history_file_format(void)
+{
+	gchar *path = test_path_new("history");
+	const gchar *contents =
+		"# gebrm history 1\n"
+		"flow\tnode\txeon\t2\t10\t5.000\t9.500\t1000\t4000\n"
+		"flow\tnode\txeon\t2\t10\n";	/* skipped */
+
+	g_assert(g_file_set_contents(path, contents, -1, NULL));
+
+	GebrmHistory *history = gebrm_history_new(path);
+	g_assert_cmpfloat(gebrm_history_get_cost(history, "flow", "xeon"), ==, 1.0);
+	g_assert_cmpint(gebrm_history_get_memory(history, "flow"), ==, 2000);
+
+	GebrmHistoryRecord record = { 0, };
+	record.daemon = (gchar *)"node";
+	record.cpu_class = (gchar *)"xeon";
+	record.ncores = 2;
+	record.iterations = 10;
+	record.wall_time = 5;
+	record.cpu_time = 7.25;
+	record.date = 2000;
+	gebrm_history_append(history, "flow", &record);
+	gebrm_history_free(history);
+
+	gchar *written;
+	g_assert(g_file_get_contents(path, &written, NULL, NULL));
+	g_assert(strstr(written, "flow\tnode\txeon\t2\t10\t5.000\t7.250\t2000\t0\n") != NULL);
+	g_free(written);
+	g_assert_cmpint(test_count_lines(path), ==, 4);
+
+	test_path_free(path);
+}
+
+int main(int argc, char *argv[])
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/maestro/history/round-trip", test_history_round_trip);
+	g_test_add_func("/maestro/history/records-per-flow", test_history_records_per_flow);
+	g_test_add_func("/maestro/history/max-flows", test_history_max_flows);
+	g_test_add_func("/maestro/history/compaction", test_history_compaction);
+	g_test_add_func("/maestro/history/file-format", test_history_file_format);
+
+	return g_test_run();
+}
@@ -0,0 +1,202 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "../gebrm-journal.h"
+#include "test-utils.h"
+
+static void
+append_event(const gchar *id,
+	     gchar **event,
+	     gpointer user_data)
+{
+	GString *replay = user_data;
+	gchar *joined = g_strjoinv(" ", event);
+	g_string_append_printf(replay, "%s %s|", id, joined);
+	g_free(joined);
+}
+
+/* Returns the events kept in @journal, as "id event args|" */
+static gchar *
+replay(GebrmJournal *journal)
+{
+	GString *replay = g_string_new(NULL);
+	gebrm_journal_replay(journal, append_event, replay);
+	return g_string_free(replay, FALSE);
+}
+
+static void
+test_journal_replay(void)
+{
+	gchar *path = test_path_new("journal");
+	GebrmJournal *journal = gebrm_journal_new(path);
+	const gchar *expected =
+		"2 submit b|2 issue Disk full|"
+		"3 submit c|3 dispatch node1 4|3 status finished now|";
+
+	gebrm_journal_append(journal, "1", GEBRM_JOURNAL_STATUS, "running", NULL);	/* ignored */
+	gebrm_journal_append(journal, "2", GEBRM_JOURNAL_SUBMIT, "b", NULL);
+	gebrm_journal_append(journal, "1", GEBRM_JOURNAL_SUBMIT, "a", NULL);
+	gebrm_journal_append(journal, "3", GEBRM_JOURNAL_SUBMIT, "c", NULL);
+	gebrm_journal_append(journal, "3", GEBRM_JOURNAL_DISPATCH, "node1", "4", NULL);
+	gebrm_journal_append(journal, "3", GEBRM_JOURNAL_STATUS, "running", "before", NULL);
+	gebrm_journal_append(journal, "2", GEBRM_JOURNAL_ISSUE, "Disk full", NULL);
+	gebrm_journal_append(journal, "3", GEBRM_JOURNAL_STATUS, "finished", "now", NULL);
+	gebrm_journal_append(journal, "1", GEBRM_JOURNAL_CLOSE, NULL);
+
+	/* Only the last status is kept, where the first one was */
+	gchar *events = replay(journal);
+	g_assert_cmpstr(events, ==, expected);
+	g_free(events);
+	gebrm_journal_free(journal);
+
+	journal = gebrm_journal_new(path);
+	events = replay(journal);
+	g_assert_cmpstr(events, ==, expected);
+	g_free(events);
+	gebrm_journal_free(journal);
+
+	test_path_free(path);
+}
+
+static void
+test_journal_escape(void)
+{
+	gchar *path = test_path_new("journal");
+	GebrmJournal *journal = gebrm_journal_new(path);
+
+	gebrm_journal_append(journal, "1\t", GEBRM_JOURNAL_SUBMIT, "a\tb\nc\\", "", NULL);
+	gebrm_journal_free(journal);
+
+	/* Header and one event */
+	g_assert_cmpint(test_count_lines(path), ==, 2);
+
+	journal = gebrm_journal_new(path);
+	gchar *events = replay(journal);
+	g_assert_cmpstr(events, ==, "1\t submit a\tb\nc\\ |");
+	g_free(events);
+	gebrm_journal_free(journal);
+
+	test_path_free(path);
+}
+
+static void
+test_journal_snapshot(void)
+{
+	gchar *path = test_path_new("journal");
+	GebrmJournal *journal = gebrm_journal_new(path);
+
+	for (gint i = 0; i < 10; i++) {
+		gchar *id = g_strdup_printf("%d", i);
+		gebrm_journal_append(journal, id, GEBRM_JOURNAL_SUBMIT, "a", NULL);
+		gebrm_journal_append(journal, id, GEBRM_JOURNAL_STATUS, "running", NULL);
+		if (i != 5)
+			gebrm_journal_append(journal, id, GEBRM_JOURNAL_CLOSE, NULL);
+		g_free(id);
+	}
+	g_assert(gebrm_journal_sync(journal));
+	g_assert_cmpint(test_count_lines(path), ==, 1 + 10 * 3 - 1);
+
+	/* Only the events of the open jobs are rewritten */
+	g_assert(gebrm_journal_snapshot(journal));
+	g_assert_cmpint(test_count_lines(path), ==, 1 + 2);
+
+	/* And the next ones are appended after them */
+	gebrm_journal_append(journal, "5", GEBRM_JOURNAL_STATUS, "finished", NULL);
+	gebrm_journal_free(journal);
+	g_assert_cmpint(test_count_lines(path), ==, 1 + 3);
+
+	journal = gebrm_journal_new(path);
+	gchar *events = replay(journal);
+	g_assert_cmpstr(events, ==, "5 submit a|5 status finished|");
+	g_free(events);
+	gebrm_journal_free(journal);
+
+	test_path_free(path);
+}
+
+static void
+test_journal_compact_on_load(void)
+{
+	gchar *path = test_path_new("journal");
+	GString *contents = g_string_new("# gebrm journal 1\n");
+
+	/* Many more lines than needed to compact, of closed jobs only */
+	for (gint i = 0; i < 2000; i++)
+		g_string_append_printf(contents, "%d\tsubmit\ta\n%d\tclose\n", i, i);
+	g_string_append(contents, "open\tsubmit\ta\n");
+	g_assert(g_file_set_contents(path, contents->str, -1, NULL));
+	g_string_free(contents, TRUE);
+
+	GebrmJournal *journal = gebrm_journal_new(path);
+	g_assert_cmpint(test_count_lines(path), ==, 1 + 1);
+
+	gchar *events = replay(journal);
+	g_assert_cmpstr(events, ==, "open submit a|");
+	g_free(events);
+	gebrm_journal_free(journal);
+
+	test_path_free(path);
+}
+
+static void
+test_journal_retry(void)
+{
+	gchar *path = test_path_new("journal");
+	gchar *dir = g_path_get_dirname(path);
+	gchar *subdir = g_build_filename(dir, "missing", NULL);
+	gchar *subpath = g_build_filename(subdir, "journal", NULL);
+	GLogLevelFlags fatal = g_log_set_always_fatal(G_LOG_FATAL_MASK);
+
+	GebrmJournal *journal = gebrm_journal_new(subpath);
+	gebrm_journal_append(journal, "1", GEBRM_JOURNAL_SUBMIT, "a", NULL);
+
+	/* The failed write keeps the event for the next one */
+	g_assert(!gebrm_journal_sync(journal));
+	g_assert(g_mkdir(subdir, 0700) == 0);
+	g_assert(gebrm_journal_sync(journal));
+	g_assert_cmpint(test_count_lines(subpath), ==, 1 + 1);
+	gebrm_journal_free(journal);
+
+	journal = gebrm_journal_new(subpath);
+	gchar *events = replay(journal);
+	g_assert_cmpstr(events, ==, "1 submit a|");
+	g_free(events);
+	gebrm_journal_free(journal);
+
+	g_log_set_always_fatal(fatal);
+	g_unlink(subpath);
+	g_assert(g_rmdir(subdir) == 0);
+	g_free(subpath);
+	g_free(subdir);
+	g_free(dir);
+	test_path_free(path);
+}
+
+int main(int argc, char *argv[])
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/maestro/journal/replay", test_journal_replay);
+	g_test_add_func("/maestro/journal/escape", test_journal_escape);
+	g_test_add_func("/maestro/journal/snapshot", test_journal_snapshot);
+	g_test_add_func("/maestro/journal/compact-on-load", test_journal_compact_on_load);
+	g_test_add_func("/maestro/journal/retry", test_journal_retry);
+
+	return g_test_run();
+}
@@ -0,0 +1,160 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../gebrm-output.h"
+
+static void
+test_output_memory(void)
+{
+	GebrmOutput *output = gebrm_output_new(NULL);
+	gchar *data;
+
+	g_assert_cmpuint(gebrm_output_get_length(output), ==, 0);
+	data = gebrm_output_read(output, 0, 10);
+	g_assert_cmpstr(data, ==, "");
+	g_free(data);
+
+	gebrm_output_append(output, "hello ", 6);
+	gebrm_output_append(output, "world", 5);
+	g_assert_cmpuint(gebrm_output_get_length(output), ==, 11);
+
+	data = gebrm_output_read(output, 0, 100);
+	g_assert_cmpstr(data, ==, "hello world");
+	g_free(data);
+
+	data = gebrm_output_read(output, 3, 5);
+	g_assert_cmpstr(data, ==, "lo wo");
+	g_free(data);
+
+	data = gebrm_output_read(output, 11, 5);
+	g_assert_cmpstr(data, ==, "");
+	g_free(data);
+
+	gebrm_output_free(output);
+}
+
+static void
+test_output_file(void)
+{
+	gchar *dir = g_build_filename(g_get_tmp_dir(), "gebr-test-XXXXXX", NULL);
+	g_assert(mkdtemp(dir) != NULL);
+	gchar *path = g_build_filename(dir, "output", NULL);
+	GebrmOutput *output = gebrm_output_new(path);
+	gsize total = 3 * GEBRM_OUTPUT_TAIL_SIZE;
+	gchar line[] = "0123456789abcdef";
+
+	/* Enough that the beginning is only in the file */
+	for (gsize i = 0; i < total; i += 16)
+		gebrm_output_append(output, line, 16);
+	g_assert_cmpuint(gebrm_output_get_length(output), ==, total);
+	g_assert(g_file_test(path, G_FILE_TEST_EXISTS));
+
+	gchar *data = gebrm_output_read(output, 4, 16);
+	g_assert_cmpstr(data, ==, "456789abcdef0123");
+	g_free(data);
+
+	/* Every part of it reads the same, in the file or in memory */
+	data = gebrm_output_read(output, 0, total);
+	g_assert_cmpuint(strlen(data), ==, total);
+	for (gsize i = 0; i < total; i += 16)
+		g_assert(strncmp(data + i, line, 16) == 0);
+	g_free(data);
+
+	gebrm_output_free(output);
+	g_assert(!g_file_test(path, G_FILE_TEST_EXISTS));
+
+	g_assert(g_rmdir(dir) == 0);
+	g_free(path);
+	g_free(dir);
+}
+
+static void
+test_output_page(void)
+{
+	GebrmOutput *output = gebrm_output_new(NULL);
+	/* a, e acute (2 bytes), euro (3 bytes), b */
+	const gchar *text = "a\xc3\xa9\xe2\x82\xac" "b";
+	gsize offset;
+	gchar *page;
+
+	gebrm_output_append(output, text, strlen(text));
+
+	/* Whole characters are left alone */
+	offset = 0;
+	page = gebrm_output_read_page(output, &offset, 3);
+	g_assert_cmpstr(page, ==, "a\xc3\xa9");
+	g_assert_cmpuint(offset, ==, 0);
+	g_free(page);
+
+	/* A page starting inside a character starts after it */
+	offset = 2;
+	page = gebrm_output_read_page(output, &offset, 10);
+	g_assert_cmpstr(page, ==, "\xe2\x82\xac" "b");
+	g_assert_cmpuint(offset, ==, 3);
+	g_free(page);
+
+	/* A page ending inside a character ends before it */
+	offset = 0;
+	page = gebrm_output_read_page(output, &offset, 5);
+	g_assert_cmpstr(page, ==, "a\xc3\xa9");
+	g_assert_cmpuint(offset, ==, 0);
+	g_free(page);
+
+	offset = 2;
+	page = gebrm_output_read_page(output, &offset, 3);
+	g_assert_cmpstr(page, ==, "");
+	g_assert_cmpuint(offset, ==, 3);
+	g_free(page);
+
+	/* Paging through the output gives it back whole */
+	GString *joined = g_string_new(NULL);
+	offset = 0;
+	while (offset < gebrm_output_get_length(output)) {
+		page = gebrm_output_read_page(output, &offset, 4);
+		g_assert(g_utf8_validate(page, -1, NULL));
+		g_string_append(joined, page);
+		offset += strlen(page);
+		g_free(page);
+	}
+	g_assert_cmpstr(joined->str, ==, text);
+	g_string_free(joined, TRUE);
+
+	/* The end of the output may be the start of a character still
+	 * arriving, it is not held back */
+	gebrm_output_append(output, "\xe2\x82", 2);
+	offset = 7;
+	page = gebrm_output_read_page(output, &offset, 10);
+	g_assert_cmpstr(page, ==, "\xe2\x82");
+	g_free(page);
+
+	gebrm_output_free(output);
+}
+
+int main(int argc, char *argv[])
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/maestro/output/memory", test_output_memory);
+	g_test_add_func("/maestro/output/file", test_output_file);
+	g_test_add_func("/maestro/output/page", test_output_page);
+
+	return g_test_run();
+}
@@ -0,0 +1,139 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <glib.h>
+
+#include "../gebrm-sweep.h"
+
+/* Returns the points of @table as "a,b;c,d;" */
+static gchar *
+join_points(GPtrArray *table)
+{
+	GString *joined = g_string_new(NULL);
+
+	for (guint i = 0; i < table->len; i++) {
+		gchar *point = g_strjoinv(",", g_ptr_array_index(table, i));
+		g_string_append_printf(joined, "%s;", point);
+		g_free(point);
+	}
+
+	return g_string_free(joined, FALSE);
+}
+
+static void
+test_sweep_split_fields(void)
+{
+	gchar **fields = gebrm_sweep_split_fields("a\tb\\tc\t\\n");
+
+	g_assert_cmpuint(g_strv_length(fields), ==, 3);
+	g_assert_cmpstr(fields[0], ==, "a");
+	g_assert_cmpstr(fields[1], ==, "b\tc");
+	g_assert_cmpstr(fields[2], ==, "\n");
+	g_strfreev(fields);
+}
+
+static void
+test_sweep_explicit_points(void)
+{
+	GPtrArray *table = gebrm_sweep_get_points(2, "1\tx\n2\ty\n3\tz\n", FALSE);
+	gchar *joined;
+
+	g_assert(table != NULL);
+	joined = join_points(table);
+	g_assert_cmpstr(joined, ==, "1,x;2,y;3,z;");
+	g_free(joined);
+	g_ptr_array_free(table, TRUE);
+
+	/* Without the line break at the end */
+	table = gebrm_sweep_get_points(1, "1\n2", FALSE);
+	g_assert(table != NULL);
+	joined = join_points(table);
+	g_assert_cmpstr(joined, ==, "1;2;");
+	g_free(joined);
+	g_ptr_array_free(table, TRUE);
+
+	/* Every point has a value for each variable */
+	g_assert(gebrm_sweep_get_points(2, "1\tx\n2\n", FALSE) == NULL);
+	g_assert(gebrm_sweep_get_points(1, "1\tx\n", FALSE) == NULL);
+}
+
+static void
+test_sweep_product(void)
+{
+	GPtrArray *table = gebrm_sweep_get_points(3, "1\t2\na\tb\tc\nx\n", TRUE);
+
+	g_assert(table != NULL);
+	g_assert_cmpuint(table->len, ==, 2 * 3 * 1);
+
+	/* The last variable changes faster */
+	gchar *joined = join_points(table);
+	g_assert_cmpstr(joined, ==, "1,a,x;1,b,x;1,c,x;2,a,x;2,b,x;2,c,x;");
+	g_free(joined);
+	g_ptr_array_free(table, TRUE);
+
+	/* One line of values for each variable */
+	g_assert(gebrm_sweep_get_points(2, "1\t2\n", TRUE) == NULL);
+	g_assert(gebrm_sweep_get_points(1, "1\t2\na\tb\n", TRUE) == NULL);
+}
+
+static void
+test_sweep_max_points(void)
+{
+	GString *points = g_string_new(NULL);
+	GPtrArray *table;
+
+	for (gint i = 0; i < GEBRM_SWEEP_MAX_POINTS; i++)
+		g_string_append_printf(points, "%d\n", i);
+
+	table = gebrm_sweep_get_points(1, points->str, FALSE);
+	g_assert(table != NULL);
+	g_assert_cmpuint(table->len, ==, GEBRM_SWEEP_MAX_POINTS);
+	g_ptr_array_free(table, TRUE);
+
+	g_string_append(points, "one too many\n");
+	g_assert(gebrm_sweep_get_points(1, points->str, FALSE) == NULL);
+	g_string_free(points, TRUE);
+
+	/* 100 x 100 is the limit, the next value of the product is over it */
+	GString *values = g_string_new(NULL);
+	for (gint i = 0; i < 100; i++)
+		g_string_append_printf(values, "%s%d", i ? "\t" : "", i);
+
+	gchar *product = g_strdup_printf("%s\n%s\n", values->str, values->str);
+	table = gebrm_sweep_get_points(2, product, TRUE);
+	g_assert(table != NULL);
+	g_assert_cmpuint(table->len, ==, GEBRM_SWEEP_MAX_POINTS);
+	g_ptr_array_free(table, TRUE);
+	g_free(product);
+
+	product = g_strdup_printf("%s\t100\n%s\n", values->str, values->str);
+	g_assert(gebrm_sweep_get_points(2, product, TRUE) == NULL);
+	g_free(product);
+
+	g_string_free(values, TRUE);
+}
+
+int main(int argc, char *argv[])
+{
+	g_test_init(&argc, &argv, NULL);
+
+	g_test_add_func("/maestro/sweep/split-fields", test_sweep_split_fields);
+	g_test_add_func("/maestro/sweep/explicit-points", test_sweep_explicit_points);
+	g_test_add_func("/maestro/sweep/product", test_sweep_product);
+	g_test_add_func("/maestro/sweep/max-points", test_sweep_max_points);
+
+	return g_test_run();
+}
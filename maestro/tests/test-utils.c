@@ -0,0 +1,56 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+
+#include "test-utils.h"
+
+gchar *
+test_path_new(const gchar *name)
+{
+	gchar *dir = g_build_filename(g_get_tmp_dir(), "gebr-test-XXXXXX", NULL);
+	g_assert(mkdtemp(dir) != NULL);
+	gchar *path = g_build_filename(dir, name, NULL);
+	g_free(dir);
+	return path;
+}
+
+void
+test_path_free(gchar *path)
+{
+	gchar *dir = g_path_get_dirname(path);
+	g_unlink(path);
+	g_assert(g_rmdir(dir) == 0);
+	g_free(dir);
+	g_free(path);
+}
+
+gint
+test_count_lines(const gchar *path)
+{
+	gchar *contents;
+	gint n = 0;
+
+	g_assert(g_file_get_contents(path, &contents, NULL, NULL));
+	for (gchar *i = contents; *i; i++)
+		if (*i == '\n')
+			n++;
+	g_free(contents);
+
+	return n;
+}
@@ -0,0 +1,39 @@
+/*   GeBR Maestro
+ *   Copyright (C) 2012 GeBR core team (http://www.gebrproject.com/)
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEST_UTILS_H__
+#define __TEST_UTILS_H__
+
+#include <glib.h>
+
+/*
+ * Returns: a path named @name in a new temporary directory, which
+ * test_path_free() removes.
+ */
+gchar *test_path_new(const gchar *name);
+
+/*
+ * Removes the file at @path and its directory.
+ */
+void test_path_free(gchar *path);
+
+/*
+ * Returns: the number of lines of the file at @path.
+ */
+gint test_count_lines(const gchar *path);
+
+#endif /* __TEST_UTILS_H__ */